@@ -16,6 +16,9 @@ extern void CANTP_SytstemTickControl(void);
 /*Init CAN TP list*/
 extern void CANTP_Init(void);
 
+/*CF reception from the driver RX interrupt, TRUE if the frame was taken*/
+extern boolean CANTP_DriverReceiveCF(const uint32 i_RxID, const uint32 i_dataLen, const uint8 *i_pDataBuf);
+
 #endif /*#ifdef EN_CAN_TP*/
 
 #endif /*#ifndef __CAN_TP_H__*/
@@ -16,13 +16,15 @@ typedef uint16 tBlockSize;
 typedef void (*tpfNetTxCallBack)(void);
 typedef uint8 (*tNetTxMsg)(const tUdsId, const uint16, const uint8 *, const tpfNetTxCallBack, const uint32);
 typedef uint8 (*tNetRx)(tUdsId *, uint8 *, uint8 *);
-typedef uint16 tCanTpDataLen;
+typedef uint32 tCanTpDataLen;
 
 /*abort tx message*/
 typedef void (*tpfAbortTxMsg)(void);
 
 
-#define MAX_CF_DATA_LEN (150u) /*max first frame data len */
+/*max FF_DL in the 12 bit field, longer messages use the escaped 32 bit FF_DL.
+Rx/Tx data lives in TP_pdu.h pool buffers (TP_PDU_BUF_LEN).*/
+#define FF_DL_12BIT_MAX (0x0FFFu)
 
 #define MAX_CAN_DATA_LEN (64u)  /*max CAN data len*/
 
@@ -50,6 +52,30 @@ typedef void (*tpfAbortTxMsg)(void);
 #define TX_CF_DATA_MAX_LEN (SF_CANFD_DATA_MAX_LEN + 1u)  /*single conective frame max data len*/
 #endif
 
+/*BS sent in our FC, 0 = all CFs without further FC*/
+#ifndef CANTP_RX_BLOCK_SIZE
+#define CANTP_RX_BLOCK_SIZE (0u)
+#endif
+
+/*STmin sent in our FC as on the bus: 0x00-0x7F ms, 0xF1-0xF9 100-900 us*/
+#ifndef CANTP_RX_STMIN
+#define CANTP_RX_STMIN (1u)
+#endif
+
+#if (CANTP_RX_STMIN > 0x7Fu) && ((CANTP_RX_STMIN < 0xF1u) || (CANTP_RX_STMIN > 0xF9u))
+#error "CANTP_RX_STMIN must be 0x00..0x7F or 0xF1..0xF9"
+#endif
+
+/*CFs given to the driver before the first is confirmed (TX mailboxes it keeps loaded), 1 = one by one.
+TX_BUS_FIFO_LEN must hold this many frames.*/
+#ifndef CANTP_TX_PIPELINE_DEPTH
+#define CANTP_TX_PIPELINE_DEPTH (3u)
+#endif
+
+#if (CANTP_TX_PIPELINE_DEPTH < 1u) || (CANTP_TX_PIPELINE_DEPTH > 8u)
+#error "CANTP_TX_PIPELINE_DEPTH must be 1..8"
+#endif
+
 /*standard CAN message length for CAN TP*/
 #define STANDARD_CAN_DL (8u)          
 
@@ -63,7 +89,7 @@ typedef struct
 	tUdsId xRxPhyId;             /*Rx phy ID*/
 	tUdsId xTxId;                /*Tx ID*/
 	tBlockSize xBlockSize;       /*BS*/
-	tNetTime xSTmin;             /*STmin*/
+	tNetTime xSTmin;             /*STmin, FC byte: 0x00-0x7F ms, 0xF1-0xF9 100-900 us*/
 	tNetTime xNAs;               /*N_As*/
 	tNetTime xNAr;               /*N_Ar*/
 	tNetTime xNBs;               /*N_Bs*/
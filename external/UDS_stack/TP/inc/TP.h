@@ -24,6 +24,7 @@
  ******************************************************************************/
 #include "includes.h"
 #include "TP_cfg.h"
+#include "TP_pdu.h"
 
 #ifdef EN_CAN_TP
 #include "can_tp.h"
@@ -105,12 +106,18 @@ extern void TP_MainFun(void);
 extern void TP_SystemTickCtl(void);
 
 
-/*read a frame  tp data  from UDS to Tp TxFIFO. If no data can read return FALSE, else return TRUE*/
-extern boolean TP_ReadAFrameDataFromTP(uint32 *o_pRxMsgID, 
-									  uint32 *o_pxRxDataLen,
-									  uint8 *o_pDataBuf);
+/*read a received PDU for UDS. If none return FALSE, else return TRUE and the caller owns one reference of *o_pxPdu.*/
+extern boolean TP_ReadAPduFromTP(uint32 *o_pRxMsgID, 
+								 uint32 *o_pxRxDataLen,
+								 tTPPduHandle *o_pxPdu);
 
-/*write a frame data from  Tp to UDS RxFIFO*/
+/*send the first i_xTxDataLen bytes of a PDU. The TP takes its own reference, the caller keeps its one.*/
+extern boolean TP_WriteAPduInTP(const uint32 i_TxMsgID,
+								const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+								const uint32 i_xTxDataLen,
+								const tTPPduHandle i_xPdu);
+
+/*send a short message held outside the pool (copied into a PDU buffer)*/
 extern boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
 									 const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
 									 const uint32 i_xTxDataLen,
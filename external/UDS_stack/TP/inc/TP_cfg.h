@@ -33,7 +33,7 @@ typedef struct
 #define RX_TP_QUEUE_ID ('R')  /*TP RX  FIFO ID*/
 #define TX_TP_QUEUE_ID ('T')  /*TP TX  FIFO ID*/
 
-/*defined FIFO length*/
+/*defined FIFO length, LIN TP only. CAN TP passes messages as TP_pdu.h pool buffers.*/
 #define TX_TP_QUEUE_LEN (50u)  /*UDS send message to  TP max length*/
 #define RX_TP_QUEUE_LEN (150)  /*UDS read message from TP max length*/
 
@@ -48,10 +48,18 @@ typedef struct
 {
 	uint32 TxMsgID;       /*Tx message ID*/
 	uint32 TxMsgLength;   /*TX message length*/
-	uint32 TxMsgCallBack; /*Tx message callback*/
+	void (*pfTxMsgCallBack)(void); /*Tx message callback*/
 }tTPTxMsgHeader;
 
 
+/*frames from the bus driver, see TP_GetRxStatistics()*/
+typedef struct
+{
+	uint32 rxFrameCnt;   /*frames the driver wrote in TP*/
+	uint32 rxDropCnt;    /*frames the TP had no room for*/
+	uint32 rxOverrunCnt; /*RX FIFO overflows reported by the driver*/
+}tTPRxStatistics;
+
 /*Get TP config TX message ID*/
 extern uint32 TP_GetConfigTxMsgID(void);
 
@@ -75,6 +83,12 @@ extern void TP_DoTransmittedAFrameMsgCallBack(const uint8 i_result);
 /*Driver write data in TP*/
 extern boolean TP_DriverWriteDataInTP(const uint32 i_RxID, const uint32 i_RxDataLen, const uint8 *i_pRxDataBuf);
 
+/*Driver reports received frames lost before the TP saw them (controller RX FIFO overflow)*/
+extern void TP_DriverRxOverrun(void);
+
+/*Get RX statistics since power up*/
+extern void TP_GetRxStatistics(tTPRxStatistics *o_pstRxStatistics);
+
 /*Driver read data from TP for Tx message to BUS*/
 extern boolean TP_DriverReadDataFromTP(const uint32 i_readDataLen, uint8 * o_pReadDatabuf, uint32 *o_pTxMsgID, uint32 *o_pTxMsgLength);
 
@@ -0,0 +1,80 @@
+/*
+ * TP_pdu.h
+ *
+ *  Pooled PDU buffers shared by the TP and the UDS layer.
+ *
+ *  A request is reassembled by the TP directly into a pool buffer, handed to
+ *  UDS by handle, answered in place and handed back to the TP for sending,
+ *  so no layer keeps its own copy. Buffers are reference counted: whoever
+ *  holds a handle (TP reassembly, RX/TX queue, UDS, a parked request) owns
+ *  one reference and releases it when done.
+ *
+ *  Everything runs in the main loop (TP_MainFun()/UDS_MainFun()), the pool
+ *  is not interrupt safe.
+ */
+
+#ifndef _TP_PDU_H_
+#define _TP_PDU_H_
+
+#include "TP_cfg.h"
+
+/*largest request/response. Above 4095 bytes CAN TP uses the ISO 15765-2:2016 escaped FF_DL.*/
+#ifndef TP_PDU_BUF_LEN
+#define TP_PDU_BUF_LEN (4096u)
+#endif
+
+#if (TP_PDU_BUF_LEN < 64) || (TP_PDU_BUF_LEN > 0xFFFF)
+#error "TP_PDU_BUF_LEN should config [64, 0xFFFF]"
+#endif
+
+/*buffers in the pool: one being received, one parked in UDS, one being sent, one queued*/
+#ifndef TP_PDU_BUF_NUM
+#define TP_PDU_BUF_NUM (4u)
+#endif
+
+#if (TP_PDU_BUF_NUM < 2) || (TP_PDU_BUF_NUM > 16)
+#error "TP_PDU_BUF_NUM should config [2, 16]"
+#endif
+
+/*handle of a pool buffer, 1..TP_PDU_BUF_NUM. Zeroed state holds no buffer.*/
+typedef uint8 tTPPduHandle;
+
+#define TP_PDU_NONE (0u)
+
+/*clear the pool and the queues*/
+extern void TP_PduInit(void);
+
+/*take a free buffer with one reference, TP_PDU_NONE if the pool is empty*/
+extern tTPPduHandle TP_AllocPdu(void);
+
+/*add a reference*/
+extern void TP_RetainPdu(const tTPPduHandle i_xPdu);
+
+/*drop a reference, the buffer goes back to the pool with the last one. TP_PDU_NONE is ignored.*/
+extern void TP_ReleasePdu(const tTPPduHandle i_xPdu);
+
+/*data of a buffer, TP_PDU_BUF_LEN bytes. NULL_PTR for TP_PDU_NONE.*/
+extern uint8 *TP_GetPduBuf(const tTPPduHandle i_xPdu);
+
+/*free buffers in the pool*/
+extern uint8 TP_GetFreePduNum(void);
+
+/*received PDU for UDS. The queue takes over the caller's reference.*/
+extern boolean TP_PutRxPdu(const uint32 i_RxMsgID, const uint32 i_dataLen, const tTPPduHandle i_xPdu);
+
+/*oldest received PDU, the caller takes over the queue's reference*/
+extern boolean TP_GetRxPdu(uint32 *o_pRxMsgID, uint32 *o_pDataLen, tTPPduHandle *o_pxPdu);
+
+/*PDU for the bus. The queue takes over the caller's reference.*/
+extern boolean TP_PutTxPdu(const uint32 i_TxMsgID,
+						   const tpfUDSTxMsgCallBack i_pfCallBack,
+						   const uint32 i_dataLen,
+						   const tTPPduHandle i_xPdu);
+
+/*oldest PDU to send, the caller takes over the queue's reference*/
+extern boolean TP_GetTxPdu(uint32 *o_pTxMsgID,
+						   tpfUDSTxMsgCallBack *o_pfCallBack,
+						   uint32 *o_pDataLen,
+						   tTPPduHandle *o_pxPdu);
+
+#endif /* _TP_PDU_H_ */
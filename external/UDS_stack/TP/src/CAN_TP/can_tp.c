@@ -3,6 +3,7 @@
 #ifdef EN_CAN_TP
 #include "can_tp.h"
 #include "TP_cfg.h"
+#include "TP_pdu.h"
 
 /*CAN/CAN FD define*/
 typedef enum
@@ -91,15 +92,23 @@ typedef struct
 	tUdsId xCanTpId;                           /*can tp message id*/
 	tCanTpDataLen xPduDataLen;                 /*pdu data len(Rx/Tx data len)*/
 	tCanTpDataLen xFFDataLen;                  /*Rx/Tx FF data len*/
-	uint8 aDataBuf[MAX_CF_DATA_LEN]; /*Rx/Tx data buf*/
+	tTPPduHandle xPdu;                         /*pool buffer holding the Rx/Tx data, see TP_pdu.h*/
+	uint8 *pDataBuf;                           /*data of xPdu*/
 }tCanTpDataInfo;
 
+/*time on CANTP_GetTimeUs(): ulTimeUs from ulStartUs on. All 0 = timeout.*/
+typedef struct
+{
+	uint32 ulStartUs;    /*started at*/
+	uint32 ulTimeUs;     /*runs for*/
+}tCanTpTimer;
+
 typedef struct
 {
 	uint8 ucSN;          /*SN*/
 	uint8 ucBlockSize;   /*Block size*/
-	tNetTime xSTmin;             /*STmin*/
-	tNetTime xMaxWatiTimeout;    /*timeout time*/
+	tCanTpTimer stSTmin;           /*STmin*/
+	tCanTpTimer stMaxWatiTimeout;  /*timeout time*/
 	tCanTpDataInfo stCanTpDataInfo;
 }tCanTpInfo;
 
@@ -111,6 +120,35 @@ typedef struct
 	uint8 aMsgBuf[MAX_CAN_DATA_LEN]; /*message data buf*/
 }tCanTpMsg;
 
+/*CF reception in the driver RX interrupt, see CANTP_DriverReceiveCF()*/
+typedef enum
+{
+	CF_RX_OFF,        /*CFs are not expected, frames go through RX_BUS_FIFO*/
+	CF_RX_ON,         /*CFs are written into the reassembly buffer*/
+	CF_RX_BLOCK_END,  /*BS CFs received, waiting for our FC*/
+	CF_RX_DONE,       /*all FF_DL bytes received*/
+	CF_RX_WRONG_SN    /*CF with an unexpected SN, reception aborted*/
+}tCanTpCFRxStatus;
+
+typedef struct
+{
+	tCanTpCFRxStatus eStatus;      /*set by CANTP_MainFun() to CF_RX_ON, by the interrupt to the others*/
+	tUdsId xRxId;                  /*ID the FF came with*/
+	uint8 *pDataBuf;               /*reassembly buffer (pool buffer of the message)*/
+	tCanTpDataLen xFFDataLen;      /*FF_DL*/
+	tCanTpDataLen xRevDataLen;     /*bytes in pDataBuf*/
+	uint8 ucSN;                    /*next expected SN*/
+	tBlockSize xBlockLeft;         /*CFs until the next FC, 0 without BS*/
+}tCanTpCFRxInfo;
+
+/*CFs on their way to the bus, see CANTP_DoTransmitCF()*/
+typedef struct
+{
+	uint8 ucInFlight;            /*CFs given to the driver and not confirmed yet, up to CANTP_TX_PIPELINE_DEPTH*/
+	volatile uint8 ucConfirmed;  /*confirmations from the driver TX interrupt not taken yet*/
+	boolean isBlockEnd;          /*last CF of the block the FC allowed is queued*/
+}tCanTpCFTxInfo;
+
 typedef tN_Result (*tpfCanTpFun)(tCanTpMsg *, tCanTpWorkStatus *);
 typedef struct
 {
@@ -120,29 +158,38 @@ typedef struct
 
 /***********************Global value*************************/
  static tCanTpInfo gs_stCanTPTxDataInfo; /*can tp tx data*/
- static tNetTime gs_xCanTPTxSTmin = 0u; /*tx STmin*/
- static uint32 gs_CANTPTxMsgMaxWaitTime = 0u;/*tx message max wait time, RX / TX frame both used waitting status*/
+ static uint32 gs_ulCanTPTxSTminUs = 0u; /*tx STmin (us) from the tester's FC*/
+ static tCanTpTimer gs_stCANTPTxMsgMaxWaitTime;/*tx message max wait time, RX / TX frame both used waitting status*/
  static tCanTpInfo gs_stCanTPRxDataInfo; /*can tp rx data*/
  static tCanTpWorkStatus gs_eCanTpWorkStatus = IDLE;
  static volatile tCanTPTxMsgStatus gs_eCANTPTxMsStatus = CANTP_TX_MSG_IDLE;
  static tpfNetTxCallBack gs_pfCANTPTxMsgCallBack = NULL_PTR;
+ static volatile tCanTpCFRxInfo gs_stCanTPCFRxInfo; /*CF reception shared with the RX interrupt*/
+ static tCanTpCFTxInfo gs_stCanTPCFTxInfo; /*CF transmission, confirmed in the TX interrupt*/
 /*********************************************************/
 
 /***********************Static function***********************/
-#define CanTpTimeToCount(xTime) ((xTime) / g_stCANUdsNetLayerCfgInfo.ucCalledPeriod)
+#define CanTpMsToUs(xTime) ((uint32)(xTime) * 1000u)
+
+/*STmin byte of an FC: 0x00-0x7F ms, 0xF1-0xF9 100-900 us, the rest reserved*/
+#define STMIN_MS_MAX (0x7Fu)
+#define STMIN_US_MIN (0xF1u)
+#define STMIN_US_MAX (0xF9u)
+
+/*start timer, xTimeUs from now*/
+#define StartCanTpTimer(stTimer, xTimeUs)\
+do{\
+	(stTimer).ulStartUs = CANTP_GetTimeUs();\
+	(stTimer).ulTimeUs = (uint32)(xTimeUs);\
+}while(0u)
+
+/*Is timer timeout? The unsigned difference survives the wrap of the microsecond counter.*/
+#define IsCanTpTimerTimeout(stTimer) (((uint32)(CANTP_GetTimeUs() - (stTimer).ulStartUs) >= (stTimer).ulTimeUs) ? TRUE : FALSE)
+
 #define IsSF(xNetWorkFrameType) ((((xNetWorkFrameType) >> 4u) ==  SF) ? TRUE : FALSE)
 #define IsFF(xNetWorkFrameType) ((((xNetWorkFrameType) >> 4u) ==  FF) ? TRUE : FALSE)
 #define IsCF(xNetWorkFrameType) ((((xNetWorkFrameType) >> 4u) ==  CF) ? TRUE : FALSE)
 #define IsFC(xNetWorkFrameType) ((((xNetWorkFrameType)>> 4u) ==  FC) ? TRUE : FALSE)
-#define IsRevSNValid(xSN) ((gs_stCanTPRxDataInfo.ucSN == ((xSN) & 0x0Fu)) ? TRUE : FALSE)
-#define AddWaitSN()\
-do{\
-	gs_stCanTPRxDataInfo.ucSN++;\
-	if(gs_stCanTPRxDataInfo.ucSN > 0x0Fu)\
-	{\
-		gs_stCanTPRxDataInfo.ucSN = 0u;\
-	}\
-}while(0u)
 
 #define GetFrameLen(pucRevData, pxDataLen)\
 do{\
@@ -165,6 +212,9 @@ static boolean GetRxSFMsgValidPosition(const uint32 i_RxMsgLen, uint8* o_pDataSt
 /*get RX FF frame message length*/
 static boolean GetRXFFFrameMsgLength(const uint32 i_RxMsgLen, const uint8 *i_pMsgBuf, uint32 *o_pFrameLen);
 
+/*STmin byte of an FC to us*/
+static uint32 CANTP_STminToUs(const uint8 i_ucSTmin);
+
 /*check received message length valid or not?*/
 #define IsRxMsgLenValid(address_type, frameLen, RXCANMsgLen) ((address_type == NORMAL_ADDRESSING) ? (frameLen <= RXCANMsgLen - 1) : (frameLen <= RXCANMsgLen - 2))
 
@@ -174,25 +224,16 @@ static boolean GetRXFFFrameMsgLength(const uint32 i_RxMsgLen, const uint8 *i_pMs
 /*set BS*/
 #define SetBlockSize(pucBSBuf, xBlockSize) (*(pucBSBuf) = (uint8)(xBlockSize))
 
-/*add block size*/
-#define AddBlockSize()\
-do{\
-	if(0u != g_stCANUdsNetLayerCfgInfo.xBlockSize)\
-	{\
-		gs_stCanTPRxDataInfo.ucBlockSize++;\
-	}\
-}while(0u)
-
 /*set STmin*/
 #define SetSTmin(pucSTminBuf, xSTmin) (*(pucSTminBuf) = (uint8)(xSTmin))
 
 /*set wait  STmin*/
-#define SetWaitSTmin() (gs_stCanTPRxDataInfo.xSTmin = CanTpTimeToCount(g_stCANUdsNetLayerCfgInfo.xSTmin))
+#define SetWaitSTmin() StartCanTpTimer(gs_stCanTPRxDataInfo.stSTmin, CANTP_STminToUs((uint8)g_stCANUdsNetLayerCfgInfo.xSTmin))
 
 /*set wait frame time*/
 #define SetRxWaitFrameTime(xWaitTimeout) do{\
-	(gs_stCanTPRxDataInfo.xMaxWatiTimeout = CanTpTimeToCount(xWaitTimeout));\
-	gs_CANTPTxMsgMaxWaitTime = gs_stCanTPRxDataInfo.xMaxWatiTimeout;\
+	StartCanTpTimer(gs_stCanTPRxDataInfo.stMaxWatiTimeout, CanTpMsToUs(xWaitTimeout));\
+	gs_stCANTPTxMsgMaxWaitTime = gs_stCanTPRxDataInfo.stMaxWatiTimeout;\
 }while(0u);
 
 /*RX frame set Rx msg wait time*/
@@ -201,8 +242,13 @@ do{\
 /*RX frame set Tx msg wait time*/
 #define RXFrame_SetTxMsgWaitTime(xWaitTimeout) SetRxWaitFrameTime(xWaitTimeout)
 
-/*set wait SN*/
-#define SetWaitSN(xSN) (gs_stCanTPRxDataInfo.ucSN = xSN)
+/*stop CF reception in the RX interrupt before the reassembly buffer is released or reused*/
+#define StopDriverReceiveCF()\
+do{\
+	DisableAllInterrupts();\
+	gs_stCanTPCFRxInfo.eStatus = CF_RX_OFF;\
+	EnableAllInterrupts();\
+}while(0u)
 
 /*set FS*/
 #define SetFS(pucFsBuf, xFlowStatus) (*(pucFsBuf) = (*(pucFsBuf) & 0xF0u) | (uint8)(xFlowStatus))
@@ -216,23 +262,24 @@ do{\
 /*add rev data len*/
 #define AddRevDataLen(xRevDataLen) (gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen += (xRevDataLen))
 
-/*Is rev conective frame all.*/
-#define IsReciveCFAll(xCFDataLen) (((gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen + (uint8)(xCFDataLen))\
-									>= gs_stCanTPRxDataInfo.stCanTpDataInfo.xFFDataLen) ? TRUE : FALSE)
+/*FF data start position: FF_DL over 4095 bytes is escaped (12 bit 0, then 32 bit length)*/
+#define GetFFDataStartPos(xFFDataLen) (((xFFDataLen) > FF_DL_12BIT_MAX) ? 6u : 2u)
+
+/*received message went to UDS or was dropped, the buffer is not ours any more*/
+#define DetachRxPdu()\
+do{\
+	gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu = TP_PDU_NONE;\
+	gs_stCanTPRxDataInfo.stCanTpDataInfo.pDataBuf = NULL_PTR;\
+}while(0u)
 
 /*Is STmin timeout?*/
-#define IsSTminTimeOut() ((0u == gs_stCanTPRxDataInfo.xSTmin) ? TRUE : FALSE)
+#define IsSTminTimeOut() IsCanTpTimerTimeout(gs_stCanTPRxDataInfo.stSTmin)
 
 /*Is wait Flow control timeout?*/
-#define IsWaitFCTimeout()  ((0u == gs_stCanTPRxDataInfo.xMaxWatiTimeout) ? TRUE : FALSE)
+#define IsWaitFCTimeout()  IsCanTpTimerTimeout(gs_stCanTPRxDataInfo.stMaxWatiTimeout)
 
 /*Is wait conective frame timeout?*/
-#define IsWaitCFTimeout() ((0u == gs_stCanTPRxDataInfo.xMaxWatiTimeout) ? TRUE : FALSE)
-
-/*Is block sizeo overflow*/
-#define IsRxBlockSizeOverflow() (((0u != g_stCANUdsNetLayerCfgInfo.xBlockSize) &&\
-							     (gs_stCanTPRxDataInfo.ucBlockSize >= g_stCANUdsNetLayerCfgInfo.xBlockSize))\
-							    ? TRUE : FALSE)
+#define IsWaitCFTimeout() IsCanTpTimerTimeout(gs_stCanTPRxDataInfo.stMaxWatiTimeout)
 
 /*Is transmitted data len overflow max SF?*/
 #define IsTxDataLenOverflowSF() ((gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen > TX_SF_DATA_MAX_LEN) ? TRUE : FALSE)
@@ -247,30 +294,22 @@ do{\
 	(*(pucSFDataLenBuf) |= (xTxSFDataLen));\
 }while(0u)
 
-/*set transmitted FF data len*/
-#define SetTxFFDataLen(pucTxFFDataLenBuf, xTxFFDataLen)\
-do{\
-	*(pucTxFFDataLenBuf + 0u) &= 0xF0u;\
-	*(pucTxFFDataLenBuf + 0u) |= (uint8)((xTxFFDataLen) >> 8u);\
-	*(pucTxFFDataLenBuf + 1u) |= (uint8)(xTxFFDataLen);\
-}while(0u)
-
 /*add Tx data len*/
 #define AddTxDataLen(xTxDataLen) (gs_stCanTPTxDataInfo.stCanTpDataInfo.xPduDataLen += (xTxDataLen))
 
 /*set tx STmin */
-#define SetTxSTmin() (gs_stCanTPTxDataInfo.xSTmin = CanTpTimeToCount(gs_xCanTPTxSTmin))
+#define SetTxSTmin() StartCanTpTimer(gs_stCanTPTxDataInfo.stSTmin, gs_ulCanTPTxSTminUs)
 
 /*save Tx STmin*/
-#define SaveTxSTmin(xTxSTmin) (gs_xCanTPTxSTmin = xTxSTmin)
+#define SaveTxSTmin(xTxSTmin) (gs_ulCanTPTxSTminUs = CANTP_STminToUs(xTxSTmin))
 
 /*Is Tx STmin timeout?*/
-#define IsTxSTminTimeout() ((0u == gs_stCanTPTxDataInfo.xSTmin) ? TRUE : FALSE)
+#define IsTxSTminTimeout() IsCanTpTimerTimeout(gs_stCanTPTxDataInfo.stSTmin)
 
 /*Set tx wait frame time*/
 #define SetTxWaitFrameTime(xWaitTime) do{\
-	(gs_stCanTPTxDataInfo.xMaxWatiTimeout = CanTpTimeToCount(xWaitTime));\
-	gs_CANTPTxMsgMaxWaitTime = gs_stCanTPTxDataInfo.xMaxWatiTimeout;\
+	StartCanTpTimer(gs_stCanTPTxDataInfo.stMaxWatiTimeout, CanTpMsToUs(xWaitTime));\
+	gs_stCANTPTxMsgMaxWaitTime = gs_stCanTPTxDataInfo.stMaxWatiTimeout;\
 }while(0u);
 
 
@@ -281,10 +320,10 @@ do{\
 #define TXFrame_SetRxMsgWaitTime(xWaitTime) SetTxWaitFrameTime(xWaitTime)
 
 /*Is Tx wait frame timeout?*/
-#define IsTxWaitFrameTimeout() ((0u == gs_stCanTPTxDataInfo.xMaxWatiTimeout) ? TRUE : FALSE)
+#define IsTxWaitFrameTimeout() IsCanTpTimerTimeout(gs_stCanTPTxDataInfo.stMaxWatiTimeout)
 
 /*Is Tx message wait frame timeout?*/
-#define IsTxMsgWaittingFrameTimeout() ((0u == gs_CANTPTxMsgMaxWaitTime) ? TRUE : FALSE)
+#define IsTxMsgWaittingFrameTimeout() IsCanTpTimerTimeout(gs_stCANTPTxMsgMaxWaitTime)
 
 /*Get FS*/
 #define GetFS(ucFlowStaus, pxFlowStatusBuf) (*(pxFlowStatusBuf) = (ucFlowStaus) & 0x0Fu)
@@ -362,8 +401,11 @@ static tN_Result CANTP_DoTransmitFF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m
 /*wait flow control frame*/
 static tN_Result CANTP_DoReceiveFC(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_peNextStatus);
 
-/*transmit CF callback*/
-static void CANTP_DoTransmitCFCallBack(void);
+/*CF confirmed by the driver*/
+static void CANTP_TxCFSuccessfulCallBack(void);
+
+/*give the driver the next CF*/
+static boolean CANTP_TransmitNextCF(void);
 
 /*transmit conective frame*/
 static tN_Result CANTP_DoTransmitCF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_peNextStatus);
@@ -401,16 +443,11 @@ static boolean CANTP_FillTxMsgInfo(const tNetWorkFrameType i_eFrameType,
 								   uint8 *o_pDstMsgBuf,
 								   uint32 *o_pDstMsgLen);
 
-/*received a can tp frame, copy these data in fifo.*/
-static uint8 CANTP_CopyAFrameDataInRxFifo(const tUdsId i_xRxCanID, 
-										      		const tLen i_xRxDataLen,
-									          		const uint8 *i_pDataBuf 
-									          		);
+/*received a whole message, hand its buffer to UDS.*/
+static uint8 CANTP_PassRxPduToUDS(const tUdsId i_xRxCanID, const tCanTpDataLen i_xRxDataLen);
 
-/*uds transmitted a application frame data, copy these data in TX fifo.*/
-static uint8 CANTP_CopyAFrameFromFifoToBuf(tUdsId *o_pxTxCanID, 
-										      		   uint8 *o_pTxDataLen,
-									          		   uint8 *o_pDataBuf);
+/*take the next message UDS wants transmitted.*/
+static uint8 CANTP_GetTxPduFromUDS(void);
 
 /*CAN TP TX message callback*/
 static void CANTP_TxMsgSuccessfulCallBack(void);
@@ -445,26 +482,7 @@ void CANTP_Init(void)
 {
 	tErroCode eStatus;
 
-	ApplyFifo(RX_TP_QUEUE_LEN, RX_TP_QUEUE_ID, &eStatus);
-	if(ERRO_NONE != eStatus)
-	{
-		TP_DebugPrintf("apply RX_TP_QUEUE_ID failed!\n");
-		while(1)
-		{
-			
-		}
-	}
-
-	ApplyFifo(TX_TP_QUEUE_LEN, TX_TP_QUEUE_ID, &eStatus);
-	if(ERRO_NONE != eStatus)
-	{
-		TP_DebugPrintf("apply TX_TP_QUEUE_ID failed\n");
-		while(1)
-		{
-			
-		}
-	}
-	
+	/*messages to and from UDS are passed as pool buffers (TP_pdu.h), not through FIFOs*/
     ApplyFifo(RX_BUS_FIFO_LEN, RX_BUS_FIFO, &eStatus);
 	if(ERRO_NONE != eStatus)
 	{
@@ -490,30 +508,7 @@ void CANTP_Init(void)
 /*can tp system tick control. This function should period called by system.*/
 void CANTP_SytstemTickControl(void)
 {
-	if(gs_stCanTPRxDataInfo.xSTmin)
-	{
-		gs_stCanTPRxDataInfo.xSTmin--;
-	}
-	
-	if(gs_stCanTPRxDataInfo.xMaxWatiTimeout)
-	{
-		gs_stCanTPRxDataInfo.xMaxWatiTimeout--;
-	}
-	
-	if(gs_stCanTPTxDataInfo.xSTmin)
-	{
-		gs_stCanTPTxDataInfo.xSTmin--;
-	}
-	
-	if(gs_stCanTPTxDataInfo.xMaxWatiTimeout)
-	{
-		gs_stCanTPTxDataInfo.xMaxWatiTimeout--;
-	}
-
-	if(gs_CANTPTxMsgMaxWaitTime)
-	{
-		gs_CANTPTxMsgMaxWaitTime--;
-	}
+	/*STmin and the waitting times run on CANTP_GetTimeUs(), nothing to count down here*/
 }
 
 /*uds network man function*/
@@ -524,8 +519,9 @@ void CANTP_MainFun(void)
 	tCanTpMsg stRxCanTpMsg = {TRUE, 0u, 0u, {0u}};
 	tN_Result result = N_OK;
 
-	/*In waitting TX message, cannot read message from FIFO. Because, In waitting message will lost read messages.*/
-	if(WAITTING_TX != GetCurCANTPStatus())
+	/*In waitting TX message, cannot read message from FIFO. Because, In waitting message will lost read messages.
+	Same while sending CFs: the FC after a block can come before we have taken the confirmations.*/
+	if((WAITTING_TX != GetCurCANTPStatus()) && (TX_CF != GetCurCANTPStatus()))
 	{
 		/*read msg from CAN driver RxFIFO*/
 		if(TRUE == g_stCANUdsNetLayerCfgInfo.pfNetRx(&stRxCanTpMsg.xMsgId, 
@@ -573,98 +569,43 @@ void CANTP_MainFun(void)
 	CANTP_DoRegisterTxMsgCallBack();
 }
 
-/*received a can tp frame, copy these data in UDS RX fifo.*/
-static uint8 CANTP_CopyAFrameDataInRxFifo(const tUdsId i_xRxCanID, 
-										      		const tLen i_xRxDataLen,
-									          		const uint8 *i_pDataBuf)
+/*received a whole message, hand its buffer to UDS.*/
+static uint8 CANTP_PassRxPduToUDS(const tUdsId i_xRxCanID, const tCanTpDataLen i_xRxDataLen)
 {
-	tErroCode eStatus;
-	tLen xCanWriteLen = 0u;
-
-	tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
-
-	ASSERT(NULL_PTR == i_pDataBuf);
+	const tTPPduHandle xPdu = gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu;
 
-	if(0u == i_xRxDataLen)
-	{
-		return FALSE;
-	}
+	DetachRxPdu();
 
-	/*check can wirte data len*/
-	GetCanWriteLen(RX_TP_QUEUE_ID, &xCanWriteLen, &eStatus);
-	if((ERRO_NONE != eStatus) || (xCanWriteLen < (i_xRxDataLen + sizeof(tUDSAndTPExchangeMsgInfo))))
+	/*the queue takes over our reference*/
+	if(TRUE != TP_PutRxPdu(i_xRxCanID, i_xRxDataLen, xPdu))
 	{
-		return FALSE;
-	}
+		TP_ReleasePdu(xPdu);
 
-	exchangeMsgInfo.msgID = i_xRxCanID;
-	exchangeMsgInfo.dataLen = i_xRxDataLen;
-	exchangeMsgInfo.pfCallBack = NULL_PTR;
-
-	/*write data uds transmitt ID and data len*/
-	WriteDataInFifo(RX_TP_QUEUE_ID, (uint8 *)&exchangeMsgInfo, sizeof(tUDSAndTPExchangeMsgInfo), &eStatus);
-	if(ERRO_NONE != eStatus)
-	{
 		return FALSE;
 	}
 
-	/*write data in fifo*/
-	WriteDataInFifo(RX_TP_QUEUE_ID, (uint8 *)i_pDataBuf, i_xRxDataLen, &eStatus);
-	if(ERRO_NONE != eStatus)
-	{
-		return FALSE;
-	}	
-	
 	return TRUE;
 }
 
-/*uds transmitted a application frame data, copy these data in TX fifo.*/
-static uint8 CANTP_CopyAFrameFromFifoToBuf(tUdsId *o_pxTxCanID, 
-										      		   uint8 *o_pTxDataLen,
-									          		   uint8 *o_pDataBuf)
+/*take the next message UDS wants transmitted.*/
+static uint8 CANTP_GetTxPduFromUDS(void)
 {
-	tErroCode eStatus;
-	tLen xRealReadLen = 0u;
-	tUDSAndTPExchangeMsgInfo exchangeMsgInfo;
-
-	ASSERT(NULL_PTR == o_pxTxCanID);
-	ASSERT(NULL_PTR == o_pTxDataLen);
-	ASSERT(NULL_PTR == o_pDataBuf);
-
-	/*can read data from buf*/
-	GetCanReadLen(TX_TP_QUEUE_ID, &xRealReadLen, &eStatus);
-	if((ERRO_NONE != eStatus) || (0u == xRealReadLen) || (xRealReadLen < sizeof(tUDSAndTPExchangeMsgInfo)))
-	{
-		return FALSE;
-	}
-
-	/*read receive ID*/
-	ReadDataFromFifo(TX_TP_QUEUE_ID, 
-				    sizeof(tUDSAndTPExchangeMsgInfo), 
-				    (uint8 *)&exchangeMsgInfo, 
-				    &xRealReadLen, 
-					&eStatus);
-	if(ERRO_NONE != eStatus || sizeof(tUDSAndTPExchangeMsgInfo) != xRealReadLen)
-	{
-		return FALSE;
-	}
+	uint32 txMsgID = 0u;
+	uint32 txDataLen = 0u;
+	tTPPduHandle xPdu = TP_PDU_NONE;
+	tpfUDSTxMsgCallBack pfCallBack = NULL_PTR;
 
-	/*read data from fifo*/
-	ReadDataFromFifo(TX_TP_QUEUE_ID, 
-				    exchangeMsgInfo.dataLen, 
-				    o_pDataBuf, 
-				    &xRealReadLen, 
-					&eStatus);
-	if(ERRO_NONE != eStatus || exchangeMsgInfo.dataLen != xRealReadLen)
+	if(TRUE != TP_GetTxPdu(&txMsgID, &pfCallBack, &txDataLen, &xPdu))
 	{
 		return FALSE;
 	}
 
-	*o_pxTxCanID = exchangeMsgInfo.msgID;
+	gs_stCanTPTxDataInfo.stCanTpDataInfo.xCanTpId = txMsgID;
+	gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen = txDataLen;
+	gs_stCanTPTxDataInfo.stCanTpDataInfo.xPdu = xPdu;
+	gs_stCanTPTxDataInfo.stCanTpDataInfo.pDataBuf = TP_GetPduBuf(xPdu);
 
-	*o_pTxDataLen = exchangeMsgInfo.dataLen;
-
-	TP_RegisterTransmittedAFrmaeMsgCallBack(exchangeMsgInfo.pfCallBack);
+	TP_RegisterTransmittedAFrmaeMsgCallBack(pfCallBack);
 
 	return TRUE;
 }
@@ -672,16 +613,19 @@ static uint8 CANTP_CopyAFrameFromFifoToBuf(tUdsId *o_pxTxCanID,
 /*can tp IDLE*/
 static tN_Result CANTP_DoCanTpIdle(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_peNextStatus)
 {
-	uint8 txDataLen = (uint8)gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen;
-	
 	ASSERT(NULL_PTR == m_peNextStatus);
 
+	/*give back buffers of a finished or aborted message*/
+	StopDriverReceiveCF();
+	TP_ReleasePdu(gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu);
+	TP_ReleasePdu(gs_stCanTPTxDataInfo.stCanTpDataInfo.xPdu);
+
 	/*clear can tp data*/
 	fsl_memset((void *)&gs_stCanTPRxDataInfo,0u,sizeof(tCanTpInfo));
 	fsl_memset((void *)&gs_stCanTPTxDataInfo,0u,sizeof(tCanTpInfo));
 
 	/*clear waitting time*/
-	gs_CANTPTxMsgMaxWaitTime = 0u;
+	fsl_memset((void *)&gs_stCANTPTxMsgMaxWaitTime,0u,sizeof(tCanTpTimer));
 
 	/*set NULL to transmitted message callback*/
 	TP_RegisterTransmittedAFrmaeMsgCallBack(NULL_PTR);
@@ -706,12 +650,8 @@ static tN_Result CANTP_DoCanTpIdle(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_
 	else
 	{
 		/*Judge have message can will tx.*/
-		if(TRUE == CANTP_CopyAFrameFromFifoToBuf(&gs_stCanTPTxDataInfo.stCanTpDataInfo.xCanTpId, 
-										  &txDataLen, 
-										  gs_stCanTPTxDataInfo.stCanTpDataInfo.aDataBuf))
+		if(TRUE == CANTP_GetTxPduFromUDS())
 		{
-			gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen = txDataLen;
-			
 			if(TRUE == IsTxDataLenOverflowSF())
 			{
 				*m_peNextStatus = TX_FF;
@@ -760,10 +700,16 @@ static tN_Result CANTP_DoReceiveSF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_
 		return N_ERROR;
 	}
 	
-	/*write data to UDS fifo*/
-	if(FALSE == CANTP_CopyAFrameDataInRxFifo(m_stMsgInfo->xMsgId, 
-									   SFLen, 
-								       &m_stMsgInfo->aMsgBuf[dataStartPos]))
+	gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu = TP_AllocPdu();
+	if(TP_PDU_NONE == gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu)
+	{
+		return N_ERROR;
+	}
+
+	fsl_memcpy(TP_GetPduBuf(gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu), &m_stMsgInfo->aMsgBuf[dataStartPos], SFLen);
+
+	/*hand the message to UDS*/
+	if(FALSE == CANTP_PassRxPduToUDS(m_stMsgInfo->xMsgId, SFLen))
 	{
 		TP_DebugPrintf("copy data erro!\n");
 	
@@ -779,6 +725,7 @@ static tN_Result CANTP_DoReceiveSF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_
 static tN_Result CANTP_DoReceiveFF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_peNextStatus)
 {
 	uint32 FFDataLen = 0u;
+	uint8 dataStartPos = 0u;
 
 	ASSERT(NULL_PTR == m_peNextStatus);
 
@@ -802,19 +749,45 @@ static tN_Result CANTP_DoReceiveFF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_
 		return N_ERROR;
 	}
 	
+	dataStartPos = GetFFDataStartPos(FFDataLen);
+	if((m_stMsgInfo->msgLen <= dataStartPos) || ((m_stMsgInfo->msgLen - dataStartPos) >= FFDataLen))
+	{
+		TP_DebugPrintf("FF: data len invalid!\n");
+
+		return N_ERROR;
+	}
+
 	/*save received msg ID*/
     SaveRxMsgId(m_stMsgInfo->xMsgId);
 	
-	/*write data in global buf. When receive all data, write these data in fifo.*/
+	/*reassemble in a pool buffer. When receive all data, hand it to UDS.*/
 	SaveFFDataLen(FFDataLen);
 
 	/*set wait flow control time*/
 	RXFrame_SetTxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNBr);
+
+	/*no buffer (message too long or pool empty): FC answers overflow*/
+	if(FFDataLen <= TP_PDU_BUF_LEN)
+	{
+		gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu = TP_AllocPdu();
+		gs_stCanTPRxDataInfo.stCanTpDataInfo.pDataBuf = TP_GetPduBuf(gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu);
+	}
 	
-	/*copy data in golbal buf*/
-	fsl_memcpy(gs_stCanTPRxDataInfo.stCanTpDataInfo.aDataBuf, (const void *)&m_stMsgInfo->aMsgBuf[2u], m_stMsgInfo->msgLen - 2u);
+	if(TP_PDU_NONE != gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu)
+	{
+		fsl_memcpy(gs_stCanTPRxDataInfo.stCanTpDataInfo.pDataBuf, 
+				   (const void *)&m_stMsgInfo->aMsgBuf[dataStartPos], 
+				   m_stMsgInfo->msgLen - dataStartPos);
+	}
 
-	AddRevDataLen(m_stMsgInfo->msgLen - 2u);
+	AddRevDataLen(m_stMsgInfo->msgLen - dataStartPos);
+
+	/*CFs go straight from the RX interrupt into the buffer once our FC is queued*/
+	gs_stCanTPCFRxInfo.xRxId = m_stMsgInfo->xMsgId;
+	gs_stCanTPCFRxInfo.pDataBuf = gs_stCanTPRxDataInfo.stCanTpDataInfo.pDataBuf;
+	gs_stCanTPCFRxInfo.xFFDataLen = FFDataLen;
+	gs_stCanTPCFRxInfo.xRevDataLen = gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen;
+	gs_stCanTPCFRxInfo.ucSN = 1u;
 
 	/*jump to next status*/	
 	*m_peNextStatus = TX_FC;
@@ -825,115 +798,137 @@ static tN_Result CANTP_DoReceiveFF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_
 }
 
 
-/*do receive conective frame*/
+/*do receive conective frame: the RX interrupt writes CFs into the buffer (CANTP_DriverReceiveCF), here 
+only the progress is checked.*/
 static tN_Result CANTP_DoReceiveCF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_peNextStatus)
 {
+	tCanTpCFRxStatus eStatus = CF_RX_OFF;
+	tCanTpDataLen xRevDataLen = 0u;
+
 	ASSERT(NULL_PTR == m_peNextStatus);
 
-	/*Is timeout rx wait timeout? If wait time out receive CF over.*/
-	if(TRUE == IsWaitCFTimeout())
+	/*check received msssage is SF or FF? If received SF or FF, start new receive progrocess.*/
+	if((0u != m_stMsgInfo->msgLen) && (TRUE != m_stMsgInfo->isFree) &&
+	   ((TRUE == IsSF(m_stMsgInfo->aMsgBuf[0u])) || (TRUE == IsFF(m_stMsgInfo->aMsgBuf[0u]))))
 	{
-		TP_DebugPrintf("wait conective frame timeout!\n");
-		
+		TP_DebugPrintf("In receive progrocess: received SF\n");
+
 		*m_peNextStatus = IDLE;
-	
-		return N_TIMEOUT_Cr;
+
+		return N_UNEXP_PDU;
 	}
 
-	if(0u == m_stMsgInfo->msgLen || TRUE == m_stMsgInfo->isFree)
-	{	
-		/*waitting CF message, It's normally for not received CAN message in the step.*/
-		return N_OK;
+	DisableAllInterrupts();
+	eStatus = gs_stCanTPCFRxInfo.eStatus;
+	xRevDataLen = gs_stCanTPCFRxInfo.xRevDataLen;
+	EnableAllInterrupts();
+
+	/*CFs received since the last check, restart N_Cr*/
+	if(xRevDataLen != gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen)
+	{
+		gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen = xRevDataLen;
+
+		RXFrame_SetRxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNCr);
 	}
 
-	/*check received msssage is SF or FF? If received SF or FF, start new receive progrocess.*/
-	if((TRUE == IsSF(m_stMsgInfo->aMsgBuf[0u])) || (TRUE == IsFF(m_stMsgInfo->aMsgBuf[0u])))
+	if(CF_RX_WRONG_SN == eStatus)
 	{
-		TP_DebugPrintf("In receive progrocess: received SF\n");
+		TP_DebugPrintf("Msg SN invalid in CF!\n");
 
 		*m_peNextStatus = IDLE;
 
-		return N_UNEXP_PDU;
+		return N_WRONG_SN;
 	}
 
-	if(gs_stCanTPRxDataInfo.stCanTpDataInfo.xCanTpId != m_stMsgInfo->xMsgId)
-	{	
-#ifdef EN_TP_DEBUG
-		TP_DebugPrintf("Msg ID invalid in CF! F RX ID = %X, RX ID = %X\n", 
-		gs_stCanTPRxDataInfo.stCanTpDataInfo.xCanTpId, m_stMsgInfo->xMsgId);
-#endif
-	
-		return N_ERROR;
+	if(CF_RX_DONE == eStatus)
+	{
+		/*hand the message to UDS*/
+		(void)CANTP_PassRxPduToUDS(gs_stCanTPRxDataInfo.stCanTpDataInfo.xCanTpId,
+							  gs_stCanTPRxDataInfo.stCanTpDataInfo.xFFDataLen);
+
+		*m_peNextStatus = IDLE;
+
+		return N_OK;
 	}
 
-	if(TRUE != IsCF(m_stMsgInfo->aMsgBuf[0u]))
+	if(CF_RX_BLOCK_END == eStatus)
 	{
-#ifdef EN_TP_DEBUG	
-		TP_DebugPrintf("Msg type invalid in CF %X!\n", m_stMsgInfo->aMsgBuf[0u]);
-#endif
+		RXFrame_SetTxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNBr);
 
-		return N_ERROR;
+		*m_peNextStatus = TX_FC;
+
+		return N_OK;
 	}
 
-	/*Get rev SN. If SN invalid, return FALSE.*/
-	if(TRUE != IsRevSNValid(m_stMsgInfo->aMsgBuf[0u]))
+	/*Is timeout rx wait timeout? If wait time out receive CF over.*/
+	if(TRUE == IsWaitCFTimeout())
 	{
-		TP_DebugPrintf("Msg SN invalid in CF!\n");
+		TP_DebugPrintf("wait conective frame timeout!\n");
+		
+		*m_peNextStatus = IDLE;
 	
-		return N_WRONG_SN;
+		return N_TIMEOUT_Cr;
 	}
 
-	/*check receive cf all? If receive all, copy data in fifo and clear receive 
-	buf information. Else count SN and add receive data len.*/
-	if(TRUE == IsReciveCFAll(m_stMsgInfo->msgLen - 1u))
+	/*waitting CF message, CFs the interrupt did not take are ignored*/
+	return N_OK;
+}
+
+/*RX interrupt side of CF reception: places the CF payload at its offset in the reassembly buffer. Returns 
+FALSE for frames that are not an expected CF, they go through RX_BUS_FIFO.*/
+boolean CANTP_DriverReceiveCF(const uint32 i_RxID, const uint32 i_dataLen, const uint8 *i_pDataBuf)
+{
+	tCanTpDataLen copyLen = 0u;
+
+	if((CF_RX_ON != gs_stCanTPCFRxInfo.eStatus) || (i_RxID != gs_stCanTPCFRxInfo.xRxId) ||
+	   (i_dataLen < 2u) || (TRUE != IsCF(i_pDataBuf[0u])))
 	{
-		/*copy all data in fifo and receive over. */	
-		fsl_memcpy(&gs_stCanTPRxDataInfo.stCanTpDataInfo.aDataBuf[gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen],
-			      &m_stMsgInfo->aMsgBuf[1u],
-			      gs_stCanTPRxDataInfo.stCanTpDataInfo.xFFDataLen - gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen);
+		return FALSE;
+	}
 
-		/*copy all data in FIFO*/
-		(void)CANTP_CopyAFrameDataInRxFifo(gs_stCanTPRxDataInfo.stCanTpDataInfo.xCanTpId,
-							  gs_stCanTPRxDataInfo.stCanTpDataInfo.xFFDataLen, 
-							  gs_stCanTPRxDataInfo.stCanTpDataInfo.aDataBuf);
-		
-		*m_peNextStatus = IDLE;
+	if(gs_stCanTPCFRxInfo.ucSN != (i_pDataBuf[0u] & 0x0Fu))
+	{
+		gs_stCanTPCFRxInfo.eStatus = CF_RX_WRONG_SN;
 
+		return TRUE;
 	}
-	else
+
+	/*the last CF may be padded*/
+	copyLen = gs_stCanTPCFRxInfo.xFFDataLen - gs_stCanTPCFRxInfo.xRevDataLen;
+	if(copyLen > (i_dataLen - 1u))
 	{
-		/*If is block size overflow.*/
-		if(TRUE == IsRxBlockSizeOverflow())
-		{
-			RXFrame_SetTxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNBr);
-		
-			*m_peNextStatus = TX_FC;
-		}
-		else
-		{
-			/*count Sn and set STmin, wait timeout time*/
-			AddWaitSN();
+		copyLen = i_dataLen - 1u;
+	}
 
-			/*set wait frame time*/
-			RXFrame_SetRxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNCr);
-		}
-	
-		/*Copy data in global fifo*/
-		fsl_memcpy(&gs_stCanTPRxDataInfo.stCanTpDataInfo.aDataBuf[gs_stCanTPRxDataInfo.stCanTpDataInfo.xPduDataLen],
-			       &m_stMsgInfo->aMsgBuf[1u],
-			      m_stMsgInfo->msgLen - 1u);
+	fsl_memcpy(&gs_stCanTPCFRxInfo.pDataBuf[gs_stCanTPCFRxInfo.xRevDataLen], &i_pDataBuf[1u], copyLen);
+	gs_stCanTPCFRxInfo.xRevDataLen += copyLen;
+	gs_stCanTPCFRxInfo.ucSN = (gs_stCanTPCFRxInfo.ucSN + 1u) & 0x0Fu;
 
-		AddRevDataLen(m_stMsgInfo->msgLen - 1u);
+	if(gs_stCanTPCFRxInfo.xRevDataLen >= gs_stCanTPCFRxInfo.xFFDataLen)
+	{
+		gs_stCanTPCFRxInfo.eStatus = CF_RX_DONE;
+	}
+	else if(0u != gs_stCanTPCFRxInfo.xBlockLeft)
+	{
+		gs_stCanTPCFRxInfo.xBlockLeft--;
+		if(0u == gs_stCanTPCFRxInfo.xBlockLeft)
+		{
+			gs_stCanTPCFRxInfo.eStatus = CF_RX_BLOCK_END;
+		}
+	}
+	else
+	{
+		/*no BS, keep receiving*/
 	}
 
-	return N_OK;
+	return TRUE;
 }
 
 /*transmit FC callback*/
 static void CANTP_DoTransmitFCCallBack(void)
 {
-
-	if(gs_stCanTPRxDataInfo.stCanTpDataInfo.xFFDataLen > MAX_CF_DATA_LEN)
+	/*sent overflow FC, receive over*/
+	if(TP_PDU_NONE == gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu)
 	{
 		SetCurCANTPSatus(IDLE);
 	}
@@ -974,25 +969,19 @@ static tN_Result CANTP_DoTransmitFC(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m
 	(void)CANTP_SetFrameType(CANType, FC, &aucTransDataBuf[0u]);
 
 	/*Check current buf. */
-	if(gs_stCanTPRxDataInfo.stCanTpDataInfo.xFFDataLen > MAX_CF_DATA_LEN)
+	if(TP_PDU_NONE == gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu)
 	{
 		/*set FS*/
-		SetFS(&aucTransDataBuf[1u], OVERFLOW_BUF);
+		SetFS(&aucTransDataBuf[0u], OVERFLOW_BUF);
 	}
 	else
 	{
-		SetFS(&aucTransDataBuf[1u], CONTINUE_TO_SEND);
+		SetFS(&aucTransDataBuf[0u], CONTINUE_TO_SEND);
 	}
 	
 	/*set BS*/
 	SetBlockSize(&aucTransDataBuf[1u], g_stCANUdsNetLayerCfgInfo.xBlockSize);
 
-	/*add block size*/
-	AddBlockSize();
-
-	/*add wait SN*/
-	AddWaitSN();
-
 	/*set STmin*/
 	SetSTmin(&aucTransDataBuf[2u], g_stCANUdsNetLayerCfgInfo.xSTmin);
 
@@ -1003,6 +992,15 @@ static tN_Result CANTP_DoTransmitFC(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m
 	CANTP_SetTxMsgStatus(CANTP_TX_MSG_WAITTING);
 	CANTP_RegisterTxMsgCallBack(CANTP_DoTransmitFCCallBack);
 
+	/*the tester may answer the FC before its TX confirmation: take CFs from now on*/
+	if(TP_PDU_NONE != gs_stCanTPRxDataInfo.stCanTpDataInfo.xPdu)
+	{
+		DisableAllInterrupts();
+		gs_stCanTPCFRxInfo.xBlockLeft = g_stCANUdsNetLayerCfgInfo.xBlockSize;
+		gs_stCanTPCFRxInfo.eStatus = CF_RX_ON;
+		EnableAllInterrupts();
+	}
+
 	/*transmit flow control*/
 	if(TRUE == g_stCANUdsNetLayerCfgInfo.pfNetTxMsg(g_stCANUdsNetLayerCfgInfo.xTxId, 
 									          sizeof(aucTransDataBuf),
@@ -1076,13 +1074,13 @@ static tN_Result CANTP_DoTransmitSF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m
 
 	/*copy data in tx buf*/
 	fsl_memcpy(&aDataBuf[1u],
-		      gs_stCanTPTxDataInfo.stCanTpDataInfo.aDataBuf,
+		      gs_stCanTPTxDataInfo.stCanTpDataInfo.pDataBuf,
 		      gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen);
 #endif
 
 	if(TRUE != CANTP_FillTxMsgInfo(SF, 
 					  	gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen,
-						gs_stCanTPTxDataInfo.stCanTpDataInfo.aDataBuf,
+						gs_stCanTPTxDataInfo.stCanTpDataInfo.pDataBuf,
 						DATA_LEN, 
 						aDataBuf, 
 						&txLen))
@@ -1126,7 +1124,7 @@ static tN_Result CANTP_DoTransmitSF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m
 static void CANTP_DoTransmitFFCallBack(void)
 {
 	/*add tx data len*/
-	AddTxDataLen(TX_FF_DATA_MIN_LEN - 2);
+	AddTxDataLen(DATA_LEN - GetFFDataStartPos(gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen));
 
 	/*set Tx wait time*/
 	TXFrame_SetRxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNBs);
@@ -1172,13 +1170,13 @@ static tN_Result CANTP_DoTransmitFF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m
 	SetTxFFDataLen(aDataBuf, gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen);
 
 	/*copy data in tx buf*/
-	fsl_memcpy(&aDataBuf[2u],gs_stCanTPTxDataInfo.stCanTpDataInfo.aDataBuf, TX_FF_DATA_MIN_LEN - 2);
+	fsl_memcpy(&aDataBuf[2u],gs_stCanTPTxDataInfo.stCanTpDataInfo.pDataBuf, TX_FF_DATA_MIN_LEN - 2);
 	txMsgLen = sizeof(aDataBuf);	
 #else
 
 	if(TRUE != CANTP_FillTxMsgInfo(FF, 
 					  	gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen,
-						gs_stCanTPTxDataInfo.stCanTpDataInfo.aDataBuf,
+						gs_stCanTPTxDataInfo.stCanTpDataInfo.pDataBuf,
 						DATA_LEN, 
 						aDataBuf, 
 						&txMsgLen))
@@ -1271,6 +1269,11 @@ static tN_Result CANTP_DoReceiveFC(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_
 
 		SaveTxSTmin(m_stMsgInfo->aMsgBuf[2u]);
 
+		/*nothing is on the way while we wait for an FC*/
+		gs_stCanTPCFTxInfo.ucInFlight = 0u;
+		gs_stCanTPCFTxInfo.ucConfirmed = 0u;
+		gs_stCanTPCFTxInfo.isBlockEnd = FALSE;
+
 		TXFrame_SetTxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNCs);
 
 		/*remove Add Tx SN, because this SN is added in send First frame callback*/
@@ -1292,150 +1295,162 @@ static tN_Result CANTP_DoReceiveFC(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_
 	return N_OK;
 }
 
-/*transmit CF callback*/
-static void CANTP_DoTransmitCFCallBack(void)
+/*CF confirmed by the driver. Called in the TX interrupt, CANTP_DoTransmitCF() takes the count.*/
+static void CANTP_TxCFSuccessfulCallBack(void)
+{
+	gs_stCanTPCFTxInfo.ucConfirmed++;
+}
+
+/*give the driver the next CF*/
+static boolean CANTP_TransmitNextCF(void)
 {
-	if(TRUE == IsTxAll())
+	uint8 aTxDataBuf[DATA_LEN] = {0u};
+	uint32 txLen = 0u;
+	uint32 txAllLen = 0u;
+	tCANType CANType = CANTP_STANDARD;
+
+	if(TRUE == CANTP_IsEnableTxCANFDMsg())
 	{
-		TP_DoTransmittedAFrameMsgCallBack(TX_MSG_SUCCESSFUL);
+		CANType = CANTP_FD;
+	}
 	
-		SetCurCANTPSatus(IDLE);
+	(void)CANTP_SetFrameType(CANType, CF, &aTxDataBuf[0u]);
 
-		return;
-	}
+	SetTxSN(&aTxDataBuf[0u]);
 
-	/*set transmitted next frame min time.*/
-	SetTxSTmin();
-	
-	if(gs_stCanTPTxDataInfo.ucBlockSize)
+	txLen = gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen - gs_stCanTPTxDataInfo.stCanTpDataInfo.xPduDataLen;
+	if(txLen >= TX_CF_DATA_MAX_LEN)
 	{
-		gs_stCanTPTxDataInfo.ucBlockSize--;
+		txLen = TX_CF_DATA_MAX_LEN;
+		txAllLen = sizeof(aTxDataBuf);
+	}
+	else
+	{
+		txAllLen = txLen + 1u;
+	}
 
-        /*block size is equal 0,  waitting  flow control message. if not equal 0, continual send CF message.*/
-		if(0u == gs_stCanTPTxDataInfo.ucBlockSize)
-		{
-			SetCurCANTPSatus(RX_FC);
-			
-			TXFrame_SetRxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNBs);	
+	fsl_memcpy(&aTxDataBuf[1u],
+			  &gs_stCanTPTxDataInfo.stCanTpDataInfo.pDataBuf[gs_stCanTPTxDataInfo.stCanTpDataInfo.xPduDataLen],
+			  txLen);
 
-			return;
-		}
+	/*request transmitted application message.*/
+	if(TRUE != g_stCANUdsNetLayerCfgInfo.pfNetTxMsg(gs_stCanTPTxDataInfo.stCanTpDataInfo.xCanTpId, 
+								              txAllLen,
+								              aTxDataBuf,
+								              CANTP_TxCFSuccessfulCallBack,
+								              g_stCANUdsNetLayerCfgInfo.txBlockingMaxTimeMs))
+	{
+		return FALSE;
 	}
 
+	AddTxDataLen(txLen);
 	AddTxSN();
+	gs_stCanTPCFTxInfo.ucInFlight++;
 
-	/*set tx next frame max time.*/
-	TXFrame_SetRxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNCs);
+	/*BS = 0: no further FC*/
+	if(0u != gs_stCanTPTxDataInfo.ucBlockSize)
+	{
+		gs_stCanTPTxDataInfo.ucBlockSize--;
+		if(0u == gs_stCanTPTxDataInfo.ucBlockSize)
+		{
+			gs_stCanTPCFTxInfo.isBlockEnd = TRUE;
+		}
+	}
 
-	SetCurCANTPSatus(TX_CF);
+	return TRUE;
 }
 
-
-/*transmit conective frame*/
+/*transmit conective frames: up to CANTP_TX_PIPELINE_DEPTH CFs are kept with the driver so its TX 
+mailboxes are loaded back-to-back. With STmin > 0 they go one by one, STmin after each confirmation.*/
 static tN_Result CANTP_DoTransmitCF(tCanTpMsg * m_stMsgInfo, tCanTpWorkStatus *m_peNextStatus)
 {
-	uint8 aTxDataBuf[DATA_LEN] = {0u};
-	uint8 txLen = 0u;
-	uint8 txAllLen = 0u;
-	tCANType CANType = CANTP_STANDARD;
+	uint8 ucConfirmed = 0u;
 
 	ASSERT(NULL_PTR == m_peNextStatus);
 
-	/*Is Tx STmin timeout?*/
-	if(FALSE == IsTxSTminTimeout())
-	{
-		/*watting STmin timeout.  It's normally in the step.*/
-		return N_OK;
-	}
+	DisableAllInterrupts();
+	ucConfirmed = gs_stCanTPCFTxInfo.ucConfirmed;
+	gs_stCanTPCFTxInfo.ucConfirmed = 0u;
+	EnableAllInterrupts();
 
-	/*Is transmitted timeout?*/
-	if(TRUE == IsTxWaitFrameTimeout())
-	{
-		*m_peNextStatus = IDLE;
-	
-		return N_TIMEOUT_Bs;
-	}
-	
-	if(TRUE == CANTP_IsEnableTxCANFDMsg())
-	{
-		CANType = CANTP_FD;
-	}
-	else
+	if(0u != ucConfirmed)
 	{
-		CANType = CANTP_STANDARD;
-	}
-	
-	(void)CANTP_SetFrameType(CANType, CF, &aTxDataBuf[0u]);
-
-	SetTxSN(&aTxDataBuf[0u]);
+		gs_stCanTPCFTxInfo.ucInFlight = (ucConfirmed < gs_stCanTPCFTxInfo.ucInFlight) ? 
+										(uint8)(gs_stCanTPCFTxInfo.ucInFlight - ucConfirmed) : 0u;
 
-	txLen = gs_stCanTPTxDataInfo.stCanTpDataInfo.xFFDataLen - gs_stCanTPTxDataInfo.stCanTpDataInfo.xPduDataLen;
+		/*set transmitted next frame min time.*/
+		SetTxSTmin();
 
-	/*CAN TP set tx message status and register tx message successful callback.*/
-	CANTP_SetTxMsgStatus(CANTP_TX_MSG_WAITTING);
-	CANTP_RegisterTxMsgCallBack(CANTP_DoTransmitCFCallBack);
+		/*set wait send frame successful max time*/
+		TXFrame_SetTxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNAs);
+	}
 
-	if(txLen >= TX_CF_DATA_MAX_LEN)
+	if(0u != gs_stCanTPCFTxInfo.ucInFlight)
 	{
-		fsl_memcpy(&aTxDataBuf[1u],
-				  &gs_stCanTPTxDataInfo.stCanTpDataInfo.aDataBuf[gs_stCanTPTxDataInfo.stCanTpDataInfo.xPduDataLen],
-				  TX_CF_DATA_MAX_LEN);
-		
-		/*request transmitted application message.*/
-		if(TRUE != g_stCANUdsNetLayerCfgInfo.pfNetTxMsg(gs_stCanTPTxDataInfo.stCanTpDataInfo.xCanTpId, 
-									              sizeof(aTxDataBuf),
-									              aTxDataBuf,
-									              CANTP_TxMsgSuccessfulCallBack,
-									              g_stCANUdsNetLayerCfgInfo.txBlockingMaxTimeMs))
+		/*check is waitting timeout?*/
+		if(TRUE == IsTxMsgWaittingFrameTimeout())
 		{
-			/*CAN TP set tx message status and register tx message successful callback.*/
-			CANTP_SetTxMsgStatus(CANTP_TX_MSG_FAIL);
-			CANTP_RegisterTxMsgCallBack(NULL_PTR);
+			/*abort CAN bus send message*/
+			if(NULL_PTR != g_stCANUdsNetLayerCfgInfo.pfAbortTXMsg)
+			{
+				(g_stCANUdsNetLayerCfgInfo.pfAbortTXMsg) ();
+			}
 
-			/*send message error*/
-			*m_peNextStatus = IDLE;		
-			
-			/*request transmitted application message failed.*/
-			return N_ERROR;
+			/*tell up layer, tx message timeout*/
+			TP_DoTransmittedAFrameMsgCallBack(TX_MSG_TIMEOUT);
+
+			*m_peNextStatus = IDLE;
+
+			return N_TIMEOUT_A;
 		}
+	}
+	else if(TRUE == IsTxAll())
+	{
+		TP_DoTransmittedAFrameMsgCallBack(TX_MSG_SUCCESSFUL);
+
+		*m_peNextStatus = IDLE;
 
-		AddTxDataLen(TX_CF_DATA_MAX_LEN);
+		return N_OK;
 	}
+	else if(TRUE == gs_stCanTPCFTxInfo.isBlockEnd)
+	{
+		/*block is on the bus, waitting  flow control message.*/
+		TXFrame_SetRxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNBs);
+
+		*m_peNextStatus = RX_FC;
 
+		return N_OK;
+	}
 	else
 	{
-		fsl_memcpy(&aTxDataBuf[1u],
-				&gs_stCanTPTxDataInfo.stCanTpDataInfo.aDataBuf[gs_stCanTPTxDataInfo.stCanTpDataInfo.xPduDataLen],
-			       txLen);
-		
-		txAllLen = txLen + 1u;	
-		
-		/*request transmitted application message.*/
-		if(TRUE != g_stCANUdsNetLayerCfgInfo.pfNetTxMsg(gs_stCanTPTxDataInfo.stCanTpDataInfo.xCanTpId, 
-				txAllLen, 
-				aTxDataBuf,
-				CANTP_TxMsgSuccessfulCallBack,
-				g_stCANUdsNetLayerCfgInfo.txBlockingMaxTimeMs))
+		/*do nothing*/
+	}
+
+	while((gs_stCanTPCFTxInfo.ucInFlight < CANTP_TX_PIPELINE_DEPTH) &&
+		  (TRUE != IsTxAll()) &&
+		  (TRUE != gs_stCanTPCFTxInfo.isBlockEnd) &&
+		  (TRUE == IsTxSTminTimeout()) &&
+		  ((0u == gs_ulCanTPTxSTminUs) || (0u == gs_stCanTPCFTxInfo.ucInFlight)))
+	{
+		if(TRUE != CANTP_TransmitNextCF())
 		{
-			/*CAN TP set tx message status and register tx message successful callback.*/
-			CANTP_SetTxMsgStatus(CANTP_TX_MSG_FAIL);
-			CANTP_RegisterTxMsgCallBack(NULL_PTR);
+			/*abort CFs already given to the driver*/
+			if(NULL_PTR != g_stCANUdsNetLayerCfgInfo.pfAbortTXMsg)
+			{
+				(g_stCANUdsNetLayerCfgInfo.pfAbortTXMsg) ();
+			}
 
 			/*send message error*/
 			*m_peNextStatus = IDLE;		
-		
+			
 			/*request transmitted application message failed.*/
 			return N_ERROR;
 		}
 
-		AddTxDataLen(txLen);
+		/*set wait send frame successful max time*/
+		TXFrame_SetTxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNAs);
 	}
 
-	/*set wait send frame successful max time*/
-	TXFrame_SetTxMsgWaitTime(g_stCANUdsNetLayerCfgInfo.xNAs);
-
-	*m_peNextStatus = WAITTING_TX;
-
 	return N_OK;
 }
 
@@ -1531,11 +1546,17 @@ static boolean CANTP_SetTxFFDataLen(const uint32 i_txSFDataLen, uint8 *o_pFFMsgB
 		return FALSE;
 	}
 
-	if(i_txSFDataLen > 0x0FFFu)
+	if(i_txSFDataLen > FF_DL_12BIT_MAX)
 	{
-		TP_DebugPrintf("CAN TP tx message over max!\n");
-		
-		return FALSE;
+		/*escaped FF_DL: 12 bit 0, then 32 bit length, ISO15765-2 2016*/
+		*(o_pFFMsgBuf + 0u) &= 0xF0u;
+		*(o_pFFMsgBuf + 1u) = 0u;
+		*(o_pFFMsgBuf + 2u) = (uint8)((i_txSFDataLen) >> 24u);
+		*(o_pFFMsgBuf + 3u) = (uint8)((i_txSFDataLen) >> 16u);
+		*(o_pFFMsgBuf + 4u) = (uint8)((i_txSFDataLen) >> 8u);
+		*(o_pFFMsgBuf + 5u) = (uint8)(i_txSFDataLen);
+
+		return TRUE;
 	}
 
 	*(o_pFFMsgBuf + 0u) &= 0xF0u;
@@ -1641,19 +1662,11 @@ static boolean CANTP_GetFillDataInfo(const tCANType i_CANType,
 	}
 	else if(FF == i_eFrameType)
 	{
-		/*CAN and CAN are the same data start position*/
-		dataStartPos = 2u;
+		/*CAN and CAN FD are the same data start position, 6 with escaped FF_DL*/
+		dataStartPos = GetFFDataStartPos(i_fillMsgLen);
 
-		if(TRUE == isCANFDType)
-		{
-			/*CAN FD FF is max 62 bytes, but FF is less than 63 bytes*/
-			maxDataLen = TX_FF_DATA_MIN_LEN - 1u;
-		}
-		else
-		{
-			/*standard CAN FF is max 6 bytes, but FF is less than 8 bytes*/
-			maxDataLen = TX_FF_DATA_MIN_LEN - 2u;
-		}
+		/*FF fills the whole frame: standard CAN 6 (2) bytes, CAN FD 62 (58) bytes*/
+		maxDataLen = DATA_LEN - dataStartPos;
 	}
 	else if(FC == i_eFrameType)
 	{
@@ -1833,10 +1846,11 @@ static boolean GetRXSFFrameMsgLength(const uint32 i_RxMsgLen, const uint8 *i_pMs
 		frameLen = i_pMsgBuf[0u] & 0x0Fu;
 		if(0u == frameLen)
 		{
+			/*CAN FD SF: SF_DL in the second byte, data from the third*/
 			frameLen = i_pMsgBuf[1u];
 			if((frameLen <= SF_CANFD_DATA_MAX_LEN) && (frameLen > 0u))
 			{
-				result = IsRxMsgLenValid(NORMAL_ADDRESSING, frameLen, i_RxMsgLen);
+				result = IsRxMsgLenValid(NORMAL_ADDRESSING, frameLen, i_RxMsgLen - 1u);
 			}			
 		}
 	}
@@ -1897,6 +1911,12 @@ static boolean GetRXFFFrameMsgLength(const uint32 i_RxMsgLen, const uint8 *i_pMs
 			frameLen <<= 8u; 
 			frameLen |= i_pMsgBuf[index + 2u];
 		}
+
+		/*escape is only valid for lengths that do not fit 12 bit*/
+		if(frameLen <= FF_DL_12BIT_MAX)
+		{
+			return FALSE;
+		}
 	}
 
 	if(frameLen < RX_FF_DATA_LESS_LEN)
@@ -1916,6 +1936,28 @@ static boolean GetRXFFFrameMsgLength(const uint32 i_RxMsgLen, const uint8 *i_pMs
 	return result;
 }
 
+/*STmin byte of an FC to us, reserved values are taken as 0x7F (ISO15765-2 2016)*/
+static uint32 CANTP_STminToUs(const uint8 i_ucSTmin)
+{
+	uint32 STminUs = 0u;
+
+	if(i_ucSTmin <= STMIN_MS_MAX)
+	{
+		STminUs = CanTpMsToUs(i_ucSTmin);
+	}
+	else if((i_ucSTmin >= STMIN_US_MIN) && (i_ucSTmin <= STMIN_US_MAX))
+	{
+		/*0xF1 - 0xF9: 100 - 900 us*/
+		STminUs = (uint32)(i_ucSTmin - 0xF0u) * 100u;
+	}
+	else
+	{
+		STminUs = CanTpMsToUs(STMIN_MS_MAX);
+	}
+
+	return STminUs;
+}
+
 #endif /*#ifdef EN_CAN_TP*/
 /***************************End file********************************/
 
@@ -2,10 +2,15 @@
 
 #ifdef EN_CAN_TP
 #include "can_tp_cfg.h"
+#include "can_tp.h"
 #include "multi_cyc_fifo.h"
 //#include "can_driver.h"
 static tpfAbortTxMsg gs_pfCANTPAbortTxMsg = NULL_PTR;
-static tpfNetTxCallBack gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+
+/*callbacks of the frames the driver has read and not confirmed yet, oldest first*/
+static tpfNetTxCallBack gs_apfTxMsgSuccessfulCallBack[CANTP_TX_PIPELINE_DEPTH];
+static uint8 gs_ucTxMsgCallBackHead = 0u;
+static uint8 gs_ucTxMsgCallBackNum = 0u;
 
 
 static uint8 CANTP_TxMsg(const tUdsId i_xTxId,
@@ -36,8 +41,8 @@ const tUdsCANNetLayerCfg g_stCANUdsNetLayerCfgInfo =
 	RX_FUN_ID,   /*can tp rx function ID*/
 	RX_PHY_ID,   /*can tp rx phy ID*/
 	TX_ID,   /*can tp tx ID*/
-	0u,       /*BS = block size*/
-	1u,      /*STmin*/
+	CANTP_RX_BLOCK_SIZE, /*BS = block size*/
+	CANTP_RX_STMIN, /*STmin*/
 	1000u,      /*N_As*/
 	1000u,      /*N_Ar*/
 	1000u,     /*N_Bs*/
@@ -79,7 +84,7 @@ static uint8 CANTP_TxMsg(const tUdsId i_xTxId,
 #else
 		txMsgInfo.TxMsgLength = sizeof(aMsgBuf);
 #endif
-		txMsgInfo.TxMsgCallBack = (uint32)i_pfNetTxCallBack;
+		txMsgInfo.pfTxMsgCallBack = i_pfNetTxCallBack;
 		
 		fsl_memcpy(&aMsgBuf[0u], i_pDataBuf, i_dataLen);
 
@@ -104,6 +109,11 @@ static uint8 CANTP_TxMsg(const tUdsId i_xTxId,
 			return FALSE;
 		}
 	}
+	else
+	{
+		/*no room in TX_BUS_FIFO*/
+		return FALSE;
+	}
 	
 	return TRUE;
 }
@@ -116,8 +126,7 @@ static uint8 CANTP_RxMsg(tUdsId * o_pxRxId,
 	tLen xCanRxDataLen = 0u;
 	tLen xReadDataLen = 0u;
 	tErroCode eStatus;
-	tRxMsgInfo stRxCanMsg = {0u};
-	uint8 ucIndex = 0u;
+	tRxMsgInfo stRxCanMsg;
 	const uint32 headerLen = sizeof(stRxCanMsg.rxDataId) + sizeof(stRxCanMsg.rxDataLen);
 
 	ASSERT(NULL_PTR == o_pxRxId);
@@ -135,9 +144,10 @@ static uint8 CANTP_RxMsg(tUdsId * o_pxRxId,
 
 		if((ERRO_NONE == eStatus) && (headerLen <= xCanRxDataLen))
 		{
+			/*frame data straight into the caller's buffer (MAX_CAN_DATA_LEN, checked on write)*/
 			ReadDataFromFifo(RX_BUS_FIFO, 
 							 stRxCanMsg.rxDataLen,
-							(uint8 *)&stRxCanMsg.aucDataBuf,
+							o_pRxBuf,
 							&xCanRxDataLen,
 							&eStatus);
 
@@ -149,11 +159,6 @@ static uint8 CANTP_RxMsg(tUdsId * o_pxRxId,
 			*o_pxRxId = stRxCanMsg.rxDataId;
 			*o_pRxDataLen = stRxCanMsg.rxDataLen;
 
-			for(ucIndex = 0u; ucIndex < stRxCanMsg.rxDataLen; ucIndex++)
-			{
-				o_pRxBuf[ucIndex] = stRxCanMsg.aucDataBuf[ucIndex];
-			}
-
 			return TRUE;
 		}
 		
@@ -223,10 +228,11 @@ static void CANTP_AbortTxMsg(void)
 	if(NULL_PTR != gs_pfCANTPAbortTxMsg)
 	{
 		(gs_pfCANTPAbortTxMsg)();
-
-		gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
 	}
 
+	/*aborted frames are not confirmed*/
+	gs_ucTxMsgCallBackNum = 0u;
+
 	if(TRUE != CANTP_ClearTXBUSFIFO())
 	{
 		TP_DebugPrintf("CANTP_AbortTxMsg: Clear TX BUS FIFO failed!\n");
@@ -252,6 +258,17 @@ boolean CANTP_DriverWriteDataInCANTP(const uint32 i_RxID, const uint32 i_dataLen
 
 	ASSERT(NULL_PTR == i_pDataBuf);
 
+	if(i_dataLen > MAX_CAN_DATA_LEN)
+	{
+		return FALSE;
+	}
+
+	/*CFs of the message being received are written into its buffer right away*/
+	if(TRUE == CANTP_DriverReceiveCF(i_RxID, i_dataLen, i_pDataBuf))
+	{
+		return TRUE;
+	}
+
 	GetCanWriteLen(RX_BUS_FIFO, &xCanWriteDataLen, &eStatus);
 	if((ERRO_NONE == eStatus) && ((i_dataLen + headerLen) <= xCanWriteDataLen))
 	{
@@ -270,22 +287,34 @@ boolean CANTP_DriverWriteDataInCANTP(const uint32 i_RxID, const uint32 i_dataLen
 			return FALSE;
 		}		
 	}
+	else
+	{
+		/*RX_BUS_FIFO full: the frame is lost*/
+		return FALSE;
+	}
 
 	return TRUE;	
 }
 
-/*Driver read data from LINTP*/
+/*Driver read data from LINTP. The driver gets up to CANTP_TX_PIPELINE_DEPTH frames before it has to 
+confirm the first one, and confirms them in the order it read them.*/
 boolean CANTP_DriverReadDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pReadDataBuf, tTPTxMsgHeader *o_pstTxMsgHeader)
 {
 	boolean result = FALSE;
 	tLen xCanRxDataLen = 0u;
 	tErroCode eStatus;
 	tTPTxMsgHeader txMsgInfo;
+	uint8 aDropBuf[DATA_LEN];
 	const uint32 msgInfoLen = sizeof(tTPTxMsgHeader);
 
 	ASSERT(NULL_PTR == o_pReadDataBuf);
 	ASSERT(NULL_PTR == o_pstTxMsgHeader);	
 	ASSERT(0u == i_readDataLen);
+
+	if(gs_ucTxMsgCallBackNum >= CANTP_TX_PIPELINE_DEPTH)
+	{
+		return FALSE;
+	}
 	
 	GetCanReadLen(TX_BUS_FIFO, &xCanRxDataLen, &eStatus);
 	if((ERRO_NONE == eStatus) && (xCanRxDataLen > msgInfoLen))
@@ -303,20 +332,38 @@ boolean CANTP_DriverReadDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pRead
 
 		if(TRUE == result)
 		{
-			
-			ReadDataFromFifo(TX_BUS_FIFO, 
-							 i_readDataLen,
-							o_pReadDataBuf,
-							&xCanRxDataLen,
-							&eStatus);
-			if((ERRO_NONE == eStatus) && (i_readDataLen >= txMsgInfo.TxMsgLength))
+			/*read exactly this frame, the next one may already be behind it*/
+			if(i_readDataLen >= txMsgInfo.TxMsgLength)
 			{
-				result = TRUE;
+				ReadDataFromFifo(TX_BUS_FIFO, 
+								 txMsgInfo.TxMsgLength,
+								o_pReadDataBuf,
+								&xCanRxDataLen,
+								&eStatus);
+			}
+			else
+			{
+				ReadDataFromFifo(TX_BUS_FIFO, 
+								 txMsgInfo.TxMsgLength,
+								aDropBuf,
+								&xCanRxDataLen,
+								&eStatus);
+
+				result = FALSE;
+			}
 
+			if((TRUE == result) && (ERRO_NONE == eStatus) && (xCanRxDataLen == txMsgInfo.TxMsgLength))
+			{
 				*o_pstTxMsgHeader = txMsgInfo;
 
 				/*storage callback, if user want to TX message callback please call TP_DoTxMsgSuccesfulCallback or self call callback*/
-				gs_pfTxMsgSuccessfulCallBack = (tpfNetTxCallBack)txMsgInfo.TxMsgCallBack;
+				gs_apfTxMsgSuccessfulCallBack[(gs_ucTxMsgCallBackHead + gs_ucTxMsgCallBackNum) % CANTP_TX_PIPELINE_DEPTH] = 
+					txMsgInfo.pfTxMsgCallBack;
+				gs_ucTxMsgCallBackNum++;
+			}
+			else
+			{
+				result = FALSE;
 			}
 		}
 	}
@@ -325,14 +372,21 @@ boolean CANTP_DriverReadDataFromCANTP(const uint32 i_readDataLen, uint8 *o_pRead
 }
 
 
-/*do tx message successful callback*/
+/*do tx message successful callback: confirms the oldest frame the driver read*/
 void CANTP_DoTxMsgSuccessfulCallBack(void)
 {
-	if(NULL_PTR != gs_pfTxMsgSuccessfulCallBack)
+	tpfNetTxCallBack pfTxMsgSuccessfulCallBack = NULL_PTR;
+
+	if(0u != gs_ucTxMsgCallBackNum)
 	{
-		(gs_pfTxMsgSuccessfulCallBack)();
+		pfTxMsgSuccessfulCallBack = gs_apfTxMsgSuccessfulCallBack[gs_ucTxMsgCallBackHead];
+		gs_ucTxMsgCallBackHead = (uint8)((gs_ucTxMsgCallBackHead + 1u) % CANTP_TX_PIPELINE_DEPTH);
+		gs_ucTxMsgCallBackNum--;
 
-		gs_pfTxMsgSuccessfulCallBack = NULL_PTR;
+		if(NULL_PTR != pfTxMsgSuccessfulCallBack)
+		{
+			(pfTxMsgSuccessfulCallBack)();
+		}
 	}
 }
 
@@ -71,7 +71,7 @@ static uint8 LINTP_TxMsg(const tUdsId i_xTxId,
 	{
 		TxMsgInfo.TxMsgID = i_xTxId;
 		TxMsgInfo.TxMsgLength = sizeof(aMsgBuf);
-		TxMsgInfo.TxMsgCallBack = (uint32)i_pfNetTxCallBack;
+		TxMsgInfo.pfTxMsgCallBack = i_pfNetTxCallBack;
 		
 		aMsgBuf[0u] = (uint8)i_xTxId;
 		fsl_memcpy(&aMsgBuf[1u], i_pDataBuf, i_DataLen);
@@ -229,7 +229,7 @@ boolean LINTP_DriverReadDataFromLINTP(const uint32 i_readDataLen, uint8 *o_pRead
 					*o_pstTxMsgHeader = TxMsgInfo;
 					
 					/*storage callback, if user want to TX message callback please call TP_DoTxMsgSuccesfulCallback or self call callback*/
-					gs_pfTxMsgSuccessfulCallBack = (tpfNetTxCallBack)TxMsgInfo.TxMsgCallBack;
+					gs_pfTxMsgSuccessfulCallBack = TxMsgInfo.pfTxMsgCallBack;
 				}
 			}
 	}
@@ -63,7 +63,8 @@ When you update, please do not forgot to del me and add your info at here.
  *END**************************************************************************/
 void TP_Init(void)
 {
-    
+	TP_PduInit();
+
 #ifdef EN_CAN_TP
 	CANTP_Init();
 
@@ -110,10 +111,11 @@ void TP_SystemTickCtl(void)
 }
 
 
+#ifdef EN_LIN_TP
 /*read a frame from TP Rx FIFO. If no data can read return FALSE, else return TRUE*/
-boolean TP_ReadAFrameDataFromTP(uint32 *o_pRxMsgID, 
-									  uint32 *o_pxRxDataLen,
-									  uint8 *o_pDataBuf)
+static boolean TP_ReadAFrameDataFromFifo(uint32 *o_pRxMsgID, 
+										 uint32 *o_pxRxDataLen,
+										 uint8 *o_pDataBuf)
 {
 	tErroCode eStatus;
 	tLen xReadDataLen = 0u;
@@ -162,10 +164,10 @@ boolean TP_ReadAFrameDataFromTP(uint32 *o_pRxMsgID,
 }
 
 /*write a frame data  to tp TX FIFO*/
-boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
-									 const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
-									 const uint32 i_xTxDataLen,
-									 const uint8 *i_pDataBuf)
+static boolean TP_WriteAFrameDataInFifo(const uint32 i_TxMsgID,
+										const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+										const uint32 i_xTxDataLen,
+										const uint8 *i_pDataBuf)
 {
 	tErroCode eStatus;
 	tLen xCanWriteLen = 0u;
@@ -214,8 +216,110 @@ boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
 
 	return TRUE;
 }
+#endif /*#ifdef EN_LIN_TP*/
+
+/*read a received PDU for UDS. If none return FALSE, else return TRUE and the caller owns one reference of *o_pxPdu.*/
+boolean TP_ReadAPduFromTP(uint32 *o_pRxMsgID, 
+						  uint32 *o_pxRxDataLen,
+						  tTPPduHandle *o_pxPdu)
+{
+	boolean result = FALSE;
+
+	ASSERT(NULL_PTR == o_pRxMsgID);
+	ASSERT(NULL_PTR == o_pxRxDataLen);
+	ASSERT(NULL_PTR == o_pxPdu);
+
+#ifdef EN_CAN_TP
+	/*CAN TP reassembled the message in a pool buffer already*/
+	result = TP_GetRxPdu(o_pRxMsgID, o_pxRxDataLen, o_pxPdu);
+#endif
+
+#ifdef EN_LIN_TP
+	tTPPduHandle xPdu = TP_AllocPdu();
+
+	if(TP_PDU_NONE != xPdu)
+	{
+		result = TP_ReadAFrameDataFromFifo(o_pRxMsgID, o_pxRxDataLen, TP_GetPduBuf(xPdu));
+		if(TRUE == result)
+		{
+			*o_pxPdu = xPdu;
+		}
+		else
+		{
+			TP_ReleasePdu(xPdu);
+		}
+	}
+#endif
+
+	return result;
+}
+
+/*send the first i_xTxDataLen bytes of a PDU. The TP takes its own reference, the caller keeps its one.*/
+boolean TP_WriteAPduInTP(const uint32 i_TxMsgID,
+						 const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+						 const uint32 i_xTxDataLen,
+						 const tTPPduHandle i_xPdu)
+{
+	boolean result = FALSE;
+
+	/*check transmit ID*/
+	if(i_TxMsgID != TP_GetConfigTxMsgID())
+	{
+		return FALSE;
+	}
+
+	if((0u == i_xTxDataLen) || (i_xTxDataLen > TP_PDU_BUF_LEN) || (NULL_PTR == TP_GetPduBuf(i_xPdu)))
+	{
+		return FALSE;
+	}
+
+#ifdef EN_CAN_TP
+	/*CAN TP segments the message straight out of the pool buffer*/
+	TP_RetainPdu(i_xPdu);
+	result = TP_PutTxPdu(i_TxMsgID, i_pfUDSTxMsgCallBack, i_xTxDataLen, i_xPdu);
+	if(TRUE != result)
+	{
+		TP_ReleasePdu(i_xPdu);
+	}
+#endif
+
+#ifdef EN_LIN_TP
+	result = TP_WriteAFrameDataInFifo(i_TxMsgID, i_pfUDSTxMsgCallBack, i_xTxDataLen, TP_GetPduBuf(i_xPdu));
+#endif
+
+	return result;
+}
+
+/*send a short message held outside the pool (copied into a PDU buffer)*/
+boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID,
+									 const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+									 const uint32 i_xTxDataLen,
+									 const uint8 *i_pDataBuf)
+{
+	boolean result = FALSE;
+	tTPPduHandle xPdu = TP_PDU_NONE;
+
+	ASSERT(NULL_PTR == i_pDataBuf);
 
+	if((0u == i_xTxDataLen) || (i_xTxDataLen > TP_PDU_BUF_LEN))
+	{
+		return FALSE;
+	}
 
+	xPdu = TP_AllocPdu();
+	if(TP_PDU_NONE == xPdu)
+	{
+		return FALSE;
+	}
+
+	fsl_memcpy(TP_GetPduBuf(xPdu), i_pDataBuf, i_xTxDataLen);
+
+	result = TP_WriteAPduInTP(i_TxMsgID, i_pfUDSTxMsgCallBack, i_xTxDataLen, xPdu);
+
+	TP_ReleasePdu(xPdu);
+
+	return result;
+}
 
 /*FUNCTION**********************************************************************
  *
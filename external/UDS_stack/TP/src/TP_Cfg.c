@@ -19,6 +19,7 @@ Note: These marco is global. Because it used by TP and UDS layer.
 */
 
 static tpfUDSTxMsgCallBack gs_pfUDSTxMsgCallBack = NULL_PTR; /*Tx message call back*/
+static volatile tTPRxStatistics gs_stTPRxStatistics; /*written in the driver RX interrupt, since power up*/
 
 
 /*Get TP config TX message ID*/
@@ -115,9 +116,33 @@ boolean TP_DriverWriteDataInTP(const uint32 i_RxID, const uint32 i_RxDataLen, co
 	result = LINTP_DriverWriteDataInLINTP(i_pRxDataBuf[0u], i_RxDataLen - 1u, &i_pRxDataBuf[1u]);
 #endif
 
+	gs_stTPRxStatistics.rxFrameCnt++;
+	if(TRUE != result)
+	{
+		gs_stTPRxStatistics.rxDropCnt++;
+	}
+
 	return result;
 }
 
+/*Driver reports received frames lost before the TP saw them (controller RX FIFO overflow)*/
+void TP_DriverRxOverrun(void)
+{
+	gs_stTPRxStatistics.rxOverrunCnt++;
+}
+
+/*Get RX statistics*/
+void TP_GetRxStatistics(tTPRxStatistics *o_pstRxStatistics)
+{
+	ASSERT(NULL_PTR == o_pstRxStatistics);
+
+	DisableAllInterrupts();
+	o_pstRxStatistics->rxFrameCnt = gs_stTPRxStatistics.rxFrameCnt;
+	o_pstRxStatistics->rxDropCnt = gs_stTPRxStatistics.rxDropCnt;
+	o_pstRxStatistics->rxOverrunCnt = gs_stTPRxStatistics.rxOverrunCnt;
+	EnableAllInterrupts();
+}
+
 /*Driver read data from TP for Tx message to BUS*/
 boolean TP_DriverReadDataFromTP(const uint32 i_readDataLen, uint8 * o_pReadDatabuf, uint32 *o_pTxMsgID, uint32 *o_pTxMsgLength)
 {
@@ -0,0 +1,233 @@
+/*
+ * TP_pdu.c
+ *
+ *  Pooled PDU buffers shared by the TP and the UDS layer, see TP_pdu.h
+ */
+
+#include "TP_pdu.h"
+
+/*message waiting in a queue*/
+typedef struct
+{
+	uint32 msgID;                   /*message ID*/
+	uint32 dataLen;                 /*data length*/
+	tpfUDSTxMsgCallBack pfCallBack; /*call back, TX only*/
+	tTPPduHandle xPdu;              /*buffer holding the data*/
+}tTPPduMsgInfo;
+
+typedef struct
+{
+	tTPPduMsgInfo astMsg[TP_PDU_BUF_NUM]; /*can never hold more messages than there are buffers*/
+	uint8 head;                           /*oldest message*/
+	uint8 count;                          /*messages in the queue*/
+}tTPPduQueue;
+
+/***********************Global value*************************/
+static uint8 gs_aTPPduBuf[TP_PDU_BUF_NUM][TP_PDU_BUF_LEN]; /*pool buffers*/
+static uint8 gs_aTPPduRefCnt[TP_PDU_BUF_NUM];              /*references, 0 = free*/
+static tTPPduQueue gs_stTPRxPduQueue;                      /*TP -> UDS*/
+static tTPPduQueue gs_stTPTxPduQueue;                      /*UDS -> TP*/
+/*********************************************************/
+
+#define IsPduHandleValid(xPdu) (((TP_PDU_NONE != (xPdu)) && ((xPdu) <= TP_PDU_BUF_NUM)) ? TRUE : FALSE)
+
+/*add a message to a queue*/
+static boolean TP_PutPduMsg(tTPPduQueue *m_pstQueue, const tTPPduMsgInfo *i_pstMsg)
+{
+	uint8 index = 0u;
+
+	if(m_pstQueue->count >= TP_PDU_BUF_NUM)
+	{
+		return FALSE;
+	}
+
+	index = (uint8)((m_pstQueue->head + m_pstQueue->count) % TP_PDU_BUF_NUM);
+	m_pstQueue->astMsg[index] = *i_pstMsg;
+	m_pstQueue->count++;
+
+	return TRUE;
+}
+
+/*take the oldest message from a queue*/
+static boolean TP_GetPduMsg(tTPPduQueue *m_pstQueue, tTPPduMsgInfo *o_pstMsg)
+{
+	if(0u == m_pstQueue->count)
+	{
+		return FALSE;
+	}
+
+	*o_pstMsg = m_pstQueue->astMsg[m_pstQueue->head];
+	m_pstQueue->head = (uint8)((m_pstQueue->head + 1u) % TP_PDU_BUF_NUM);
+	m_pstQueue->count--;
+
+	return TRUE;
+}
+
+/*clear the pool and the queues*/
+void TP_PduInit(void)
+{
+	fsl_memset(gs_aTPPduRefCnt, 0u, sizeof(gs_aTPPduRefCnt));
+	fsl_memset(&gs_stTPRxPduQueue, 0u, sizeof(gs_stTPRxPduQueue));
+	fsl_memset(&gs_stTPTxPduQueue, 0u, sizeof(gs_stTPTxPduQueue));
+}
+
+/*take a free buffer with one reference, TP_PDU_NONE if the pool is empty*/
+tTPPduHandle TP_AllocPdu(void)
+{
+	uint8 index = 0u;
+
+	for(index = 0u; index < TP_PDU_BUF_NUM; index++)
+	{
+		if(0u == gs_aTPPduRefCnt[index])
+		{
+			gs_aTPPduRefCnt[index] = 1u;
+
+			return (tTPPduHandle)(index + 1u);
+		}
+	}
+
+	TP_DebugPrintf("PDU pool empty!\n");
+
+	return TP_PDU_NONE;
+}
+
+/*add a reference*/
+void TP_RetainPdu(const tTPPduHandle i_xPdu)
+{
+	if(TRUE == IsPduHandleValid(i_xPdu))
+	{
+		ASSERT(0u == gs_aTPPduRefCnt[i_xPdu - 1u]);
+
+		gs_aTPPduRefCnt[i_xPdu - 1u]++;
+	}
+}
+
+/*drop a reference, the buffer goes back to the pool with the last one*/
+void TP_ReleasePdu(const tTPPduHandle i_xPdu)
+{
+	if(TRUE == IsPduHandleValid(i_xPdu))
+	{
+		ASSERT(0u == gs_aTPPduRefCnt[i_xPdu - 1u]);
+
+		if(0u != gs_aTPPduRefCnt[i_xPdu - 1u])
+		{
+			gs_aTPPduRefCnt[i_xPdu - 1u]--;
+		}
+	}
+}
+
+/*data of a buffer, TP_PDU_BUF_LEN bytes*/
+uint8 *TP_GetPduBuf(const tTPPduHandle i_xPdu)
+{
+	if(TRUE != IsPduHandleValid(i_xPdu))
+	{
+		return NULL_PTR;
+	}
+
+	return &gs_aTPPduBuf[i_xPdu - 1u][0u];
+}
+
+/*free buffers in the pool*/
+uint8 TP_GetFreePduNum(void)
+{
+	uint8 index = 0u;
+	uint8 freeNum = 0u;
+
+	for(index = 0u; index < TP_PDU_BUF_NUM; index++)
+	{
+		if(0u == gs_aTPPduRefCnt[index])
+		{
+			freeNum++;
+		}
+	}
+
+	return freeNum;
+}
+
+/*received PDU for UDS. The queue takes over the caller's reference.*/
+boolean TP_PutRxPdu(const uint32 i_RxMsgID, const uint32 i_dataLen, const tTPPduHandle i_xPdu)
+{
+	tTPPduMsgInfo stMsg;
+
+	if((TRUE != IsPduHandleValid(i_xPdu)) || (0u == i_dataLen) || (i_dataLen > TP_PDU_BUF_LEN))
+	{
+		return FALSE;
+	}
+
+	stMsg.msgID = i_RxMsgID;
+	stMsg.dataLen = i_dataLen;
+	stMsg.pfCallBack = NULL_PTR;
+	stMsg.xPdu = i_xPdu;
+
+	return TP_PutPduMsg(&gs_stTPRxPduQueue, &stMsg);
+}
+
+/*oldest received PDU, the caller takes over the queue's reference*/
+boolean TP_GetRxPdu(uint32 *o_pRxMsgID, uint32 *o_pDataLen, tTPPduHandle *o_pxPdu)
+{
+	tTPPduMsgInfo stMsg;
+
+	ASSERT(NULL_PTR == o_pRxMsgID);
+	ASSERT(NULL_PTR == o_pDataLen);
+	ASSERT(NULL_PTR == o_pxPdu);
+
+	if(TRUE != TP_GetPduMsg(&gs_stTPRxPduQueue, &stMsg))
+	{
+		return FALSE;
+	}
+
+	*o_pRxMsgID = stMsg.msgID;
+	*o_pDataLen = stMsg.dataLen;
+	*o_pxPdu = stMsg.xPdu;
+
+	return TRUE;
+}
+
+/*PDU for the bus. The queue takes over the caller's reference.*/
+boolean TP_PutTxPdu(const uint32 i_TxMsgID,
+					const tpfUDSTxMsgCallBack i_pfCallBack,
+					const uint32 i_dataLen,
+					const tTPPduHandle i_xPdu)
+{
+	tTPPduMsgInfo stMsg;
+
+	if((TRUE != IsPduHandleValid(i_xPdu)) || (0u == i_dataLen) || (i_dataLen > TP_PDU_BUF_LEN))
+	{
+		return FALSE;
+	}
+
+	stMsg.msgID = i_TxMsgID;
+	stMsg.dataLen = i_dataLen;
+	stMsg.pfCallBack = i_pfCallBack;
+	stMsg.xPdu = i_xPdu;
+
+	return TP_PutPduMsg(&gs_stTPTxPduQueue, &stMsg);
+}
+
+/*oldest PDU to send, the caller takes over the queue's reference*/
+boolean TP_GetTxPdu(uint32 *o_pTxMsgID,
+					tpfUDSTxMsgCallBack *o_pfCallBack,
+					uint32 *o_pDataLen,
+					tTPPduHandle *o_pxPdu)
+{
+	tTPPduMsgInfo stMsg;
+
+	ASSERT(NULL_PTR == o_pTxMsgID);
+	ASSERT(NULL_PTR == o_pfCallBack);
+	ASSERT(NULL_PTR == o_pDataLen);
+	ASSERT(NULL_PTR == o_pxPdu);
+
+	if(TRUE != TP_GetPduMsg(&gs_stTPTxPduQueue, &stMsg))
+	{
+		return FALSE;
+	}
+
+	*o_pTxMsgID = stMsg.msgID;
+	*o_pfCallBack = stMsg.pfCallBack;
+	*o_pDataLen = stMsg.dataLen;
+	*o_pxPdu = stMsg.xPdu;
+
+	return TRUE;
+}
+
+/***************************End file********************************/
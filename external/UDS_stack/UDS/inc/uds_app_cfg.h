@@ -14,11 +14,15 @@
 
 typedef uint16 tUdsTime;
 
+/*UDS message buffer len: requests and responses live in TP pool buffers (TP_pdu.h)*/
+#define UDS_MSG_BUF_LEN (TP_PDU_BUF_LEN)
+
 typedef struct
 {
     tUdsId xUdsId;
     tUdsLen xDataLen;
-    uint8 aDataBuf[150u];
+    uint8 *aDataBuf;      /*UDS_MSG_BUF_LEN bytes: the request, the response is built in place*/
+    tTPPduHandle xPdu;    /*pool buffer behind aDataBuf, TP_PDU_NONE for a local buffer*/
     /*tx message call back*/
     void (*pfUDSTxMsgServiceCallBack)(uint8);
 } tUdsAppMsgInfo;
@@ -43,6 +47,44 @@ typedef struct UDSServiceInfo
 #error "S3_TIMER_WATERMARK_PERCENT should config (0, 100]"
 #endif
 
+/*TransferData pipeline: flash sector sized SRAM segments (int_sram_shareable, 32 KiB) programmed in the background*/
+#ifndef UDS_DOWNLOAD_SEGMENT_NUM
+#define UDS_DOWNLOAD_SEGMENT_NUM (3u)
+#endif
+
+#if (UDS_DOWNLOAD_SEGMENT_NUM < 2) || (UDS_DOWNLOAD_SEGMENT_NUM > 4)
+#error "UDS_DOWNLOAD_SEGMENT_NUM should config [2, 4]"
+#endif
+
+/*time between two 0x78 of a request waiting for the flash, below P2*server*/
+#ifndef UDS_RESPONSE_PENDING_TIME
+#define UDS_RESPONSE_PENDING_TIME (4000u)
+#endif
+
+/*EraseMemory (0x31 01 FF00): 1 = answer at once and erase in the background ahead of TransferData,
+  0 = answer (0x78 until then) once the whole range is erased*/
+#ifndef UDS_ERASE_AHEAD
+#define UDS_ERASE_AHEAD (1u)
+#endif
+
+/*sectors queued for erase at a time, and how far the erase runs ahead of the TransferData write address*/
+#ifndef UDS_ERASE_AHEAD_SECTORS
+#define UDS_ERASE_AHEAD_SECTORS (2u)
+#endif
+
+#if (UDS_ERASE_AHEAD_SECTORS < 1) || (UDS_ERASE_AHEAD_SECTORS > 8)
+#error "UDS_ERASE_AHEAD_SECTORS should config [1, 8]"
+#endif
+
+/*downloaded ranges remembered for CheckMemory/CheckProgrammingDependencies, cleared by EraseMemory*/
+#ifndef UDS_DOWNLOAD_RANGE_NUM
+#define UDS_DOWNLOAD_RANGE_NUM (4u)
+#endif
+
+#if (UDS_DOWNLOAD_RANGE_NUM < 1) || (UDS_DOWNLOAD_RANGE_NUM > 16)
+#error "UDS_DOWNLOAD_RANGE_NUM should config [1, 16]"
+#endif
+
 /*uds negative value define*/
 #define NEGTIVE_ID (0x7Fu)
 #define	SNS (0x11u)          /*service not support*/
@@ -52,9 +94,14 @@ typedef struct UDSServiceInfo
 #define	CNC (0x22u)          /*conditions not correct*/
 #define	RSE (0x24u)          /*request 	sequence error*/
 #define	ROOR (0x31u)         /*request out of range*/
+#define	RTL (0x14u)          /*response too long*/
 #define	SAD (0x33u)          /*security access denied*/
 #define	IK (0x35u)           /*invalid key*/
 #define	ENOA (0x36u)         /*exceed number of attempts*/
+#define	UDNA (0x70u)         /*upload download not accepted*/
+#define	TDS (0x71u)          /*transfer data suspended*/
+#define	GPF (0x72u)          /*general programming failure*/
+#define	WBSC (0x73u)         /*wrong block sequence counter*/
 #define	RCRRP (0x78u)        /*request correctly received-response pending*/
 
 /*define session mode*/
@@ -62,10 +109,63 @@ typedef struct UDSServiceInfo
 #define PROGRAM_SESSION (1u << 1u)       /*program session*/
 #define EXTEND_SESSION (1u << 2u)        /*extend session*/
 
-/*security request*/
-#define NONE_SECURITY (1u << 0u)                          /*none security can request*/
-#define SECURITY_LEVEL_1 ((1 << 1u) | NONE_SECURITY)      /*security level 1 request*/
-#define SECURITY_LEVEL_2 ((1u << 2u) | SECURITY_LEVEL_1)  /*security level 2 request*/
+/*security state, one bit each, for UDS_SetSecurityLevel()*/
+#define SECURITY_STATE_LOCKED (1u << 0u)                  /*no SecurityAccess yet*/
+#define SECURITY_STATE_LEVEL_1 (1u << 1u)                 /*unlocked at level 1*/
+#define SECURITY_STATE_LEVEL_2 (1u << 2u)                 /*unlocked at level 2*/
+
+/*security request: the states a service or DID is accepted in*/
+#define NONE_SECURITY (SECURITY_STATE_LOCKED | SECURITY_STATE_LEVEL_1 | SECURITY_STATE_LEVEL_2) /*none security can request*/
+#define SECURITY_LEVEL_1 (NONE_SECURITY)                  /*security level 1 request, open while locked: there is no 0x27 service yet*/
+#define SECURITY_LEVEL_2 (NONE_SECURITY)                  /*security level 2 request, open while locked: there is no 0x27 service yet*/
+#define SECURITY_UNLOCKED (SECURITY_STATE_LEVEL_1 | SECURITY_STATE_LEVEL_2) /*unlocked at any level, never while locked*/
+
+/*max request length the TP can hand to UDS: CAN TP reassembles into a pool buffer,
+LIN TP is still limited by its RX queue (minus its header)*/
+#define UDS_MIN_LEN(a, b) (((a) < (b)) ? (a) : (b))
+#ifdef EN_CAN_TP
+#define UDS_MAX_REQUEST_LEN ((uint32)UDS_MSG_BUF_LEN)
+#else
+#define UDS_RX_QUEUE_MSG_LEN ((uint32)RX_TP_QUEUE_LEN - (uint32)sizeof(tUDSAndTPExchangeMsgInfo))
+#define UDS_MAX_REQUEST_LEN UDS_MIN_LEN(UDS_RX_QUEUE_MSG_LEN, (uint32)UDS_MSG_BUF_LEN)
+#endif
+
+/*maxNumberOfBlockLength reported in the RequestDownload response (whole 0x36 request incl. SID and counter)*/
+#define UDS_MAX_BLOCK_LEN (UDS_MAX_REQUEST_LEN)
+
+/*data flash the tester may read back with 0x23/0x35, besides the application slots: the calibration area
+  only, below the bootloader's own records from 0x10010000 on (boot control, verified-image cache,
+  fingerprint, delta progress)*/
+#ifndef UDS_READ_DATA_FLASH_ADDR
+#define UDS_READ_DATA_FLASH_ADDR (0x10000000u)
+#endif
+
+#ifndef UDS_READ_DATA_FLASH_SIZE
+#define UDS_READ_DATA_FLASH_SIZE (0x00010000u)
+#endif
+
+/*flash is read in whole words straight into the response: up to 3 bytes before and 3 behind the range*/
+#define UDS_READ_MEMORY_SLACK (6u)
+
+/*largest memorySize of a ReadMemoryByAddress (response is SID + data)*/
+#define UDS_MAX_READ_MEMORY_LEN ((uint32)UDS_MSG_BUF_LEN - 1u - UDS_READ_MEMORY_SLACK)
+
+/*maxNumberOfBlockLength reported in the RequestUpload response (whole 0x36 response incl. SID and counter)*/
+#define UDS_MAX_UPLOAD_BLOCK_LEN ((uint32)UDS_MSG_BUF_LEN - UDS_READ_MEMORY_SLACK)
+
+/*DIDs one ReadDataByIdentifier may ask for*/
+#ifndef UDS_MAX_READ_DID_NUM
+#define UDS_MAX_READ_DID_NUM (16u)
+#endif
+
+#if (UDS_MAX_READ_DID_NUM < 1) || (UDS_MAX_READ_DID_NUM > 64)
+#error "UDS_MAX_READ_DID_NUM should config [1, 64]"
+#endif
+
+/*data flash sector holding the fingerprint (DID 0xF15A), after the verified-image cache (boot_verify.h)*/
+#ifndef UDS_FINGERPRINT_ADDR
+#define UDS_FINGERPRINT_ADDR (0x10016000u)
+#endif
 
 /*********************************************************/
 /*set currrent session mode. DEFAULT_SESSION/PROGRAM_SESSION/EXTEND_SESSION */
@@ -99,6 +199,15 @@ extern uint8 UDS_IsCurSecurityLevelRequest(uint8 i_securityLevel);
 /* Get UDS config Service information */
 tUDSService* UDS_GetUDSServiceInfo(uint8 *m_pSupServItem);
 
+/*build the SID lookup and permission masks of the service table. Called from UDS_Init().*/
+extern void UDS_BuildServiceIndex(void);
+
+/*service of a SID, NULL_PTR if not supported. o_pIsPermitted: current session, request ID and security level can request it.*/
+extern tUDSService* UDS_FindUDSService(const uint8 i_serNum, uint8 *o_pIsPermitted);
+
+/*count a request read from TP (DID 0xFD10)*/
+extern void UDS_CountRequest(void);
+
 /* If Rx UDS msg, set g_ucIsRxUdsMsg TURE */
 extern void UDS_SetIsRxUdsMsg(const uint8 i_setValue);
 
@@ -112,6 +221,9 @@ extern void UDS_SetNegativeErroCode(const uint8 i_UDSServiceNum,
 /*uds time control*/
 extern void UDS_SystemTickCtl(void);
 
+/*download background work, called from UDS_MainFun()*/
+extern void UDS_DownloadMainFun(void);
+
 /*write message to host basd on UDS for request enter bootloader mode*/
 extern boolean UDS_TxMsgToHost(void);
 
@@ -7,17 +7,16 @@
 /*UDS init*/
 void UDS_Init(void)
 {
-
+    /*SID lookup table, so UDS_MainFun() finds a service with one index*/
+    UDS_BuildServiceIndex();
 }
 
 /*uds main function. ISO14229*/
 void UDS_MainFun(void)
 {
-    uint8 UDSSerIndex = 0u;
     uint8 UDSSerNum = 0u;
-    tUdsAppMsgInfo stUdsAppMsg = {0u, 0u, {0u}, NULL_PTR};
-    uint8 isFindService = FALSE;
-    uint8 SupSerItem = 0u;
+    tUdsAppMsgInfo stUdsAppMsg = {0u, 0u, NULL_PTR, TP_PDU_NONE, NULL_PTR};
+    uint8 isPermitted = FALSE;
     tUDSService *pstUDSService = NULL_PTR;
 
     if(TRUE == UDS_IsS3ServerTimeout())
@@ -26,16 +25,23 @@ void UDS_MainFun(void)
         UDS_SetCurrentSession(DEFALUT_SESSION);
 
         /*set security level. If S3server timeout, clear current security.*/
-        UDS_SetSecurityLevel(NONE_SECURITY);
+        UDS_SetSecurityLevel(SECURITY_STATE_LOCKED);
     }
 
-    /*read data from can tp*/
-    if(TRUE == TP_ReadAFrameDataFromTP(&stUdsAppMsg.xUdsId,
-                                        &stUdsAppMsg.xDataLen,
-                                        stUdsAppMsg.aDataBuf))
+    /*program buffered TransferData and answer a request waiting for the flash*/
+    UDS_DownloadMainFun();
+
+    /*read a request from tp, we own one reference of its buffer*/
+    if(TRUE == TP_ReadAPduFromTP(&stUdsAppMsg.xUdsId,
+                                  &stUdsAppMsg.xDataLen,
+                                  &stUdsAppMsg.xPdu))
     {
+        stUdsAppMsg.aDataBuf = TP_GetPduBuf(stUdsAppMsg.xPdu);
+
         UDS_SetIsRxUdsMsg(TRUE);
 
+        UDS_CountRequest();
+
         if(TRUE != UDS_IsCurDefaultSession())
         {
             /*restart s3server time*/
@@ -50,76 +56,39 @@ void UDS_MainFun(void)
         return;
     }
 
-    /*get UDS service Information, start PTR and service item*/
-    pstUDSService = UDS_GetUDSServiceInfo(&SupSerItem);
-
     /*get UDS service ID*/
     UDSSerNum = stUdsAppMsg.aDataBuf[0u];
 
-    while((UDSSerIndex < SupSerItem) && (NULL_PTR != pstUDSService))
-    {
-        if(UDSSerNum == pstUDSService[UDSSerIndex].serNum)
-        {
-            isFindService = TRUE;
-
-            if(TRUE != UDS_IsCurRxIdCanRequest(pstUDSService[UDSSerIndex].supReqMode))
-            {
-                /*received ID cann't request this service.*/
-                UDS_SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], SNS, &stUdsAppMsg);
-
-                break;
-            }
-
-            if(TRUE != UDS_IsCurSessionCanRequest(pstUDSService[UDSSerIndex].sessionMode))
-            {
-                /*currnet session mode cann't request ths service.*/
-                UDS_SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], SNS, &stUdsAppMsg);
-
-                break;
-            }
-
-            if(TRUE != UDS_IsCurSecurityLevelRequest(pstUDSService[UDSSerIndex].reqLevel))
-            {
-                /*current security level cann't request this service.*/
-                UDS_SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], SNS, &stUdsAppMsg);
-
-                break;
-            }
-
-            stUdsAppMsg.pfUDSTxMsgServiceCallBack = NULL_PTR;
-
-            /*find service, and do it.*/
-            if(NULL_PTR != pstUDSService[UDSSerIndex].pfSerNameFun)
-            {
-                pstUDSService[UDSSerIndex].pfSerNameFun((tUDSService *)&pstUDSService[UDSSerIndex], &stUdsAppMsg);
-            }
-            else
-            {
-                /*current security level cann't request this service.*/
-                UDS_SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], SNS, &stUdsAppMsg);
-            }
-
-            break;
-        }
+    /*look up the service and whether current session, request ID and security level can request it*/
+    pstUDSService = UDS_FindUDSService(UDSSerNum, &isPermitted);
 
-        UDSSerIndex++;
-    }
-
-    if(TRUE != isFindService)
+    if((NULL_PTR == pstUDSService) ||
+       (TRUE != isPermitted) ||
+       (NULL_PTR == pstUDSService->pfSerNameFun))
     {
         /*response not support service.*/
         UDS_SetNegativeErroCode(stUdsAppMsg.aDataBuf[0u], SNS, &stUdsAppMsg);
     }
+    else
+    {
+        stUdsAppMsg.pfUDSTxMsgServiceCallBack = NULL_PTR;
+
+        /*find service, and do it.*/
+        pstUDSService->pfSerNameFun(pstUDSService, &stUdsAppMsg);
+    }
 
     if(0u != stUdsAppMsg.xDataLen)
     {
         stUdsAppMsg.xUdsId = TP_GetConfigTxMsgID();
 
-        (void)TP_WriteAFrameDataInTP(stUdsAppMsg.xUdsId,
-                                     stUdsAppMsg.pfUDSTxMsgServiceCallBack,
-                                     stUdsAppMsg.xDataLen,
-                                     stUdsAppMsg.aDataBuf);
+        /*the response was built in the request buffer, the TP sends it from there*/
+        (void)TP_WriteAPduInTP(stUdsAppMsg.xUdsId,
+                               stUdsAppMsg.pfUDSTxMsgServiceCallBack,
+                               stUdsAppMsg.xDataLen,
+                               stUdsAppMsg.xPdu);
     }
+
+    TP_ReleasePdu(stUdsAppMsg.xPdu);
 }
 
 
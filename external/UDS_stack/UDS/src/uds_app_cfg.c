@@ -1,13 +1,101 @@
+#include <stddef.h>
 #include "uds_app_cfg.h"
 #include "watchdog_hal.h"
 #include "boot.h"
+#include "boot_ctrl.h"
+#include "boot_verify.h"
+#include "hal_flash.h"
+#include "hal_crc.h"
+#include "hal_error.h"
+#include "boot_lzss.h"
+#include "boot_delta.h"
+#include "boot_version.h"
 
 typedef struct
 {
     uint32 startAddr;         /*data start address*/
     uint32 dataLen;           /*data len*/
+    uint32 receivedLen;       /*data len received and buffered*/
+    uint32 dataCrc;           /*CRC32 of the data received so far, pieces joined with hal_crc32_combine()*/
+    uint8 blockSequenceCounter;  /*expected block sequence counter of next TransferData*/
+    boolean isDownloading;    /*RequestDownload accepted and RequestTransferExit not received yet*/
+    boolean isProgramFailed;  /*a background program/verify job failed*/
+    tAPPType targetSlot;      /*slot written by this download (must be erased)*/
+    uint8 fillSegment;        /*segment the next TransferData byte goes to*/
+    uint8 dataFormat;         /*DOWLOAD_FORMAT_xxx. For LZSS and delta, dataLen/receivedLen count the bytes written to flash.*/
+    uint32 blockOffset;       /*delta: payload bytes of the current TransferData already applied*/
 } tDowloadDataInfo;
 
+/*download segment state*/
+typedef enum
+{
+    DOWLOAD_SEGMENT_FREE,         /*not in use*/
+    DOWLOAD_SEGMENT_FILLING,      /*collecting TransferData blocks*/
+    DOWLOAD_SEGMENT_PROGRAMMING,  /*handed to the flash engine*/
+} tDowloadSegmentState;
+
+/*one SRAM segment of the TransferData pipeline, mirrors a flash sector*/
+typedef struct
+{
+    uint32 flashAddr;             /*flash address of the first segment byte*/
+    uint32 startOffset;           /*first byte holding download data*/
+    uint32 fillLen;               /*end of the download data in the segment*/
+    tDowloadSegmentState state;   /*segment state*/
+    hal_flash_job_t stJob;        /*program, then verify job*/
+    boolean hasDeltaProgress;     /*delta: the segment ends on a sector boundary, stDeltaState is saved once it is in flash*/
+    uint32 deltaOutCrc;           /*delta: image CRC up to the segment end*/
+    boot_delta_t stDeltaState;    /*delta: applier state at the segment end*/
+} tDowloadSegment;
+
+/*RequestUpload..RequestTransferExit: flash read back block by block*/
+typedef struct
+{
+    uint32 startAddr;         /*first byte*/
+    uint32 dataLen;           /*length*/
+    uint32 sentLen;           /*bytes answered so far*/
+    uint32 lastBlockLen;      /*data bytes of the last TransferData response, sent again for a repeated counter*/
+    uint8 blockSequenceCounter;  /*expected block sequence counter of next TransferData*/
+    boolean isUploading;      /*RequestUpload accepted and RequestTransferExit not received yet*/
+} tUploadDataInfo;
+
+/*request waiting for the flash engine, answered from UDS_DownloadMainFun()*/
+typedef struct
+{
+    tUDSService *pstService;      /*service to run again, NULL_PTR when nothing waits*/
+    tUdsTime xResponsePendingTime;/*time left until the next 0x78*/
+    tUdsAppMsgInfo stMsg;         /*copy of the request, holds a reference of its TP buffer*/
+} tDowloadPendingInfo;
+
+/*range written by one RequestDownload..RequestTransferExit*/
+typedef struct
+{
+    uint32 startAddr;             /*first byte*/
+    uint32 dataLen;               /*length*/
+    uint32 dataCrc;               /*CRC32 of the data, folded in while it was received*/
+    boolean isChecked;            /*CheckMemory matched the tester's CRC (and the flash, see hal_flash verify policy)*/
+} tDowloadRangeInfo;
+
+/*EraseMemory routine: range erased sector by sector through the flash engine*/
+typedef struct
+{
+    uint32 startAddr;             /*first sector of the range*/
+    uint32 nextAddr;              /*next sector not queued for erase yet*/
+    uint32 endAddr;               /*end of the (sector aligned) range to erase*/
+    boolean isEraseFailed;        /*an erase job failed, cleared by the next EraseMemory*/
+    boolean isRangeStarted;       /*range of the request being answered is set up (it may have waited for the previous one)*/
+    hal_flash_job_t astJob[UDS_ERASE_AHEAD_SECTORS]; /*one sector each*/
+} tEraseMemoryInfo;
+
+/*progress of a delta download, appended to the data flash sector at BOOT_DELTA_PROGRESS_ADDR*/
+typedef struct
+{
+    boot_delta_progress_t stRecord;   /*record being programmed*/
+    hal_flash_job_t stEraseJob;       /*erase of the sector once it is full*/
+    hal_flash_job_t stJob;            /*program of stRecord*/
+    uint32 nextAddr;                  /*where the next record goes*/
+    uint32 savedLen;                  /*image bytes covered by the newest record*/
+} tDeltaProgressInfo;
+
 /*define security access info*/
 typedef struct
 {
@@ -18,15 +106,42 @@ typedef struct
     void (*pfRoutine)(void);    /*routine*/
 } tUDS_SecurityAccessInfo;
 
-/*define write data subfunction*/
+/*data identifier of ReadDataByIdentifier/WriteDataByIdentifier. Handlers return 0 or the NRC.*/
+typedef struct
+{
+    uint16 dataId;          /*DID, the registry is sorted by it*/
+    uint16 dataLen;         /*record length, read and written as a whole*/
+    uint8 readSession;      /*sessions it can be read in, 0 if write only*/
+    uint8 readLevel;        /*security level to read*/
+    uint8 writeSession;     /*sessions it can be written in, 0 if read only*/
+    uint8 writeLevel;       /*security level to write*/
+    uint8 (*pfRead)(uint8 *o_pData);        /*fill dataLen bytes*/
+    uint8 (*pfWrite)(const uint8 *i_pData); /*take dataLen bytes*/
+} tUDS_DataIdentifierInfo;
+
+/*counters read back through DID 0xFD10*/
+typedef struct
+{
+    uint32 requestCnt;        /*requests read from TP*/
+    uint32 responsePendingCnt;/*0x78 sent*/
+    uint32 parkedCnt;         /*requests parked until the flash caught up*/
+    uint32 downloadBytes;     /*bytes of completed downloads*/
+    uint32 readBackBytes;     /*bytes read back by 0x23/0x36*/
+} tUdsPerfInfo;
+
+/*fingerprint (DID 0xF15A) record in its own data flash sector*/
+#define DID_FINGERPRINT_LEN (9u)          /*tester serial number (6), programming date YYMMDD BCD (3)*/
+#define DID_FINGERPRINT_MAGIC (0x46505254u) /*"FPRT"*/
+
 typedef struct
 {
-    uint8 Subfunction;      /*subfunction*/
-    uint8 requestSession;   /*request session*/
-    uint8 requestIdMode;    /*request id mode*/
-    uint8 requestLevel;     /*request level*/
-    void (*pfRoutine)(void);/*routine*/
-} tUDS_WriteDataByIdentifierInfo;
+    uint32 magic;                         /*DID_FINGERPRINT_MAGIC*/
+    uint8 aData[DID_FINGERPRINT_LEN];     /*last written fingerprint*/
+    uint8 aReserved[3u];                  /*pads the record to whole words*/
+    uint32 crc32;                         /*CRC32 over the bytes before*/
+} tFingerprintRecord;
+
+#define DID_FINGERPRINT_CRC_LEN (offsetof(tFingerprintRecord, crc32))
 
 typedef enum
 {
@@ -39,6 +154,48 @@ typedef enum
 #define DOWLOAD_DATA_ADDR_LEN (4u)      /*dowload data addr len*/
 #define DOWLOAD_DATA_LEN (4u)           /*dowload data len*/
 
+/*addressAndLengthFormatIdentifier accepted by RequestDownload*/
+#define DOWLOAD_ADDR_LEN_FORMAT ((DOWLOAD_DATA_LEN << 4u) | DOWLOAD_DATA_ADDR_LEN)
+
+/*EraseMemory request: 31 01 FF 00, addressAndLengthFormatIdentifier, address, size*/
+#define ERASE_MEMORY_REQUEST_LEN (5u + DOWLOAD_DATA_ADDR_LEN + DOWLOAD_DATA_LEN)
+
+/*routineStatusRecord of a positive EraseMemory/CheckMemory/CheckProgrammingDependencies response*/
+#define ROUTINE_STATUS_CORRECT (0x00u)
+#define ROUTINE_STATUS_INCORRECT (0x01u)
+
+/*CheckMemory request: 31 01 02 02, CRC32*/
+#define CHECK_SUM_REQUEST_LEN (4u + 4u)
+
+/*dataFormatIdentifier accepted by RequestDownload: no encryption; uncompressed, LZSS (boot_lzss.h)
+  or a delta patch against the image in the active slot (boot_delta.h). DELTA_RESUME goes on with the delta
+  download a reset interrupted, from the progress DID 0xFD20 reports; it is a delta download from then on.*/
+#define DOWLOAD_FORMAT_RAW (0x00u)
+#define DOWLOAD_FORMAT_LZSS (0x10u)
+#define DOWLOAD_FORMAT_DELTA (0x20u)
+#define DOWLOAD_FORMAT_DELTA_RESUME (0x30u)
+
+/*dataFormatIdentifier accepted by RequestUpload: plain flash content*/
+#define UPLOAD_FORMAT_RAW (0x00u)
+
+/*lengthFormatIdentifier of the RequestDownload response: maxNumberOfBlockLength is 2 bytes*/
+#define DOWLOAD_MAX_BLOCK_LEN_FORMAT (0x20u)
+
+/*pipeline segments are flash sector sized and sector aligned, so two jobs never share a write unit*/
+#define DOWLOAD_SEGMENT_SIZE (HAL_FLASH_SECTOR_SIZE)
+
+/*maxNumberOfBlockLength of a compressed download: the worst case output of one block has to fit into
+  the pipeline when only the segment being filled is partly used, so a parked block always gets its space*/
+#define DOWLOAD_LZSS_MAX_BLOCK_LEN UDS_MIN_LEN((uint32)UDS_MAX_BLOCK_LEN, \
+    2u * ((((UDS_DOWNLOAD_SEGMENT_NUM - 1u) * DOWLOAD_SEGMENT_SIZE) / BOOT_LZSS_MAX_COUNT) - 2u) + 2u)
+
+/*segment buffers live in int_sram_shareable on target, host builds keep them in .bss*/
+#if defined(__GNUC__) && defined(__arm__)
+#define DOWLOAD_SEGMENT_BSS __attribute__((section(".mcal_shared_bss"), aligned(8)))
+#else
+#define DOWLOAD_SEGMENT_BSS __attribute__((aligned(8)))
+#endif
+
 /*support function/physical ID request*/
 #define ERRO_REQUEST_ID (0u)             /*received ID failled*/
 #define SUPPORT_PHYSICAL_ADDR (1u << 0u) /*support physical ID request */
@@ -104,15 +261,32 @@ typedef struct
     uint8 securityLevel;   /*current security level*/
     tUdsTime xUdsS3ServerTime;      /*uds s3 server time*/
     tUdsTime xSecurityReqLockTime;  /*security request lock time*/
+    uint32 curStateMask;   /*bit of the current session/request ID/security state, see UDS_UpdateStateMask()*/
 } tUdsInfo;
 
+/*states a service can be requested in: every session x request ID type x security level*/
+static const uint8 gs_aUDSSessionModes[] = {DEFALUT_SESSION, PROGRAM_SESSION, EXTEND_SESSION};
+static const uint8 gs_aUDSRequestIdModes[] = {ERRO_REQUEST_ID, SUPPORT_PHYSICAL_ADDR, SUPPORT_FUNCTION_ADDR};
+static const uint8 gs_aUDSSecurityLevels[] = {SECURITY_STATE_LOCKED, SECURITY_STATE_LEVEL_1, SECURITY_STATE_LEVEL_2};
+
+#define UDS_STATE_ITEMS(a) ((uint8)(sizeof(a) / sizeof((a)[0u])))
+#define UDS_STATE_NUM (UDS_STATE_ITEMS(gs_aUDSSessionModes) * \
+                       UDS_STATE_ITEMS(gs_aUDSRequestIdModes) * \
+                       UDS_STATE_ITEMS(gs_aUDSSecurityLevels))
+
+/*bit of state (session, request ID, security) in a permission mask*/
+#define UDS_StateBit(sessionIndex, requestIdIndex, securityIndex) \
+    ((uint32)1u << ((((sessionIndex) * UDS_STATE_ITEMS(gs_aUDSRequestIdModes)) + (requestIdIndex)) * \
+                    UDS_STATE_ITEMS(gs_aUDSSecurityLevels) + (securityIndex)))
+
 /***********************UDS Information Static Global value************************/
 /* UDS support Session mode?��RequestId and Security level config */
 static tUdsInfo gs_stUdsInfo =
 {
     DEFALUT_SESSION,
     ERRO_REQUEST_ID,
-    NONE_SECURITY,
+    SECURITY_STATE_LOCKED,
+    0u,
     0u,
     0u,
 };
@@ -154,9 +328,51 @@ static uint8 UDS_IsSecurityRequestLockTimeout(void)
     return status;
 }
 
+/*index of value in a state list, 0xFF if not there*/
+static uint8 UDS_FindStateIndex(const uint8 *i_pList, const uint8 i_listItems, const uint8 i_value)
+{
+    uint8 index = 0u;
+
+    while((index < i_listItems) && (i_value != i_pList[index]))
+    {
+        index++;
+    }
+
+    return (index < i_listItems) ? index : 0xFFu;
+}
+
+/*recompute the current state bit. Called whenever session, request ID type or security level changes.*/
+static void UDS_UpdateStateMask(void)
+{
+    const uint8 sessionIndex = UDS_FindStateIndex(gs_aUDSSessionModes,
+                                                  UDS_STATE_ITEMS(gs_aUDSSessionModes),
+                                                  gs_stUdsInfo.curSessionMode);
+    const uint8 requestIdIndex = UDS_FindStateIndex(gs_aUDSRequestIdModes,
+                                                    UDS_STATE_ITEMS(gs_aUDSRequestIdModes),
+                                                    gs_stUdsInfo.requsetIdMode);
+    const uint8 securityIndex = UDS_FindStateIndex(gs_aUDSSecurityLevels,
+                                                   UDS_STATE_ITEMS(gs_aUDSSecurityLevels),
+                                                   gs_stUdsInfo.securityLevel);
+
+    if((0xFFu == sessionIndex) || (0xFFu == requestIdIndex) || (0xFFu == securityIndex))
+    {
+        /*unknown state: no service can be requested*/
+        gs_stUdsInfo.curStateMask = 0u;
+    }
+    else
+    {
+        gs_stUdsInfo.curStateMask = UDS_StateBit(sessionIndex, requestIdIndex, securityIndex);
+    }
+}
+
 /***********************UDS Information Global function************************/
 /*set current request id  SUPPORT_PHYSICAL_ADDR/SUPPORT_FUNCTION_ADDR */
-#define UDS_SetRequestIdType(xRequestIDType) (gs_stUdsInfo.requsetIdMode = (xRequestIDType))
+static void UDS_SetRequestIdType(const uint8 i_requestIdType)
+{
+    gs_stUdsInfo.requsetIdMode = i_requestIdType;
+
+    UDS_UpdateStateMask();
+}
 
 /*restart s3server time*/
 void UDS_RestartS3Server(void)
@@ -164,10 +380,76 @@ void UDS_RestartS3Server(void)
     gs_stUdsInfo.xUdsS3ServerTime = UdsAppTimeToCount(gs_stUdsAppCfg.xS3Server);
 }
 
+/*dowload data info*/
+static tDowloadDataInfo gs_stDowloadDataInfo;
+
+/*TransferData pipeline: blocks are collected here while earlier segments program*/
+static uint8 gs_aDowloadSegmentBuf[UDS_DOWNLOAD_SEGMENT_NUM][DOWLOAD_SEGMENT_SIZE] DOWLOAD_SEGMENT_BSS;
+static tDowloadSegment gs_astDowloadSegment[UDS_DOWNLOAD_SEGMENT_NUM];
+static tDowloadPendingInfo gs_stDowloadPendingInfo;
+
+/*EraseMemory routine info*/
+static tEraseMemoryInfo gs_stEraseMemoryInfo;
+
+/*ranges downloaded since the last EraseMemory, oldest first*/
+static tDowloadRangeInfo gs_astDowloadRange[UDS_DOWNLOAD_RANGE_NUM];
+static uint8 gs_dowloadRangeCnt = 0u;
+
+/*decompressor of a compressed download*/
+static boot_lzss_t gs_stDowloadLzss;
+
+/*patch applier of a delta download*/
+static boot_delta_t gs_stDowloadDelta;
+
+/*delta download progress records*/
+static tDeltaProgressInfo gs_stDeltaProgressInfo;
+
+/*upload info*/
+static tUploadDataInfo gs_stUploadDataInfo;
+
+/*performance counters*/
+static tUdsPerfInfo gs_stUdsPerfInfo;
+
+/*abort download. Called when program session is left.*/
+static void UDS_AbortDownload(void)
+{
+    uint8 index = 0u;
+
+    gs_stDowloadDataInfo.isDownloading = FALSE;
+    gs_stUploadDataInfo.isUploading = FALSE;
+
+    /*a parked request is never answered, give its buffer back*/
+    if(NULL_PTR != gs_stDowloadPendingInfo.pstService)
+    {
+        TP_ReleasePdu(gs_stDowloadPendingInfo.stMsg.xPdu);
+        gs_stDowloadPendingInfo.stMsg.xPdu = TP_PDU_NONE;
+    }
+    gs_stDowloadPendingInfo.pstService = NULL_PTR;
+
+    /*sectors already queued finish, the rest of the erase range is dropped*/
+    gs_stEraseMemoryInfo.nextAddr = gs_stEraseMemoryInfo.endAddr;
+
+    /*segments already with the flash engine are recycled by UDS_DownloadMainFun()*/
+    for(index = 0u; index < UDS_DOWNLOAD_SEGMENT_NUM; index++)
+    {
+        if(DOWLOAD_SEGMENT_FILLING == gs_astDowloadSegment[index].state)
+        {
+            gs_astDowloadSegment[index].state = DOWLOAD_SEGMENT_FREE;
+        }
+    }
+}
+
 /*set currrent session mode. DEFAULT_SESSION/PROGRAM_SESSION/EXTEND_SESSION */
 void UDS_SetCurrentSession(const uint8 i_setSessionMode)
 {
+    if(PROGRAM_SESSION != i_setSessionMode)
+    {
+        UDS_AbortDownload();
+    }
+
     gs_stUdsInfo.curSessionMode = i_setSessionMode;
+
+    UDS_UpdateStateMask();
 }
 
 /*********************************************************/
@@ -183,6 +465,24 @@ static void UDS_AppMemset(const uint8 i_setValue, const uint16 i_len, void *m_pv
 /*Is get version?*/
 static uint8 UDS_IsGetVersion(const tUdsAppMsgInfo *m_pstPDUMsg);
 
+/*Is erase memory?*/
+static uint8 UDS_IsEraseMemory(const tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*erase memory routine*/
+static void UDS_EraseMemory(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*Is check sum?*/
+static uint8 UDS_IsCheckSum(const tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*check memory routine*/
+static void UDS_CheckSum(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*Is check programming dependency?*/
+static uint8 UDS_IsCheckDependency(const tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*check programming dependencies routine*/
+static void UDS_CheckDependency(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
 /*transmitted confirm message callback*/
 static void UDS_TXConfrimMsgCallback(uint8 i_status);
 
@@ -208,6 +508,43 @@ static void UDS_RoutineControl(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsA
 /*Tester present service*/
 static void UDS_TesterPresent(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
 
+/*request download*/
+static void UDS_RequestDownload(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*transfer data*/
+static void UDS_TransferData(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*request transfer exit*/
+static void UDS_RequestTransferExit(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*read memory by address*/
+static void UDS_ReadMemoryByAddress(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*request upload*/
+static void UDS_RequestUpload(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*transfer data of an upload*/
+static void UDS_UploadData(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*read data by identifier*/
+static void UDS_ReadDataByIdentifier(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*write data by identifier*/
+static void UDS_WriteDataByIdentifier(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg);
+
+/*DID read/write handlers*/
+static uint8 UDS_ReadFingerprint(uint8 *o_pData);
+static uint8 UDS_WriteFingerprint(const uint8 *i_pData);
+static uint8 UDS_ReadBootVersion(uint8 *o_pData);
+static uint8 UDS_ReadActiveSession(uint8 *o_pData);
+static uint8 UDS_ReadAppVersion(uint8 *o_pData);
+static uint8 UDS_ReadAppName(uint8 *o_pData);
+static uint8 UDS_ReadAppImageInfo(uint8 *o_pData);
+static uint8 UDS_ReadPerfCounters(uint8 *o_pData);
+#ifdef EN_SUPPORT_APP_B
+static uint8 UDS_ReadDeltaProgress(uint8 *o_pData);
+#endif
+
 /***********************UDS service Static Global value************************/
 /*dig serverice config table*/
 const static tUDSService gs_astUDSService[] =
@@ -255,12 +592,127 @@ const static tUDSService gs_astUDSService[] =
 		SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
 		NONE_SECURITY,
         UDS_TesterPresent
-    },		
+    },
+
+    /*request download*/
+    {
+        0x34u,
+        PROGRAM_SESSION,
+        SUPPORT_PHYSICAL_ADDR,
+        SECURITY_LEVEL_1,
+        UDS_RequestDownload
+    },
+
+    /*transfer data*/
+    {
+        0x36u,
+        PROGRAM_SESSION,
+        SUPPORT_PHYSICAL_ADDR,
+        SECURITY_LEVEL_1,
+        UDS_TransferData
+    },
+
+    /*request transfer exit*/
+    {
+        0x37u,
+        PROGRAM_SESSION,
+        SUPPORT_PHYSICAL_ADDR,
+        SECURITY_LEVEL_1,
+        UDS_RequestTransferExit
+    },
+
+    /*read memory by address*/
+    {
+        0x23u,
+        PROGRAM_SESSION | EXTEND_SESSION,
+        SUPPORT_PHYSICAL_ADDR,
+        SECURITY_UNLOCKED,
+        UDS_ReadMemoryByAddress
+    },
+
+    /*request upload*/
+    {
+        0x35u,
+        PROGRAM_SESSION,
+        SUPPORT_PHYSICAL_ADDR,
+        SECURITY_UNLOCKED,
+        UDS_RequestUpload
+    },
+
+    /*read data by identifier, session and security checked per DID*/
+    {
+        0x22u,
+        DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION,
+        SUPPORT_PHYSICAL_ADDR | SUPPORT_FUNCTION_ADDR,
+        NONE_SECURITY,
+        UDS_ReadDataByIdentifier
+    },
+
+    /*write data by identifier, session and security checked per DID*/
+    {
+        0x2Eu,
+        PROGRAM_SESSION | EXTEND_SESSION,
+        SUPPORT_PHYSICAL_ADDR,
+        NONE_SECURITY,
+        UDS_WriteDataByIdentifier
+    },
+};
+
+/*DID registry, sorted by DID for the binary search in UDS_FindDataIdentifier()*/
+#define DID_ALL_SESSION (DEFALUT_SESSION | PROGRAM_SESSION | EXTEND_SESSION)
+#define DID_BOOT_VERSION_LEN ((uint16)(sizeof(EASY_BOOT_VERSION) - 1u))
+
+const static tUDS_DataIdentifierInfo gs_astUDSDataIdentifier[] =
+{
+    /*fingerprint of the last programming*/
+    {0xF15Au, DID_FINGERPRINT_LEN, DID_ALL_SESSION, NONE_SECURITY, PROGRAM_SESSION, SECURITY_LEVEL_1,
+     UDS_ReadFingerprint, UDS_WriteFingerprint},
+
+    /*boot software identification*/
+    {0xF180u, DID_BOOT_VERSION_LEN, DID_ALL_SESSION, NONE_SECURITY, 0u, NONE_SECURITY,
+     UDS_ReadBootVersion, NULL_PTR},
+
+    /*active diagnostic session*/
+    {0xF186u, 1u, DID_ALL_SESSION, NONE_SECURITY, 0u, NONE_SECURITY,
+     UDS_ReadActiveSession, NULL_PTR},
+
+    /*application software version (app_metadata_t version)*/
+    {0xF189u, APP_VERSION_MAX_LEN, DID_ALL_SESSION, NONE_SECURITY, 0u, NONE_SECURITY,
+     UDS_ReadAppVersion, NULL_PTR},
+
+    /*application name (app_metadata_t app_name)*/
+    {0xF197u, APP_NAME_MAX_LEN, DID_ALL_SESSION, NONE_SECURITY, 0u, NONE_SECURITY,
+     UDS_ReadAppName, NULL_PTR},
+
+    /*application image: flash start address, size, CRC32 (app_metadata_t)*/
+    {0xFD00u, 12u, DID_ALL_SESSION, NONE_SECURITY, 0u, NONE_SECURITY,
+     UDS_ReadAppImageInfo, NULL_PTR},
+
+    /*performance counters, see tUdsPerfInfo, free TP buffers and tTPRxStatistics*/
+    {0xFD10u, 36u, DID_ALL_SESSION, NONE_SECURITY, 0u, NONE_SECURITY,
+     UDS_ReadPerfCounters, NULL_PTR},
+
+#ifdef EN_SUPPORT_APP_B
+    /*delta download a reset interrupted, see UDS_ReadDeltaProgress()*/
+    {0xFD20u, 24u, PROGRAM_SESSION, NONE_SECURITY, 0u, NONE_SECURITY,
+     UDS_ReadDeltaProgress, NULL_PTR},
+#endif
 };
 
+#define UDS_DID_NUM (sizeof(gs_astUDSDataIdentifier) / sizeof(gs_astUDSDataIdentifier[0u]))
+
 /*Get bootloader version*/
 const static uint8 gs_aGetVersion[] = {0x31u, 0x01, 0x03, 0xFFu};
 
+/*Erase memory*/
+const static uint8 gs_aEraseMemory[] = {0x31u, 0x01u, 0xFFu, 0x00u};
+
+/*Check memory*/
+const static uint8 gs_aCheckSum[] = {0x31u, 0x01u, 0x02u, 0x02u};
+
+/*Check programming dependencies*/
+const static uint8 gs_aCheckDependency[] = {0x31u, 0x01u, 0xFFu, 0x01u};
+
 /**********************UDS service correlation main function realizing************************/
 /*dig session*/
 static void UDS_DigSession(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
@@ -389,8 +841,6 @@ static void UDS_CommunicationControl(struct UDSServiceInfo* i_pstUDSServiceInfo,
 /*routine control*/
 static void UDS_RoutineControl(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
 {
-    uint8 ret = FALSE;
-    uint32 ReceivedCrc = 0u;
 	uint8 aSWVersion[] = APP_SW_VERSION;
 	uint8 aHWVersion[] = APP_HW_VERSION;
 	uint8 offset = 0u;
@@ -423,7 +873,25 @@ static void UDS_RoutineControl(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsA
 
 		m_pstPDUMsg->xDataLen = offset;
 	}
-	
+
+	/*Is erase memory*/
+	else if(TRUE == UDS_IsEraseMemory(m_pstPDUMsg))
+	{
+		UDS_EraseMemory(i_pstUDSServiceInfo, m_pstPDUMsg);
+	}
+
+	/*Is check sum*/
+	else if(TRUE == UDS_IsCheckSum(m_pstPDUMsg))
+	{
+		UDS_CheckSum(i_pstUDSServiceInfo, m_pstPDUMsg);
+	}
+
+	/*Is check programming dependency*/
+	else if(TRUE == UDS_IsCheckDependency(m_pstPDUMsg))
+	{
+		UDS_CheckDependency(i_pstUDSServiceInfo, m_pstPDUMsg);
+	}
+
     else
     {
         /*don't have this routine control ID*/
@@ -461,134 +929,2065 @@ static void UDS_TesterPresent(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAp
     }
 }
 
-/*do reset mcu*/
-static void UDS_DoResetMCU(uint8 Txstatus)
+/*read big endian uint32 from request*/
+static uint32 UDS_GetUint32(const uint8 *i_pBuf)
 {
-    if(TX_MSG_SUCCESSFUL == Txstatus)
-    {
-    	/*request enter bootloader mode*/
-    	Boot_RequestEnterBootloader();
-		
-        /*reset ECU*/
-        WATCHDOG_HAL_SystemRest();
-        while(1)
-        {
-            /*wait watch dog reset mcu*/
-        }
-    }
+    return ((uint32)i_pBuf[0u] << 24u) | ((uint32)i_pBuf[1u] << 16u) |
+           ((uint32)i_pBuf[2u] << 8u) | (uint32)i_pBuf[3u];
 }
 
-/**********************UDS service correlation other function realizing************************/
-/* get uds service config information */
-tUDSService* UDS_GetUDSServiceInfo(uint8 *m_pSupServItem)
+/*Is download range inside the download target slot?*/
+static uint8 UDS_IsDownloadRangeValid(const tAPPType i_slot, const uint32 i_startAddr, const uint32 i_dataLen)
 {
-    ASSERT(NULL_PTR == m_pSupServItem);
-    
-    *m_pSupServItem = sizeof(gs_astUDSService) / sizeof(gs_astUDSService[0u]);
-
-    return (tUDSService*) &gs_astUDSService[0u];
-}
+    const uint32 slotAddr = boot_ctrl_slot_addr(i_slot);
 
-/* If Rx UDS msg, set UDS layer received message TURE */
-void UDS_SetIsRxUdsMsg(const uint8 i_setValue)
-{
+    if((0u == slotAddr) || (0u == i_dataLen) || (i_dataLen > BOOT_SLOT_SIZE))
+    {
+        return FALSE;
+    }
 
-}
+    if((i_startAddr < slotAddr) || ((i_startAddr - slotAddr) > (BOOT_SLOT_SIZE - i_dataLen)))
+    {
+        return FALSE;
+    }
 
-uint8 UDS_IsRxUdsMsg(void)
-{
     return TRUE;
 }
 
-/*set negative erro code*/
-void UDS_SetNegativeErroCode(const uint8 i_UDSServiceNum,
-                         const uint8 i_erroCode,
-                         tUdsAppMsgInfo *m_pstPDUMsg)
-{
-    ASSERT(NULL_PTR == m_pstPDUMsg);
-
-    m_pstPDUMsg->aDataBuf[0u] = NEGTIVE_ID;
-    m_pstPDUMsg->aDataBuf[1u] = i_UDSServiceNum;
-    m_pstPDUMsg->aDataBuf[2u] = i_erroCode;
-    m_pstPDUMsg->xDataLen = 3u;
-}
-
-/*Is current session DEFAULT return TRUE, else return FALSE.*/
-uint8 UDS_IsCurDefaultSession(void)
+/*Is the dataFormatIdentifier one RequestDownload can take?
+  A delta needs the installed image in the other slot as its source, so only with A/B slots.*/
+static uint8 UDS_IsDownloadFormatValid(const uint8 i_dataFormatId)
 {
-    uint8 isCurDefaultSessionStatus = FALSE;
-
-    if(DEFALUT_SESSION == gs_stUdsInfo.curSessionMode)
+    if((DOWLOAD_FORMAT_RAW == i_dataFormatId) || (DOWLOAD_FORMAT_LZSS == i_dataFormatId))
     {
-        isCurDefaultSessionStatus = TRUE;
+        return TRUE;
     }
-    else
+
+#ifdef EN_SUPPORT_APP_B
+    if((DOWLOAD_FORMAT_DELTA == i_dataFormatId) || (DOWLOAD_FORMAT_DELTA_RESUME == i_dataFormatId))
     {
-        isCurDefaultSessionStatus = FALSE;
+        return TRUE;
     }
+#endif
 
-    return isCurDefaultSessionStatus;
+    return FALSE;
 }
 
-/*Is S3server timeout?*/
-uint8 UDS_IsS3ServerTimeout(void)
+/*Is every pipeline segment free (nothing buffered, no flash job in flight)?*/
+static uint8 UDS_IsDownloadIdle(void)
 {
-    uint8 TimeoutStatus = FALSE;
+    uint8 index = 0u;
 
-    if(0u == gs_stUdsInfo.xUdsS3ServerTime)
+    /*a delta progress record still being written counts as in flight*/
+    if((HAL_ERR_RESOURCE_BUSY == hal_flash_job_status(&gs_stDeltaProgressInfo.stEraseJob)) ||
+       (HAL_ERR_RESOURCE_BUSY == hal_flash_job_status(&gs_stDeltaProgressInfo.stJob)))
     {
-        TimeoutStatus = TRUE;
+        return FALSE;
     }
-    else
+
+    for(index = 0u; index < UDS_DOWNLOAD_SEGMENT_NUM; index++)
     {
-        TimeoutStatus = FALSE;
+        if(DOWLOAD_SEGMENT_FREE != gs_astDowloadSegment[index].state)
+        {
+            return FALSE;
+        }
     }
 
-    return TimeoutStatus;
+    return TRUE;
 }
 
-/*Is current session can request?*/
-uint8 UDS_IsCurSessionCanRequest(uint8 i_sessionMode)
+/*bytes the pipeline can take right now. Segments are filled and freed in ring order.*/
+static uint32 UDS_GetDownloadBufferSpace(void)
 {
-    uint8 status = FALSE;
+    const uint32 writeAddr = gs_stDowloadDataInfo.startAddr + gs_stDowloadDataInfo.receivedLen;
+    uint32 space = 0u;
+    uint8 index = 0u;
+    uint8 segment = gs_stDowloadDataInfo.fillSegment;
 
-    if((i_sessionMode & gs_stUdsInfo.curSessionMode) == gs_stUdsInfo.curSessionMode)
-    {
-        status = TRUE;
-    }
-    else
+    for(index = 0u; index < UDS_DOWNLOAD_SEGMENT_NUM; index++)
     {
-        status = FALSE;
+        if(DOWLOAD_SEGMENT_PROGRAMMING == gs_astDowloadSegment[segment].state)
+        {
+            break;
+        }
+
+        /*the segment being filled only has the part behind the current address left*/
+        space += (0u == index) ? (DOWLOAD_SEGMENT_SIZE - (writeAddr % DOWLOAD_SEGMENT_SIZE)) : DOWLOAD_SEGMENT_SIZE;
+        segment = (uint8)((segment + 1u) % UDS_DOWNLOAD_SEGMENT_NUM);
     }
 
-    return status;
+    return space;
 }
 
-/*save received request id. If receved physical/function/none phy and function ID set rceived physicali/function/erro ID.*/
-void UDS_SaveRequestIdType(const uint32 i_serRequestID)
+/*hand a segment to the flash engine, trimmed and padded to whole write units*/
+static uint8 UDS_ProgramDownloadSegment(const uint8 i_segment)
 {
-    if(i_serRequestID == TP_GetConfigRxMsgPHYID())
+    tDowloadSegment *pstSegment = &gs_astDowloadSegment[i_segment];
+    uint8 *pBuf = gs_aDowloadSegmentBuf[i_segment];
+    const uint32 start = pstSegment->startOffset - (pstSegment->startOffset % HAL_FLASH_WRITE_UNIT);
+    const uint32 end = (pstSegment->fillLen + HAL_FLASH_WRITE_UNIT - 1u) / HAL_FLASH_WRITE_UNIT * HAL_FLASH_WRITE_UNIT;
+
+    fsl_memset(&pBuf[start], 0xFFu, pstSegment->startOffset - start);
+    fsl_memset(&pBuf[pstSegment->fillLen], 0xFFu, end - pstSegment->fillLen);
+
+    fsl_memset(&pstSegment->stJob, 0u, sizeof(pstSegment->stJob));
+    pstSegment->stJob.type = HAL_FLASH_JOB_PROGRAM;
+    pstSegment->stJob.addr = pstSegment->flashAddr + start;
+    pstSegment->stJob.size = end - start;
+    pstSegment->stJob.data = &pBuf[start];
+    pstSegment->state = DOWLOAD_SEGMENT_PROGRAMMING;
+
+    if(HAL_ERR_SUCCESS != hal_flash_submit(&pstSegment->stJob))
     {
-        UDS_SetRequestIdType(SUPPORT_PHYSICAL_ADDR);
+        pstSegment->state = DOWLOAD_SEGMENT_FREE;
+
+        return FALSE;
     }
-    else if(i_serRequestID == TP_GetConfigRxMsgFUNID())
+
+    return TRUE;
+}
+
+/*CRC32 of a buffer through the streaming CRC API. Returns HAL_ERR_SUCCESS or the CRC error.*/
+static int32_t UDS_Crc32(const uint8 *i_pData, const uint32 i_len, uint32 *o_pCrc)
+{
+    hal_crc32_ctx_t stCtx;
+    int32_t ret = hal_crc32_begin(&stCtx);
+
+    if(HAL_ERR_SUCCESS == ret)
     {
-        UDS_SetRequestIdType(SUPPORT_FUNCTION_ADDR);
+        ret = hal_crc32_update(&stCtx, i_pData, i_len);
     }
-    else
+    if(HAL_ERR_SUCCESS == ret)
     {
-        UDS_SetRequestIdType(ERRO_REQUEST_ID);
+        ret = hal_crc32_final(&stCtx, o_pCrc);
     }
+
+    return ret;
 }
 
-/*Is current received id can request?*/
-uint8 UDS_IsCurRxIdCanRequest(uint8 i_serRequestIdMode)
+/*fold i_len more bytes into the image CRC. The piece is computed on its own and combined, so other CRC
+  users may take the channel between TransferData blocks. Returns FALSE when the CRC could not be computed.*/
+static uint8 UDS_FoldDownloadCrc(const uint8 *i_pData, const uint32 i_len)
 {
-    uint8 status = 0u;
+    uint32 pieceCrc = 0u;
 
-    if((i_serRequestIdMode & gs_stUdsInfo.requsetIdMode) == gs_stUdsInfo.requsetIdMode)
+    if(HAL_ERR_SUCCESS != UDS_Crc32(i_pData, i_len, &pieceCrc))
     {
-        status = TRUE;
+        return FALSE;
+    }
+
+    gs_stDowloadDataInfo.dataCrc = hal_crc32_combine(gs_stDowloadDataInfo.dataCrc, pieceCrc, i_len);
+
+    return TRUE;
+}
+
+/*copy TransferData payload into the pipeline. Caller checked UDS_GetDownloadBufferSpace().*/
+static uint8 UDS_BufferDownloadData(const uint8 *i_pData, uint32 i_dataLen)
+{
+    tDowloadSegment *pstSegment = NULL_PTR;
+    uint32 writeAddr = gs_stDowloadDataInfo.startAddr + gs_stDowloadDataInfo.receivedLen;
+    uint32 copyLen = 0u;
+
+    ASSERT(NULL_PTR == i_pData);
+
+    while(0u != i_dataLen)
+    {
+        pstSegment = &gs_astDowloadSegment[gs_stDowloadDataInfo.fillSegment];
+
+        if(DOWLOAD_SEGMENT_FREE == pstSegment->state)
+        {
+            pstSegment->flashAddr = writeAddr - (writeAddr % DOWLOAD_SEGMENT_SIZE);
+            pstSegment->startOffset = writeAddr - pstSegment->flashAddr;
+            pstSegment->fillLen = pstSegment->startOffset;
+            pstSegment->hasDeltaProgress = FALSE;
+            pstSegment->state = DOWLOAD_SEGMENT_FILLING;
+        }
+
+        copyLen = DOWLOAD_SEGMENT_SIZE - pstSegment->fillLen;
+        if(copyLen > i_dataLen)
+        {
+            copyLen = i_dataLen;
+        }
+
+        fsl_memcpy(&gs_aDowloadSegmentBuf[gs_stDowloadDataInfo.fillSegment][pstSegment->fillLen], i_pData, copyLen);
+        pstSegment->fillLen += copyLen;
+        writeAddr += copyLen;
+        i_pData += copyLen;
+        i_dataLen -= copyLen;
+
+        /*full segment: program it in the background and move on*/
+        if(DOWLOAD_SEGMENT_SIZE == pstSegment->fillLen)
+        {
+            if(TRUE != UDS_ProgramDownloadSegment(gs_stDowloadDataInfo.fillSegment))
+            {
+                return FALSE;
+            }
+
+            gs_stDowloadDataInfo.fillSegment = (uint8)((gs_stDowloadDataInfo.fillSegment + 1u) % UDS_DOWNLOAD_SEGMENT_NUM);
+        }
+    }
+
+    return TRUE;
+}
+
+/*segment the next decoded byte goes to, opened at the current write address when free*/
+static tDowloadSegment *UDS_OpenFillSegment(void)
+{
+    const uint32 writeAddr = gs_stDowloadDataInfo.startAddr + gs_stDowloadDataInfo.receivedLen;
+    tDowloadSegment *pstSegment = &gs_astDowloadSegment[gs_stDowloadDataInfo.fillSegment];
+
+    if(DOWLOAD_SEGMENT_FREE == pstSegment->state)
+    {
+        pstSegment->flashAddr = writeAddr - (writeAddr % DOWLOAD_SEGMENT_SIZE);
+        pstSegment->startOffset = writeAddr - pstSegment->flashAddr;
+        pstSegment->fillLen = pstSegment->startOffset;
+        pstSegment->hasDeltaProgress = FALSE;
+        pstSegment->state = DOWLOAD_SEGMENT_FILLING;
+    }
+
+    return pstSegment;
+}
+
+/*account for i_len bytes a decoder wrote behind the fill segment's data: image CRC, length,
+  and the segment is programmed once full. FALSE if the CRC or the programming failed.*/
+static uint8 UDS_CommitDecodedData(const uint8 *i_pData, const uint32 i_len)
+{
+    tDowloadSegment *pstSegment = &gs_astDowloadSegment[gs_stDowloadDataInfo.fillSegment];
+
+    if(TRUE != UDS_FoldDownloadCrc(i_pData, i_len))
+    {
+        return FALSE;
+    }
+
+    gs_stDowloadDataInfo.receivedLen += i_len;
+    pstSegment->fillLen += i_len;
+
+    if(DOWLOAD_SEGMENT_SIZE == pstSegment->fillLen)
+    {
+        /*the applier just stopped at the segment end: a state a reset can resume from*/
+        pstSegment->hasDeltaProgress = (DOWLOAD_FORMAT_DELTA == gs_stDowloadDataInfo.dataFormat) ? TRUE : FALSE;
+        if(TRUE == pstSegment->hasDeltaProgress)
+        {
+            pstSegment->deltaOutCrc = gs_stDowloadDataInfo.dataCrc;
+            pstSegment->stDeltaState = gs_stDowloadDelta;
+        }
+
+        if(TRUE != UDS_ProgramDownloadSegment(gs_stDowloadDataInfo.fillSegment))
+        {
+            return FALSE;
+        }
+
+        gs_stDowloadDataInfo.fillSegment = (uint8)((gs_stDowloadDataInfo.fillSegment + 1u) % UDS_DOWNLOAD_SEGMENT_NUM);
+    }
+
+    return TRUE;
+}
+
+/*decompress TransferData payload straight into the pipeline and fold the output into the image CRC.
+  Caller checked UDS_GetDownloadBufferSpace() against the worst case output.
+  Returns FALSE with *o_pNrc TDS for a corrupt stream or one producing more than the announced size,
+  GPF when the CRC or the flash failed.*/
+static uint8 UDS_InflateDownloadData(const uint8 *i_pData, uint32 i_dataLen, uint8 *o_pNrc)
+{
+    tDowloadSegment *pstSegment = NULL_PTR;
+    uint8 *pOut = NULL_PTR;
+    uint32 outSize = 0u;
+    uint32 outLen = 0u;
+    uint8 extra = 0u;
+
+    ASSERT(NULL_PTR == i_pData);
+
+    do
+    {
+        pstSegment = UDS_OpenFillSegment();
+        outSize = UDS_MIN_LEN(DOWLOAD_SEGMENT_SIZE - pstSegment->fillLen,
+                              gs_stDowloadDataInfo.dataLen - gs_stDowloadDataInfo.receivedLen);
+        pOut = &gs_aDowloadSegmentBuf[gs_stDowloadDataInfo.fillSegment][pstSegment->fillLen];
+
+        if(HAL_ERR_SUCCESS != boot_lzss_decode(&gs_stDowloadLzss, &i_pData, &i_dataLen, pOut, outSize, &outLen))
+        {
+            *o_pNrc = TDS;
+
+            return FALSE;
+        }
+
+        if(TRUE != UDS_CommitDecodedData(pOut, outLen))
+        {
+            *o_pNrc = GPF;
+
+            return FALSE;
+        }
+    }while((outLen == outSize) && (gs_stDowloadDataInfo.receivedLen != gs_stDowloadDataInfo.dataLen));
+
+    /*image complete: whatever is left may only be padding bits*/
+    if(gs_stDowloadDataInfo.receivedLen == gs_stDowloadDataInfo.dataLen)
+    {
+        if((HAL_ERR_SUCCESS != boot_lzss_decode(&gs_stDowloadLzss, &i_pData, &i_dataLen, &extra, 1u, &outLen)) ||
+           (0u != outLen) || (0u != i_dataLen))
+        {
+            *o_pNrc = TDS;
+
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+/*Is part of the EraseMemory range not erased yet (unqueued or in flight)?*/
+static uint8 UDS_IsEraseBusy(void)
+{
+    uint8 index = 0u;
+
+    if(gs_stEraseMemoryInfo.nextAddr < gs_stEraseMemoryInfo.endAddr)
+    {
+        return TRUE;
+    }
+
+    for(index = 0u; index < UDS_ERASE_AHEAD_SECTORS; index++)
+    {
+        if(HAL_ERR_RESOURCE_BUSY == hal_flash_job_status(&gs_stEraseMemoryInfo.astJob[index]))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/*sector erase finished, called from hal_flash_main_function()*/
+static void UDS_EraseDoneCallback(hal_flash_job_t *i_pstJob, int32_t i_result)
+{
+    (void)i_pstJob;
+
+    if(HAL_ERR_SUCCESS != i_result)
+    {
+        /*data already buffered for this range can't be programmed either*/
+        gs_stEraseMemoryInfo.isEraseFailed = TRUE;
+        gs_stDowloadDataInfo.isProgramFailed = TRUE;
+    }
+}
+
+/*queue sector erases of the EraseMemory range below i_limitAddr while an erase job is free.
+  Returns TRUE once every sector below i_limitAddr is queued.*/
+static uint8 UDS_QueueErase(const uint32 i_limitAddr)
+{
+    hal_flash_job_t *pstJob = NULL_PTR;
+    uint32 limitAddr = UDS_MIN_LEN(i_limitAddr, gs_stEraseMemoryInfo.endAddr);
+    uint8 index = 0u;
+
+    for(index = 0u; (index < UDS_ERASE_AHEAD_SECTORS) && (gs_stEraseMemoryInfo.nextAddr < limitAddr); index++)
+    {
+        pstJob = &gs_stEraseMemoryInfo.astJob[index];
+
+        if(HAL_ERR_RESOURCE_BUSY == hal_flash_job_status(pstJob))
+        {
+            continue;
+        }
+
+        /*queued behind the program jobs already submitted, ahead of those for this sector*/
+        if(HAL_ERR_SUCCESS != hal_flash_erase_ahead(pstJob, gs_stEraseMemoryInfo.nextAddr, HAL_FLASH_SECTOR_SIZE))
+        {
+            UDS_EraseDoneCallback(pstJob, HAL_ERR_FLASH_ERASE_FAILED);
+            gs_stEraseMemoryInfo.nextAddr = gs_stEraseMemoryInfo.endAddr;
+
+            return FALSE;
+        }
+
+        gs_stEraseMemoryInfo.nextAddr += HAL_FLASH_SECTOR_SIZE;
+    }
+
+    return (gs_stEraseMemoryInfo.nextAddr >= limitAddr) ? TRUE : FALSE;
+}
+
+/*erase background work. While a download runs the erase stays UDS_ERASE_AHEAD_SECTORS ahead of it,
+  so segment program jobs never queue behind a long run of erases.*/
+static void UDS_EraseMainFun(void)
+{
+    uint32 limitAddr = gs_stEraseMemoryInfo.endAddr;
+#if (UDS_ERASE_AHEAD)
+    const uint32 writeAddr = gs_stDowloadDataInfo.startAddr + gs_stDowloadDataInfo.receivedLen;
+
+    if(TRUE == gs_stDowloadDataInfo.isDownloading)
+    {
+        limitAddr = writeAddr - (writeAddr % HAL_FLASH_SECTOR_SIZE) + (UDS_ERASE_AHEAD_SECTORS * HAL_FLASH_SECTOR_SIZE);
+    }
+#endif
+
+    (void)UDS_QueueErase(limitAddr);
+}
+
+/*apply delta patch payload into the pipeline, as far as free segments and the erase-ahead allow.
+  A copy can produce far more than its few patch bytes, so instead of reserving the worst case the block is
+  applied in steps: returns FALSE with *o_pNrc 0 when the flash has to catch up first (blockOffset remembers
+  where to go on), FALSE with the NRC for a patch that can't be applied, TRUE once the block is used up.*/
+static uint8 UDS_PatchDownloadData(const uint8 *i_pData, const uint32 i_dataLen, uint8 *o_pNrc)
+{
+    tDowloadSegment *pstSegment = NULL_PTR;
+    const uint8 *pIn = &i_pData[gs_stDowloadDataInfo.blockOffset];
+    uint32 inLen = i_dataLen - gs_stDowloadDataInfo.blockOffset;
+    uint32 writeAddr = 0u;
+    uint32 limit = 0u;
+    uint32 outSize = 0u;
+    uint32 outLen = 0u;
+    uint8 *pOut = NULL_PTR;
+    uint8 extra = 0u;
+    int32_t ret = HAL_ERR_SUCCESS;
+
+    ASSERT(NULL_PTR == i_pData);
+
+    *o_pNrc = 0u;
+
+    do
+    {
+        writeAddr = gs_stDowloadDataInfo.startAddr + gs_stDowloadDataInfo.receivedLen;
+
+        /*image complete: the applier refuses anything but the end of the patch*/
+        if(gs_stDowloadDataInfo.receivedLen == gs_stDowloadDataInfo.dataLen)
+        {
+            ret = boot_delta_apply(&gs_stDowloadDelta, &pIn, &inLen, &extra, 1u, &outLen);
+            break;
+        }
+
+        limit = UDS_MIN_LEN(UDS_GetDownloadBufferSpace(), gs_stDowloadDataInfo.dataLen - gs_stDowloadDataInfo.receivedLen);
+        if(TRUE != UDS_QueueErase(writeAddr + limit))
+        {
+            limit = (gs_stEraseMemoryInfo.nextAddr > writeAddr) ? (gs_stEraseMemoryInfo.nextAddr - writeAddr) : 0u;
+        }
+
+        if(0u == limit)
+        {
+            gs_stDowloadDataInfo.blockOffset = i_dataLen - inLen;
+
+            return FALSE;
+        }
+
+        pstSegment = UDS_OpenFillSegment();
+        outSize = UDS_MIN_LEN(DOWLOAD_SEGMENT_SIZE - pstSegment->fillLen, limit);
+        pOut = &gs_aDowloadSegmentBuf[gs_stDowloadDataInfo.fillSegment][pstSegment->fillLen];
+
+        ret = boot_delta_apply(&gs_stDowloadDelta, &pIn, &inLen, pOut, outSize, &outLen);
+        if((HAL_ERR_SUCCESS == ret) && (TRUE != UDS_CommitDecodedData(pOut, outLen)))
+        {
+            ret = HAL_ERR_FLASH_WRITE_FAILED;
+        }
+    }while((HAL_ERR_SUCCESS == ret) && (outLen == outSize));
+
+    if(HAL_ERR_SUCCESS != ret)
+    {
+        /*patch made for another installed image / corrupt patch / flash*/
+        *o_pNrc = (HAL_ERR_FLASH_VERIFY_FAILED == ret) ? CNC : ((HAL_ERR_INVALID_PARAM == ret) ? TDS : GPF);
+
+        return FALSE;
+    }
+
+    gs_stDowloadDataInfo.blockOffset = 0u;
+
+    return TRUE;
+}
+
+/*append the delta progress of a segment that is in flash. Skipped while the previous record still programs,
+  the next segment brings a newer one; out of order completions never move the record back.*/
+static void UDS_SaveDeltaProgress(const tDowloadSegment *i_pstSegment)
+{
+    tDeltaProgressInfo *pstProgress = &gs_stDeltaProgressInfo;
+
+    if((TRUE != i_pstSegment->hasDeltaProgress) || (TRUE == gs_stDowloadDataInfo.isProgramFailed) ||
+       (i_pstSegment->stDeltaState.out_total <= pstProgress->savedLen) ||
+       (HAL_ERR_RESOURCE_BUSY == hal_flash_job_status(&pstProgress->stEraseJob)) ||
+       (HAL_ERR_RESOURCE_BUSY == hal_flash_job_status(&pstProgress->stJob)))
+    {
+        return;
+    }
+
+    /*sector full: start it over, the erase is queued ahead of the record*/
+    if((pstProgress->nextAddr + sizeof(pstProgress->stRecord)) > (BOOT_DELTA_PROGRESS_ADDR + HAL_FLASH_SECTOR_SIZE))
+    {
+        fsl_memset(&pstProgress->stEraseJob, 0u, sizeof(pstProgress->stEraseJob));
+        pstProgress->stEraseJob.type = HAL_FLASH_JOB_ERASE;
+        pstProgress->stEraseJob.addr = BOOT_DELTA_PROGRESS_ADDR;
+        pstProgress->stEraseJob.size = HAL_FLASH_SECTOR_SIZE;
+
+        if(HAL_ERR_SUCCESS != hal_flash_submit(&pstProgress->stEraseJob))
+        {
+            return;
+        }
+
+        pstProgress->nextAddr = BOOT_DELTA_PROGRESS_ADDR;
+    }
+
+    boot_delta_progress_make(&pstProgress->stRecord, &i_pstSegment->stDeltaState,
+                             gs_stDowloadDataInfo.startAddr, i_pstSegment->deltaOutCrc);
+
+    fsl_memset(&pstProgress->stJob, 0u, sizeof(pstProgress->stJob));
+    pstProgress->stJob.type = HAL_FLASH_JOB_PROGRAM;
+    pstProgress->stJob.addr = pstProgress->nextAddr;
+    pstProgress->stJob.size = sizeof(pstProgress->stRecord);
+    pstProgress->stJob.data = (const uint8 *)&pstProgress->stRecord;
+
+    if(HAL_ERR_SUCCESS == hal_flash_submit(&pstProgress->stJob))
+    {
+        pstProgress->nextAddr += sizeof(pstProgress->stRecord);
+        pstProgress->savedLen = i_pstSegment->stDeltaState.out_total;
+    }
+}
+
+/*0x78 of a parked request sent (or not): schedule the next one*/
+static void UDS_DownloadMoreTimeCallback(uint8 i_TxStatus)
+{
+    if(TX_MSG_SUCCESSFUL != i_TxStatus)
+    {
+        /*try again on the next main function call*/
+        gs_stDowloadPendingInfo.xResponsePendingTime = 0u;
+    }
+}
+
+/*park a request until the flash engine catches up. The tester gets 0x78 now and the final response later.*/
+static void UDS_DelayDownloadResponse(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    if(m_pstPDUMsg != &gs_stDowloadPendingInfo.stMsg)
+    {
+        fsl_memcpy(&gs_stDowloadPendingInfo.stMsg, m_pstPDUMsg, sizeof(gs_stDowloadPendingInfo.stMsg));
+        TP_RetainPdu(gs_stDowloadPendingInfo.stMsg.xPdu);
+        gs_stUdsPerfInfo.parkedCnt++;
+        gs_stDowloadPendingInfo.xResponsePendingTime = UdsAppTimeToCount(UDS_RESPONSE_PENDING_TIME);
+
+        UDS_RequestMoreTime(i_pstUDSServiceInfo->serNum, &UDS_DownloadMoreTimeCallback);
+
+        /*the 0x78 is the only response for now*/
+        m_pstPDUMsg->xDataLen = 0u;
+    }
+
+    gs_stDowloadPendingInfo.pstService = i_pstUDSServiceInfo;
+}
+
+/*erase memory routine: 31 01 FF 00 44 address size, range inside the download target slot*/
+static void UDS_EraseMemory(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint32 startAddr = 0u;
+    uint32 dataLen = 0u;
+    uint8 index = 0u;
+    const tAPPType targetSlot = boot_ctrl_get_inactive_slot();
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if((TRUE != UDS_IsCurSessionCanRequest(PROGRAM_SESSION)) ||
+       (TRUE != UDS_IsCurRxIdCanRequest(SUPPORT_PHYSICAL_ADDR)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE != UDS_IsCurSecurityLevelRequest(SECURITY_LEVEL_1))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, SAD, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(ERASE_MEMORY_REQUEST_LEN != m_pstPDUMsg->xDataLen)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    startAddr = UDS_GetUint32(&m_pstPDUMsg->aDataBuf[5u]);
+    dataLen = UDS_GetUint32(&m_pstPDUMsg->aDataBuf[5u + DOWLOAD_DATA_ADDR_LEN]);
+
+    if((DOWLOAD_ADDR_LEN_FORMAT != m_pstPDUMsg->aDataBuf[4u]) ||
+       (TRUE != UDS_IsDownloadRangeValid(targetSlot, startAddr, dataLen)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*another request is parked, or the range would change under an active transfer*/
+    if(((NULL_PTR != gs_stDowloadPendingInfo.pstService) && (m_pstPDUMsg != &gs_stDowloadPendingInfo.stMsg)) ||
+       (TRUE == gs_stDowloadDataInfo.isDownloading) || (TRUE == gs_stUploadDataInfo.isUploading))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, CNC, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(m_pstPDUMsg != &gs_stDowloadPendingInfo.stMsg)
+    {
+        gs_stEraseMemoryInfo.isRangeStarted = FALSE;
+    }
+
+    if(TRUE != gs_stEraseMemoryInfo.isRangeStarted)
+    {
+        /*the previous range is still erasing: take over once it is done*/
+        if(TRUE == UDS_IsEraseBusy())
+        {
+            UDS_DelayDownloadResponse(i_pstUDSServiceInfo, m_pstPDUMsg);
+
+            return;
+        }
+
+        /*slot content is about to change: drop its verified-image cache entry*/
+        if(HAL_ERR_SUCCESS != boot_verify_invalidate(targetSlot))
+        {
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, CNC, m_pstPDUMsg);
+
+            return;
+        }
+
+        for(index = 0u; index < UDS_ERASE_AHEAD_SECTORS; index++)
+        {
+            gs_stEraseMemoryInfo.astJob[index].complete = &UDS_EraseDoneCallback;
+        }
+
+        gs_stEraseMemoryInfo.startAddr = startAddr - (startAddr % HAL_FLASH_SECTOR_SIZE);
+        gs_stEraseMemoryInfo.nextAddr = gs_stEraseMemoryInfo.startAddr;
+        gs_stEraseMemoryInfo.endAddr = (startAddr + dataLen + HAL_FLASH_SECTOR_SIZE - 1u) / HAL_FLASH_SECTOR_SIZE * HAL_FLASH_SECTOR_SIZE;
+        gs_stEraseMemoryInfo.isEraseFailed = FALSE;
+        gs_stEraseMemoryInfo.isRangeStarted = TRUE;
+
+        /*new programming cycle: forget the ranges of the previous one*/
+        gs_dowloadRangeCnt = 0u;
+
+        /*start right away, UDS_DownloadMainFun() keeps it going*/
+        (void)UDS_QueueErase(gs_stEraseMemoryInfo.endAddr);
+    }
+
+#if (0u == UDS_ERASE_AHEAD)
+    /*answer once the whole range is erased, 0x78 until then*/
+    if((TRUE != gs_stEraseMemoryInfo.isEraseFailed) && (TRUE == UDS_IsEraseBusy()))
+    {
+        UDS_DelayDownloadResponse(i_pstUDSServiceInfo, m_pstPDUMsg);
+
+        return;
+    }
+#endif
+
+    /*with erase-ahead a later failure is reported by TransferData/RequestTransferExit*/
+    if(TRUE == gs_stEraseMemoryInfo.isEraseFailed)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, GPF, m_pstPDUMsg);
+
+        return;
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[4u] = ROUTINE_STATUS_CORRECT;
+    m_pstPDUMsg->xDataLen = 5u;
+}
+
+/*Is the flash idle for a check routine: no transfer, no segment or erase in flight?*/
+static uint8 UDS_IsCheckAllowed(void)
+{
+    if((TRUE == gs_stDowloadDataInfo.isDownloading) || (TRUE != UDS_IsDownloadIdle()) ||
+       (TRUE == UDS_IsEraseBusy()) || (NULL_PTR != gs_stDowloadPendingInfo.pstService))
+    {
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+/*check memory routine: 31 01 02 02 CRC32 over the last downloaded range.
+  The CRC was folded in during TransferData, so only a deferred-verify download reads the flash back.*/
+static void UDS_CheckSum(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    tDowloadRangeInfo *pstRange = NULL_PTR;
+    uint32 receivedCrc = 0u;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if((TRUE != UDS_IsCurSessionCanRequest(PROGRAM_SESSION)) ||
+       (TRUE != UDS_IsCurRxIdCanRequest(SUPPORT_PHYSICAL_ADDR)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(CHECK_SUM_REQUEST_LEN != m_pstPDUMsg->xDataLen)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if((0u == gs_dowloadRangeCnt) || (TRUE != UDS_IsCheckAllowed()))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, RSE, m_pstPDUMsg);
+
+        return;
+    }
+
+    pstRange = &gs_astDowloadRange[gs_dowloadRangeCnt - 1u];
+    receivedCrc = UDS_GetUint32(&m_pstPDUMsg->aDataBuf[4u]);
+
+    pstRange->isChecked = FALSE;
+
+    if(receivedCrc == pstRange->dataCrc)
+    {
+        pstRange->isChecked = TRUE;
+
+        /*nothing read the segments back while programming: one CRC pass over the range now*/
+        if((HAL_FLASH_VERIFY_DEFERRED == hal_flash_get_verify_policy()) &&
+           (HAL_ERR_SUCCESS != hal_flash_verify_crc32(pstRange->startAddr, pstRange->dataLen, pstRange->dataCrc)))
+        {
+            pstRange->isChecked = FALSE;
+        }
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[4u] = (TRUE == pstRange->isChecked) ? ROUTINE_STATUS_CORRECT : ROUTINE_STATUS_INCORRECT;
+    m_pstPDUMsg->xDataLen = 5u;
+}
+
+/*Is the slot image described by its metadata intact?
+  A checked range that is exactly the image stands in for a rescan of the flash.*/
+static uint8 UDS_IsSlotImageValid(const tAPPType i_slot)
+{
+    app_metadata_t stMeta;
+    const uint32 slotAddr = boot_ctrl_slot_addr(i_slot);
+    uint8 index = 0u;
+
+    if((0u == slotAddr) ||
+       (HAL_ERR_SUCCESS != hal_flash_read(boot_ctrl_slot_metadata_addr(i_slot), (uint8 *)&stMeta, sizeof(stMeta))))
+    {
+        return FALSE;
+    }
+
+    /*same rules as boot_verify_image(): image inside the slot and short of the metadata*/
+    if((APP_METADATA_MAGIC != stMeta.magic) || (stMeta.flash_start_addr < slotAddr) || (0u == stMeta.image_size) ||
+       (stMeta.image_size > (BOOT_SLOT_METADATA_OFFSET - (stMeta.flash_start_addr - slotAddr))))
+    {
+        return FALSE;
+    }
+
+    for(index = 0u; index < gs_dowloadRangeCnt; index++)
+    {
+        if((TRUE == gs_astDowloadRange[index].isChecked) &&
+           (stMeta.flash_start_addr == gs_astDowloadRange[index].startAddr) &&
+           (stMeta.image_size == gs_astDowloadRange[index].dataLen) &&
+           (stMeta.crc32 == gs_astDowloadRange[index].dataCrc))
+        {
+            return TRUE;
+        }
+    }
+
+    return (HAL_ERR_SUCCESS == hal_flash_verify_crc32(stMeta.flash_start_addr, stMeta.image_size, stMeta.crc32)) ? TRUE : FALSE;
+}
+
+/*check programming dependencies routine: 31 01 FF 01. Validates the downloaded slot and marks it to boot next.*/
+static void UDS_CheckDependency(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    const tAPPType targetSlot = boot_ctrl_get_inactive_slot();
+    uint8 routineStatus = ROUTINE_STATUS_INCORRECT;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if((TRUE != UDS_IsCurSessionCanRequest(PROGRAM_SESSION)) ||
+       (TRUE != UDS_IsCurRxIdCanRequest(SUPPORT_PHYSICAL_ADDR)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE != UDS_IsCurSecurityLevelRequest(SECURITY_LEVEL_1))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, SAD, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(4u != m_pstPDUMsg->xDataLen)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE != UDS_IsCheckAllowed())
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, CNC, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE == UDS_IsSlotImageValid(targetSlot))
+    {
+        /*boot-valid marker: the slot boots next, unconfirmed*/
+        if(HAL_ERR_SUCCESS != boot_ctrl_mark_pending(targetSlot))
+        {
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, GPF, m_pstPDUMsg);
+
+            return;
+        }
+
+        routineStatus = ROUTINE_STATUS_CORRECT;
+        gs_dowloadRangeCnt = 0u;
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[4u] = routineStatus;
+    m_pstPDUMsg->xDataLen = 5u;
+}
+
+#ifdef EN_SUPPORT_APP_B
+/*set up the patch applier of a delta download. A new one drops the progress of an earlier one, DELTA_RESUME
+  continues from the newest progress record: *o_pDataCrc is the image CRC of the bytes already in flash.
+  Returns 0 or the NRC.*/
+static uint8 UDS_StartDeltaDownload(const uint8 i_dataFormatId, const tAPPType i_targetSlot,
+                                    const uint32 i_startAddr, const uint32 i_dataLen, uint32 *o_pDataCrc)
+{
+    /*the patch copies from the image in the active slot, which stays untouched*/
+    const uint32 srcAddr = boot_ctrl_slot_addr((APP_A_TYPE == i_targetSlot) ? APP_B_TYPE : APP_A_TYPE);
+    boot_delta_progress_t stProgress;
+
+    *o_pDataCrc = 0u;
+    gs_stDeltaProgressInfo.savedLen = 0u;
+
+    if(DOWLOAD_FORMAT_DELTA == i_dataFormatId)
+    {
+        if(HAL_ERR_SUCCESS != boot_delta_progress_clear())
+        {
+            return UDNA;
+        }
+
+        gs_stDeltaProgressInfo.nextAddr = BOOT_DELTA_PROGRESS_ADDR;
+        boot_delta_init(&gs_stDowloadDelta, srcAddr, BOOT_SLOT_SIZE, i_dataLen);
+
+        return 0u;
+    }
+
+    /*the record must be this download's, with the source and the bytes written before the reset unchanged*/
+    if((TRUE != boot_delta_progress_load(&stProgress, &gs_stDeltaProgressInfo.nextAddr)) ||
+       (HAL_ERR_SUCCESS != boot_delta_resume(&gs_stDowloadDelta, &stProgress, srcAddr, i_startAddr, i_dataLen)))
+    {
+        return UDNA;
+    }
+
+    /*an EraseMemory range still to be erased may only start behind them*/
+    if((TRUE == UDS_IsEraseBusy()) &&
+       (gs_stEraseMemoryInfo.startAddr < (i_startAddr + gs_stDowloadDelta.out_total)))
+    {
+        return UDNA;
+    }
+
+    *o_pDataCrc = stProgress.out_crc;
+    gs_stDeltaProgressInfo.savedLen = gs_stDowloadDelta.out_total;
+
+    return 0u;
+}
+#endif
+
+/*request download*/
+static void UDS_RequestDownload(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 dataFormatId = 0u;
+    uint8 addrLenFormatId = 0u;
+    uint32 startAddr = 0u;
+    uint32 dataLen = 0u;
+    uint32 maxBlockLen = UDS_MAX_BLOCK_LEN;
+    uint32 dataCrc = 0u;
+    tAPPType targetSlot = APP_A_TYPE;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if((3u + DOWLOAD_DATA_ADDR_LEN + DOWLOAD_DATA_LEN) != m_pstPDUMsg->xDataLen)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*a transfer is active, an aborted download still has segments programming, or EraseMemory is parked*/
+    if((TRUE == gs_stDowloadDataInfo.isDownloading) || (TRUE == gs_stUploadDataInfo.isUploading) ||
+       (TRUE != UDS_IsDownloadIdle()) || (NULL_PTR != gs_stDowloadPendingInfo.pstService))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, CNC, m_pstPDUMsg);
+
+        return;
+    }
+
+    dataFormatId = m_pstPDUMsg->aDataBuf[1u];
+    addrLenFormatId = m_pstPDUMsg->aDataBuf[2u];
+    startAddr = UDS_GetUint32(&m_pstPDUMsg->aDataBuf[3u]);
+    dataLen = UDS_GetUint32(&m_pstPDUMsg->aDataBuf[3u + DOWLOAD_DATA_ADDR_LEN]);
+    targetSlot = boot_ctrl_get_inactive_slot();
+
+    /*supported format, 4 byte address and 4 byte size (of the data written to flash), inside the inactive slot*/
+    if((TRUE != UDS_IsDownloadFormatValid(dataFormatId)) ||
+       (DOWLOAD_ADDR_LEN_FORMAT != addrLenFormatId) ||
+       (TRUE != UDS_IsDownloadRangeValid(targetSlot, startAddr, dataLen)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*slot content is about to change: drop its verified-image cache entry. A failed erase must be redone first,
+      and EraseMemory starts a new range list once it is full.*/
+    if((TRUE == gs_stEraseMemoryInfo.isEraseFailed) || (UDS_DOWNLOAD_RANGE_NUM <= gs_dowloadRangeCnt) ||
+       (HAL_ERR_SUCCESS != boot_verify_invalidate(targetSlot)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, UDNA, m_pstPDUMsg);
+
+        return;
+    }
+
+#ifdef EN_SUPPORT_APP_B
+    if((DOWLOAD_FORMAT_DELTA == dataFormatId) || (DOWLOAD_FORMAT_DELTA_RESUME == dataFormatId))
+    {
+        const uint8 nrc = UDS_StartDeltaDownload(dataFormatId, targetSlot, startAddr, dataLen, &dataCrc);
+
+        if(0u != nrc)
+        {
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, nrc, m_pstPDUMsg);
+
+            return;
+        }
+
+        dataFormatId = DOWLOAD_FORMAT_DELTA;
+    }
+#endif
+
+    gs_stDowloadDataInfo.startAddr = startAddr;
+    gs_stDowloadDataInfo.dataLen = dataLen;
+    gs_stDowloadDataInfo.receivedLen = 0u;
+    gs_stDowloadDataInfo.dataCrc = 0u;
+    gs_stDowloadDataInfo.blockSequenceCounter = 1u;
+    gs_stDowloadDataInfo.targetSlot = targetSlot;
+    gs_stDowloadDataInfo.isProgramFailed = FALSE;
+    gs_stDowloadDataInfo.dataFormat = dataFormatId;
+    gs_stDowloadDataInfo.blockOffset = 0u;
+    gs_stDowloadDataInfo.isDownloading = TRUE;
+
+    if(DOWLOAD_FORMAT_LZSS == dataFormatId)
+    {
+        boot_lzss_init(&gs_stDowloadLzss);
+        maxBlockLen = DOWLOAD_LZSS_MAX_BLOCK_LEN;
+    }
+    else if(DOWLOAD_FORMAT_DELTA == dataFormatId)
+    {
+        /*applier set up above, a resumed download goes on behind the bytes already in flash*/
+        gs_stDowloadDataInfo.receivedLen = gs_stDowloadDelta.out_total;
+        gs_stDowloadDataInfo.dataCrc = dataCrc;
+    }
+    else
+    {
+        /*uncompressed*/
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[1u] = DOWLOAD_MAX_BLOCK_LEN_FORMAT;
+    m_pstPDUMsg->aDataBuf[2u] = (uint8)(maxBlockLen >> 8u);
+    m_pstPDUMsg->aDataBuf[3u] = (uint8)maxBlockLen;
+    m_pstPDUMsg->xDataLen = 4u;
+}
+
+/*transfer data*/
+static void UDS_TransferData(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint8 blockSequenceCounter = 0u;
+    uint32 blockLen = 0u;
+    uint32 outLen = 0u;
+    uint32 maxBlockLen = UDS_MAX_BLOCK_LEN;
+    uint8 nrc = 0u;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if(TRUE == gs_stUploadDataInfo.isUploading)
+    {
+        UDS_UploadData(i_pstUDSServiceInfo, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE != gs_stDowloadDataInfo.isDownloading)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, RSE, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*previous block still waits for a segment*/
+    if((NULL_PTR != gs_stDowloadPendingInfo.pstService) && (m_pstPDUMsg != &gs_stDowloadPendingInfo.stMsg))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, BRR, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(DOWLOAD_FORMAT_LZSS == gs_stDowloadDataInfo.dataFormat)
+    {
+        maxBlockLen = DOWLOAD_LZSS_MAX_BLOCK_LEN;
+    }
+
+    if((m_pstPDUMsg->xDataLen < 3u) || (m_pstPDUMsg->xDataLen > maxBlockLen))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE == gs_stDowloadDataInfo.isProgramFailed)
+    {
+        UDS_AbortDownload();
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, GPF, m_pstPDUMsg);
+
+        return;
+    }
+
+    blockSequenceCounter = m_pstPDUMsg->aDataBuf[1u];
+    blockLen = m_pstPDUMsg->xDataLen - 2u;
+
+    /*flash the block may fill: a compressed block is reserved for its worst case output*/
+    outLen = blockLen;
+    if(DOWLOAD_FORMAT_LZSS == gs_stDowloadDataInfo.dataFormat)
+    {
+        outLen = UDS_MIN_LEN(BOOT_LZSS_MAX_OUTPUT(blockLen), gs_stDowloadDataInfo.dataLen - gs_stDowloadDataInfo.receivedLen);
+    }
+
+    if((0u != gs_stDowloadDataInfo.receivedLen) &&
+       (blockSequenceCounter == (uint8)(gs_stDowloadDataInfo.blockSequenceCounter - 1u)))
+    {
+        /*repeated block (our response was lost): already buffered, only answer again*/
+    }
+    else if(blockSequenceCounter != gs_stDowloadDataInfo.blockSequenceCounter)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, WBSC, m_pstPDUMsg);
+
+        return;
+    }
+    else if(((DOWLOAD_FORMAT_RAW == gs_stDowloadDataInfo.dataFormat) &&
+             (blockLen > (gs_stDowloadDataInfo.dataLen - gs_stDowloadDataInfo.receivedLen))) ||
+            (gs_stDowloadDataInfo.dataLen == gs_stDowloadDataInfo.receivedLen))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, TDS, m_pstPDUMsg);
+
+        return;
+    }
+    else if(DOWLOAD_FORMAT_DELTA == gs_stDowloadDataInfo.dataFormat)
+    {
+        /*applied as far as the flash allows, the rest of the block waits parked*/
+        if(TRUE != UDS_PatchDownloadData(&m_pstPDUMsg->aDataBuf[2u], blockLen, &nrc))
+        {
+            if(0u == nrc)
+            {
+                UDS_DelayDownloadResponse(i_pstUDSServiceInfo, m_pstPDUMsg);
+            }
+            else
+            {
+                UDS_AbortDownload();
+                UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, nrc, m_pstPDUMsg);
+            }
+
+            return;
+        }
+
+        gs_stDowloadDataInfo.blockSequenceCounter++;
+    }
+    else if((outLen > UDS_GetDownloadBufferSpace()) ||
+            (TRUE != UDS_QueueErase(gs_stDowloadDataInfo.startAddr + gs_stDowloadDataInfo.receivedLen + outLen)))
+    {
+        /*all segments busy programming, or the erase-ahead is behind: answer once the flash caught up*/
+        UDS_DelayDownloadResponse(i_pstUDSServiceInfo, m_pstPDUMsg);
+
+        return;
+    }
+    else if(DOWLOAD_FORMAT_LZSS == gs_stDowloadDataInfo.dataFormat)
+    {
+        /*the image CRC covers the decompressed data, as CheckMemory sees it*/
+        if(TRUE != UDS_InflateDownloadData(&m_pstPDUMsg->aDataBuf[2u], blockLen, &nrc))
+        {
+            UDS_AbortDownload();
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, nrc, m_pstPDUMsg);
+
+            return;
+        }
+
+        gs_stDowloadDataInfo.blockSequenceCounter++;
+    }
+    else
+    {
+        /*buffer and fold into the image CRC; the block is programmed behind our response*/
+        if((TRUE != UDS_BufferDownloadData(&m_pstPDUMsg->aDataBuf[2u], blockLen)) ||
+           (TRUE != UDS_FoldDownloadCrc(&m_pstPDUMsg->aDataBuf[2u], blockLen)))
+        {
+            UDS_AbortDownload();
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, GPF, m_pstPDUMsg);
+
+            return;
+        }
+
+        gs_stDowloadDataInfo.receivedLen += blockLen;
+        gs_stDowloadDataInfo.blockSequenceCounter++;
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[1u] = blockSequenceCounter;
+    m_pstPDUMsg->xDataLen = 2u;
+}
+
+/*request transfer exit*/
+static void UDS_RequestTransferExit(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    const uint8 segment = gs_stDowloadDataInfo.fillSegment;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    /*upload: every block has been read*/
+    if(TRUE == gs_stUploadDataInfo.isUploading)
+    {
+        if(gs_stUploadDataInfo.sentLen != gs_stUploadDataInfo.dataLen)
+        {
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, RSE, m_pstPDUMsg);
+
+            return;
+        }
+
+        gs_stUploadDataInfo.isUploading = FALSE;
+
+        m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+        m_pstPDUMsg->xDataLen = 1u;
+
+        return;
+    }
+
+    if((TRUE != gs_stDowloadDataInfo.isDownloading) ||
+       (gs_stDowloadDataInfo.receivedLen != gs_stDowloadDataInfo.dataLen) ||
+       ((DOWLOAD_FORMAT_DELTA == gs_stDowloadDataInfo.dataFormat) && (TRUE != boot_delta_is_done(&gs_stDowloadDelta))))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, RSE, m_pstPDUMsg);
+
+        return;
+    }
+
+    if((NULL_PTR != gs_stDowloadPendingInfo.pstService) && (m_pstPDUMsg != &gs_stDowloadPendingInfo.stMsg))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, BRR, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*program the last partial segment*/
+    if(DOWLOAD_SEGMENT_FILLING == gs_astDowloadSegment[segment].state)
+    {
+        if(TRUE != UDS_ProgramDownloadSegment(segment))
+        {
+            gs_stDowloadDataInfo.isProgramFailed = TRUE;
+        }
+        else
+        {
+            gs_stDowloadDataInfo.fillSegment = (uint8)((segment + 1u) % UDS_DOWNLOAD_SEGMENT_NUM);
+        }
+    }
+
+    if((TRUE != gs_stDowloadDataInfo.isProgramFailed) && (TRUE != UDS_IsDownloadIdle()))
+    {
+        UDS_DelayDownloadResponse(i_pstUDSServiceInfo, m_pstPDUMsg);
+
+        return;
+    }
+
+    gs_stDowloadDataInfo.isDownloading = FALSE;
+
+    /*a delta must have rebuilt exactly the image it was made for*/
+    if((TRUE == gs_stDowloadDataInfo.isProgramFailed) ||
+       ((DOWLOAD_FORMAT_DELTA == gs_stDowloadDataInfo.dataFormat) &&
+        (gs_stDowloadDataInfo.dataCrc != gs_stDowloadDelta.dst_crc)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, GPF, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*the image is complete, nothing left to resume. A record that stays behind only ever resumes into it.*/
+    if(DOWLOAD_FORMAT_DELTA == gs_stDowloadDataInfo.dataFormat)
+    {
+        (void)boot_delta_progress_clear();
+    }
+
+    /*remembered for CheckMemory/CheckProgrammingDependencies (RequestDownload kept a free entry)*/
+    gs_astDowloadRange[gs_dowloadRangeCnt].startAddr = gs_stDowloadDataInfo.startAddr;
+    gs_astDowloadRange[gs_dowloadRangeCnt].dataLen = gs_stDowloadDataInfo.dataLen;
+    gs_astDowloadRange[gs_dowloadRangeCnt].dataCrc = gs_stDowloadDataInfo.dataCrc;
+    gs_astDowloadRange[gs_dowloadRangeCnt].isChecked = FALSE;
+    gs_dowloadRangeCnt++;
+
+    gs_stUdsPerfInfo.downloadBytes += gs_stDowloadDataInfo.dataLen;
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 1u;
+}
+
+/*read big endian address or size of i_len (1..4) bytes from request*/
+static uint32 UDS_GetMemoryParam(const uint8 *i_pBuf, const uint8 i_len)
+{
+    uint32 value = 0u;
+    uint8 index = 0u;
+
+    for(index = 0u; index < i_len; index++)
+    {
+        value = (value << 8u) | (uint32)i_pBuf[index];
+    }
+
+    return value;
+}
+
+/*the calibration area read back must stay clear of the bootloader's data flash records*/
+#if ((UDS_READ_DATA_FLASH_ADDR + UDS_READ_DATA_FLASH_SIZE) > BOOT_CTRL_SECTOR_0_ADDR) && \
+    (UDS_READ_DATA_FLASH_ADDR < (BOOT_DELTA_PROGRESS_ADDR + HAL_FLASH_SECTOR_SIZE))
+#error "UDS_READ_DATA_FLASH_ADDR/UDS_READ_DATA_FLASH_SIZE overlap the boot records in data flash"
+#endif
+
+/*Is the range one the tester may read back: inside the application slots or the calibration area?*/
+static uint8 UDS_IsReadRangeValid(const uint32 i_startAddr, const uint32 i_dataLen)
+{
+    const uint32 appLen = BOOT_SLOT_COUNT * BOOT_SLOT_SIZE;
+
+    if(0u == i_dataLen)
+    {
+        return FALSE;
+    }
+
+    if((i_startAddr >= APP_START_ADDRESS) && (i_dataLen <= appLen) &&
+       ((i_startAddr - APP_START_ADDRESS) <= (appLen - i_dataLen)))
+    {
+        return TRUE;
+    }
+
+    if((i_startAddr >= UDS_READ_DATA_FLASH_ADDR) && (i_dataLen <= UDS_READ_DATA_FLASH_SIZE) &&
+       ((i_startAddr - UDS_READ_DATA_FLASH_ADDR) <= (UDS_READ_DATA_FLASH_SIZE - i_dataLen)))
+    {
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+/*parse addressAndLengthFormatIdentifier, memoryAddress and memorySize at i_pBuf (i_len bytes left in the request).
+  4 byte address, 1..4 byte size. Returns FALSE with the NRC for a malformed or unsupported request.*/
+static uint8 UDS_GetMemoryRange(const uint8 *i_pBuf, const uint32 i_len, uint32 *o_pStartAddr, uint32 *o_pDataLen, uint8 *o_pNrc)
+{
+    const uint8 sizeLen = (uint8)(i_pBuf[0u] >> 4u);
+    const uint8 addrLen = (uint8)(i_pBuf[0u] & 0x0Fu);
+
+    if((0u == sizeLen) || (0u == addrLen) || (i_len != (1u + (uint32)addrLen + (uint32)sizeLen)))
+    {
+        *o_pNrc = IMLOIF;
+
+        return FALSE;
+    }
+
+    if((DOWLOAD_DATA_ADDR_LEN != addrLen) || (sizeLen > DOWLOAD_DATA_LEN))
+    {
+        *o_pNrc = ROOR;
+
+        return FALSE;
+    }
+
+    *o_pStartAddr = UDS_GetMemoryParam(&i_pBuf[1u], addrLen);
+    *o_pDataLen = UDS_GetMemoryParam(&i_pBuf[1u + addrLen], sizeLen);
+
+    return TRUE;
+}
+
+/*read flash straight into the response. hal_flash_read() takes whole words, so the word aligned span is read
+  and moved down over the leading bytes; o_pBuf needs UDS_READ_MEMORY_SLACK bytes behind i_len.*/
+static uint8 UDS_ReadFlash(const uint32 i_startAddr, const uint32 i_len, uint8 *o_pBuf)
+{
+    const uint32 alignedAddr = i_startAddr & ~3u;
+    const uint32 skip = i_startAddr - alignedAddr;
+
+    /*no flash job may run while the array is read*/
+    if(TRUE != hal_flash_is_idle())
+    {
+        return FALSE;
+    }
+
+    if(HAL_ERR_SUCCESS != hal_flash_read(alignedAddr, o_pBuf, (skip + i_len + 3u) & ~3u))
+    {
+        return FALSE;
+    }
+
+    if(0u != skip)
+    {
+        fsl_memmove(o_pBuf, &o_pBuf[skip], i_len);
+    }
+
+    return TRUE;
+}
+
+/*read memory by address: 23 addressAndLengthFormatIdentifier address size, answered 63 data*/
+static void UDS_ReadMemoryByAddress(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint32 startAddr = 0u;
+    uint32 dataLen = 0u;
+    uint8 nrc = 0u;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if(m_pstPDUMsg->xDataLen < 2u)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE != UDS_GetMemoryRange(&m_pstPDUMsg->aDataBuf[1u], m_pstPDUMsg->xDataLen - 1u, &startAddr, &dataLen, &nrc))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, nrc, m_pstPDUMsg);
+
+        return;
+    }
+
+    if((dataLen > UDS_MAX_READ_MEMORY_LEN) || (TRUE != UDS_IsReadRangeValid(startAddr, dataLen)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*a download or erase is writing the flash*/
+    if(TRUE != UDS_ReadFlash(startAddr, dataLen, &m_pstPDUMsg->aDataBuf[1u]))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, CNC, m_pstPDUMsg);
+
+        return;
+    }
+
+    gs_stUdsPerfInfo.readBackBytes += dataLen;
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 1u + dataLen;
+}
+
+/*request upload: 35 dataFormatIdentifier addressAndLengthFormatIdentifier address size*/
+static void UDS_RequestUpload(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    uint32 startAddr = 0u;
+    uint32 dataLen = 0u;
+    uint8 nrc = 0u;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if(m_pstPDUMsg->xDataLen < 3u)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE != UDS_GetMemoryRange(&m_pstPDUMsg->aDataBuf[2u], m_pstPDUMsg->xDataLen - 2u, &startAddr, &dataLen, &nrc))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, nrc, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*a transfer is active, or the flash is still being written*/
+    if((TRUE == gs_stDowloadDataInfo.isDownloading) || (TRUE == gs_stUploadDataInfo.isUploading) ||
+       (TRUE != UDS_IsDownloadIdle()) || (NULL_PTR != gs_stDowloadPendingInfo.pstService) ||
+       (TRUE == UDS_IsEraseBusy()))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, CNC, m_pstPDUMsg);
+
+        return;
+    }
+
+    if((UPLOAD_FORMAT_RAW != m_pstPDUMsg->aDataBuf[1u]) || (TRUE != UDS_IsReadRangeValid(startAddr, dataLen)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    gs_stUploadDataInfo.startAddr = startAddr;
+    gs_stUploadDataInfo.dataLen = dataLen;
+    gs_stUploadDataInfo.sentLen = 0u;
+    gs_stUploadDataInfo.lastBlockLen = 0u;
+    gs_stUploadDataInfo.blockSequenceCounter = 1u;
+    gs_stUploadDataInfo.isUploading = TRUE;
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[1u] = DOWLOAD_MAX_BLOCK_LEN_FORMAT;
+    m_pstPDUMsg->aDataBuf[2u] = (uint8)(UDS_MAX_UPLOAD_BLOCK_LEN >> 8u);
+    m_pstPDUMsg->aDataBuf[3u] = (uint8)UDS_MAX_UPLOAD_BLOCK_LEN;
+    m_pstPDUMsg->xDataLen = 4u;
+}
+
+/*transfer data of an upload: 36 counter, answered 76 counter data read straight from flash*/
+static void UDS_UploadData(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    const uint8 blockSequenceCounter = m_pstPDUMsg->aDataBuf[1u];
+    uint32 offset = gs_stUploadDataInfo.sentLen;
+    uint32 blockLen = 0u;
+
+    if(2u != m_pstPDUMsg->xDataLen)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if((0u != gs_stUploadDataInfo.sentLen) &&
+       (blockSequenceCounter == (uint8)(gs_stUploadDataInfo.blockSequenceCounter - 1u)))
+    {
+        /*repeated block (our response was lost): read it again*/
+        offset -= gs_stUploadDataInfo.lastBlockLen;
+        blockLen = gs_stUploadDataInfo.lastBlockLen;
+    }
+    else if(blockSequenceCounter != gs_stUploadDataInfo.blockSequenceCounter)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, WBSC, m_pstPDUMsg);
+
+        return;
+    }
+    else if(gs_stUploadDataInfo.sentLen == gs_stUploadDataInfo.dataLen)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, RSE, m_pstPDUMsg);
+
+        return;
+    }
+    else
+    {
+        blockLen = UDS_MIN_LEN(gs_stUploadDataInfo.dataLen - gs_stUploadDataInfo.sentLen,
+                               UDS_MAX_UPLOAD_BLOCK_LEN - 2u);
+    }
+
+    if(TRUE != UDS_ReadFlash(gs_stUploadDataInfo.startAddr + offset, blockLen, &m_pstPDUMsg->aDataBuf[2u]))
+    {
+        gs_stUploadDataInfo.isUploading = FALSE;
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, GPF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(offset == gs_stUploadDataInfo.sentLen)
+    {
+        gs_stUdsPerfInfo.readBackBytes += blockLen;
+        gs_stUploadDataInfo.sentLen += blockLen;
+        gs_stUploadDataInfo.lastBlockLen = blockLen;
+        gs_stUploadDataInfo.blockSequenceCounter++;
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->aDataBuf[1u] = blockSequenceCounter;
+    m_pstPDUMsg->xDataLen = 2u + blockLen;
+}
+
+/*write big endian uint32 into response*/
+static void UDS_PutUint32(uint8 *o_pBuf, const uint32 i_value)
+{
+    o_pBuf[0u] = (uint8)(i_value >> 24u);
+    o_pBuf[1u] = (uint8)(i_value >> 16u);
+    o_pBuf[2u] = (uint8)(i_value >> 8u);
+    o_pBuf[3u] = (uint8)i_value;
+}
+
+/*DID registry entry, binary search. NULL_PTR if not supported.*/
+static const tUDS_DataIdentifierInfo *UDS_FindDataIdentifier(const uint16 i_dataId)
+{
+    uint32 low = 0u;
+    uint32 high = UDS_DID_NUM;
+    uint32 mid = 0u;
+
+    while(low < high)
+    {
+        mid = (low + high) / 2u;
+
+        if(gs_astUDSDataIdentifier[mid].dataId == i_dataId)
+        {
+            return &gs_astUDSDataIdentifier[mid];
+        }
+
+        if(gs_astUDSDataIdentifier[mid].dataId < i_dataId)
+        {
+            low = mid + 1u;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+
+    return NULL_PTR;
+}
+
+/*read data by identifier: 22 DID [DID ...], answered 62 DID data [DID data ...].
+  DIDs not supported in the current session are left out, ROOR if none is left.*/
+static void UDS_ReadDataByIdentifier(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    const tUDS_DataIdentifierInfo *apstDid[UDS_MAX_READ_DID_NUM];
+    uint32 didNum = 0u;
+    uint32 rspLen = 1u;
+    uint32 index = 0u;
+    uint8 nrc = 0u;
+    const tUDS_DataIdentifierInfo *pstDid = NULL_PTR;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if((m_pstPDUMsg->xDataLen < 3u) || (0u == (m_pstPDUMsg->xDataLen & 1u)) ||
+       (((m_pstPDUMsg->xDataLen - 1u) / 2u) > UDS_MAX_READ_DID_NUM))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    /*look every DID up first: the response overwrites the request*/
+    for(index = 1u; index < m_pstPDUMsg->xDataLen; index += 2u)
+    {
+        pstDid = UDS_FindDataIdentifier((uint16)(((uint16)m_pstPDUMsg->aDataBuf[index] << 8u) |
+                                                 m_pstPDUMsg->aDataBuf[index + 1u]));
+
+        if((NULL_PTR == pstDid) || (NULL_PTR == pstDid->pfRead) ||
+           (TRUE != UDS_IsCurSessionCanRequest(pstDid->readSession)))
+        {
+            continue;
+        }
+
+        if(TRUE != UDS_IsCurSecurityLevelRequest(pstDid->readLevel))
+        {
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, SAD, m_pstPDUMsg);
+
+            return;
+        }
+
+        apstDid[didNum] = pstDid;
+        didNum++;
+        rspLen += 2u + pstDid->dataLen;
+    }
+
+    if(0u == didNum)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(rspLen > UDS_MSG_BUF_LEN)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, RTL, m_pstPDUMsg);
+
+        return;
+    }
+
+    rspLen = 1u;
+    for(index = 0u; index < didNum; index++)
+    {
+        m_pstPDUMsg->aDataBuf[rspLen] = (uint8)(apstDid[index]->dataId >> 8u);
+        m_pstPDUMsg->aDataBuf[rspLen + 1u] = (uint8)apstDid[index]->dataId;
+
+        nrc = apstDid[index]->pfRead(&m_pstPDUMsg->aDataBuf[rspLen + 2u]);
+        if(0u != nrc)
+        {
+            UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, nrc, m_pstPDUMsg);
+
+            return;
+        }
+
+        rspLen += 2u + apstDid[index]->dataLen;
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->xDataLen = rspLen;
+}
+
+/*write data by identifier: 2E DID data, answered 6E DID*/
+static void UDS_WriteDataByIdentifier(struct UDSServiceInfo* i_pstUDSServiceInfo, tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    const tUDS_DataIdentifierInfo *pstDid = NULL_PTR;
+    uint8 nrc = 0u;
+
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+    ASSERT(NULL_PTR == i_pstUDSServiceInfo);
+
+    if(m_pstPDUMsg->xDataLen < 4u)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    pstDid = UDS_FindDataIdentifier((uint16)(((uint16)m_pstPDUMsg->aDataBuf[1u] << 8u) | m_pstPDUMsg->aDataBuf[2u]));
+
+    if((NULL_PTR == pstDid) || (NULL_PTR == pstDid->pfWrite) ||
+       (TRUE != UDS_IsCurSessionCanRequest(pstDid->writeSession)))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, ROOR, m_pstPDUMsg);
+
+        return;
+    }
+
+    if((3u + (uint32)pstDid->dataLen) != m_pstPDUMsg->xDataLen)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, IMLOIF, m_pstPDUMsg);
+
+        return;
+    }
+
+    if(TRUE != UDS_IsCurSecurityLevelRequest(pstDid->writeLevel))
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, SAD, m_pstPDUMsg);
+
+        return;
+    }
+
+    nrc = pstDid->pfWrite(&m_pstPDUMsg->aDataBuf[3u]);
+    if(0u != nrc)
+    {
+        UDS_SetNegativeErroCode(i_pstUDSServiceInfo->serNum, nrc, m_pstPDUMsg);
+
+        return;
+    }
+
+    m_pstPDUMsg->aDataBuf[0u] = i_pstUDSServiceInfo->serNum + 0x40u;
+    m_pstPDUMsg->xDataLen = 3u;
+}
+
+/*app_metadata_t as laid out in flash (boot.h). Fields are taken by offset, so host builds
+  with 64 bit pointers read the same layout.*/
+#define APP_METADATA_FLASH_LEN (0x34u)
+#define APP_METADATA_NAME_OFFSET (0x04u)
+#define APP_METADATA_VERSION_OFFSET (0x14u)
+#define APP_METADATA_START_ADDR_OFFSET (0x28u)
+
+/*slot holding the installed application: the one downloads do not go to*/
+static tAPPType UDS_GetActiveSlot(void)
+{
+#ifdef EN_SUPPORT_APP_B
+    return (APP_A_TYPE == boot_ctrl_get_inactive_slot()) ? APP_B_TYPE : APP_A_TYPE;
+#else
+    return APP_A_TYPE;
+#endif
+}
+
+/*read the metadata block of the installed application. Returns 0 or the NRC.*/
+static uint8 UDS_ReadAppMetadata(uint8 *o_pMetadata)
+{
+    const uint32 metadataAddr = boot_ctrl_slot_metadata_addr(UDS_GetActiveSlot());
+
+    if((TRUE != hal_flash_is_idle()) ||
+       (HAL_ERR_SUCCESS != hal_flash_read(metadataAddr, o_pMetadata, APP_METADATA_FLASH_LEN)))
+    {
+        return CNC;
+    }
+
+    /*magic is stored little endian*/
+    if(APP_METADATA_MAGIC != (((uint32)o_pMetadata[3u] << 24u) | ((uint32)o_pMetadata[2u] << 16u) |
+                              ((uint32)o_pMetadata[1u] << 8u) | (uint32)o_pMetadata[0u]))
+    {
+        return CNC;
+    }
+
+    return 0u;
+}
+
+/*DID 0xF15A: erased (all 0xFF) until the first write*/
+static uint8 UDS_ReadFingerprint(uint8 *o_pData)
+{
+    tFingerprintRecord stRecord;
+
+    if((TRUE != hal_flash_is_idle()) ||
+       (HAL_ERR_SUCCESS != hal_flash_read(UDS_FINGERPRINT_ADDR, (uint8 *)&stRecord, sizeof(stRecord))))
+    {
+        return CNC;
+    }
+
+    if((DID_FINGERPRINT_MAGIC != stRecord.magic) ||
+       (stRecord.crc32 != hal_crc32_compute((const uint8 *)&stRecord, DID_FINGERPRINT_CRC_LEN, 0xFFFFFFFFu)))
+    {
+        fsl_memset(o_pData, 0xFFu, DID_FINGERPRINT_LEN);
+
+        return 0u;
+    }
+
+    fsl_memcpy(o_pData, stRecord.aData, DID_FINGERPRINT_LEN);
+
+    return 0u;
+}
+
+/*DID 0xF15A: erase and program its sector, not while a download keeps the flash busy*/
+static uint8 UDS_WriteFingerprint(const uint8 *i_pData)
+{
+    tFingerprintRecord stRecord;
+
+    if((TRUE == gs_stDowloadDataInfo.isDownloading) || (TRUE != hal_flash_is_idle()))
+    {
+        return CNC;
+    }
+
+    fsl_memset(&stRecord, 0xFFu, sizeof(stRecord));
+    stRecord.magic = DID_FINGERPRINT_MAGIC;
+    fsl_memcpy(stRecord.aData, i_pData, DID_FINGERPRINT_LEN);
+    stRecord.crc32 = hal_crc32_compute((const uint8 *)&stRecord, DID_FINGERPRINT_CRC_LEN, 0xFFFFFFFFu);
+
+    if(HAL_ERR_SUCCESS != hal_flash_write(UDS_FINGERPRINT_ADDR, (const uint8 *)&stRecord, sizeof(stRecord)))
+    {
+        return GPF;
+    }
+
+    return 0u;
+}
+
+/*DID 0xF180*/
+static uint8 UDS_ReadBootVersion(uint8 *o_pData)
+{
+    fsl_memcpy(o_pData, EASY_BOOT_VERSION, DID_BOOT_VERSION_LEN);
+
+    return 0u;
+}
+
+/*DID 0xF186: 0x01 default, 0x02 programming, 0x03 extended*/
+static uint8 UDS_ReadActiveSession(uint8 *o_pData)
+{
+    if(TRUE == UDS_IsCurSessionCanRequest(PROGRAM_SESSION))
+    {
+        o_pData[0u] = 0x02u;
+    }
+    else if(TRUE == UDS_IsCurSessionCanRequest(EXTEND_SESSION))
+    {
+        o_pData[0u] = 0x03u;
+    }
+    else
+    {
+        o_pData[0u] = 0x01u;
+    }
+
+    return 0u;
+}
+
+/*DID 0xF189*/
+static uint8 UDS_ReadAppVersion(uint8 *o_pData)
+{
+    uint8 aMetadata[APP_METADATA_FLASH_LEN];
+    const uint8 nrc = UDS_ReadAppMetadata(aMetadata);
+
+    if(0u == nrc)
+    {
+        fsl_memcpy(o_pData, &aMetadata[APP_METADATA_VERSION_OFFSET], APP_VERSION_MAX_LEN);
+    }
+
+    return nrc;
+}
+
+/*DID 0xF197*/
+static uint8 UDS_ReadAppName(uint8 *o_pData)
+{
+    uint8 aMetadata[APP_METADATA_FLASH_LEN];
+    const uint8 nrc = UDS_ReadAppMetadata(aMetadata);
+
+    if(0u == nrc)
+    {
+        fsl_memcpy(o_pData, &aMetadata[APP_METADATA_NAME_OFFSET], APP_NAME_MAX_LEN);
+    }
+
+    return nrc;
+}
+
+/*DID 0xFD00: flash_start_addr, image_size, crc32, big endian*/
+static uint8 UDS_ReadAppImageInfo(uint8 *o_pData)
+{
+    uint8 aMetadata[APP_METADATA_FLASH_LEN];
+    const uint8 nrc = UDS_ReadAppMetadata(aMetadata);
+    uint8 index = 0u;
+
+    if(0u == nrc)
+    {
+        /*three little endian words from flash_start_addr on*/
+        for(index = 0u; index < 12u; index++)
+        {
+            o_pData[index] = aMetadata[APP_METADATA_START_ADDR_OFFSET + (index & ~3u) + 3u - (index & 3u)];
+        }
+    }
+
+    return nrc;
+}
+
+/*DID 0xFD10: tUdsPerfInfo, the free TP buffers, then tTPRxStatistics*/
+static uint8 UDS_ReadPerfCounters(uint8 *o_pData)
+{
+    tTPRxStatistics stRxStatistics;
+
+    TP_GetRxStatistics(&stRxStatistics);
+
+    UDS_PutUint32(&o_pData[0u], gs_stUdsPerfInfo.requestCnt);
+    UDS_PutUint32(&o_pData[4u], gs_stUdsPerfInfo.responsePendingCnt);
+    UDS_PutUint32(&o_pData[8u], gs_stUdsPerfInfo.parkedCnt);
+    UDS_PutUint32(&o_pData[12u], gs_stUdsPerfInfo.downloadBytes);
+    UDS_PutUint32(&o_pData[16u], gs_stUdsPerfInfo.readBackBytes);
+    UDS_PutUint32(&o_pData[20u], (uint32)TP_GetFreePduNum());
+    UDS_PutUint32(&o_pData[24u], stRxStatistics.rxFrameCnt);
+    UDS_PutUint32(&o_pData[28u], stRxStatistics.rxDropCnt);
+    UDS_PutUint32(&o_pData[32u], stRxStatistics.rxOverrunCnt);
+
+    return 0u;
+}
+
+#ifdef EN_SUPPORT_APP_B
+/*DID 0xFD20: memoryAddress, memorySize, source and image CRC32 of the patch header, image bytes in flash,
+  patch bytes applied, big endian; all zero without a record. When they match the tester's patch, it erases
+  from memoryAddress + image bytes on, requests DELTA_RESUME and sends the patch from the applied bytes on.*/
+static uint8 UDS_ReadDeltaProgress(uint8 *o_pData)
+{
+    boot_delta_progress_t stProgress;
+    uint32 nextAddr = 0u;
+
+    if((TRUE == gs_stDowloadDataInfo.isDownloading) || (TRUE != hal_flash_is_idle()))
+    {
+        return CNC;
+    }
+
+    fsl_memset(o_pData, 0u, 24u);
+
+    if(TRUE == boot_delta_progress_load(&stProgress, &nextAddr))
+    {
+        UDS_PutUint32(&o_pData[0u], stProgress.dst_addr);
+        UDS_PutUint32(&o_pData[4u], stProgress.delta.dst_expected);
+        UDS_PutUint32(&o_pData[8u], stProgress.delta.src_crc);
+        UDS_PutUint32(&o_pData[12u], stProgress.delta.dst_crc);
+        UDS_PutUint32(&o_pData[16u], stProgress.delta.out_total);
+        UDS_PutUint32(&o_pData[20u], stProgress.delta.in_total);
+    }
+
+    return 0u;
+}
+#endif
+
+/*do reset mcu*/
+static void UDS_DoResetMCU(uint8 Txstatus)
+{
+    if(TX_MSG_SUCCESSFUL == Txstatus)
+    {
+    	/*request enter bootloader mode*/
+    	Boot_RequestEnterBootloader();
+		
+        /*reset ECU*/
+        WATCHDOG_HAL_SystemRest();
+        while(1)
+        {
+            /*wait watch dog reset mcu*/
+        }
+    }
+}
+
+/**********************UDS service correlation other function realizing************************/
+/* get uds service config information */
+tUDSService* UDS_GetUDSServiceInfo(uint8 *m_pSupServItem)
+{
+    ASSERT(NULL_PTR == m_pSupServItem);
+    
+    *m_pSupServItem = sizeof(gs_astUDSService) / sizeof(gs_astUDSService[0u]);
+
+    return (tUDSService*) &gs_astUDSService[0u];
+}
+
+/*number of configured services*/
+#define UDS_SERVICE_NUM (sizeof(gs_astUDSService) / sizeof(gs_astUDSService[0u]))
+
+/*index + 1 into gs_astUDSService of every SID, 0 if not supported. Built by UDS_BuildServiceIndex().*/
+static uint8 gs_aUDSServiceIndex[256u];
+
+/*states each service can be requested in, see UDS_StateBit()*/
+static uint32 gs_aUDSServicePermission[UDS_SERVICE_NUM];
+
+/*build SID lookup and permission masks from gs_astUDSService[]*/
+void UDS_BuildServiceIndex(void)
+{
+    uint8 index = 0u;
+    uint8 sessionIndex = 0u;
+    uint8 requestIdIndex = 0u;
+    uint8 securityIndex = 0u;
+    uint32 permission = 0u;
+    const tUDSService *pstService = NULL_PTR;
+
+    /*permission mask holds every state, service index + 1 fits in uint8*/
+    ASSERT(UDS_STATE_NUM > 32u);
+    ASSERT(UDS_SERVICE_NUM >= 0xFFu);
+
+    /*the DID registry is binary searched*/
+    for(index = 1u; index < UDS_DID_NUM; index++)
+    {
+        ASSERT(gs_astUDSDataIdentifier[index - 1u].dataId >= gs_astUDSDataIdentifier[index].dataId);
+    }
+
+    UDS_AppMemset(0u, (uint16)sizeof(gs_aUDSServiceIndex), gs_aUDSServiceIndex);
+
+    for(index = 0u; index < UDS_SERVICE_NUM; index++)
+    {
+        pstService = &gs_astUDSService[index];
+
+        /*a SID listed twice keeps its first entry, like the linear search did*/
+        if(0u == gs_aUDSServiceIndex[pstService->serNum])
+        {
+            gs_aUDSServiceIndex[pstService->serNum] = index + 1u;
+        }
+
+        /*same checks UDS_IsCurSessionCanRequest()/UDS_IsCurRxIdCanRequest()/UDS_IsCurSecurityLevelRequest() do*/
+        permission = 0u;
+        for(sessionIndex = 0u; sessionIndex < UDS_STATE_ITEMS(gs_aUDSSessionModes); sessionIndex++)
+        {
+            for(requestIdIndex = 0u; requestIdIndex < UDS_STATE_ITEMS(gs_aUDSRequestIdModes); requestIdIndex++)
+            {
+                for(securityIndex = 0u; securityIndex < UDS_STATE_ITEMS(gs_aUDSSecurityLevels); securityIndex++)
+                {
+                    if(((pstService->sessionMode & gs_aUDSSessionModes[sessionIndex]) == gs_aUDSSessionModes[sessionIndex]) &&
+                       ((pstService->supReqMode & gs_aUDSRequestIdModes[requestIdIndex]) == gs_aUDSRequestIdModes[requestIdIndex]) &&
+                       ((pstService->reqLevel & gs_aUDSSecurityLevels[securityIndex]) == gs_aUDSSecurityLevels[securityIndex]))
+                    {
+                        permission |= UDS_StateBit(sessionIndex, requestIdIndex, securityIndex);
+                    }
+                }
+            }
+        }
+
+        gs_aUDSServicePermission[index] = permission;
+    }
+
+    UDS_UpdateStateMask();
+}
+
+/*service of a SID, NULL_PTR if not supported. o_pIsPermitted: current session, request ID and security level can request it.*/
+tUDSService* UDS_FindUDSService(const uint8 i_serNum, uint8 *o_pIsPermitted)
+{
+    const uint8 index = gs_aUDSServiceIndex[i_serNum];
+    tUDSService *pstService = NULL_PTR;
+
+    ASSERT(NULL_PTR == o_pIsPermitted);
+
+    *o_pIsPermitted = FALSE;
+
+    if(0u != index)
+    {
+        pstService = (tUDSService*) &gs_astUDSService[index - 1u];
+
+        if(0u != (gs_aUDSServicePermission[index - 1u] & gs_stUdsInfo.curStateMask))
+        {
+            *o_pIsPermitted = TRUE;
+        }
+    }
+
+    return pstService;
+}
+
+/* If Rx UDS msg, set UDS layer received message TURE */
+void UDS_SetIsRxUdsMsg(const uint8 i_setValue)
+{
+
+}
+
+uint8 UDS_IsRxUdsMsg(void)
+{
+    return TRUE;
+}
+
+/*set negative erro code*/
+void UDS_SetNegativeErroCode(const uint8 i_UDSServiceNum,
+                         const uint8 i_erroCode,
+                         tUdsAppMsgInfo *m_pstPDUMsg)
+{
+    ASSERT(NULL_PTR == m_pstPDUMsg);
+
+    m_pstPDUMsg->aDataBuf[0u] = NEGTIVE_ID;
+    m_pstPDUMsg->aDataBuf[1u] = i_UDSServiceNum;
+    m_pstPDUMsg->aDataBuf[2u] = i_erroCode;
+    m_pstPDUMsg->xDataLen = 3u;
+}
+
+/*Is current session DEFAULT return TRUE, else return FALSE.*/
+uint8 UDS_IsCurDefaultSession(void)
+{
+    uint8 isCurDefaultSessionStatus = FALSE;
+
+    if(DEFALUT_SESSION == gs_stUdsInfo.curSessionMode)
+    {
+        isCurDefaultSessionStatus = TRUE;
+    }
+    else
+    {
+        isCurDefaultSessionStatus = FALSE;
+    }
+
+    return isCurDefaultSessionStatus;
+}
+
+/*Is S3server timeout?*/
+uint8 UDS_IsS3ServerTimeout(void)
+{
+    uint8 TimeoutStatus = FALSE;
+
+    if(0u == gs_stUdsInfo.xUdsS3ServerTime)
+    {
+        TimeoutStatus = TRUE;
+    }
+    else
+    {
+        TimeoutStatus = FALSE;
+    }
+
+    return TimeoutStatus;
+}
+
+/*Is current session can request?*/
+uint8 UDS_IsCurSessionCanRequest(uint8 i_sessionMode)
+{
+    uint8 status = FALSE;
+
+    if((i_sessionMode & gs_stUdsInfo.curSessionMode) == gs_stUdsInfo.curSessionMode)
+    {
+        status = TRUE;
+    }
+    else
+    {
+        status = FALSE;
+    }
+
+    return status;
+}
+
+/*count a request read from TP (DID 0xFD10)*/
+void UDS_CountRequest(void)
+{
+    gs_stUdsPerfInfo.requestCnt++;
+}
+
+/*save received request id. If receved physical/function/none phy and function ID set rceived physicali/function/erro ID.*/
+void UDS_SaveRequestIdType(const uint32 i_serRequestID)
+{
+    if(i_serRequestID == TP_GetConfigRxMsgPHYID())
+    {
+        UDS_SetRequestIdType(SUPPORT_PHYSICAL_ADDR);
+    }
+    else if(i_serRequestID == TP_GetConfigRxMsgFUNID())
+    {
+        UDS_SetRequestIdType(SUPPORT_FUNCTION_ADDR);
+    }
+    else
+    {
+        UDS_SetRequestIdType(ERRO_REQUEST_ID);
+    }
+}
+
+/*Is current received id can request?*/
+uint8 UDS_IsCurRxIdCanRequest(uint8 i_serRequestIdMode)
+{
+    uint8 status = 0u;
+
+    if((i_serRequestIdMode & gs_stUdsInfo.requsetIdMode) == gs_stUdsInfo.requsetIdMode)
+    {
+        status = TRUE;
     }
     else
     {
@@ -602,6 +3001,8 @@ uint8 UDS_IsCurRxIdCanRequest(uint8 i_serRequestIdMode)
 void UDS_SetSecurityLevel(const uint8 i_setSecurityLevel)
 {
     gs_stUdsInfo.securityLevel = i_setSecurityLevel;
+
+    UDS_UpdateStateMask();
 }
 
 /*Is current security level can request?*/
@@ -657,6 +3058,24 @@ static uint8 UDS_IsCheckUDS_RoutineControlRight(const tCheckRoutineCtlInfo i_eCh
 
 			break;
 
+		case ERASE_MEMORY_ROUTINE_CONTROL:
+			pDestRoutineCltId = (uint8 *)&gs_aEraseMemory[0u];
+			FindCnt = sizeof(gs_aEraseMemory);
+
+			break;
+
+		case CHECK_SUM_ROUTINE_CONTROL:
+			pDestRoutineCltId = (uint8 *)&gs_aCheckSum[0u];
+			FindCnt = sizeof(gs_aCheckSum);
+
+			break;
+
+		case CHECK_DEPENDENCY_ROUTINE_CONTROL:
+			pDestRoutineCltId = (uint8 *)&gs_aCheckDependency[0u];
+			FindCnt = sizeof(gs_aCheckDependency);
+
+			break;
+
 	    default :
 
 	        return FALSE;
@@ -690,6 +3109,30 @@ static uint8 UDS_IsGetVersion(const tUdsAppMsgInfo *m_pstPDUMsg)
 	return UDS_IsCheckUDS_RoutineControlRight(GET_VERSION, m_pstPDUMsg);
 }
 
+/*Is erase memory?*/
+static uint8 UDS_IsEraseMemory(const tUdsAppMsgInfo *m_pstPDUMsg)
+{
+	ASSERT(NULL_PTR == m_pstPDUMsg);
+
+	return UDS_IsCheckUDS_RoutineControlRight(ERASE_MEMORY_ROUTINE_CONTROL, m_pstPDUMsg);
+}
+
+/*Is check sum?*/
+static uint8 UDS_IsCheckSum(const tUdsAppMsgInfo *m_pstPDUMsg)
+{
+	ASSERT(NULL_PTR == m_pstPDUMsg);
+
+	return UDS_IsCheckUDS_RoutineControlRight(CHECK_SUM_ROUTINE_CONTROL, m_pstPDUMsg);
+}
+
+/*Is check programming dependency?*/
+static uint8 UDS_IsCheckDependency(const tUdsAppMsgInfo *m_pstPDUMsg)
+{
+	ASSERT(NULL_PTR == m_pstPDUMsg);
+
+	return UDS_IsCheckUDS_RoutineControlRight(CHECK_DEPENDENCY_ROUTINE_CONTROL, m_pstPDUMsg);
+}
+
 typedef void (*tpfFlashOperateMoreTimecallback)(uint8);
 
 /* For erasing or programming flash were timeout callback */
@@ -711,14 +3154,17 @@ static void RequestMoreTimeCallback(uint8 i_TxStatus)
 
 static void UDS_RequestMoreTime(const uint8 UDSServiceID, void (*pcallback)(uint8))
 {
+    uint8 aDataBuf[3u] = {0u};
     tUdsAppMsgInfo stMsgBuf = {0};
 
     ASSERT(NULL_PTR == pcallback);
 
+    stMsgBuf.aDataBuf = aDataBuf;
     stMsgBuf.xUdsId = TP_GetConfigTxMsgID();
     UDS_SetNegativeErroCode(UDSServiceID, RCRRP, &stMsgBuf);
     stMsgBuf.pfUDSTxMsgServiceCallBack = &RequestMoreTimeCallback;
     gs_pfFlashOperateMoreTimecallback = pcallback;
+    gs_stUdsPerfInfo.responsePendingCnt++;
 
     (void)TP_WriteAFrameDataInTP(stMsgBuf.xUdsId, stMsgBuf.pfUDSTxMsgServiceCallBack,
                                  stMsgBuf.xDataLen, stMsgBuf.aDataBuf);
@@ -727,13 +3173,125 @@ static void UDS_RequestMoreTime(const uint8 UDSServiceID, void (*pcallback)(uint
 /*********************************************************/
 /**********************UDS service other module call function realizing************************/
 
+/*a programmed segment passed its read-back check (per the hal_flash verify policy)?*/
+static int32_t UDS_VerifyDownloadSegment(tDowloadSegment *m_pstSegment)
+{
+    hal_flash_job_t *pstJob = &m_pstSegment->stJob;
+    uint32 dataCrc = 0u;
+    int32_t ret = HAL_ERR_SUCCESS;
+
+    switch(hal_flash_get_verify_policy())
+    {
+    case HAL_FLASH_VERIFY_DEFERRED:
+        return HAL_ERR_SUCCESS;
+
+    case HAL_FLASH_VERIFY_SECTOR_CRC:
+        ret = UDS_Crc32(pstJob->data, pstJob->size, &dataCrc);
+        if(HAL_ERR_SUCCESS != ret)
+        {
+            return ret;
+        }
+
+        return hal_flash_verify_crc32(pstJob->addr, pstJob->size, dataCrc);
+
+    case HAL_FLASH_VERIFY_COMPARE:
+    default:
+        /*compare in the background as well*/
+        pstJob->type = HAL_FLASH_JOB_VERIFY;
+
+        return hal_flash_submit(pstJob);
+    }
+}
+
+/*download background work: drive the flash engine and the erase, recycle finished segments, answer a parked request*/
+void UDS_DownloadMainFun(void)
+{
+    tDowloadSegment *pstSegment = NULL_PTR;
+    tUDSService *pstService = NULL_PTR;
+    int32_t status = HAL_ERR_SUCCESS;
+    uint8 index = 0u;
+
+    hal_flash_main_function();
+
+    /*keep the EraseMemory range going (ahead of the segments below)*/
+    UDS_EraseMainFun();
+
+    for(index = 0u; index < UDS_DOWNLOAD_SEGMENT_NUM; index++)
+    {
+        pstSegment = &gs_astDowloadSegment[index];
+
+        if(DOWLOAD_SEGMENT_PROGRAMMING != pstSegment->state)
+        {
+            continue;
+        }
+
+        status = hal_flash_job_status(&pstSegment->stJob);
+        if((HAL_ERR_SUCCESS == status) && (HAL_FLASH_JOB_PROGRAM == pstSegment->stJob.type))
+        {
+            status = UDS_VerifyDownloadSegment(pstSegment);
+            if(HAL_ERR_SUCCESS == status)
+            {
+                status = pstSegment->stJob.result;
+            }
+        }
+
+        if(HAL_ERR_RESOURCE_BUSY == status)
+        {
+            continue;
+        }
+
+        if(HAL_ERR_SUCCESS != status)
+        {
+            gs_stDowloadDataInfo.isProgramFailed = TRUE;
+        }
+        else
+        {
+            UDS_SaveDeltaProgress(pstSegment);
+        }
+
+        pstSegment->state = DOWLOAD_SEGMENT_FREE;
+    }
+
+    /*run the parked request again, it parks itself once more while the flash is still behind*/
+    pstService = gs_stDowloadPendingInfo.pstService;
+    if(NULL_PTR == pstService)
+    {
+        return;
+    }
+
+    gs_stDowloadPendingInfo.pstService = NULL_PTR;
+    gs_stDowloadPendingInfo.stMsg.pfUDSTxMsgServiceCallBack = NULL_PTR;
+    pstService->pfSerNameFun(pstService, &gs_stDowloadPendingInfo.stMsg);
+
+    if(NULL_PTR == gs_stDowloadPendingInfo.pstService)
+    {
+        if(0u != gs_stDowloadPendingInfo.stMsg.xDataLen)
+        {
+            (void)TP_WriteAPduInTP(TP_GetConfigTxMsgID(),
+                                   gs_stDowloadPendingInfo.stMsg.pfUDSTxMsgServiceCallBack,
+                                   gs_stDowloadPendingInfo.stMsg.xDataLen,
+                                   gs_stDowloadPendingInfo.stMsg.xPdu);
+        }
+
+        /*answered, the TP holds its own reference while sending*/
+        TP_ReleasePdu(gs_stDowloadPendingInfo.stMsg.xPdu);
+        gs_stDowloadPendingInfo.stMsg.xPdu = TP_PDU_NONE;
+    }
+    else if(0u == gs_stDowloadPendingInfo.xResponsePendingTime)
+    {
+        /*keep the tester's P2* timer from running out*/
+        gs_stDowloadPendingInfo.xResponsePendingTime = UdsAppTimeToCount(UDS_RESPONSE_PENDING_TIME);
+        UDS_RequestMoreTime(pstService->serNum, &UDS_DownloadMoreTimeCallback);
+    }
+}
+
 /*transmitted confirm message callback*/
 static void UDS_TXConfrimMsgCallback(uint8 i_status)
 {
     if(TX_MSG_SUCCESSFUL == i_status)
     {
         UDS_SetCurrentSession(PROGRAM_SESSION);
-        UDS_SetSecurityLevel(NONE_SECURITY);
+        UDS_SetSecurityLevel(SECURITY_STATE_LOCKED);
 
         /*restart s3server time*/
         UDS_RestartS3Server();
@@ -743,9 +3301,11 @@ static void UDS_TXConfrimMsgCallback(uint8 i_status)
 /*write message to host basd on UDS for request enter bootloader mode*/
 boolean UDS_TxMsgToHost(void)
 {
-    tUdsAppMsgInfo stUdsAppMsg = {0u, 0u, {0u}, NULL_PTR};
+    uint8 aDataBuf[2u] = {0u};
+    tUdsAppMsgInfo stUdsAppMsg = {0u, 0u, NULL_PTR, TP_PDU_NONE, NULL_PTR};
     boolean ret = FALSE;
 
+    stUdsAppMsg.aDataBuf = aDataBuf;
     stUdsAppMsg.xUdsId = TP_GetConfigTxMsgID();
     stUdsAppMsg.xDataLen = 2u;
     stUdsAppMsg.aDataBuf[0u] = 0x51u;
@@ -770,6 +3330,11 @@ void UDS_SystemTickCtl(void)
     {
         UDS_SubUdsSecurityReqLockTime(1u);
     }
+
+    if(gs_stDowloadPendingInfo.xResponsePendingTime)
+    {
+        gs_stDowloadPendingInfo.xResponsePendingTime--;
+    }
 }
 
 /***************************End file********************************/
@@ -4,7 +4,11 @@
 // Application start address (in flash)
 #define APP_START_ADDRESS 0x00440000U
 #define EASY_BOOT_START_ADDR 0x00400000U
+// app_metadata_t placement, the application linker script must put it here:
+// a single-slot image at APP_METADATA_ADDR, an A/B image (EN_SUPPORT_APP_B)
+// APP_METADATA_SLOT_TAIL bytes before the end of its slot, see boot_ctrl.h
 #define APP_METADATA_ADDR 0x005CFFF0U
+#define APP_METADATA_SLOT_TAIL 0x40U
 #define APP_METADATA_MAGIC 0xAABBCCDDU
 #define APP_NAME_MAX_LEN 16U
 #define APP_VERSION_MAX_LEN 12U
@@ -79,10 +83,11 @@ int32_t boot_read_device_id(char *id_buffer, size_t buf_size);
  * @brief Start execution of the user application from flash.
  *
  * This function performs the necessary steps to safely jump from
- * the bootloader to the application code located at a fixed flash
- * address (APP_START_ADDRESS).
+ * the bootloader to the application code located in the slot chosen
+ * by boot_ctrl_select_slot() (see boot_ctrl.h).
  *
  * Steps performed:
+ * 0. Flush the log ring (osal_log_flush()) so pending messages are sent.
  * 1. Disable interrupts to avoid unexpected behavior during jump.
  * 2. Read and validate the application's initial stack pointer (MSP).
  * 3. Read the application reset vector (initial PC) from vector table.
@@ -93,7 +98,7 @@ int32_t boot_read_device_id(char *id_buffer, size_t buf_size);
  *
  * If validation fails, the function will enter a failure loop with an LED indication.
  *
- * @note APP_START_ADDRESS must be defined elsewhere as the base address of the application in flash.
+ * @note With EN_SUPPORT_APP_B, slot A starts at APP_START_ADDRESS and slot B at BOOT_SLOT_B_ADDR.
  * @note This function does not return on success.
  */
 void boot_app(void);
@@ -0,0 +1,155 @@
+/**
+ * @file boot_ctrl.h
+ * @brief A/B application slot layout and boot-control record
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * int_flash_app_0 is split into two equally sized application slots. Which
+ * slot boots is decided by a small boot-control record kept in data flash.
+ * The record is stored ping-pong style in two data flash sectors: a new copy
+ * is always written to the sector that does not hold the current one, so a
+ * reset in the middle of an update leaves the previous record intact.
+ *
+ * A freshly programmed slot is marked pending (unconfirmed). The bootloader
+ * gives it BOOT_CTRL_MAX_TRIES boots; the application must confirm itself
+ * through boot_ctrl_mark_confirmed() (or by writing the same record layout)
+ * before the tries run out, otherwise the bootloader falls back to the other
+ * slot.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial A/B slot support
+ */
+
+#ifndef BOOT_CTRL_H_
+#define BOOT_CTRL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "user_config.h"
+#include "boot.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*******************************************************************************
+ * Slot layout
+ ******************************************************************************/
+
+#ifdef EN_SUPPORT_APP_B
+#define BOOT_SLOT_COUNT             (2U)
+#define BOOT_SLOT_SIZE              (0x000CA000U)   /* Half of int_flash_app_0 (808 KiB) */
+#define BOOT_SLOT_A_ADDR            (APP_START_ADDRESS)
+#define BOOT_SLOT_B_ADDR            (APP_START_ADDRESS + BOOT_SLOT_SIZE)
+/* Each slot carries its own app_metadata_t at the end of the slot, not at APP_METADATA_ADDR */
+#define BOOT_SLOT_METADATA_OFFSET   (BOOT_SLOT_SIZE - APP_METADATA_SLOT_TAIL)
+#else
+#define BOOT_SLOT_COUNT             (1U)
+#define BOOT_SLOT_SIZE              (0x00194000U)   /* Whole int_flash_app_0 */
+#define BOOT_SLOT_A_ADDR            (APP_START_ADDRESS)
+#define BOOT_SLOT_METADATA_OFFSET   (APP_METADATA_ADDR - APP_START_ADDRESS)
+#endif
+
+/*******************************************************************************
+ * Boot-control record (data flash)
+ ******************************************************************************/
+
+#define BOOT_CTRL_SECTOR_0_ADDR     (0x10010000U)   /* Data flash, first copy */
+#define BOOT_CTRL_SECTOR_1_ADDR     (0x10012000U)   /* Data flash, second copy */
+#define BOOT_CTRL_MAGIC             (0x42435452U)   /* "BCTR" */
+#define BOOT_CTRL_MAX_TRIES         (3U)            /* Boots allowed before an unconfirmed slot is dropped */
+
+typedef struct
+{
+    uint32_t magic;                         // 0x00: BOOT_CTRL_MAGIC
+    uint32_t sequence;                      // 0x04: Incremented on every record update
+    uint32_t generation[2];                 // 0x08: Per-slot image generation, higher is newer
+    uint8_t  active_slot;                   // 0x10: tAPPType of the slot to boot
+    uint8_t  try_count;                     // 0x11: Boots of active_slot while unconfirmed
+    uint8_t  confirmed_mask;                // 0x12: Bit n set when slot n confirmed itself
+    uint8_t  reserved[9];                   // 0x13: Pads the record to a flash double word
+    uint32_t crc32;                         // 0x1C: CRC32 over bytes 0x00..0x1B
+} boot_ctrl_record_t;
+
+/*******************************************************************************
+ * API
+ ******************************************************************************/
+
+/**
+ * @brief Base address of an application slot.
+ * @param slot APP_A_TYPE or APP_B_TYPE.
+ * @return Slot base address, 0 for an invalid slot.
+ */
+uint32_t boot_ctrl_slot_addr(tAPPType slot);
+
+/**
+ * @brief Address of the app_metadata_t block inside a slot.
+ * @param slot APP_A_TYPE or APP_B_TYPE.
+ * @return Metadata address, 0 for an invalid slot.
+ */
+uint32_t boot_ctrl_slot_metadata_addr(tAPPType slot);
+
+/**
+ * @brief Check that a slot holds a bootable image: valid metadata magic,
+ *        a sane vector table pointer and a matching image CRC32
+ *        (see boot_verify_image()).
+ * @param slot APP_A_TYPE or APP_B_TYPE.
+ * @return true if the slot is bootable.
+ */
+bool boot_ctrl_is_slot_valid(tAPPType slot);
+
+/**
+ * @brief Load the most recent valid boot-control record from data flash.
+ * @param[out] record Record buffer.
+ * @return 0 on success, -1 if no valid record exists.
+ */
+int32_t boot_ctrl_load(boot_ctrl_record_t *record);
+
+/**
+ * @brief Decide which slot to boot, updating the try counter and performing
+ *        the fallback to the other slot when needed.
+ *
+ * Called once per boot, before the jump. A pending slot consumes one try per
+ * call; once BOOT_CTRL_MAX_TRIES is exceeded the record is switched back to
+ * the newest (highest generation) confirmed slot that is valid. A confirmed
+ * active slot that turns invalid falls back the same way, without changing
+ * the record. Falling back needs EN_NEWEST_APP_INVALID_JUMP_OLD_APP.
+ *
+ * @return Slot to boot, or APP_INVLID_TYPE if no slot is bootable.
+ */
+tAPPType boot_ctrl_select_slot(void);
+
+/**
+ * @brief Slot that boot_ctrl_select_slot() picked on this boot.
+ * @return Selected slot, APP_A_TYPE before any selection has run.
+ */
+tAPPType boot_ctrl_get_selected_slot(void);
+
+/**
+ * @brief Slot that is not currently active, i.e. the download target.
+ * @return Inactive slot (APP_A_TYPE when only one slot is configured).
+ */
+tAPPType boot_ctrl_get_inactive_slot(void);
+
+/**
+ * @brief Mark a freshly programmed slot as the next one to boot (unconfirmed).
+ * @param slot Slot that has just been programmed.
+ * @return HAL_ERR_SUCCESS on success, or a HAL flash error code.
+ */
+int32_t boot_ctrl_mark_pending(tAPPType slot);
+
+/**
+ * @brief Confirm a slot so it is no longer subject to the try limit.
+ * @param slot Slot to confirm.
+ * @return HAL_ERR_SUCCESS on success, or a HAL flash error code.
+ */
+int32_t boot_ctrl_mark_confirmed(tAPPType slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_CTRL_H_ */
@@ -0,0 +1,188 @@
+/**
+ * @file boot_delta.h
+ * @brief Streaming delta patch applier for differential downloads
+ *
+ * @version 1.1.0
+ * @date 2026-10-17
+ *
+ * @details
+ * A patch rebuilds a new image from the installed one (the source, read from
+ * flash, never written) plus the bytes that changed. All values big endian.
+ *
+ *   header  BOOT_DELTA_HEADER_SIZE bytes:
+ *           magic      BOOT_DELTA_MAGIC
+ *           src_size   bytes of the source the patch was made against
+ *           src_crc    CRC32 of those bytes, checked before any output
+ *           dst_size   size of the rebuilt image
+ *           dst_crc    CRC32 of the rebuilt image
+ *
+ *   then operations until dst_size bytes have been produced:
+ *
+ *   0nnnnnnn <n + 1 bytes>             insert the following bytes
+ *   1nnnnnnn nnnnnnnn <zigzag LEB128>  copy n + 1 source bytes; the varint
+ *                                      is the signed distance from the end
+ *                                      of the previous copy (0 at start)
+ *
+ * Copies never leave [0, src_size). The output only ever moves forward, so
+ * it can be streamed into flash sector by sector; the source and the output
+ * must not overlap (the download goes to the inactive A/B slot). Input and
+ * output may be split into pieces of any size, as with boot_lzss.h.
+ * tools/delta holds the matching host-side diff generator.
+ *
+ * Progress survives a reset: whenever a sector of the output is in flash the
+ * caller appends a boot_delta_progress_t to a data flash sector of its own.
+ * After a reset boot_delta_resume() restores the applier from the newest
+ * record, and the patch goes on from delta.in_total instead of byte 0.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial patch applier
+ *  - v1.1.0, 2026-10-17, Progress records to resume after a reset
+ */
+
+#ifndef BOOT_DELTA_H_
+#define BOOT_DELTA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_DELTA_MAGIC            (0x45424450UL)  /* "EBDP" */
+#define BOOT_DELTA_HEADER_SIZE      (20U)
+#define BOOT_DELTA_MAX_INSERT       (0x80U)
+#define BOOT_DELTA_MAX_COPY         (0x8000U)
+
+#define BOOT_DELTA_PROGRESS_ADDR    (0x10018000U)   /* Data flash sector after the UDS fingerprint */
+#define BOOT_DELTA_PROGRESS_MAGIC   (0x44505247UL)  /* "DPRG" */
+
+/**
+ * @brief Applier state, see boot_delta_init()
+ */
+typedef struct
+{
+    uint32_t src_addr;                          /* Flash address of source byte 0 */
+    uint32_t src_limit;                         /* Largest src_size accepted */
+    uint32_t dst_expected;                      /* dst_size the caller announced */
+    uint32_t src_size;                          /* Header fields, valid once the header is in */
+    uint32_t src_crc;
+    uint32_t dst_size;
+    uint32_t dst_crc;
+    uint32_t out_total;                         /* Bytes produced since boot_delta_init() */
+    uint32_t in_total;                          /* Patch bytes consumed since boot_delta_init() */
+    uint32_t src_pos;                           /* Next source byte of the copy in progress */
+    uint32_t remain;                            /* Bytes of the current operation still to produce */
+    uint32_t varint;                            /* Copy distance being assembled */
+    uint8_t  varint_shift;
+    uint8_t  state;                             /* Next item expected, see boot_delta.c */
+    uint8_t  header_len;                        /* Header bytes collected */
+    uint8_t  header[BOOT_DELTA_HEADER_SIZE];
+} boot_delta_t;
+
+/**
+ * @brief Progress record, appended to the BOOT_DELTA_PROGRESS_ADDR sector
+ *
+ * A whole number of flash write units, programmed in one go.
+ */
+typedef struct
+{
+    uint32_t magic;                             /* BOOT_DELTA_PROGRESS_MAGIC */
+    uint32_t dst_addr;                          /* Flash address of output byte 0 */
+    uint32_t out_crc;                           /* CRC32 of the delta.out_total bytes in flash */
+    boot_delta_t delta;                         /* Applier state right after those bytes */
+    uint32_t crc32;                             /* CRC32 over the bytes before */
+} boot_delta_progress_t;
+
+/**
+ * @brief Start applying a new patch
+ *
+ * @param dt Applier state
+ * @param src_addr Flash address of the installed image the patch copies from
+ * @param src_limit Bytes readable at src_addr
+ * @param dst_size Size of the image the caller expects the patch to build
+ */
+void boot_delta_init(boot_delta_t *dt, uint32_t src_addr, uint32_t src_limit, uint32_t dst_size);
+
+/**
+ * @brief Apply as much of the patch as fits into out
+ *
+ * Stops when out is full or the input is used up. *in and *in_len are
+ * advanced past the consumed input; a partly received header or operation
+ * stays in the state. Call again while *out_len == out_size.
+ *
+ * @param dt Applier state
+ * @param in Input pointer, advanced
+ * @param in_len Input bytes left, decremented
+ * @param out Output buffer
+ * @param out_size Size of out
+ * @param[out] out_len Bytes written to out
+ * @return HAL_ERR_SUCCESS,
+ *         HAL_ERR_FLASH_VERIFY_FAILED if the installed image is not the one
+ *         the patch was made for,
+ *         HAL_ERR_INVALID_PARAM for a corrupt patch (bad header, dst_size
+ *         other than announced, copy outside the source, output past dst_size),
+ *         or the hal_flash_read() error of a copy
+ */
+int32_t boot_delta_apply(boot_delta_t *dt, const uint8_t **in, uint32_t *in_len,
+                         uint8_t *out, uint32_t out_size, uint32_t *out_len);
+
+/**
+ * @brief Tells whether the patch is complete: dst_size bytes produced and no
+ *        operation half received
+ */
+bool boot_delta_is_done(const boot_delta_t *dt);
+
+/**
+ * @brief Fill in a progress record for the applier state at a sector boundary
+ *
+ * @param progress Record to fill in, ready to be programmed
+ * @param dt Applier state right after the last byte now in flash
+ * @param dst_addr Flash address of output byte 0
+ * @param out_crc CRC32 of the dt->out_total bytes at dst_addr
+ */
+void boot_delta_progress_make(boot_delta_progress_t *progress, const boot_delta_t *dt,
+                              uint32_t dst_addr, uint32_t out_crc);
+
+/**
+ * @brief Find the newest intact progress record
+ *
+ * Records are appended; a torn or unreadable one is skipped.
+ *
+ * @param[out] progress Newest record, only valid when true is returned
+ * @param[out] next_addr Where the next record goes: behind the last one
+ *             written, BOOT_DELTA_PROGRESS_ADDR + sector size when full
+ * @return true if a record was found
+ */
+bool boot_delta_progress_load(boot_delta_progress_t *progress, uint32_t *next_addr);
+
+/**
+ * @brief Drop all progress records, erasing their sector unless it is blank
+ * @return HAL_ERR_SUCCESS or the hal_flash_erase_sector() error
+ */
+int32_t boot_delta_progress_clear(void);
+
+/**
+ * @brief Restore the applier from a progress record
+ *
+ * The record must be for this download (same output address and size, same
+ * source address), the installed image must still be the patch's source and
+ * the output written before the reset must still be in flash.
+ *
+ * @param dt Applier state, left alone on failure
+ * @param progress Record from boot_delta_progress_load()
+ * @param src_addr Flash address of the installed image
+ * @param dst_addr Flash address of output byte 0
+ * @param dst_size Size of the image the caller expects the patch to build
+ * @return HAL_ERR_SUCCESS,
+ *         HAL_ERR_INVALID_PARAM if the record belongs to another download,
+ *         HAL_ERR_FLASH_VERIFY_FAILED if the source or the output changed
+ */
+int32_t boot_delta_resume(boot_delta_t *dt, const boot_delta_progress_t *progress,
+                          uint32_t src_addr, uint32_t dst_addr, uint32_t dst_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_DELTA_H_ */
@@ -0,0 +1,104 @@
+/**
+ * @file boot_lzss.h
+ * @brief Streaming LZSS decompressor for compressed downloads
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * Heatshrink-class LZSS with a fixed 2 KiB window. The stream is a sequence
+ * of bits, most significant bit of each byte first:
+ *
+ *   1 <8 bits>                         literal byte
+ *   0 <W bits: distance - 1> <L bits: count - 1>
+ *                                      copy count bytes starting distance
+ *                                      bytes back in the output
+ *
+ * with W = BOOT_LZSS_WINDOW_BITS and L = BOOT_LZSS_COUNT_BITS. A copy may
+ * overlap the bytes it produces (run-length style) but never reaches back
+ * before the first output byte. The last byte is padded with zero bits.
+ *
+ * The decoder keeps only the window and a few bits of state, so input can be
+ * fed in pieces of any size (one UDS TransferData block at a time) and the
+ * output can be drained into any number of buffers. tools/lzss holds the
+ * matching host-side compressor.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial decompressor
+ */
+
+#ifndef BOOT_LZSS_H_
+#define BOOT_LZSS_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_LZSS_WINDOW_BITS       (11U)
+#define BOOT_LZSS_COUNT_BITS        (4U)
+#define BOOT_LZSS_WINDOW_SIZE       (1UL << BOOT_LZSS_WINDOW_BITS)
+#define BOOT_LZSS_MAX_COUNT         (1UL << BOOT_LZSS_COUNT_BITS)
+
+/*
+ * Most output n more input bytes can produce: every 16 bits a full-length
+ * copy, plus one copy completed by bits left over from earlier input and one
+ * still in progress from the previous call
+ */
+#define BOOT_LZSS_MAX_OUTPUT(n)     ((((n) / 2U) + 2U) * BOOT_LZSS_MAX_COUNT)
+
+/**
+ * @brief Decoder state, see boot_lzss_init()
+ */
+typedef struct
+{
+    uint8_t  window[BOOT_LZSS_WINDOW_SIZE];    /* Last BOOT_LZSS_WINDOW_SIZE output bytes */
+    uint32_t out_total;                         /* Bytes produced since boot_lzss_init() */
+    uint32_t bits;                              /* Input bits not consumed yet (low bit_count bits) */
+    uint8_t  bit_count;
+    uint8_t  state;                             /* Next item expected, see boot_lzss.c */
+    uint16_t distance;                          /* Copy in progress */
+    uint16_t count;                             /* Copy bytes still to produce */
+} boot_lzss_t;
+
+/**
+ * @brief Start a new stream
+ *
+ * @param lz Decoder state
+ */
+void boot_lzss_init(boot_lzss_t *lz);
+
+/**
+ * @brief Decode as much as fits into out
+ *
+ * Stops when out is full or the input is used up. *in and *in_len are
+ * advanced past the consumed input; bits of a partially received item are
+ * kept in the state, so the next call simply continues with more input.
+ * Call again with the same input while *out_len == out_size.
+ *
+ * @param lz Decoder state
+ * @param in Input pointer, advanced
+ * @param in_len Input bytes left, decremented
+ * @param out Output buffer
+ * @param out_size Size of out
+ * @param[out] out_len Bytes written to out
+ * @return HAL_ERR_SUCCESS, or HAL_ERR_INVALID_PARAM for a copy that reaches
+ *         back before the start of the stream (corrupt input)
+ */
+int32_t boot_lzss_decode(boot_lzss_t *lz, const uint8_t **in, uint32_t *in_len,
+                         uint8_t *out, uint32_t out_size, uint32_t *out_len);
+
+/**
+ * @brief Tells whether no copy is half done, i.e. the output so far is complete
+ *
+ * Leftover padding bits do not count as pending.
+ */
+bool boot_lzss_is_idle(const boot_lzss_t *lz);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_LZSS_H_ */
@@ -0,0 +1,80 @@
+/**
+ * @file boot_verify.h
+ * @brief Application image CRC32 verification with a verified-image cache
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * An image is verified by computing CRC32 over
+ * [flash_start_addr, flash_start_addr + image_size) and comparing it with
+ * app_metadata_t.crc32. A successful full scan is remembered in a small
+ * record in data flash (one entry per slot) holding the image CRC, a CRC32
+ * of the metadata block and the slot's flash program counter (the
+ * boot-control generation). On later boots the scan is skipped as long as
+ * all three still match.
+ *
+ * Anything that reprograms a slot must call boot_verify_invalidate() before
+ * the first erase, so an interrupted download cannot hit a stale entry.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial image verification and cache
+ */
+
+#ifndef BOOT_VERIFY_H_
+#define BOOT_VERIFY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "user_config.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BOOT_VERIFY_CACHE_ADDR      (0x10014000U)   /* Data flash sector after the boot-control copies */
+#define BOOT_VERIFY_MAGIC           (0x56455249U)   /* "VERI" */
+
+typedef struct
+{
+    uint32_t slot_addr;                     // 0x00: Slot base address the entry belongs to
+    uint32_t image_crc;                     // 0x04: CRC32 of the image as verified
+    uint32_t meta_crc;                      // 0x08: CRC32 of the app_metadata_t block
+    uint32_t program_count;                 // 0x0C: Slot flash program counter at verify time
+} boot_verify_entry_t;
+
+typedef struct
+{
+    uint32_t magic;                         // 0x00: BOOT_VERIFY_MAGIC
+    uint32_t reserved;                      // 0x04: Keeps entries double-word aligned
+    boot_verify_entry_t entry[2];           // 0x08: One entry per slot
+    uint32_t pad;                           // 0x28: Pads the record to a flash double word
+    uint32_t crc32;                         // 0x2C: CRC32 over bytes 0x00..0x2B
+} boot_verify_cache_t;
+
+/**
+ * @brief Verify the image in a slot against the CRC32 in its metadata.
+ *
+ * Uses the cache when it matches, otherwise performs the full scan and
+ * refreshes the cache entry on success.
+ *
+ * @param slot Slot to verify.
+ * @param[out] cached Optional, set to true when the result came from the cache.
+ * @return HAL_ERR_SUCCESS if the image is intact, HAL_ERR_INVALID_PARAM for
+ *         bad metadata, HAL_ERR_FLASH_VERIFY_FAILED on CRC mismatch, or
+ *         the hal_crc32_update() error (e.g. HAL_ERR_TIMEOUT).
+ */
+int32_t boot_verify_image(tAPPType slot, bool *cached);
+
+/**
+ * @brief Drop the cache entry of a slot, forcing a full scan on next boot.
+ * @param slot Slot about to be reprogrammed.
+ * @return HAL_ERR_SUCCESS or a HAL flash error code.
+ */
+int32_t boot_verify_invalidate(tAPPType slot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BOOT_VERIFY_H_ */
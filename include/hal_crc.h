@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -12,10 +13,43 @@ extern "C" {
 #define HAL_CRC_USE_HARDWARE 1
 #endif
 
+/*
+ * Software CRC32 variant, used when HAL_CRC_USE_HARDWARE is 0:
+ *   1 - byte-at-a-time, single 1 KiB table
+ *   4 - slicing-by-4, 4 KiB of tables
+ *   8 - slicing-by-8, 8 KiB of tables
+ * The sliced tables and the CRC16 table are built on first use and live in
+ * DTCM on target.
+ */
+#ifndef HAL_CRC_SW_SLICING
+#define HAL_CRC_SW_SLICING 8
+#endif
+
+/* Largest block handed to one hardware CRC/DMA transfer; bigger updates are chained */
+#ifndef HAL_CRC_DMA_CHUNK_SIZE
+#define HAL_CRC_DMA_CHUNK_SIZE (0x4000U)
+#endif
+
+/**
+ * @brief Streaming CRC32 context, see hal_crc32_begin()
+ *
+ * Treat as opaque. The hardware path has a single CRC32 channel, so only one
+ * context can be in progress at a time; the software path has no such limit.
+ */
+typedef struct
+{
+    uint32_t crc;               /* Running CRC32 */
+    const uint8_t *data;        /* Next byte not yet handed to the engine */
+    size_t remaining;           /* Bytes of the current update still to feed */
+    uint32_t wait;              /* Polls spent on the chunk in flight */
+    bool first;                 /* Next hardware chunk starts a new CRC */
+    bool running;               /* A hardware chunk is in flight */
+} hal_crc32_ctx_t;
+
 /**
  * @brief Initializes the CRC module (hardware/software depending on configuration)
  *        - For hardware: initializes Crc_Ip channel configuration
- *        - For software: optional (no operation)
+ *        - For software: builds the lookup tables (also done lazily on first use)
  */
 void hal_crc_init(void);
 
@@ -46,6 +80,73 @@ uint16_t hal_crc16_compute(const uint8_t *data, size_t length, uint16_t init_val
  */
 uint32_t hal_crc32_compute(const uint8_t *data, size_t length, uint32_t init_value);
 
+/**
+ * @brief CRC32 of A followed by B from the CRC32 of A, the CRC32 of B and
+ *        the length of B (pure arithmetic, no CRC channel involved)
+ *
+ * Lets a CRC32 be built from pieces computed independently, e.g. with
+ * hal_crc32_begin/update/final while other users share the channel in
+ * between. The CRC32 of no data is 0.
+ *
+ * @param crc1 CRC32 of A
+ * @param crc2 CRC32 of B
+ * @param len2 Length of B in bytes
+ * @return CRC32 of A followed by B
+ */
+uint32_t hal_crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2);
+
+/**
+ * @brief Start a streaming CRC32 (Ethernet, same result as hal_crc32_compute
+ *        with a fresh init value) over data fed in any number of updates
+ *
+ * @param ctx Context to initialize
+ * @return HAL_ERR_SUCCESS, HAL_ERR_NOT_INITIALIZED, or HAL_ERR_RESOURCE_BUSY
+ *         when another context is using the hardware channel
+ */
+int32_t hal_crc32_begin(hal_crc32_ctx_t *ctx);
+
+/**
+ * @brief Feed data and wait until it has been processed
+ *
+ * Regions of any size are accepted; on hardware they are split into
+ * HAL_CRC_DMA_CHUNK_SIZE transfers chained through the CRC channel.
+ *
+ * @return HAL_ERR_SUCCESS, HAL_ERR_TIMEOUT if a DMA transfer never completed
+ *         (the context is then dead and must be restarted), or the errors of
+ *         hal_crc32_update_async()
+ */
+int32_t hal_crc32_update(hal_crc32_ctx_t *ctx, const uint8_t *data, size_t length);
+
+/**
+ * @brief Feed data without waiting; the caller keeps calling hal_crc32_poll()
+ *
+ * The buffer must stay valid and unchanged until hal_crc32_poll() returns
+ * something other than HAL_ERR_RESOURCE_BUSY. On the software path the data
+ * is processed before returning.
+ *
+ * @return HAL_ERR_SUCCESS once queued, HAL_ERR_RESOURCE_BUSY if the previous
+ *         update is still running, HAL_ERR_INVALID_PARAM on bad arguments
+ */
+int32_t hal_crc32_update_async(hal_crc32_ctx_t *ctx, const uint8_t *data, size_t length);
+
+/**
+ * @brief Advance an asynchronous update, starting the next chained chunk
+ *        when the previous one has completed
+ *
+ * @return HAL_ERR_SUCCESS when all queued data is processed,
+ *         HAL_ERR_RESOURCE_BUSY while still running, HAL_ERR_TIMEOUT
+ */
+int32_t hal_crc32_poll(hal_crc32_ctx_t *ctx);
+
+/**
+ * @brief Finish a streaming CRC32 and release the hardware channel
+ *
+ * @param ctx Context
+ * @param[out] crc Final CRC32
+ * @return HAL_ERR_SUCCESS, HAL_ERR_RESOURCE_BUSY if an update is still running
+ */
+int32_t hal_crc32_final(hal_crc32_ctx_t *ctx, uint32_t *crc);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,8 +2,8 @@
  * @file hal_flash.h
  * @brief Hardware Abstraction Layer (HAL) interface for flash memory operations
  *
- * @version 1.0.1
- * @date 2025-06-21
+ * @version 1.4.0
+ * @date 2026-10-17
  *
  * @details
  * This header file provides function prototypes for flash memory operations
@@ -14,6 +14,10 @@
  * @history
  *  - v1.0.0, 2024-12-23, Initial flash HAL interface definitions
  *  - v1.0.1, 2025-06-21, Added hal_flash_erase_sector function
+ *  - v1.1.0, 2026-10-17, Added asynchronous job engine (hal_flash_submit/hal_flash_main_function)
+ *  - v1.2.0, 2026-10-17, Added hal_flash_program, erase-ahead and blank check; hal_flash_write is now a wrapper
+ *  - v1.3.0, 2026-10-17, Added write-combining page buffer (hal_flash_wc_*)
+ *  - v1.4.0, 2026-10-17, Added configurable verify policy and hal_flash_verify_crc32
  */
 
 #ifndef HAL_FLASH_H
@@ -27,6 +31,74 @@
 extern "C" {
 #endif
 
+#define HAL_FLASH_SECTOR_SIZE       (8192u)     /* Erase granularity */
+#define HAL_FLASH_PROGRAM_CHUNK     (128u)      /* Bytes programmed per engine step (one C40 quad-page) */
+#define HAL_FLASH_VERIFY_CHUNK      (1024u)     /* Bytes compared per engine step */
+#define HAL_FLASH_WRITE_UNIT        (8u)        /* ECC granularity; partial pages are padded to this */
+
+/**
+ * @brief Asynchronous flash job types
+ */
+typedef enum
+{
+    HAL_FLASH_JOB_ERASE = 0,    /* Erase [addr, addr + size), sector aligned */
+    HAL_FLASH_JOB_PROGRAM,      /* Program data into [addr, addr + size), range must be erased */
+    HAL_FLASH_JOB_VERIFY,       /* Compare [addr, addr + size) against data */
+} hal_flash_job_type_t;
+
+struct hal_flash_job;
+
+/**
+ * @brief Completion callback, called from hal_flash_main_function()
+ *
+ * @param job The finished job; it is no longer queued and may be resubmitted
+ * @param result HAL_ERR_SUCCESS or a HAL flash error code
+ */
+typedef void (*hal_flash_job_cb_t)(struct hal_flash_job *job, int32_t result);
+
+/**
+ * @brief Asynchronous flash job
+ *
+ * Storage is owned by the caller and must stay valid until the job completes.
+ * Fill in the public fields; the rest is managed by the engine.
+ */
+typedef struct hal_flash_job
+{
+    hal_flash_job_type_t type;
+    uint32_t addr;
+    uint32_t size;
+    const uint8_t *data;            /* Source for program/verify, unused for erase */
+    hal_flash_job_cb_t complete;    /* Optional */
+    void *user;                     /* Free for the caller */
+
+    /* Engine private */
+    uint32_t done;                  /* Bytes finished */
+    volatile int32_t result;        /* HAL_ERR_RESOURCE_BUSY while queued or running */
+    struct hal_flash_job *next;
+} hal_flash_job_t;
+
+/**
+ * @brief How hal_flash_program() checks what it has just programmed
+ */
+typedef enum
+{
+    HAL_FLASH_VERIFY_COMPARE = 0,   /* Compare against the source after every program (default) */
+    HAL_FLASH_VERIFY_SECTOR_CRC,    /* CRC32 of the source vs. CRC32 read back, per sector span */
+    HAL_FLASH_VERIFY_DEFERRED,      /* No inline check; caller runs hal_flash_verify_crc32() at the end */
+} hal_flash_verify_policy_t;
+
+/**
+ * @brief Write-combining stream into erased flash, see hal_flash_wc_open()
+ */
+typedef struct
+{
+    uint32_t addr;                                      /* Next byte to be written */
+    uint32_t page_base;                                 /* Flash address of page[] */
+    uint32_t page_start;                                /* First valid byte in page[] */
+    uint32_t page_fill;                                 /* One past the last valid byte, 0 when empty */
+    uint32_t page[HAL_FLASH_PROGRAM_CHUNK / 4u];        /* Word aligned page image */
+} hal_flash_wc_t;
+
 /**
  * @brief Initializes the flash memory interface
  *
@@ -42,6 +114,10 @@ void hal_flash_free(void);
 /**
  * @brief Writes data to the flash memory at the specified address
  *
+ * Compatibility wrapper: erases every sector the range touches (including
+ * bytes outside the range), then programs. Use hal_flash_program() with an
+ * explicit erase for anything written in more than one piece.
+ *
  * @param addr The starting address in flash memory to write to
  * @param data Pointer to the data buffer to write
  * @param size The size in bytes of the data to write
@@ -49,6 +125,111 @@ void hal_flash_free(void);
  */
 int32_t hal_flash_write(uint32_t addr, const uint8_t* data, uint32_t size);
 
+/**
+ * @brief Programs data into already erased flash, without erasing
+ *
+ * @param addr The starting address in flash memory to program
+ * @param data Pointer to the data buffer to program
+ * @param size The size in bytes of the data to program
+ * @return int32_t Returns HAL_SUCCESS on success, HAL_ERR_FLASH_WRITE_FAILED if
+ *         the controller rejects the write (e.g. target not erased),
+ *         HAL_ERR_FLASH_VERIFY_FAILED if the read-back differs, or the CRC
+ *         error if the HAL_FLASH_VERIFY_SECTOR_CRC read-back cannot run
+ */
+int32_t hal_flash_program(uint32_t addr, const uint8_t* data, uint32_t size);
+
+/**
+ * @brief Erases all sectors overlapping [addr, addr + size) and waits
+ *
+ * @param addr Start of the range, any 4-byte aligned address
+ * @param size Size of the range in bytes
+ * @return int32_t Returns HAL_SUCCESS on success, or a negative error code on failure
+ */
+int32_t hal_flash_erase_range(uint32_t addr, uint32_t size);
+
+/**
+ * @brief Queues an erase of all sectors overlapping [addr, addr + size)
+ *
+ * Used to erase ahead of the program pointer while data is still arriving.
+ *
+ * @param job Caller-owned job storage, see hal_flash_submit()
+ * @param addr Start of the range, any 4-byte aligned address
+ * @param size Size of the range in bytes
+ * @return int32_t As hal_flash_submit()
+ */
+int32_t hal_flash_erase_ahead(hal_flash_job_t *job, uint32_t addr, uint32_t size);
+
+/**
+ * @brief Checks that a range reads as erased (all 0xFF)
+ *
+ * @param addr The starting address in flash memory
+ * @param size The size in bytes to check
+ * @return int32_t Returns HAL_SUCCESS if blank, HAL_ERR_FLASH_VERIFY_FAILED if
+ *         not, or a negative error code on failure
+ */
+int32_t hal_flash_blank_check(uint32_t addr, uint32_t size);
+
+/**
+ * @brief Starts a write-combining stream at addr
+ *
+ * Bytes passed to hal_flash_wc_write() are gathered into HAL_FLASH_PROGRAM_CHUNK
+ * pages and each full page is programmed with a single quad-page write;
+ * page-aligned runs from word-aligned buffers are programmed directly. The
+ * target range must be erased. addr does not need any alignment.
+ *
+ * @param wc Stream state
+ * @param addr First flash address of the stream
+ * @return int32_t HAL_ERR_SUCCESS or HAL_ERR_INVALID_PARAM
+ */
+int32_t hal_flash_wc_open(hal_flash_wc_t *wc, uint32_t addr);
+
+/**
+ * @brief Appends data to the stream
+ *
+ * @param wc Stream state
+ * @param data Bytes to append
+ * @param size Number of bytes, any value
+ * @return int32_t As hal_flash_program()
+ */
+int32_t hal_flash_wc_write(hal_flash_wc_t *wc, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Programs the partially filled page, padded with 0xFF to HAL_FLASH_WRITE_UNIT
+ *
+ * After a commit the stream must not continue inside the same write unit.
+ *
+ * @param wc Stream state
+ * @return int32_t As hal_flash_program()
+ */
+int32_t hal_flash_wc_commit(hal_flash_wc_t *wc);
+
+/**
+ * @brief Selects the verify policy used by hal_flash_program() and its users
+ *        (hal_flash_write(), hal_flash_wc_*)
+ *
+ * @param policy New policy
+ */
+void hal_flash_set_verify_policy(hal_flash_verify_policy_t policy);
+
+/**
+ * @brief Returns the current verify policy
+ */
+hal_flash_verify_policy_t hal_flash_get_verify_policy(void);
+
+/**
+ * @brief Checks a programmed range against an expected CRC32 in one pass
+ *
+ * This is the end-of-session check for HAL_FLASH_VERIFY_DEFERRED. The CRC is
+ * the same one hal_crc32_begin/update/final produces.
+ *
+ * @param addr Start of the range
+ * @param size Size of the range in bytes
+ * @param expected_crc Expected CRC32
+ * @return int32_t HAL_ERR_SUCCESS, HAL_ERR_FLASH_VERIFY_FAILED on mismatch,
+ *         HAL_ERR_INVALID_PARAM, or the CRC engine error (e.g. HAL_ERR_TIMEOUT)
+ */
+int32_t hal_flash_verify_crc32(uint32_t addr, uint32_t size, uint32_t expected_crc);
+
 /**
  * @brief Reads data from the flash memory at the specified address
  *
@@ -68,6 +249,41 @@ int32_t hal_flash_read(uint32_t addr, uint8_t* data, uint32_t size);
  */
 int32_t hal_flash_erase_sector(uint32_t addr, uint32_t num_sectors);
 
+/**
+ * @brief Queues an asynchronous job; it runs from hal_flash_main_function()
+ *
+ * Jobs run one at a time in submission order. The engine is not reentrant:
+ * submit and drive it from the same context (main loop or one timer tick).
+ *
+ * @param job Job to queue
+ * @return int32_t HAL_ERR_SUCCESS once queued, HAL_ERR_INVALID_PARAM,
+ *         HAL_ERR_NOT_INITIALIZED, or HAL_ERR_RESOURCE_BUSY if the job is already queued
+ */
+int32_t hal_flash_submit(hal_flash_job_t *job);
+
+/**
+ * @brief Advances the job engine by one step without blocking
+ *
+ * A step either checks the flash controller for the operation in flight or
+ * starts the next one (one sector erase, one program chunk, one verify chunk).
+ * Call it from the main loop or a periodic tick.
+ */
+void hal_flash_main_function(void);
+
+/**
+ * @brief Current status of a job
+ *
+ * @return int32_t HAL_ERR_RESOURCE_BUSY while queued or running, otherwise the final result
+ */
+int32_t hal_flash_job_status(const hal_flash_job_t *job);
+
+/**
+ * @brief Tells whether the job queue is empty
+ *
+ * @return bool true when no job is queued or running
+ */
+bool hal_flash_is_idle(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -41,6 +41,7 @@ version:   author:       date&&time:      revision log: </b>
  * \n <i>supports 1ms and 100ms tick tracking</i>
  *  - provides timer initialization and deinitialization
  *  - tracks 1ms and 100ms timeouts
+ *  - provides a free-running microsecond counter
  *  - generates random seed from timer ticks
  *
  * implements : hal_timer_instance_t_class
@@ -101,6 +102,18 @@ bool hal_timer_is_100ms_tick_timeout(void);
 /* gets timer tick count for random seed generation */
 uint32_t hal_timer_get_timer_tick_cnt(void);
 
+/*!
+ * @brief gets the free-running microsecond counter.
+ *
+ * counts on the core cycle counter from hal_timer_init() or the first call,
+ * whichever comes first, at the core clock Clock_Ip_GetFreq() reports. call it
+ * only after the clocks are initialized. wraps at 2^32 us, compare times by
+ * their unsigned difference. safe to call from interrupts.
+ *
+ * @return uint32_t microseconds
+ */
+uint32_t hal_timer_get_us(void);
+
 /*!
  * @brief deinitializes the timer module.
  *
@@ -2,8 +2,8 @@
  * @file hal_uart.h
  * @brief Hardware Abstraction Layer (HAL) for UART operations
  *
- * @version 1.0.0
- * @date 2024-12-23
+ * @version 1.1.0
+ * @date 2026-10-17
  *
  * @details
  * This header provides an abstraction layer for UART communications, including
@@ -13,7 +13,7 @@
  *
  * @history
  *  - v1.0.0, 2024-12-23, Initial UART HAL interface definitions
- *  - v1.0.1, [future date], [description of updates]
+ *  - v1.1.0, 2026-10-17, Non-blocking hal_uart_transmit_it, hal_uart_poll_transmit
  *  - ...
  */
 
@@ -92,15 +92,32 @@ int32_t hal_uart_receive(HAL_UART *huart, uint8_t *data, size_t size, size_t tim
 /**
  * @brief Transmit data over UART using interrupt.
  *
- * This function sends data over the specified UART interface using interrupt mode.
+ * This function starts a transmission in interrupt (or DMA, depending on the
+ * driver configuration) mode and returns without waiting for it. The buffer
+ * must remain valid until hal_uart_tx_cplt_callback() is called.
  *
  * @param huart Pointer to the HAL_UART structure.
  * @param data Pointer to the data to transmit.
  * @param size Size of the data to transmit.
- * @return int32_t HAL status: HAL_OK if successful, otherwise an error code.
+ * @return int32_t HAL status: HAL_OK if started, HAL_ERR_RESOURCE_BUSY if a
+ *         transmission is still in flight, otherwise an error code.
  */
 int32_t hal_uart_transmit_it(HAL_UART *huart, uint8_t *data, size_t size);
 
+/**
+ * @brief Poll an interrupt-mode transmission.
+ *
+ * Retires a finished transmission that the interrupt has not reported yet and
+ * calls hal_uart_tx_cplt_callback() for it. Useful when the completion
+ * interrupt is not routed (e.g. DMA-only configurations) or while waiting for
+ * the transmitter to drain.
+ *
+ * @param huart Pointer to the HAL_UART structure.
+ * @return int32_t HAL_OK when idle, HAL_ERR_RESOURCE_BUSY while transmitting,
+ *         otherwise an error code.
+ */
+int32_t hal_uart_poll_transmit(HAL_UART *huart);
+
 /**
  * @brief Receive data over UART using interrupt.
  *
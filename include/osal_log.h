@@ -1,18 +1,103 @@
-
 #ifndef OSAL_LOG_H_
 #define OSAL_LOG_H_
 
+#include <stdint.h>
+
 #ifdef LPUART_UART_IP_INSTANCE_USING_6
 #define LPUART_INSTANCE LPUART_UART_IP_INSTANCE_USING_6
 #else
 #define LPUART_INSTANCE 6U
 #endif
 #define LOG_BUFFER_SIZE 256U
+/* Background transmit ring, must be a power of two */
+#define LOG_RING_SIZE 4096U
+/* Upper bound for osal_log_flush() before boot_app() gives up on the UART */
+#define LOG_FLUSH_TIMEOUT_MS 500U
+
+/*
+ * Log levels. OSAL_LOG_LEVEL is the compile-time threshold: calls above it
+ * expand to nothing, so neither the formatting nor the strings end up in the
+ * image. Calls at or below it are additionally filtered at run time by
+ * osal_log_set_level(). Production builds pass e.g.
+ * -DOSAL_LOG_LEVEL=OSAL_LOG_LEVEL_ERROR.
+ */
+#define OSAL_LOG_LEVEL_NONE  0U
+#define OSAL_LOG_LEVEL_ERROR 1U
+#define OSAL_LOG_LEVEL_WARN  2U
+#define OSAL_LOG_LEVEL_INFO  3U
+#define OSAL_LOG_LEVEL_DEBUG 4U
+
+#ifndef OSAL_LOG_LEVEL
+#define OSAL_LOG_LEVEL OSAL_LOG_LEVEL_INFO
+#endif
+
+/* Run-time threshold, read inline by the macros below */
+extern volatile uint8_t osal_log_runtime_level;
+
+#define OSAL_LOG_AT(level, ...) \
+	do { \
+		if ((OSAL_LOG_LEVEL >= (level)) && (osal_log_runtime_level >= (level))) { \
+			osal_log_write((level), __VA_ARGS__); \
+		} \
+	} while (0)
+
+#define osal_log_error(...) OSAL_LOG_AT(OSAL_LOG_LEVEL_ERROR, __VA_ARGS__)
+#define osal_log_warn(...)  OSAL_LOG_AT(OSAL_LOG_LEVEL_WARN, __VA_ARGS__)
+#define osal_log_info(...)  OSAL_LOG_AT(OSAL_LOG_LEVEL_INFO, __VA_ARGS__)
+#define osal_log_debug(...) OSAL_LOG_AT(OSAL_LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+/**
+ * Format a message (at most LOG_BUFFER_SIZE - 1 characters) and log it.
+ * Use the osal_log_{error,warn,info,debug} macros rather than calling this
+ * directly, so disabled levels cost nothing.
+ * @param level: OSAL_LOG_LEVEL_* of the message.
+ * @param fmt: printf-style format string.
+ */
+void osal_log_write(uint32_t level, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+/**
+ * Set the run-time log level; messages above it are discarded before
+ * formatting. Cannot raise the level above OSAL_LOG_LEVEL.
+ * @param level: OSAL_LOG_LEVEL_* threshold.
+ */
+void osal_log_set_level(uint32_t level);
+
 /**
- * Log a message via LPUART.
- * Polls transmission status to ensure completion.
+ * Current run-time log level.
+ * @return: OSAL_LOG_LEVEL_* threshold.
+ */
+uint32_t osal_log_get_level(void);
+
+/**
+ * Log an already formatted message via LPUART, bypassing the level filter.
+ * The message is copied into the log ring and sent in the background by the
+ * LPUART interrupt/DMA; the call never waits for the UART. Safe from thread
+ * and interrupt context. If the ring cannot hold the whole message it is
+ * dropped and counted (see osal_log_get_dropped()).
  * @param msg: Null-terminated message to log.
  */
-void osal_log_info(const char *msg);
+void osal_log_puts(const char *msg);
+
+/**
+ * Restart draining the log ring if the UART went idle.
+ * Only needed where the transmit-complete interrupt is not available;
+ * every logged message kicks the ring itself.
+ */
+void osal_log_process(void);
+
+/**
+ * Wait until everything in the log ring has left the UART.
+ * Must be called with interrupts enabled (boot_app() calls it before it
+ * masks them for the jump).
+ * @param timeout_ms: Give up after roughly this many milliseconds.
+ * @return: 0 when the ring is empty, -1 on timeout.
+ */
+int32_t osal_log_flush(uint32_t timeout_ms);
+
+/**
+ * Number of messages dropped because the log ring was full.
+ * @return: Dropped message count since reset.
+ */
+uint32_t osal_log_get_dropped(void);
 
 #endif /* OSAL_LOG_H_ */
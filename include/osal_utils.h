@@ -33,4 +33,44 @@ void osal_utils_delay_us(size_t us);
  */
 void osal_utils_delay_ms(size_t ms);
 
+#if !defined(__arm__) && defined(OSAL_UTILS_HOST_IRQ)
+/* host tests: simulated PRIMASK, provided by the test harness (tools/lpuart_sim) */
+uint32_t osal_utils_host_irq_save(void);
+void osal_utils_host_irq_restore(uint32_t primask);
+#endif
+
+/**
+ * Mask interrupts and return the previous PRIMASK so sections can nest.
+ * Keep the masked region short; it delays every interrupt in the system.
+ * @return: PRIMASK value to hand back to osal_utils_irq_restore().
+ */
+static inline uint32_t osal_utils_irq_save(void)
+{
+#if defined(__arm__)
+    uint32_t primask;
+
+    __asm volatile ("mrs %0, primask\n cpsid i" : "=r" (primask) :: "memory");
+    return primask;
+#elif defined(OSAL_UTILS_HOST_IRQ)
+    return osal_utils_host_irq_save();
+#else
+    return 0U;
+#endif
+}
+
+/**
+ * Restore the PRIMASK returned by osal_utils_irq_save().
+ * @param primask: Previous PRIMASK value.
+ */
+static inline void osal_utils_irq_restore(uint32_t primask)
+{
+#if defined(__arm__)
+    __asm volatile ("msr primask, %0" :: "r" (primask) : "memory");
+#elif defined(OSAL_UTILS_HOST_IRQ)
+    osal_utils_host_irq_restore(primask);
+#else
+    (void)primask;
+#endif
+}
+
 #endif /* OSAL_UTILS_H_ */
@@ -19,9 +19,15 @@
 #include "toolchain.h"
 #include "autolibc.h"
 
+/*hal_timer.h provides the microsecond counter behind CANTP_GetTimeUs().*/
+#include "hal_timer.h"
+
 /*user_config.h is used define macro for application.*/
 #include "user_config.h"
 
+/*osal_log.h provides the leveled log macros used by the debug print macros below.*/
+#include "osal_log.h"
+
 /****************************ASSERT and DEBUG IO/TIMER*******************/
 #if defined (EN_ASSERT) || defined (EN_DEBUG_TIMER) || defined (EN_DEBUG_PRINT)
 //#include "bootloader_debug.h"
@@ -40,7 +46,7 @@ do{\
 do{\
 	if(FALSE != xValue)\
 	{\
-		Debug_Printf(pString);\
+		osal_log_error(pString);\
 	}\
 }while(0)
 
@@ -48,7 +54,7 @@ do{\
 do{\
 	if(FALSE != xValue)\
 	{\
-		Debug_Printf((pString));\
+		osal_log_error((pString));\
 		while(1u){}\
 	}\
 }while(0)
@@ -60,34 +66,42 @@ do{\
 /************************************************************/
 
 /************************Debug config**************************/
+/*
+ * Module debug prints go through osal_log at debug level. A disabled module
+ * expands to nothing; an enabled one is still subject to OSAL_LOG_LEVEL (compile
+ * time) and osal_log_set_level() (run time), see osal_log.h.
+ */
+#define MODULE_DebugPrintf(...)	osal_log_debug(__VA_ARGS__)
+#define MODULE_NoPrintf(...)	do {} while (0)
+
 #ifdef EN_DEBUG_FLS_MODULE
-#define FLS_DebugPrintf Debug_Printf
+#define FLS_DebugPrintf MODULE_DebugPrintf
 #else
-#define FLS_DebugPrintf(fmt, args...)
+#define FLS_DebugPrintf MODULE_NoPrintf
 #endif
 
 #ifdef EN_UDS_DEBUG
-#define UDS_DebugPrintf Debug_Printf
+#define UDS_DebugPrintf MODULE_DebugPrintf
 #else
-#define UDS_DebugPrintf(fmt, args...)
+#define UDS_DebugPrintf MODULE_NoPrintf
 #endif
 
 #ifdef EN_TP_DEBUG
-#define TP_DebugPrintf Debug_Printf
+#define TP_DebugPrintf MODULE_DebugPrintf
 #else
-#define TP_DebugPrintf(fmt, args...)
+#define TP_DebugPrintf MODULE_NoPrintf
 #endif
 
 #ifdef EN_APP_DEBUG
-#define APP_DebugPrintf Debug_Printf
+#define APP_DebugPrintf MODULE_DebugPrintf
 #else
-#define APP_DebugPrintf(fmt, args...)
+#define APP_DebugPrintf MODULE_NoPrintf
 #endif
 
 #ifdef EN_DEBUG_FIFO
-#define FIFO_DebugPrintf Debug_Printf
+#define FIFO_DebugPrintf MODULE_DebugPrintf
 #else
-#define FIFO_DebugPrintf(fmt, args...)
+#define FIFO_DebugPrintf MODULE_NoPrintf
 #endif
 
 
@@ -68,8 +68,15 @@
 #define	RX_FUN_ID (0x7FFu)   /*can tp rx function ID*/
 #define	RX_PHY_ID (0x784u)   /*can tp rx phy ID*/
 #define	TX_ID (0x7F0u)       /*can tp tx ID*/
-/*Enable TX CAN FD or not. If enable CAN FD, CAN TP transmit SF message will over 8 Bytes*/
+/*Enable TX CAN FD or not. If enable CAN FD, CAN TP transmit SF message will over 8 Bytes.
+  Easy_Boot.mex configures FlexCAN_Config0 for classic 8 byte frames. Together with this switch set
+  fd_enable, bitRateSwitch and CanControllerFdISO to true and payload to FLEXCAN_PAYLOAD_SIZE_64
+  there, then regenerate the RTD configuration.*/
 //#define EN_TX_CAN_FD
+/*main.c hands the received CAN frames and TX confirmations to the CAN TP and loads the TX mailboxes
+  from it. Enable together with building external/UDS_stack into the firmware; the loop running
+  TP_MainFun() then calls CAN_TxFromTP() after each pass.*/
+//#define EN_CAN_TP_DRIVER
 #endif
 
 #ifdef EN_LIN_TP
@@ -95,7 +102,9 @@
 /*RX message from BUS FIFO ID*/
 #define RX_BUS_FIFO        ('r')  /*RX bus fifo*/
 
-#ifdef EN_CAN_TP
+#if (defined EN_CAN_TP) && (defined EN_TX_CAN_FD)
+#define RX_BUS_FIFO_LEN (1000u)    /*RX BUS FIFO length, 13 CAN FD frames*/
+#elif (defined EN_CAN_TP)
 #define RX_BUS_FIFO_LEN (300u)     /*RX BUS FIFO length*/
 #elif (defined EN_LIN_TP)
 #define RX_BUS_FIFO_LEN (50)      /*RX BUS FIFO length*/
@@ -106,7 +115,11 @@
 #ifdef EN_CAN_TP
 /*TX message to BUS FIFO ID*/
 #define TX_BUS_FIFO        ('t')  /*RX bus fifo*/
+#ifdef EN_TX_CAN_FD
+#define TX_BUS_FIFO_LEN (300u)     /*TX BUS FIFO length, CANTP_TX_PIPELINE_DEPTH CAN FD frames*/
+#else
 #define TX_BUS_FIFO_LEN (100u)     /*RX BUS FIFO length*/
+#endif
 #elif (defined EN_LIN_TP)
 /*TX message to BUS FIFO ID*/
 #define TX_BUS_FIFO        ('t')  /*RX bus fifo*/
@@ -117,6 +130,8 @@
 /***********************************************************/
 
 /**********************FOTA A/B config************************/
+/*A/B slots (boot_ctrl.h). Off by default: single-slot images keep app_metadata_t at APP_METADATA_ADDR,
+A/B images must be linked with it APP_METADATA_SLOT_TAIL bytes before the end of their slot (boot.h).*/
 //#define EN_SUPPORT_APP_B
 typedef enum
 {
@@ -157,6 +172,11 @@ typedef enum
 								IntCtrl_Ip_EnableIrq(LPUART0_IRQn)
 /***********************************************************/
 
+/*******************CAN TP time base************************/
+/*free-running microsecond counter CAN TP measures STmin and N_As/N_Bs/N_Cr with, wraps at 2^32*/
+#define CANTP_GetTimeUs()   hal_timer_get_us()
+/***********************************************************/
+
 /*******************MCU type for flash erase a sector time***********/
 /*MCU type for erase flash time*/
 #define MCU_S12Z (1)
@@ -10,6 +10,9 @@
 #include "leds_ctrl.h"
 #include "osal_log.h"
 #include "boot.h"
+#include "boot_ctrl.h"
+#include "boot_verify.h"
+#include "hal_error.h"
 #include "boot_version.h"
 #include "build_timestamp.h"
 #include "hse_fw_version.h"
@@ -64,6 +67,8 @@ static const board_info_t board_info = {
 // Global variables (retained to match original)
 static void (*jump_to_application)(void) = NULL;
 static uint32_t stack_point;
+static tAPPType boot_slot = APP_INVLID_TYPE;
+static uint8_t boot_slot_selected = 0;
 
 /**
  * Validates the stack pointer for the application.
@@ -80,15 +85,38 @@ static uint8_t boot_validate_app(uint32_t sp)
     return 1;
 }
 
+/**
+ * Picks the slot to boot, once per reset. The selection may consume a trial
+ * boot of a pending slot, so it must not run twice.
+ * @return: Selected slot, APP_INVLID_TYPE if none is bootable.
+ */
+static tAPPType boot_get_slot(void)
+{
+    if (!boot_slot_selected) {
+        boot_slot = boot_ctrl_select_slot();
+        boot_slot_selected = 1;
+    }
+    return boot_slot;
+}
+
 void boot_app(void)
 {
     uint32_t jump_address = 0;
+    uint32_t app_address = boot_ctrl_slot_addr(boot_get_slot());
+
+    // Drain the log ring while the UART interrupt is still live
+    (void)osal_log_flush(LOG_FLUSH_TIMEOUT_MS);
 
     // Disable interrupts
     __asm volatile("cpsid i" ::: "memory");
 
+    if (app_address == 0U) {
+        leds_ctrl_boot_led_blink_failure(); // No bootable slot
+        while (1);
+    }
+
     // Read initial stack pointer (offset 0x0C) and reset vector (offset 0x04)
-    stack_point = *(volatile uint32_t *)(APP_START_ADDRESS + 0x0CU);
+    stack_point = *(volatile uint32_t *)(app_address + 0x0CU);
 
     // Validate stack pointer
     if (!boot_validate_app(stack_point)) {
@@ -103,7 +131,7 @@ void boot_app(void)
     S32_NVIC->ICPR[0] = 0xFFFFFFFF; // Clear all pending interrupts
 
     // Set Vector Table Offset Register
-    S32_SCB->VTOR = APP_START_ADDRESS + 0x0CU;
+    S32_SCB->VTOR = app_address + 0x0CU;
 
     // Set Main Stack Pointer (MSP) and Process Stack Pointer (PSP)
     __asm volatile("msr msp, %0" : : "r" (stack_point) : "memory");
@@ -127,8 +155,9 @@ void boot_app(void)
  */
 static const app_metadata_t *get_app_metadata(void)
 {
-    const app_metadata_t *meta = (const app_metadata_t *)APP_METADATA_ADDR;
-    if (meta->magic != APP_METADATA_MAGIC) {
+    const app_metadata_t *meta =
+        (const app_metadata_t *)boot_ctrl_slot_metadata_addr(boot_get_slot());
+    if (!meta || meta->magic != APP_METADATA_MAGIC) {
         return NULL;
     }
 
@@ -192,71 +221,56 @@ int32_t boot_read_device_id(char *id_buffer, size_t buf_size)
 
 int32_t boot_print_board_info(void)
 {
-    char line_buf[128];
     char version[16] = {0};
     char app_name[20] = {0};
     char chip_id[9] = {0};
-    char build_time_str[32];
-
-    /* Madrid (CET/CEST) build time, computed by tools/gen_build_timestamp.py -
-     * not __DATE__/__TIME__, which only reflect the build machine's own local
-     * clock/timezone with no timezone label. Re-run that script to refresh it. */
-    snprintf(build_time_str, sizeof(build_time_str), "%s", BUILD_TIMESTAMP_MADRID);
+    bool cached = false;
+    tAPPType slot = boot_get_slot();
+    uint32_t app_address = boot_ctrl_slot_addr(slot);
 
     if (boot_read_device_id(chip_id, sizeof(chip_id)) != 0) {
         snprintf(chip_id, sizeof(chip_id), "Unknown");
     }
 
-    snprintf(line_buf, sizeof(line_buf), "\r\nBoot from PFLASH: 0x%08lX...\r\n", board_info.load_address);
-    osal_log_info(line_buf);
+    osal_log_info("\r\nBoot from PFLASH: 0x%08lX...\r\n", board_info.load_address);
 
     // === Bootloader Information ===
-    snprintf(line_buf, sizeof(line_buf), "\r\nS32K EasyBoot %s (%s)\r\n", EASY_BOOT_VERSION, build_time_str);
-    osal_log_info(line_buf);
+    /* Madrid (CET/CEST) build time, computed by tools/gen_build_timestamp.py -
+     * not __DATE__/__TIME__, which only reflect the build machine's own local
+     * clock/timezone with no timezone label. Re-run that script to refresh it. */
+    osal_log_info("\r\nS32K EasyBoot %s (%s)\r\n", EASY_BOOT_VERSION, BUILD_TIMESTAMP_MADRID);
 
     // === Hardware Information ===
-    snprintf(line_buf, sizeof(line_buf), "CPU:   %s\r\n", board_info.cpu_model);
-    osal_log_info(line_buf);
+    osal_log_info("CPU:   %s\r\n", board_info.cpu_model);
 
-    snprintf(line_buf, sizeof(line_buf), "Model: %s\r\n", board_info.model);
-    osal_log_info(line_buf);
+    osal_log_info("Model: %s\r\n", board_info.model);
 
-    snprintf(line_buf, sizeof(line_buf), "CPUID: %s\r\n", chip_id[0] != 'U' ? chip_id : board_info.board_id);
-    osal_log_info(line_buf);
+    osal_log_info("CPUID: %s\r\n", chip_id[0] != 'U' ? chip_id : board_info.board_id);
 
-    snprintf(line_buf, sizeof(line_buf), "SRAM:  %s\r\n", board_info.dram_size);
-    osal_log_info(line_buf);
+    osal_log_info("SRAM:  %s\r\n", board_info.dram_size);
 
-    snprintf(line_buf, sizeof(line_buf), "Flash: pflash: %s\r\n", board_info.pflash_size);
-    osal_log_info(line_buf);
+    osal_log_info("Flash: pflash: %s\r\n", board_info.pflash_size);
 
-    snprintf(line_buf, sizeof(line_buf), "       dflash: %s\r\n", board_info.dflash_size);
-    osal_log_info(line_buf);
+    osal_log_info("       dflash: %s\r\n", board_info.dflash_size);
 
-    snprintf(line_buf, sizeof(line_buf), "In:    %s\r\n", board_info.serial_in);
-    osal_log_info(line_buf);
+    osal_log_info("In:    %s\r\n", board_info.serial_in);
 
-    snprintf(line_buf, sizeof(line_buf), "Out:   %s\r\n", board_info.serial_out);
-    osal_log_info(line_buf);
+    osal_log_info("Out:   %s\r\n", board_info.serial_out);
 
-    snprintf(line_buf, sizeof(line_buf), "Err:   %s\r\n", board_info.serial_err);
-    osal_log_info(line_buf);
+    osal_log_info("Err:   %s\r\n", board_info.serial_err);
 
-    snprintf(line_buf, sizeof(line_buf), "Net:   %s\r\n", board_info.network);
-    osal_log_info(line_buf);
+    osal_log_info("Net:   %s\r\n", board_info.network);
 
-    snprintf(line_buf, sizeof(line_buf), "HSE:   %s\r\n", board_info.hse);
-    osal_log_info(line_buf);
+    osal_log_info("HSE:   %s\r\n", board_info.hse);
 
-    snprintf(line_buf, sizeof(line_buf), "HSE FW: %s\r\n", board_info.hse_fw_version);
-    osal_log_info(line_buf);
+    osal_log_info("HSE FW: %s\r\n", board_info.hse_fw_version);
 
     // === Application Information ===
     osal_log_info("## Loading App from pflash...\r\n");
 
     const app_metadata_t *meta = get_app_metadata();
     if (!meta) {
-        osal_log_info("Invalid app metadata\r\n");
+        osal_log_error("Invalid app metadata\r\n");
         return -1;
     }
 
@@ -270,30 +284,27 @@ int32_t boot_print_board_info(void)
 
     osal_log_info("App loaded successfully\r\n");
 
-    snprintf(line_buf, sizeof(line_buf), "## Booting App from pflash at 0x%08lX ...\r\n", board_info.app_address);
-    osal_log_info(line_buf);
-    snprintf(line_buf, sizeof(line_buf), "   App Name:    %s\r\n", app_name);
-    osal_log_info(line_buf);
-    snprintf(line_buf, sizeof(line_buf), "   Built Time:  %s\r\n", meta->build_timestamp);
-    osal_log_info(line_buf);
-    snprintf(line_buf, sizeof(line_buf), "   App Type:    Raw Binary\r\n");
-    osal_log_info(line_buf);
-    snprintf(line_buf, sizeof(line_buf), "   App Ver:     %s\r\n", version);
-    osal_log_info(line_buf);
-
-    snprintf(line_buf, sizeof(line_buf), "   App Size:    %lu Bytes = %ld KiB\r\n",
-             (unsigned long)meta->image_size, meta->image_size / 1024);
-    osal_log_info(line_buf);
-
-    snprintf(line_buf, sizeof(line_buf), "   App Address: 0x%08lX\r\n", board_info.app_address);
-    osal_log_info(line_buf);
-
-    snprintf(line_buf, sizeof(line_buf), "   App Point:   0x%08lX\r\n", board_info.app_load_addr);
-    osal_log_info(line_buf);
-
-    osal_log_info("   Verifying Checksum ... OK\r\n");
-    snprintf(line_buf, sizeof(line_buf), "## Loading App from 0x%08lX ...\r\n\r\n", board_info.app_address);
-    osal_log_info(line_buf);
+    osal_log_info("   App Slot:    %c\r\n", (slot == APP_A_TYPE) ? 'A' : 'B');
+
+    osal_log_info("## Booting App from pflash at 0x%08lX ...\r\n", app_address);
+    osal_log_info("   App Name:    %s\r\n", app_name);
+    osal_log_info("   Built Time:  %s\r\n", meta->build_timestamp);
+    osal_log_info("   App Type:    Raw Binary\r\n");
+    osal_log_info("   App Ver:     %s\r\n", version);
+
+    osal_log_info("   App Size:    %lu Bytes = %ld KiB\r\n",
+                  (unsigned long)meta->image_size, meta->image_size / 1024);
+
+    osal_log_info("   App Address: 0x%08lX\r\n", app_address);
+
+    osal_log_info("   App Point:   0x%08lX\r\n", app_address);
+
+    if (boot_verify_image(slot, &cached) != HAL_ERR_SUCCESS) {
+        osal_log_error("   Verifying Checksum ... Bad CRC\r\n");
+        return -1;
+    }
+    osal_log_info(cached ? "   Verifying Checksum ... OK (cached)\r\n" : "   Verifying Checksum ... OK\r\n");
+    osal_log_info("## Loading App from 0x%08lX ...\r\n\r\n", app_address);
 
     osal_log_info("Starting App ...\r\n\r\n");
 
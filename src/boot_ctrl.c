@@ -0,0 +1,348 @@
+/**
+ * @file boot_ctrl.c
+ * @brief A/B application slot selection and boot-control record handling
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * The boot-control record lives in two data flash sectors. Every update
+ * writes a complete record, with a sequence number one higher than the
+ * current one, into the sector that does not hold the current record. On
+ * load the valid copy with the highest sequence number wins, so a power loss
+ * during an update simply leaves the previous state in effect.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial A/B slot support
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "boot_ctrl.h"
+#include "boot_verify.h"
+#include "hal_crc.h"
+#include "hal_error.h"
+#include "hal_flash.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define BOOT_CTRL_CRC_LEN       (offsetof(boot_ctrl_record_t, crc32))
+#define BOOT_CTRL_SLOT_BIT(s)   ((uint8_t)(1U << (uint8_t)(s)))
+#define BOOT_CTRL_VTOR_OFFSET   (0x0CU)             /* Vector table pointer in the image header */
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+
+static const uint32_t boot_ctrl_sector_addr[2] = {
+    BOOT_CTRL_SECTOR_0_ADDR,
+    BOOT_CTRL_SECTOR_1_ADDR,
+};
+
+static tAPPType selected_slot = APP_A_TYPE;
+
+/*******************************************************************************
+ * Local Functions
+ ******************************************************************************/
+
+static bool boot_ctrl_is_slot_index(tAPPType slot)
+{
+    return (uint32_t)slot < BOOT_SLOT_COUNT;
+}
+
+static tAPPType boot_ctrl_other_slot(tAPPType slot)
+{
+#ifdef EN_SUPPORT_APP_B
+    return (slot == APP_A_TYPE) ? APP_B_TYPE : APP_A_TYPE;
+#else
+    (void)slot;
+    return APP_A_TYPE;
+#endif
+}
+
+static uint32_t boot_ctrl_record_crc(const boot_ctrl_record_t *record)
+{
+    return hal_crc32_compute((const uint8_t *)record, BOOT_CTRL_CRC_LEN, 0xFFFFFFFFU);
+}
+
+/**
+ * @brief Reads one record copy and checks magic and CRC
+ *
+ * @param index Copy index (0 or 1)
+ * @param record Output buffer
+ * @return bool true if the copy is valid
+ */
+static bool boot_ctrl_read_copy(uint32_t index, boot_ctrl_record_t *record)
+{
+    if (hal_flash_read(boot_ctrl_sector_addr[index], (uint8_t *)record,
+                       sizeof(*record)) != HAL_ERR_SUCCESS) {
+        return false;
+    }
+
+    if (record->magic != BOOT_CTRL_MAGIC) {
+        return false;
+    }
+
+    if (!boot_ctrl_is_slot_index((tAPPType)record->active_slot)) {
+        return false;
+    }
+
+    return record->crc32 == boot_ctrl_record_crc(record);
+}
+
+/**
+ * @brief Default state when no record has ever been written: slot A, confirmed
+ *
+ * This keeps boards provisioned before A/B support booting their existing app.
+ */
+static void boot_ctrl_default_record(boot_ctrl_record_t *record)
+{
+    memset(record, 0, sizeof(*record));
+    record->magic = BOOT_CTRL_MAGIC;
+    record->active_slot = (uint8_t)APP_A_TYPE;
+    record->confirmed_mask = BOOT_CTRL_SLOT_BIT(APP_A_TYPE);
+}
+
+/**
+ * @brief Picks the newest confirmed slot that is bootable
+ *
+ * Confirmed slots among the candidates are tried in order of generation,
+ * highest first, until one passes boot_ctrl_is_slot_valid().
+ *
+ * @param record Boot-control record
+ * @param candidates BOOT_CTRL_SLOT_BIT() mask of the slots that may be picked
+ * @return tAPPType Slot to boot, APP_INVLID_TYPE if none is confirmed and valid
+ */
+static tAPPType boot_ctrl_newest_confirmed(const boot_ctrl_record_t *record, uint8_t candidates)
+{
+    uint8_t left = (uint8_t)(candidates & record->confirmed_mask);
+    tAPPType newest;
+    uint32_t i;
+
+    while (left != 0U) {
+        newest = APP_INVLID_TYPE;
+        for (i = 0U; i < BOOT_SLOT_COUNT; i++) {
+            if ((left & BOOT_CTRL_SLOT_BIT(i)) == 0U) {
+                continue;
+            }
+            if (newest == APP_INVLID_TYPE ||
+                (int32_t)(record->generation[i] - record->generation[newest]) > 0) {
+                newest = (tAPPType)i;
+            }
+        }
+
+        if (boot_ctrl_is_slot_valid(newest)) {
+            return newest;
+        }
+        left &= (uint8_t)~BOOT_CTRL_SLOT_BIT(newest);
+    }
+
+    return APP_INVLID_TYPE;
+}
+
+/**
+ * @brief Persists a record into the copy that is not currently the newest
+ *
+ * @param record Record to store; sequence and crc32 are filled in here
+ * @return int32_t HAL_ERR_SUCCESS or a HAL flash error code
+ */
+static int32_t boot_ctrl_store(boot_ctrl_record_t *record)
+{
+    boot_ctrl_record_t copy[2];
+    bool valid[2];
+    uint32_t target = 0U;
+    uint32_t sequence = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < 2U; i++) {
+        valid[i] = boot_ctrl_read_copy(i, &copy[i]);
+    }
+
+    if (valid[0] && (!valid[1] || (int32_t)(copy[0].sequence - copy[1].sequence) >= 0)) {
+        sequence = copy[0].sequence;
+        target = 1U;
+    } else if (valid[1]) {
+        sequence = copy[1].sequence;
+        target = 0U;
+    }
+
+    record->magic = BOOT_CTRL_MAGIC;
+    record->sequence = sequence + 1U;
+    record->crc32 = boot_ctrl_record_crc(record);
+
+    return hal_flash_write(boot_ctrl_sector_addr[target], (const uint8_t *)record, sizeof(*record));
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+uint32_t boot_ctrl_slot_addr(tAPPType slot)
+{
+    if (!boot_ctrl_is_slot_index(slot)) {
+        return 0U;
+    }
+
+    return BOOT_SLOT_A_ADDR + ((uint32_t)slot * BOOT_SLOT_SIZE);
+}
+
+uint32_t boot_ctrl_slot_metadata_addr(tAPPType slot)
+{
+    uint32_t base = boot_ctrl_slot_addr(slot);
+
+    return (base == 0U) ? 0U : (base + BOOT_SLOT_METADATA_OFFSET);
+}
+
+bool boot_ctrl_is_slot_valid(tAPPType slot)
+{
+    uint32_t base = boot_ctrl_slot_addr(slot);
+    const app_metadata_t *meta;
+    uint32_t vtor;
+
+    if (base == 0U) {
+        return false;
+    }
+
+    meta = (const app_metadata_t *)boot_ctrl_slot_metadata_addr(slot);
+    if (meta->magic != APP_METADATA_MAGIC) {
+        return false;
+    }
+
+    /* Same rule as boot_app(): vector table pointer 8-byte aligned and non-zero */
+    vtor = *(volatile uint32_t *)(base + BOOT_CTRL_VTOR_OFFSET);
+    if ((vtor & 0x7U) != 0U || vtor == 0U) {
+        return false;
+    }
+
+    return boot_verify_image(slot, NULL) == HAL_ERR_SUCCESS;
+}
+
+int32_t boot_ctrl_load(boot_ctrl_record_t *record)
+{
+    boot_ctrl_record_t copy[2];
+    bool valid[2];
+    uint32_t i;
+
+    if (record == NULL) {
+        return -1;
+    }
+
+    for (i = 0U; i < 2U; i++) {
+        valid[i] = boot_ctrl_read_copy(i, &copy[i]);
+    }
+
+    if (valid[0] && (!valid[1] || (int32_t)(copy[0].sequence - copy[1].sequence) >= 0)) {
+        *record = copy[0];
+    } else if (valid[1]) {
+        *record = copy[1];
+    } else {
+        return -1;
+    }
+
+    return 0;
+}
+
+tAPPType boot_ctrl_select_slot(void)
+{
+    boot_ctrl_record_t record;
+    tAPPType active;
+    uint8_t candidates;
+
+    if (boot_ctrl_load(&record) != 0) {
+        boot_ctrl_default_record(&record);
+    }
+
+    active = (tAPPType)record.active_slot;
+    candidates = (uint8_t)((1U << BOOT_SLOT_COUNT) - 1U);
+
+    if ((record.confirmed_mask & BOOT_CTRL_SLOT_BIT(active)) == 0U) {
+        if (record.try_count < BOOT_CTRL_MAX_TRIES && boot_ctrl_is_slot_valid(active)) {
+            /* Trial boot: burn one try before jumping */
+            record.try_count++;
+            (void)boot_ctrl_store(&record);
+            selected_slot = active;
+            return selected_slot;
+        }
+        /* Pending slot never confirmed itself, it is out of the running */
+        candidates &= (uint8_t)~BOOT_CTRL_SLOT_BIT(active);
+    }
+
+#ifndef EN_NEWEST_APP_INVALID_JUMP_OLD_APP
+    /* No falling back to another slot */
+    candidates &= BOOT_CTRL_SLOT_BIT(active);
+#endif
+
+    selected_slot = boot_ctrl_newest_confirmed(&record, candidates);
+    if (selected_slot != APP_INVLID_TYPE && selected_slot != active &&
+        (record.confirmed_mask & BOOT_CTRL_SLOT_BIT(active)) == 0U) {
+        /* Switch back to the old slot for good */
+        record.active_slot = (uint8_t)selected_slot;
+        record.try_count = 0U;
+        (void)boot_ctrl_store(&record);
+    }
+
+    return selected_slot;
+}
+
+tAPPType boot_ctrl_get_selected_slot(void)
+{
+    return selected_slot;
+}
+
+tAPPType boot_ctrl_get_inactive_slot(void)
+{
+    boot_ctrl_record_t record;
+
+    if (boot_ctrl_load(&record) != 0) {
+        boot_ctrl_default_record(&record);
+    }
+
+    return boot_ctrl_other_slot((tAPPType)record.active_slot);
+}
+
+int32_t boot_ctrl_mark_pending(tAPPType slot)
+{
+    boot_ctrl_record_t record;
+    tAPPType other = boot_ctrl_other_slot(slot);
+
+    if (!boot_ctrl_is_slot_index(slot)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    if (boot_ctrl_load(&record) != 0) {
+        boot_ctrl_default_record(&record);
+    }
+
+    record.generation[slot] = record.generation[other] + 1U;
+    record.active_slot = (uint8_t)slot;
+    record.try_count = 0U;
+    record.confirmed_mask &= (uint8_t)~BOOT_CTRL_SLOT_BIT(slot);
+
+    return boot_ctrl_store(&record);
+}
+
+int32_t boot_ctrl_mark_confirmed(tAPPType slot)
+{
+    boot_ctrl_record_t record;
+
+    if (!boot_ctrl_is_slot_index(slot)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    if (boot_ctrl_load(&record) != 0) {
+        boot_ctrl_default_record(&record);
+    }
+
+    if ((record.confirmed_mask & BOOT_CTRL_SLOT_BIT(slot)) != 0U) {
+        return HAL_ERR_SUCCESS;
+    }
+
+    record.confirmed_mask |= BOOT_CTRL_SLOT_BIT(slot);
+    if (record.active_slot == (uint8_t)slot) {
+        record.try_count = 0U;
+    }
+
+    return boot_ctrl_store(&record);
+}
@@ -0,0 +1,341 @@
+/**
+ * @file boot_delta.c
+ * @brief Streaming delta patch applier for differential downloads
+ *
+ * @version 1.1.0
+ * @date 2026-10-17
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial patch applier
+ *  - v1.1.0, 2026-10-17, Progress records to resume after a reset
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "boot_delta.h"
+#include "hal_error.h"
+#include "hal_flash.h"
+#include "hal_crc.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/* Source reads go through hal_flash_read(), which wants whole words */
+#define DELTA_READ_CHUNK    (64U)
+
+/* Progress records are programmed whole, so they must fill whole write units */
+#define DELTA_PROGRESS_CRC_LEN  (offsetof(boot_delta_progress_t, crc32))
+#define DELTA_PROGRESS_END      (BOOT_DELTA_PROGRESS_ADDR + HAL_FLASH_SECTOR_SIZE)
+
+typedef char delta_progress_size_check[((sizeof(boot_delta_progress_t) % HAL_FLASH_WRITE_UNIT) == 0U) ? 1 : -1];
+
+/* Next item the applier expects */
+enum
+{
+    DELTA_STATE_HEADER = 0,     /* Header bytes */
+    DELTA_STATE_OP,             /* Operation byte */
+    DELTA_STATE_COPY_LEN,       /* Low byte of the copy length */
+    DELTA_STATE_COPY_DIST,      /* Copy distance varint */
+    DELTA_STATE_INSERT,         /* Inserted bytes, from the input */
+    DELTA_STATE_COPY,           /* Copied bytes, from the source */
+};
+
+/*******************************************************************************
+ * Local Functions
+ ******************************************************************************/
+
+static uint32_t delta_get_u32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+/**
+ * @brief Reads source bytes at any alignment through a small word-aligned bounce buffer
+ */
+static int32_t delta_read_source(uint32_t addr, uint8_t *out, uint32_t size)
+{
+    uint32_t chunk[DELTA_READ_CHUNK / 4U];
+    uint32_t aligned;
+    uint32_t skip;
+    uint32_t n;
+    int32_t ret;
+
+    while (size != 0U) {
+        aligned = addr & ~3UL;
+        skip = addr - aligned;
+        n = DELTA_READ_CHUNK - skip;
+        if (n > size) {
+            n = size;
+        }
+
+        ret = hal_flash_read(aligned, (uint8_t *)chunk, (skip + n + 3U) & ~3UL);
+        if (ret != HAL_ERR_SUCCESS) {
+            return ret;
+        }
+        memcpy(out, (const uint8_t *)chunk + skip, n);
+
+        addr += n;
+        out += n;
+        size -= n;
+    }
+
+    return HAL_ERR_SUCCESS;
+}
+
+/**
+ * @brief Checks the collected header against the caller's expectations and the installed image
+ */
+static int32_t delta_parse_header(boot_delta_t *dt)
+{
+    dt->src_size = delta_get_u32(&dt->header[4]);
+    dt->src_crc = delta_get_u32(&dt->header[8]);
+    dt->dst_size = delta_get_u32(&dt->header[12]);
+    dt->dst_crc = delta_get_u32(&dt->header[16]);
+
+    if ((delta_get_u32(&dt->header[0]) != BOOT_DELTA_MAGIC) ||
+        (dt->src_size > dt->src_limit) || (dt->dst_size != dt->dst_expected)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    /* A patch against another build would produce garbage, refuse it before writing anything */
+    if ((dt->src_size != 0U) &&
+        (hal_flash_verify_crc32(dt->src_addr, dt->src_size, dt->src_crc) != HAL_ERR_SUCCESS)) {
+        return HAL_ERR_FLASH_VERIFY_FAILED;
+    }
+
+    return HAL_ERR_SUCCESS;
+}
+
+/**
+ * @brief Applies the copy distance and checks the copy stays inside the source
+ */
+static int32_t delta_start_copy(boot_delta_t *dt)
+{
+    const int32_t distance = (int32_t)((dt->varint >> 1) ^ (0U - (dt->varint & 1U)));
+    const int64_t start = (int64_t)dt->src_pos + distance;
+
+    if ((start < 0) || ((uint64_t)start + dt->remain > dt->src_size)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+    dt->src_pos = (uint32_t)start;
+
+    return HAL_ERR_SUCCESS;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+void boot_delta_init(boot_delta_t *dt, uint32_t src_addr, uint32_t src_limit, uint32_t dst_size)
+{
+    memset(dt, 0, sizeof(*dt));
+    dt->src_addr = src_addr;
+    dt->src_limit = src_limit;
+    dt->dst_expected = dst_size;
+    dt->state = DELTA_STATE_HEADER;
+}
+
+int32_t boot_delta_apply(boot_delta_t *dt, const uint8_t **in, uint32_t *in_len,
+                         uint8_t *out, uint32_t out_size, uint32_t *out_len)
+{
+    int32_t ret;
+    uint32_t n;
+    uint8_t byte;
+
+    *out_len = 0U;
+
+    while (*out_len < out_size) {
+        /* States that produce output */
+        if (dt->state == DELTA_STATE_COPY) {
+            n = out_size - *out_len;
+            if (n > dt->remain) {
+                n = dt->remain;
+            }
+            ret = delta_read_source(dt->src_addr + dt->src_pos, &out[*out_len], n);
+            if (ret != HAL_ERR_SUCCESS) {
+                return ret;
+            }
+            dt->src_pos += n;
+        } else if (dt->state == DELTA_STATE_INSERT) {
+            if (*in_len == 0U) {
+                return HAL_ERR_SUCCESS;
+            }
+            n = out_size - *out_len;
+            if (n > dt->remain) {
+                n = dt->remain;
+            }
+            if (n > *in_len) {
+                n = *in_len;
+            }
+            memcpy(&out[*out_len], *in, n);
+            *in += n;
+            *in_len -= n;
+            dt->in_total += n;
+        } else {
+            n = 0U;
+        }
+
+        if (n != 0U) {
+            *out_len += n;
+            dt->out_total += n;
+            dt->remain -= n;
+            if (dt->remain == 0U) {
+                dt->state = DELTA_STATE_OP;
+            }
+            continue;
+        }
+
+        /* States that only consume input */
+        if (*in_len == 0U) {
+            return HAL_ERR_SUCCESS;
+        }
+        byte = **in;
+        (*in)++;
+        (*in_len)--;
+        dt->in_total++;
+
+        switch (dt->state) {
+        case DELTA_STATE_HEADER:
+            dt->header[dt->header_len++] = byte;
+            if (dt->header_len == BOOT_DELTA_HEADER_SIZE) {
+                ret = delta_parse_header(dt);
+                if (ret != HAL_ERR_SUCCESS) {
+                    return ret;
+                }
+                dt->state = DELTA_STATE_OP;
+            }
+            break;
+
+        case DELTA_STATE_OP:
+            if (dt->out_total == dt->dst_size) {
+                /* Anything after the last byte means the patch does not match dst_size */
+                return HAL_ERR_INVALID_PARAM;
+            }
+            if ((byte & 0x80U) != 0U) {
+                dt->remain = (uint32_t)(byte & 0x7FU) << 8;
+                dt->state = DELTA_STATE_COPY_LEN;
+            } else {
+                dt->remain = (uint32_t)byte + 1U;
+                if (dt->remain > (dt->dst_size - dt->out_total)) {
+                    return HAL_ERR_INVALID_PARAM;
+                }
+                dt->state = DELTA_STATE_INSERT;
+            }
+            break;
+
+        case DELTA_STATE_COPY_LEN:
+            dt->remain = (dt->remain | byte) + 1U;
+            if (dt->remain > (dt->dst_size - dt->out_total)) {
+                return HAL_ERR_INVALID_PARAM;
+            }
+            dt->varint = 0U;
+            dt->varint_shift = 0U;
+            dt->state = DELTA_STATE_COPY_DIST;
+            break;
+
+        case DELTA_STATE_COPY_DIST:
+        default:
+            if (dt->varint_shift > 28U) {
+                return HAL_ERR_INVALID_PARAM;
+            }
+            dt->varint |= (uint32_t)(byte & 0x7FU) << dt->varint_shift;
+            dt->varint_shift += 7U;
+            if ((byte & 0x80U) == 0U) {
+                ret = delta_start_copy(dt);
+                if (ret != HAL_ERR_SUCCESS) {
+                    return ret;
+                }
+                dt->state = DELTA_STATE_COPY;
+            }
+            break;
+        }
+    }
+
+    return HAL_ERR_SUCCESS;
+}
+
+bool boot_delta_is_done(const boot_delta_t *dt)
+{
+    return (dt->state == DELTA_STATE_OP) && (dt->out_total == dt->dst_size);
+}
+
+void boot_delta_progress_make(boot_delta_progress_t *progress, const boot_delta_t *dt,
+                              uint32_t dst_addr, uint32_t out_crc)
+{
+    memset(progress, 0, sizeof(*progress));
+    progress->magic = BOOT_DELTA_PROGRESS_MAGIC;
+    progress->dst_addr = dst_addr;
+    progress->out_crc = out_crc;
+    progress->delta = *dt;
+    progress->crc32 = hal_crc32_compute((const uint8_t *)progress, DELTA_PROGRESS_CRC_LEN, 0xFFFFFFFFU);
+}
+
+bool boot_delta_progress_load(boot_delta_progress_t *progress, uint32_t *next_addr)
+{
+    boot_delta_progress_t record;
+    uint32_t addr;
+    bool found = false;
+
+    *next_addr = BOOT_DELTA_PROGRESS_ADDR;
+
+    for (addr = BOOT_DELTA_PROGRESS_ADDR; (addr + sizeof(record)) <= DELTA_PROGRESS_END; addr += sizeof(record)) {
+        if (hal_flash_read(addr, (uint8_t *)&record, sizeof(record)) != HAL_ERR_SUCCESS) {
+            /* Most likely a torn write: the slot is used, but holds nothing */
+            *next_addr = addr + sizeof(record);
+            continue;
+        }
+        if (record.magic == 0xFFFFFFFFUL) {
+            continue;
+        }
+
+        *next_addr = addr + sizeof(record);
+        if ((record.magic == BOOT_DELTA_PROGRESS_MAGIC) &&
+            (record.crc32 == hal_crc32_compute((const uint8_t *)&record, DELTA_PROGRESS_CRC_LEN, 0xFFFFFFFFU))) {
+            *progress = record;
+            found = true;
+        }
+    }
+
+    if ((*next_addr + sizeof(record)) > DELTA_PROGRESS_END) {
+        *next_addr = DELTA_PROGRESS_END;
+    }
+
+    return found;
+}
+
+int32_t boot_delta_progress_clear(void)
+{
+    boot_delta_progress_t record;
+    uint32_t next_addr;
+
+    (void)boot_delta_progress_load(&record, &next_addr);
+    if (next_addr == BOOT_DELTA_PROGRESS_ADDR) {
+        return HAL_ERR_SUCCESS;
+    }
+
+    return hal_flash_erase_sector(BOOT_DELTA_PROGRESS_ADDR, 1U);
+}
+
+int32_t boot_delta_resume(boot_delta_t *dt, const boot_delta_progress_t *progress,
+                          uint32_t src_addr, uint32_t dst_addr, uint32_t dst_size)
+{
+    const boot_delta_t *saved = &progress->delta;
+
+    if ((progress->dst_addr != dst_addr) || (saved->src_addr != src_addr) ||
+        (saved->dst_expected != dst_size) || (saved->state == DELTA_STATE_HEADER) ||
+        (saved->out_total == 0U) || (saved->out_total > saved->dst_size)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    /* Anything may have happened to the flash since: check both ends again */
+    if (((saved->src_size != 0U) &&
+         (hal_flash_verify_crc32(saved->src_addr, saved->src_size, saved->src_crc) != HAL_ERR_SUCCESS)) ||
+        (hal_flash_verify_crc32(dst_addr, saved->out_total, progress->out_crc) != HAL_ERR_SUCCESS)) {
+        return HAL_ERR_FLASH_VERIFY_FAILED;
+    }
+
+    *dt = *saved;
+
+    return HAL_ERR_SUCCESS;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file boot_lzss.c
+ * @brief Streaming LZSS decompressor for compressed downloads
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial decompressor
+ */
+
+#include <stddef.h>
+#include "boot_lzss.h"
+#include "hal_error.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define LZSS_WINDOW_MASK    (BOOT_LZSS_WINDOW_SIZE - 1U)
+
+/* Next item the decoder expects */
+enum
+{
+    LZSS_STATE_TAG = 0,     /* One bit: literal or copy */
+    LZSS_STATE_LITERAL,     /* 8 bits */
+    LZSS_STATE_DISTANCE,    /* BOOT_LZSS_WINDOW_BITS */
+    LZSS_STATE_COUNT,       /* BOOT_LZSS_COUNT_BITS */
+    LZSS_STATE_COPY,        /* Producing a copy, no input needed */
+};
+
+/*******************************************************************************
+ * Local Functions
+ ******************************************************************************/
+
+/**
+ * @brief Takes n bits from the input, refilling a byte at a time
+ *
+ * @return true with *value set, false if the input ran out first (the bits
+ *         gathered so far stay in the state)
+ */
+static bool lzss_get_bits(boot_lzss_t *lz, const uint8_t **in, uint32_t *in_len, uint8_t n, uint32_t *value)
+{
+    while (lz->bit_count < n) {
+        if (*in_len == 0U) {
+            return false;
+        }
+        lz->bits = (lz->bits << 8) | **in;
+        lz->bit_count += 8U;
+        (*in)++;
+        (*in_len)--;
+    }
+
+    lz->bit_count -= n;
+    *value = (lz->bits >> lz->bit_count) & ((1UL << n) - 1U);
+
+    return true;
+}
+
+static void lzss_put(boot_lzss_t *lz, uint8_t byte, uint8_t *out, uint32_t *out_len)
+{
+    lz->window[lz->out_total & LZSS_WINDOW_MASK] = byte;
+    lz->out_total++;
+    out[(*out_len)++] = byte;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+void boot_lzss_init(boot_lzss_t *lz)
+{
+    lz->out_total = 0U;
+    lz->bits = 0U;
+    lz->bit_count = 0U;
+    lz->state = LZSS_STATE_TAG;
+    lz->distance = 0U;
+    lz->count = 0U;
+}
+
+int32_t boot_lzss_decode(boot_lzss_t *lz, const uint8_t **in, uint32_t *in_len,
+                         uint8_t *out, uint32_t out_size, uint32_t *out_len)
+{
+    uint32_t value;
+
+    *out_len = 0U;
+
+    while (*out_len < out_size) {
+        switch (lz->state) {
+        case LZSS_STATE_COPY:
+            lzss_put(lz, lz->window[(lz->out_total - lz->distance) & LZSS_WINDOW_MASK], out, out_len);
+            if (--lz->count == 0U) {
+                lz->state = LZSS_STATE_TAG;
+            }
+            break;
+
+        case LZSS_STATE_TAG:
+            if (!lzss_get_bits(lz, in, in_len, 1U, &value)) {
+                return HAL_ERR_SUCCESS;
+            }
+            lz->state = (value != 0U) ? LZSS_STATE_LITERAL : LZSS_STATE_DISTANCE;
+            break;
+
+        case LZSS_STATE_LITERAL:
+            if (!lzss_get_bits(lz, in, in_len, 8U, &value)) {
+                return HAL_ERR_SUCCESS;
+            }
+            lzss_put(lz, (uint8_t)value, out, out_len);
+            lz->state = LZSS_STATE_TAG;
+            break;
+
+        case LZSS_STATE_DISTANCE:
+            if (!lzss_get_bits(lz, in, in_len, BOOT_LZSS_WINDOW_BITS, &value)) {
+                return HAL_ERR_SUCCESS;
+            }
+            lz->distance = (uint16_t)(value + 1U);
+            if (lz->distance > lz->out_total) {
+                return HAL_ERR_INVALID_PARAM;
+            }
+            lz->state = LZSS_STATE_COUNT;
+            break;
+
+        case LZSS_STATE_COUNT:
+        default:
+            if (!lzss_get_bits(lz, in, in_len, BOOT_LZSS_COUNT_BITS, &value)) {
+                return HAL_ERR_SUCCESS;
+            }
+            lz->count = (uint16_t)(value + 1U);
+            lz->state = LZSS_STATE_COPY;
+            break;
+        }
+    }
+
+    return HAL_ERR_SUCCESS;
+}
+
+bool boot_lzss_is_idle(const boot_lzss_t *lz)
+{
+    return lz->state != LZSS_STATE_COPY;
+}
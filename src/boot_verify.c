@@ -0,0 +1,176 @@
+/**
+ * @file boot_verify.c
+ * @brief Application image CRC32 verification with a verified-image cache
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial image verification and cache
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "boot_ctrl.h"
+#include "boot_verify.h"
+#include "hal_crc.h"
+#include "hal_error.h"
+#include "hal_flash.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define BOOT_VERIFY_CRC_LEN     (offsetof(boot_verify_cache_t, crc32))
+
+/*******************************************************************************
+ * Local Functions
+ ******************************************************************************/
+
+static int32_t boot_verify_load(boot_verify_cache_t *cache)
+{
+    if (hal_flash_read(BOOT_VERIFY_CACHE_ADDR, (uint8_t *)cache, sizeof(*cache)) != HAL_ERR_SUCCESS) {
+        return -1;
+    }
+
+    if (cache->magic != BOOT_VERIFY_MAGIC ||
+        cache->crc32 != hal_crc32_compute((const uint8_t *)cache, BOOT_VERIFY_CRC_LEN, 0xFFFFFFFFU)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int32_t boot_verify_store(boot_verify_cache_t *cache)
+{
+    cache->magic = BOOT_VERIFY_MAGIC;
+    cache->crc32 = hal_crc32_compute((const uint8_t *)cache, BOOT_VERIFY_CRC_LEN, 0xFFFFFFFFU);
+
+    return hal_flash_write(BOOT_VERIFY_CACHE_ADDR, (const uint8_t *)cache, sizeof(*cache));
+}
+
+/**
+ * @brief Slot flash program counter, bumped whenever a slot is marked pending
+ */
+static uint32_t boot_verify_program_count(tAPPType slot)
+{
+    boot_ctrl_record_t record;
+
+    if (boot_ctrl_load(&record) != 0) {
+        return 0U;
+    }
+
+    return record.generation[slot];
+}
+
+/**
+ * @brief CRC32 over a flash range through the streaming API, so the hardware
+ *        path chains DMA chunks and reports a stuck transfer
+ */
+static int32_t boot_verify_crc_range(uint32_t addr, uint32_t size, uint32_t *crc)
+{
+    hal_crc32_ctx_t ctx;
+    int32_t ret;
+
+    ret = hal_crc32_begin(&ctx);
+    if (ret == HAL_ERR_SUCCESS) {
+        ret = hal_crc32_update(&ctx, (const uint8_t *)addr, size);
+    }
+    if (ret == HAL_ERR_SUCCESS) {
+        ret = hal_crc32_final(&ctx, crc);
+    }
+
+    return ret;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+int32_t boot_verify_image(tAPPType slot, bool *cached)
+{
+    const app_metadata_t *meta;
+    boot_verify_cache_t cache;
+    boot_verify_entry_t *entry;
+    uint32_t slot_addr = boot_ctrl_slot_addr(slot);
+    uint32_t meta_crc;
+    uint32_t program_count;
+    uint32_t image_crc = 0U;
+    int32_t ret;
+
+    if (cached) {
+        *cached = false;
+    }
+
+    if (slot_addr == 0U) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    meta = (const app_metadata_t *)boot_ctrl_slot_metadata_addr(slot);
+    if (meta->magic != APP_METADATA_MAGIC) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    /* The covered range must lie inside the slot and stop short of the metadata */
+    if (meta->flash_start_addr < slot_addr || meta->image_size == 0U ||
+        meta->image_size > BOOT_SLOT_METADATA_OFFSET - (meta->flash_start_addr - slot_addr)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    meta_crc = hal_crc32_compute((const uint8_t *)meta, sizeof(*meta), 0U);
+    program_count = boot_verify_program_count(slot);
+
+    if (boot_verify_load(&cache) != 0) {
+        memset(&cache, 0, sizeof(cache));
+    }
+    entry = &cache.entry[slot];
+
+    /* Warm boot: nothing that could have changed the image has happened */
+    if (entry->slot_addr == slot_addr && entry->image_crc == meta->crc32 &&
+        entry->meta_crc == meta_crc && entry->program_count == program_count) {
+        if (cached) {
+            *cached = true;
+        }
+        return HAL_ERR_SUCCESS;
+    }
+
+    ret = boot_verify_crc_range(meta->flash_start_addr, meta->image_size, &image_crc);
+    if (ret != HAL_ERR_SUCCESS) {
+        return ret;
+    }
+
+    if (image_crc != meta->crc32) {
+        return HAL_ERR_FLASH_VERIFY_FAILED;
+    }
+
+    entry->slot_addr = slot_addr;
+    entry->image_crc = meta->crc32;
+    entry->meta_crc = meta_crc;
+    entry->program_count = program_count;
+
+    /* A failed cache write only costs a full scan next time */
+    (void)boot_verify_store(&cache);
+
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t boot_verify_invalidate(tAPPType slot)
+{
+    boot_verify_cache_t cache;
+
+    if (boot_ctrl_slot_addr(slot) == 0U) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    if (boot_verify_load(&cache) != 0) {
+        return HAL_ERR_SUCCESS;
+    }
+
+    if (cache.entry[slot].slot_addr == 0U) {
+        return HAL_ERR_SUCCESS;
+    }
+
+    memset(&cache.entry[slot], 0, sizeof(cache.entry[slot]));
+
+    return boot_verify_store(&cache);
+}
@@ -1,17 +1,24 @@
 /**
  * @file hal_crc.c
  * @brief HAL implementation of CRC16 and CRC32, software and hardware selectable
- * @version 1.1.0
- * @date 2025-06-21
+ * @version 1.4.0
+ * @date 2026-10-17
+ *
+ * @history
+ *  - v1.2.0, 2026-10-17, Slicing-by-4/8 CRC32 and table-driven CRC16 for the software path
+ *  - v1.3.0, 2026-10-17, Streaming CRC32 API with chained DMA chunks and timeout reporting
+ *  - v1.4.0, 2026-10-17, hal_crc32_combine() for CRC32s built from independent pieces
  */
 
 #include "hal_crc.h"
-#include "Clock_Ip.h"
-#include "Dma_Ip.h"
-#include "Crc_Ip.h"
+#include "hal_error.h"
 #include <stdbool.h>
+#include <string.h>
 
 #if HAL_CRC_USE_HARDWARE
+#include "Clock_Ip.h"
+#include "Dma_Ip.h"
+#include "Crc_Ip.h"
 /*******************************************
  * Hardware CRC Implementation
  *******************************************/
@@ -19,9 +26,10 @@
 #define CRC_CHANNEL_16BIT_CCITT_FALSE (CRC_LOGIC_CHANNEL_0) /* Aligned with original S32K312 code */
 #define CRC_CHANNEL_32BIT_ETHERNET    (CRC_LOGIC_CHANNEL_2) /* Aligned with configuration */
 #define DMA_CHANNEL_32BIT_ETHERNET    (DMA_LOGIC_CH_0)
-#define DMA_TIMEOUT_CYCLES            (4800000U)
+#define DMA_TIMEOUT_CYCLES            (4800000U) /* Status polls allowed per chunk */
 
 static bool inited = false;
+static hal_crc32_ctx_t *crc32_owner = NULL; /* Context currently using the CRC32 channel */
 
 static Crc_Ip_LogicChannelConfigType g_crc16_config = {
     /* Crc_Ip_ProtocolType Protocol */ CRC_PROTOCOL_16BIT_CCITT_FALSE,
@@ -90,27 +98,132 @@ uint16_t hal_crc16_compute(const uint8_t *data, size_t length, uint16_t init_val
     return (uint16_t)crc_result;
 }
 
-uint32_t hal_crc32_compute(const uint8_t *data, size_t length, uint32_t init_value)
+/* Hand the next chunk to the CRC/DMA engine, continuing from the previous result */
+static void hal_crc32_start_chunk(hal_crc32_ctx_t *ctx)
 {
-    uint32_t crc_result;
-    uint32_t index = 0U;
-    Dma_Ip_LogicChannelStatusType dma_status;
+    uint32_t len = (ctx->remaining > HAL_CRC_DMA_CHUNK_SIZE) ? HAL_CRC_DMA_CHUNK_SIZE : (uint32_t)ctx->remaining;
+
+    (void)Crc_Ip_SetChannelCalculate(CRC_CHANNEL_32BIT_ETHERNET, ctx->data, len, ctx->crc,
+                                     ctx->first ? TRUE : FALSE);
+    ctx->first = false;
+    ctx->data += len;
+    ctx->remaining -= len;
+    ctx->wait = 0U;
+    ctx->running = true;
+}
+
+int32_t hal_crc32_begin(hal_crc32_ctx_t *ctx)
+{
+    if (ctx == NULL) {
+        return HAL_ERR_INVALID_PARAM;
+    }
 
     if (!inited) {
-        return 0U;
+        return HAL_ERR_NOT_INITIALIZED;
     }
 
-    /* Start CRC32 calculation with Ethernet protocol */
-    crc_result = Crc_Ip_SetChannelCalculate(CRC_CHANNEL_32BIT_ETHERNET, data, length, init_value, TRUE);
-    /* Wait for DMA transfer completion */
-    do {
-        Dma_Ip_GetLogicChannelStatus(DMA_CHANNEL_32BIT_ETHERNET, &dma_status);
-        if (TRUE == dma_status.Done) {
-            /* Retrieve final CRC result */
-            crc_result = Crc_Ip_GetChannelResult(CRC_CHANNEL_32BIT_ETHERNET);
-            break;
+    if (crc32_owner != NULL && crc32_owner != ctx && crc32_owner->running) {
+        return HAL_ERR_RESOURCE_BUSY;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    ctx->first = true;
+    crc32_owner = ctx;
+
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t hal_crc32_update_async(hal_crc32_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    if (ctx == NULL || (data == NULL && length != 0U)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    /* Channel was taken over by another context since begin */
+    if (crc32_owner != ctx) {
+        return HAL_ERR_RESOURCE_BUSY;
+    }
+
+    if (ctx->running || ctx->remaining != 0U) {
+        return HAL_ERR_RESOURCE_BUSY;
+    }
+
+    ctx->data = data;
+    ctx->remaining = length;
+    if (length != 0U) {
+        hal_crc32_start_chunk(ctx);
+    }
+
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t hal_crc32_poll(hal_crc32_ctx_t *ctx)
+{
+    Dma_Ip_LogicChannelStatusType dma_status;
+
+    if (ctx == NULL) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    if (!ctx->running) {
+        return HAL_ERR_SUCCESS;
+    }
+
+    Dma_Ip_GetLogicChannelStatus(DMA_CHANNEL_32BIT_ETHERNET, &dma_status);
+    if (TRUE == dma_status.Done) {
+        ctx->crc = Crc_Ip_GetChannelResult(CRC_CHANNEL_32BIT_ETHERNET);
+        ctx->running = false;
+        if (ctx->remaining == 0U) {
+            return HAL_ERR_SUCCESS;
         }
-    } while (index++ < DMA_TIMEOUT_CYCLES);
+        hal_crc32_start_chunk(ctx);
+        return HAL_ERR_RESOURCE_BUSY;
+    }
+
+    if (++ctx->wait > DMA_TIMEOUT_CYCLES) {
+        /* Give the channel up; whatever was computed so far is meaningless */
+        ctx->running = false;
+        ctx->remaining = 0U;
+        crc32_owner = NULL;
+        return HAL_ERR_TIMEOUT;
+    }
+
+    return HAL_ERR_RESOURCE_BUSY;
+}
+
+int32_t hal_crc32_final(hal_crc32_ctx_t *ctx, uint32_t *crc)
+{
+    if (ctx == NULL || crc == NULL) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    if (ctx->running || ctx->remaining != 0U) {
+        return HAL_ERR_RESOURCE_BUSY;
+    }
+
+    *crc = ctx->crc;
+    if (crc32_owner == ctx) {
+        crc32_owner = NULL;
+    }
+
+    return HAL_ERR_SUCCESS;
+}
+
+uint32_t hal_crc32_compute(const uint8_t *data, size_t length, uint32_t init_value)
+{
+    hal_crc32_ctx_t ctx;
+    uint32_t crc_result = 0U;
+
+    if (hal_crc32_begin(&ctx) != HAL_ERR_SUCCESS) {
+        return 0U;
+    }
+
+    /* First chunk is seeded with init_value, as before */
+    ctx.crc = init_value;
+    if (hal_crc32_update(&ctx, data, length) != HAL_ERR_SUCCESS) {
+        return 0U;
+    }
+    (void)hal_crc32_final(&ctx, &crc_result);
 
     return crc_result;
 }
@@ -120,15 +233,20 @@ uint32_t hal_crc32_compute(const uint8_t *data, size_t length, uint32_t init_val
  * Software CRC Implementation
  *******************************************/
 
-void hal_crc_init(void)
-{
-    /* No operation for software implementation */
-}
+#if (HAL_CRC_SW_SLICING != 1) && (HAL_CRC_SW_SLICING != 4) && (HAL_CRC_SW_SLICING != 8)
+#error "HAL_CRC_SW_SLICING must be 1, 4 or 8"
+#endif
 
-void hal_crc_deinit(void)
-{
-    /* No operation for software implementation */
-}
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) && (HAL_CRC_SW_SLICING > 1)
+#error "Sliced CRC32 assumes little-endian word loads"
+#endif
+
+/* Lookup tables go to DTCM on target; host builds (image tools, benchmark) keep them in .bss */
+#if defined(__GNUC__) && defined(__arm__)
+#define HAL_CRC_DTCM __attribute__((section(".dtcm_bss")))
+#else
+#define HAL_CRC_DTCM
+#endif
 
 static const uint32_t crc_table[256] =
 {
@@ -186,44 +304,239 @@ static const uint32_t crc_table[256] =
 	0x2d02ef8dL
 };
 
-#define DO1(buf) crc = crc_table[((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
-#define DO2(buf)  DO1(buf); DO1(buf);
-#define DO4(buf)  DO2(buf); DO2(buf);
-#define DO8(buf)  DO4(buf); DO4(buf);
+#if HAL_CRC_SW_SLICING > 1
+/* crc32_slice[0] mirrors crc_table; crc32_slice[k] advances it by k more zero bytes */
+static uint32_t crc32_slice[HAL_CRC_SW_SLICING][256] HAL_CRC_DTCM;
+#define CRC32_T0 crc32_slice[0]
+#else
+#define CRC32_T0 crc_table
+#endif
+
+static uint16_t crc16_table[256] HAL_CRC_DTCM;
+static bool tables_ready = false;
+
+static void hal_crc_build_tables(void)
+{
+    uint32_t i;
+    uint16_t crc16;
+    uint16_t bit;
+#if HAL_CRC_SW_SLICING > 1
+    uint32_t k;
+#endif
+
+    for (i = 0U; i < 256U; i++) {
+        /* CRC-16/CCITT-FALSE, MSB first */
+        crc16 = (uint16_t)(i << 8);
+        for (bit = 0U; bit < 8U; bit++) {
+            crc16 = (crc16 & 0x8000U) ? (uint16_t)((crc16 << 1) ^ 0x1021U) : (uint16_t)(crc16 << 1);
+        }
+        crc16_table[i] = crc16;
+    }
+
+#if HAL_CRC_SW_SLICING > 1
+    memcpy(crc32_slice[0], crc_table, sizeof(crc_table));
+    for (k = 1U; k < HAL_CRC_SW_SLICING; k++) {
+        for (i = 0U; i < 256U; i++) {
+            crc32_slice[k][i] = (crc32_slice[k - 1U][i] >> 8) ^ crc32_slice[0][crc32_slice[k - 1U][i] & 0xffU];
+        }
+    }
+#endif
+
+    tables_ready = true;
+}
+
+void hal_crc_init(void)
+{
+    if (!tables_ready) {
+        hal_crc_build_tables();
+    }
+}
+
+void hal_crc_deinit(void)
+{
+    /* Tables are kept, nothing to release for software implementation */
+}
+
+#define DO1(buf) crc = CRC32_T0[((int)crc ^ (*buf++)) & 0xff] ^ (crc >> 8);
+
+#if HAL_CRC_SW_SLICING > 1
+static inline uint32_t crc32_load_word(const uint8_t *buf)
+{
+    uint32_t word;
+
+    memcpy(&word, buf, sizeof(word));
+    return word;
+}
+#endif
 
 uint32_t hal_crc32_compute(const uint8_t *buffer, size_t len, uint32_t init_value)
 {
 	uint32_t crc = init_value;
+#if HAL_CRC_SW_SLICING > 1
+	uint32_t one;
+#endif
+#if HAL_CRC_SW_SLICING == 8
+	uint32_t two;
+#endif
+
+	if (!tables_ready) {
+		hal_crc_build_tables();
+	}
+
 	crc = crc ^ 0xffffffffL;
+
+#if HAL_CRC_SW_SLICING > 1
+	/* Byte steps up to a word boundary, then whole words */
+	while (len && ((uintptr_t)buffer & 3U)) {
+		DO1(buffer);
+		len--;
+	}
+#endif
+
+#if HAL_CRC_SW_SLICING == 8
 	while (len >= 8) {
-		DO8(buffer);
+		one = crc32_load_word(buffer) ^ crc;
+		two = crc32_load_word(buffer + 4);
+		crc = crc32_slice[7][one & 0xffU] ^
+		      crc32_slice[6][(one >> 8) & 0xffU] ^
+		      crc32_slice[5][(one >> 16) & 0xffU] ^
+		      crc32_slice[4][one >> 24] ^
+		      crc32_slice[3][two & 0xffU] ^
+		      crc32_slice[2][(two >> 8) & 0xffU] ^
+		      crc32_slice[1][(two >> 16) & 0xffU] ^
+		      crc32_slice[0][two >> 24];
+		buffer += 8;
 		len -= 8;
 	}
-	if (len) do {
+#endif
+
+#if HAL_CRC_SW_SLICING > 1
+	while (len >= 4) {
+		one = crc32_load_word(buffer) ^ crc;
+		crc = crc32_slice[3][one & 0xffU] ^
+		      crc32_slice[2][(one >> 8) & 0xffU] ^
+		      crc32_slice[1][(one >> 16) & 0xffU] ^
+		      crc32_slice[0][one >> 24];
+		buffer += 4;
+		len -= 4;
+	}
+#endif
+
+	while (len) {
 		DO1(buffer);
-	} while(--len);
+		len--;
+	}
 
 	return crc ^ 0xffffffffL;
 }
 
+int32_t hal_crc32_begin(hal_crc32_ctx_t *ctx)
+{
+    if (ctx == NULL) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    memset(ctx, 0, sizeof(*ctx));
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t hal_crc32_update_async(hal_crc32_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    if (ctx == NULL || (data == NULL && length != 0U)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    /* The software path chains through the init value and completes at once */
+    ctx->crc = hal_crc32_compute(data, length, ctx->crc);
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t hal_crc32_poll(hal_crc32_ctx_t *ctx)
+{
+    return (ctx == NULL) ? HAL_ERR_INVALID_PARAM : HAL_ERR_SUCCESS;
+}
+
+int32_t hal_crc32_final(hal_crc32_ctx_t *ctx, uint32_t *crc)
+{
+    if (ctx == NULL || crc == NULL) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    *crc = ctx->crc;
+    return HAL_ERR_SUCCESS;
+}
+
 /* CRC-16/CCITT-FALSE: poly=0x1021, init=0xFFFF, xor_out=0x0000 */
 uint16_t hal_crc16_compute(const uint8_t *data, size_t length, uint16_t init_value)
 {
     uint16_t crc = init_value;
-    uint16_t i;
+
+    if (!tables_ready) {
+        hal_crc_build_tables();
+    }
 
     while (length--) {
-        crc ^= ((uint16_t)(*data++)) << 8; /* XOR byte into high 8 bits */
-        for (i = 0; i < 8; ++i) {
-            if (crc & 0x8000U) {
-                crc = (crc << 1) ^ 0x1021U;
-            } else {
-                crc <<= 1;
-            }
-        }
+        crc = (uint16_t)((crc << 8) ^ crc16_table[((crc >> 8) ^ *data++) & 0xffU]);
     }
 
     return crc;
 }
 
 #endif /* HAL_CRC_USE_HARDWARE */
+
+/*******************************************
+ * Common
+ *******************************************/
+
+#define CRC32_POLY_REFLECTED (0xEDB88320U)
+
+/* a * b modulo the CRC32 polynomial, both in reflected bit order (x^0 = bit 31) */
+static uint32_t crc32_mult_mod_poly(uint32_t a, uint32_t b)
+{
+    uint32_t m = 1U << 31;
+    uint32_t p = 0U;
+
+    while (m != 0U) {
+        if ((a & m) != 0U) {
+            p ^= b;
+        }
+        m >>= 1;
+        b = ((b & 1U) != 0U) ? ((b >> 1) ^ CRC32_POLY_REFLECTED) : (b >> 1);
+    }
+
+    return p;
+}
+
+uint32_t hal_crc32_combine(uint32_t crc1, uint32_t crc2, size_t len2)
+{
+    uint32_t x2k = 1U << 23;    /* x^8: shifts by one byte */
+    uint32_t op = 1U << 31;     /* x^0 */
+
+    /* op = x^(8 * len2), squaring x^(2^k) for each bit of len2 */
+    while (len2 != 0U) {
+        if ((len2 & 1U) != 0U) {
+            op = crc32_mult_mod_poly(x2k, op);
+        }
+        len2 >>= 1;
+        if (len2 != 0U) {
+            x2k = crc32_mult_mod_poly(x2k, x2k);
+        }
+    }
+
+    return crc32_mult_mod_poly(op, crc1) ^ crc2;
+}
+
+int32_t hal_crc32_update(hal_crc32_ctx_t *ctx, const uint8_t *data, size_t length)
+{
+    int32_t ret = hal_crc32_update_async(ctx, data, length);
+
+    if (ret != HAL_ERR_SUCCESS) {
+        return ret;
+    }
+
+    do {
+        ret = hal_crc32_poll(ctx);
+    } while (ret == HAL_ERR_RESOURCE_BUSY);
+
+    return ret;
+}
@@ -2,8 +2,8 @@
  * @file hal_flash.c
  * @brief Hardware Abstraction Layer (HAL) implementation for flash memory operations
  *
- * @version 1.0.1
- * @date 2025-06-21
+ * @version 1.4.0
+ * @date 2026-10-17
  *
  * @details
  * This source file implements the flash memory operations defined in hal_flash.h,
@@ -14,17 +14,37 @@
  * @history
  *  - v1.0.0, 2025-06-21, Initial implementation based on NXP C40_Ip driver
  *  - v1.0.1, 2025-06-21, Updated to use specific flash error codes from hal_err.h
+ *  - v1.1.0, 2026-10-17, Job queue engine; blocking calls now run through it
+ *  - v1.2.0, 2026-10-17, Program-only path, erase-ahead and blank check
+ *  - v1.3.0, 2026-10-17, Write-combining page buffer
+ *  - v1.4.0, 2026-10-17, Configurable verify policy
  */
 
+#include <string.h>
 #include "C40_Ip.h"
+#include "hal_crc.h"
 #include "hal_error.h"
 #include "hal_flash.h"
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
 
-#define SECTOR_SIZE (8192u) /* Sector size for S32K312, adjust for other MCUs */
+#define SECTOR_SIZE (HAL_FLASH_SECTOR_SIZE) /* Sector size for S32K312, adjust for other MCUs */
 #define MASTER_ID (0U) /* Master ID for C40_Ip operations */
+#define BLANK_CHECK_CHUNK (64u) /* Bytes read per blank check step */
+
+/* Memory-mapped view of a flash address; the host simulator provides its own */
+#ifndef HAL_FLASH_PTR
+#define HAL_FLASH_PTR(addr) ((const uint8_t *)(uintptr_t)(addr))
+#endif
+
+/* Controller operation the engine is waiting on */
+typedef enum
+{
+    ENGINE_OP_NONE = 0,
+    ENGINE_OP_ERASE,
+    ENGINE_OP_WRITE,
+} engine_op_t;
 
 /*******************************************************************************
  * Local Variables
@@ -32,6 +52,13 @@
 
 static bool is_initialized = false; /* Tracks flash module initialization state */
 
+static hal_flash_job_t *job_head = NULL;    /* Running job */
+static hal_flash_job_t *job_tail = NULL;    /* Last queued job */
+static engine_op_t engine_op = ENGINE_OP_NONE;
+static uint32_t engine_op_len = 0u;         /* Bytes covered by the operation in flight */
+
+static hal_flash_verify_policy_t verify_policy = HAL_FLASH_VERIFY_COMPARE;
+
 /*******************************************************************************
  * Public Functions
  ******************************************************************************/
@@ -94,9 +121,114 @@ void hal_flash_free(void)
 	/* No deinitialization required for C40_Ip driver */
 }
 
+/**
+ * @brief Removes the head job from the queue and reports its result
+ *
+ * @param job The head job
+ * @param result Final result
+ */
+static void engine_finish(hal_flash_job_t *job, int32_t result)
+{
+    job_head = job->next;
+    if (job_head == NULL) {
+        job_tail = NULL;
+    }
+    job->next = NULL;
+    engine_op = ENGINE_OP_NONE;
+    job->result = result;
+
+    if (job->complete != NULL) {
+        job->complete(job, result);
+    }
+}
+
+/**
+ * @brief Starts erasing the next sector of an erase job
+ *
+ * @param job The head job
+ * @return int32_t HAL_ERR_SUCCESS if the erase was started
+ */
+static int32_t engine_start_erase(hal_flash_job_t *job)
+{
+    C40_Ip_VirtualSectorsType sector = C40_Ip_GetSectorNumberFromAddress(job->addr + job->done);
+
+    if (C40_Ip_GetLock(sector) == C40_IP_STATUS_SECTOR_PROTECTED) {
+        if (C40_Ip_ClearLock(sector, MASTER_ID) != C40_IP_STATUS_SUCCESS) {
+            return HAL_ERR_FLASH_SECTOR_PROTECTED;
+        }
+    }
+
+    if (C40_Ip_MainInterfaceSectorErase(sector, MASTER_ID) != C40_IP_STATUS_SUCCESS) {
+        return HAL_ERR_FLASH_ERASE_FAILED;
+    }
+
+    engine_op = ENGINE_OP_ERASE;
+    engine_op_len = SECTOR_SIZE;
+    return HAL_ERR_SUCCESS;
+}
+
+/**
+ * @brief Starts programming the next chunk of a program job
+ *
+ * Chunks never cross a HAL_FLASH_PROGRAM_CHUNK boundary, so each one maps to
+ * a single quad-page write.
+ *
+ * @param job The head job
+ * @return int32_t HAL_ERR_SUCCESS if the write was started
+ */
+static int32_t engine_start_write(hal_flash_job_t *job)
+{
+    uint32_t addr = job->addr + job->done;
+    uint32_t len = HAL_FLASH_PROGRAM_CHUNK - (addr % HAL_FLASH_PROGRAM_CHUNK);
+    C40_Ip_VirtualSectorsType sector = C40_Ip_GetSectorNumberFromAddress(addr);
+
+    if (len > job->size - job->done) {
+        len = job->size - job->done;
+    }
+
+    /* Sectors come out of reset locked; one that is still blank was never erased (unlocked) since */
+    if (C40_Ip_GetLock(sector) == C40_IP_STATUS_SECTOR_PROTECTED) {
+        if (C40_Ip_ClearLock(sector, MASTER_ID) != C40_IP_STATUS_SUCCESS) {
+            return HAL_ERR_FLASH_SECTOR_PROTECTED;
+        }
+    }
+
+    if (C40_Ip_MainInterfaceWrite(addr, len, job->data + job->done, MASTER_ID) != C40_IP_STATUS_SUCCESS) {
+        return HAL_ERR_FLASH_WRITE_FAILED;
+    }
+
+    engine_op = ENGINE_OP_WRITE;
+    engine_op_len = len;
+    return HAL_ERR_SUCCESS;
+}
+
+/**
+ * @brief Submits a job and drives the engine until it completes
+ *
+ * @param job Job to run
+ * @return int32_t Submit error or the job result
+ */
+static int32_t hal_flash_run_job(hal_flash_job_t *job)
+{
+    int32_t status = hal_flash_submit(job);
+
+    if (status != HAL_ERR_SUCCESS) {
+        return status;
+    }
+
+    while (job->result == HAL_ERR_RESOURCE_BUSY) {
+        hal_flash_main_function();
+    }
+
+    return job->result;
+}
+
 /**
  * @brief Erases one or more sectors of the flash memory starting at the specified address
  *
+ * Blocking; runs an erase job through the engine until it completes. As
+ * before the engine, addr may point anywhere into the first sector.
+ *
  * @param addr The starting address in flash memory to begin erasing
  * @param num_sectors The number of sectors to erase
  * @return int32_t Returns HAL_ERR_SUCCESS on success, or one of:
@@ -107,7 +239,62 @@ void hal_flash_free(void)
  */
 int32_t hal_flash_erase_sector(uint32_t addr, uint32_t num_sectors)
 {
-    if (num_sectors == 0u) {
+    hal_flash_job_t job = {0};
+
+    if (num_sectors == 0u || num_sectors > UINT32_MAX / SECTOR_SIZE ||
+        !hal_flash_is_valid_address(addr, num_sectors * SECTOR_SIZE)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    job.type = HAL_FLASH_JOB_ERASE;
+    job.addr = addr - (addr % SECTOR_SIZE);
+    job.size = num_sectors * SECTOR_SIZE;
+
+    return hal_flash_run_job(&job);
+}
+
+/**
+ * @brief Fills in an erase job covering every sector overlapping a range
+ *
+ * @return bool false if the range is invalid
+ */
+static bool hal_flash_sector_span(hal_flash_job_t *job, uint32_t addr, uint32_t size)
+{
+    uint32_t first_sector;
+
+    if (!hal_flash_is_valid_address(addr, size)) {
+        return false;
+    }
+
+    first_sector = addr - (addr % SECTOR_SIZE);
+
+    job->type = HAL_FLASH_JOB_ERASE;
+    job->addr = first_sector;
+    job->size = ((addr + size - 1u) - first_sector) / SECTOR_SIZE * SECTOR_SIZE + SECTOR_SIZE;
+    job->data = NULL;
+
+    return true;
+}
+
+/**
+ * @brief Writes data to the flash memory at the specified address
+ *
+ * Compatibility wrapper around hal_flash_erase_range() and hal_flash_program().
+ *
+ * @param addr The starting address in flash memory to write to
+ * @param data Pointer to the data buffer to write
+ * @param size The size in bytes of the data to write
+ * @return int32_t Returns HAL_ERR_SUCCESS on success, or one of:
+ *                 - HAL_ERR_INVALID_PARAM for invalid inputs
+ *                 - HAL_ERR_NOT_INITIALIZED if module is not initialized
+ *                 - HAL_ERR_FLASH_SECTOR_PROTECTED if a sector cannot be unlocked
+ *                 - HAL_ERR_FLASH_WRITE_FAILED for write or verification failures
+ */
+int32_t hal_flash_write(uint32_t addr, const uint8_t *data, uint32_t size)
+{
+    int32_t status;
+
+    if (data == NULL || !hal_flash_is_valid_address(addr, size)) {
         return HAL_ERR_INVALID_PARAM;
     }
 
@@ -115,54 +302,172 @@ int32_t hal_flash_erase_sector(uint32_t addr, uint32_t num_sectors)
     	return HAL_ERR_NOT_INITIALIZED;
     }
 
-    uint32_t size = num_sectors * SECTOR_SIZE;
-    if (!hal_flash_is_valid_address(addr, size)) {
-        return HAL_ERR_INVALID_PARAM;
+    status = hal_flash_erase_range(addr, size);
+    if (status != HAL_ERR_SUCCESS) {
+        return HAL_ERR_FLASH_ERASE_FAILED;
     }
 
-    C40_Ip_StatusType status;
-    C40_Ip_VirtualSectorsType start_sector = C40_Ip_GetSectorNumberFromAddress(addr);
-    C40_Ip_VirtualSectorsType sector;
-    uint32_t i;
+    return hal_flash_program(addr, data, size);
+}
 
-    for (i = 0u; i < num_sectors; i++) {
-        sector = start_sector + i;
+/**
+ * @brief CRC32 of a buffer through the streaming CRC API
+ *
+ * @param data Buffer (flash or RAM)
+ * @param size Bytes
+ * @param[out] crc CRC32, only valid on success
+ * @return int32_t HAL_ERR_SUCCESS or the hal_crc32_begin/update/final error
+ */
+static int32_t hal_flash_crc32(const uint8_t *data, uint32_t size, uint32_t *crc)
+{
+    hal_crc32_ctx_t ctx;
+    int32_t status;
 
-        if (C40_Ip_GetLock(sector) == C40_IP_STATUS_SECTOR_PROTECTED) {
-            status = C40_Ip_ClearLock(sector, MASTER_ID);
-            if (status != C40_IP_STATUS_SUCCESS) {
-                return HAL_ERR_FLASH_SECTOR_PROTECTED;
-            }
-        }
+    status = hal_crc32_begin(&ctx);
+    if (status == HAL_ERR_SUCCESS) {
+        status = hal_crc32_update(&ctx, data, size);
+    }
+    if (status == HAL_ERR_SUCCESS) {
+        status = hal_crc32_final(&ctx, crc);
+    }
 
-        C40_Ip_MainInterfaceSectorErase(sector, MASTER_ID);
-        do {
-            status = C40_Ip_MainInterfaceSectorEraseStatus();
-        } while (status == C40_IP_STATUS_BUSY);
+    return status;
+}
 
-        if (status != C40_IP_STATUS_SUCCESS) {
-            return HAL_ERR_FLASH_ERASE_FAILED;
+/**
+ * @brief Read-back check for HAL_FLASH_VERIFY_SECTOR_CRC
+ *
+ * Compares CRC32 of the source with CRC32 of the flash contents, once for
+ * each sector the range touches. The read-back goes through the CRC unit
+ * (DMA on hardware) instead of a CPU compare loop.
+ *
+ * @return int32_t HAL_ERR_SUCCESS, HAL_ERR_FLASH_VERIFY_FAILED or a CRC error
+ */
+static int32_t hal_flash_verify_sector_crc(uint32_t addr, const uint8_t *data, uint32_t size)
+{
+    uint32_t flash_crc = 0u;
+    uint32_t data_crc = 0u;
+    uint32_t len;
+    int32_t status;
+
+    while (size > 0u) {
+        len = SECTOR_SIZE - (addr % SECTOR_SIZE);
+        if (len > size) {
+            len = size;
+        }
+        /* One after the other, the hardware has a single CRC channel */
+        status = hal_flash_crc32(HAL_FLASH_PTR(addr), len, &flash_crc);
+        if (status == HAL_ERR_SUCCESS) {
+            status = hal_flash_crc32(data, len, &data_crc);
+        }
+        if (status != HAL_ERR_SUCCESS) {
+            return status;
         }
+        if (flash_crc != data_crc) {
+            return HAL_ERR_FLASH_VERIFY_FAILED;
+        }
+        addr += len;
+        data += len;
+        size -= len;
     }
 
     return HAL_ERR_SUCCESS;
 }
 
 /**
- * @brief Writes data to the flash memory at the specified address
+ * @brief Programs data into already erased flash, without erasing
  *
- * @param addr The starting address in flash memory to write to
- * @param data Pointer to the data buffer to write
- * @param size The size in bytes of the data to write
+ * @param addr The starting address in flash memory to program
+ * @param data Pointer to the data buffer to program
+ * @param size The size in bytes of the data to program
+ * @return int32_t Returns HAL_ERR_SUCCESS on success, or one of:
+ *                 - HAL_ERR_INVALID_PARAM for invalid inputs
+ *                 - HAL_ERR_NOT_INITIALIZED if module is not initialized
+ *                 - HAL_ERR_FLASH_WRITE_FAILED if the controller rejects the write
+ *                 - HAL_ERR_FLASH_VERIFY_FAILED if the read-back differs
+ *                 - the CRC error if the HAL_FLASH_VERIFY_SECTOR_CRC read-back fails
+ */
+int32_t hal_flash_program(uint32_t addr, const uint8_t *data, uint32_t size)
+{
+    hal_flash_job_t job = {0};
+    int32_t status;
+
+    job.type = HAL_FLASH_JOB_PROGRAM;
+    job.addr = addr;
+    job.size = size;
+    job.data = data;
+
+    status = hal_flash_run_job(&job);
+    if (status != HAL_ERR_SUCCESS) {
+        return status;
+    }
+
+    switch (verify_policy) {
+    case HAL_FLASH_VERIFY_SECTOR_CRC:
+        return hal_flash_verify_sector_crc(addr, data, size);
+
+    case HAL_FLASH_VERIFY_DEFERRED:
+        return HAL_ERR_SUCCESS;
+
+    case HAL_FLASH_VERIFY_COMPARE:
+    default:
+        job.type = HAL_FLASH_JOB_VERIFY;
+        return hal_flash_run_job(&job);
+    }
+}
+
+/**
+ * @brief Erases all sectors overlapping [addr, addr + size) and waits
+ *
+ * @param addr Start of the range
+ * @param size Size of the range in bytes
  * @return int32_t Returns HAL_ERR_SUCCESS on success, or one of:
  *                 - HAL_ERR_INVALID_PARAM for invalid inputs
  *                 - HAL_ERR_NOT_INITIALIZED if module is not initialized
  *                 - HAL_ERR_FLASH_SECTOR_PROTECTED if a sector cannot be unlocked
- *                 - HAL_ERR_FLASH_WRITE_FAILED for write or verification failures
+ *                 - HAL_ERR_FLASH_ERASE_FAILED for erase failures
  */
-int32_t hal_flash_write(uint32_t addr, const uint8_t *data, uint32_t size)
+int32_t hal_flash_erase_range(uint32_t addr, uint32_t size)
 {
-    if (data == NULL || !hal_flash_is_valid_address(addr, size)) {
+    hal_flash_job_t job = {0};
+
+    if (!hal_flash_sector_span(&job, addr, size)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    return hal_flash_run_job(&job);
+}
+
+int32_t hal_flash_erase_ahead(hal_flash_job_t *job, uint32_t addr, uint32_t size)
+{
+    if (job == NULL || !hal_flash_sector_span(job, addr, size)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    return hal_flash_submit(job);
+}
+
+/**
+ * @brief Checks that a range reads as erased (all 0xFF)
+ *
+ * Reads go through C40_Ip_Read, so ECC-protected data flash is handled the
+ * same way as everywhere else in this module.
+ *
+ * @param addr The starting address in flash memory
+ * @param size The size in bytes to check
+ * @return int32_t Returns HAL_ERR_SUCCESS if blank, or one of:
+ *                 - HAL_ERR_INVALID_PARAM for invalid inputs
+ *                 - HAL_ERR_NOT_INITIALIZED if module is not initialized
+ *                 - HAL_ERR_FLASH_READ_FAILED for read failures
+ *                 - HAL_ERR_FLASH_VERIFY_FAILED if a byte is not erased
+ */
+int32_t hal_flash_blank_check(uint32_t addr, uint32_t size)
+{
+    uint32_t buf[BLANK_CHECK_CHUNK / 4u];
+    uint32_t len;
+    uint32_t i;
+
+    if (!hal_flash_is_valid_address(addr, size)) {
         return HAL_ERR_INVALID_PARAM;
     }
 
@@ -170,32 +475,267 @@ int32_t hal_flash_write(uint32_t addr, const uint8_t *data, uint32_t size)
     	return HAL_ERR_NOT_INITIALIZED;
     }
 
-    C40_Ip_StatusType status;
-    C40_Ip_VirtualSectorsType start_sector = C40_Ip_GetSectorNumberFromAddress(addr);
-    C40_Ip_VirtualSectorsType end_sector = C40_Ip_GetSectorNumberFromAddress(addr + size - 1u);
-    uint32_t sector_count = (end_sector - start_sector) + 1u;
+    while (size > 0u) {
+        len = (size > BLANK_CHECK_CHUNK) ? BLANK_CHECK_CHUNK : size;
+        if (C40_Ip_Read(addr, len, (uint8_t *)buf) != C40_IP_STATUS_SUCCESS) {
+            return HAL_ERR_FLASH_READ_FAILED;
+        }
+        for (i = 0u; i < len / 4u; i++) {
+            if (buf[i] != 0xFFFFFFFFu) {
+                return HAL_ERR_FLASH_VERIFY_FAILED;
+            }
+        }
+        addr += len;
+        size -= len;
+    }
 
-    if (hal_flash_erase_sector(addr, sector_count) != HAL_ERR_SUCCESS) {
-        return HAL_ERR_FLASH_ERASE_FAILED;
+    return HAL_ERR_SUCCESS;
+}
+
+/**
+ * @brief Programs the buffered page, trimmed to the write units that hold data
+ *
+ * @param wc Stream state with a non-empty page
+ * @return int32_t As hal_flash_program()
+ */
+static int32_t hal_flash_wc_flush(hal_flash_wc_t *wc)
+{
+    uint8_t *page = (uint8_t *)wc->page;
+    uint32_t start = wc->page_start - (wc->page_start % HAL_FLASH_WRITE_UNIT);
+    uint32_t end = (wc->page_fill + HAL_FLASH_WRITE_UNIT - 1u) / HAL_FLASH_WRITE_UNIT * HAL_FLASH_WRITE_UNIT;
+
+    wc->page_fill = 0u;
+    wc->page_start = 0u;
+
+    return hal_flash_program(wc->page_base + start, page + start, end - start);
+}
+
+int32_t hal_flash_wc_open(hal_flash_wc_t *wc, uint32_t addr)
+{
+    if (wc == NULL) {
+        return HAL_ERR_INVALID_PARAM;
     }
 
-    C40_Ip_MainInterfaceWrite(addr, size, data, MASTER_ID);
-    do {
-        status = C40_Ip_MainInterfaceWriteStatus();
-    } while (status == C40_IP_STATUS_BUSY);
+    wc->addr = addr;
+    wc->page_base = 0u;
+    wc->page_start = 0u;
+    wc->page_fill = 0u;
 
-    if (status != C40_IP_STATUS_SUCCESS) {
-        return HAL_ERR_FLASH_WRITE_FAILED;
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t hal_flash_wc_write(hal_flash_wc_t *wc, const uint8_t *data, uint32_t size)
+{
+    uint8_t *page;
+    uint32_t offset;
+    uint32_t len;
+    int32_t status;
+
+    if (wc == NULL || (data == NULL && size != 0u)) {
+        return HAL_ERR_INVALID_PARAM;
     }
 
-    status = C40_Ip_Compare(addr, size, data);
-    if (status != C40_IP_STATUS_SUCCESS) {
-        return HAL_ERR_FLASH_VERIFY_FAILED;
+    page = (uint8_t *)wc->page;
+
+    while (size > 0u) {
+        offset = wc->addr % HAL_FLASH_PROGRAM_CHUNK;
+
+        /* Whole pages from a word aligned buffer need no copy */
+        if (wc->page_fill == 0u && offset == 0u && size >= HAL_FLASH_PROGRAM_CHUNK &&
+            ((uintptr_t)data & 3u) == 0u) {
+            len = size - (size % HAL_FLASH_PROGRAM_CHUNK);
+            status = hal_flash_program(wc->addr, data, len);
+            if (status != HAL_ERR_SUCCESS) {
+                return status;
+            }
+        } else {
+            if (wc->page_fill == 0u) {
+                memset(page, 0xFF, HAL_FLASH_PROGRAM_CHUNK);
+                wc->page_base = wc->addr - offset;
+                wc->page_start = offset;
+            }
+
+            len = HAL_FLASH_PROGRAM_CHUNK - offset;
+            if (len > size) {
+                len = size;
+            }
+            memcpy(&page[offset], data, len);
+            wc->page_fill = offset + len;
+
+            if (wc->page_fill == HAL_FLASH_PROGRAM_CHUNK) {
+                status = hal_flash_wc_flush(wc);
+                if (status != HAL_ERR_SUCCESS) {
+                    return status;
+                }
+            }
+        }
+
+        wc->addr += len;
+        data += len;
+        size -= len;
+    }
+
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t hal_flash_wc_commit(hal_flash_wc_t *wc)
+{
+    if (wc == NULL) {
+        return HAL_ERR_INVALID_PARAM;
     }
 
+    if (wc->page_fill == 0u) {
+        return HAL_ERR_SUCCESS;
+    }
+
+    return hal_flash_wc_flush(wc);
+}
+
+void hal_flash_set_verify_policy(hal_flash_verify_policy_t policy)
+{
+    verify_policy = policy;
+}
+
+hal_flash_verify_policy_t hal_flash_get_verify_policy(void)
+{
+    return verify_policy;
+}
+
+int32_t hal_flash_verify_crc32(uint32_t addr, uint32_t size, uint32_t expected_crc)
+{
+    uint32_t crc = 0u;
+    int32_t status;
+
+    if (!hal_flash_is_valid_address(addr, size)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    status = hal_flash_crc32(HAL_FLASH_PTR(addr), size, &crc);
+    if (status != HAL_ERR_SUCCESS) {
+        return status;
+    }
+
+    return (crc == expected_crc) ? HAL_ERR_SUCCESS : HAL_ERR_FLASH_VERIFY_FAILED;
+}
+
+int32_t hal_flash_submit(hal_flash_job_t *job)
+{
+    hal_flash_job_t *queued;
+
+    if (job == NULL || job->type > HAL_FLASH_JOB_VERIFY) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    if (is_initialized == false) {
+    	return HAL_ERR_NOT_INITIALIZED;
+    }
+
+    if (!hal_flash_is_valid_address(job->addr, job->size)) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    if (job->type == HAL_FLASH_JOB_ERASE) {
+        if ((job->addr % SECTOR_SIZE) != 0u || (job->size % SECTOR_SIZE) != 0u) {
+            return HAL_ERR_INVALID_PARAM;
+        }
+    } else if (job->data == NULL) {
+        return HAL_ERR_INVALID_PARAM;
+    }
+
+    for (queued = job_head; queued != NULL; queued = queued->next) {
+        if (queued == job) {
+            return HAL_ERR_RESOURCE_BUSY;
+        }
+    }
+
+    job->done = 0u;
+    job->next = NULL;
+    job->result = HAL_ERR_RESOURCE_BUSY;
+
+    if (job_tail == NULL) {
+        job_head = job;
+    } else {
+        job_tail->next = job;
+    }
+    job_tail = job;
+
     return HAL_ERR_SUCCESS;
 }
 
+void hal_flash_main_function(void)
+{
+    hal_flash_job_t *job = job_head;
+    C40_Ip_StatusType status;
+    int32_t ret;
+    uint32_t len;
+
+    if (job == NULL) {
+        return;
+    }
+
+    /* Collect the operation in flight, if any */
+    if (engine_op == ENGINE_OP_ERASE || engine_op == ENGINE_OP_WRITE) {
+        status = (engine_op == ENGINE_OP_ERASE) ? C40_Ip_MainInterfaceSectorEraseStatus()
+                                                : C40_Ip_MainInterfaceWriteStatus();
+        if (status == C40_IP_STATUS_BUSY) {
+            return;
+        }
+        if (status != C40_IP_STATUS_SUCCESS) {
+            engine_finish(job, (engine_op == ENGINE_OP_ERASE) ? HAL_ERR_FLASH_ERASE_FAILED
+                                                              : HAL_ERR_FLASH_WRITE_FAILED);
+            return;
+        }
+        job->done += engine_op_len;
+        engine_op = ENGINE_OP_NONE;
+    }
+
+    if (job->done >= job->size) {
+        engine_finish(job, HAL_ERR_SUCCESS);
+        return;
+    }
+
+    switch (job->type) {
+    case HAL_FLASH_JOB_ERASE:
+        ret = engine_start_erase(job);
+        break;
+
+    case HAL_FLASH_JOB_PROGRAM:
+        ret = engine_start_write(job);
+        break;
+
+    case HAL_FLASH_JOB_VERIFY:
+    default:
+        len = job->size - job->done;
+        if (len > HAL_FLASH_VERIFY_CHUNK) {
+            len = HAL_FLASH_VERIFY_CHUNK;
+        }
+        if (C40_Ip_Compare(job->addr + job->done, len, job->data + job->done) != C40_IP_STATUS_SUCCESS) {
+            ret = HAL_ERR_FLASH_VERIFY_FAILED;
+            break;
+        }
+        job->done += len;
+        ret = HAL_ERR_SUCCESS;
+        if (job->done >= job->size) {
+            engine_finish(job, HAL_ERR_SUCCESS);
+        }
+        break;
+    }
+
+    if (ret != HAL_ERR_SUCCESS) {
+        engine_finish(job, ret);
+    }
+}
+
+int32_t hal_flash_job_status(const hal_flash_job_t *job)
+{
+    return (job == NULL) ? HAL_ERR_INVALID_PARAM : job->result;
+}
+
+bool hal_flash_is_idle(void)
+{
+    return job_head == NULL;
+}
+
 /**
  * @brief Reads data from the flash memory at the specified address
  *
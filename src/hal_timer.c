@@ -3,14 +3,26 @@
  ******************************************************************************/
 
 #include "Pit_Ip.h"
+#include "Clock_Ip.h"
 #include "IntCtrl_Ip.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
 #include "hal_timer.h"
+#include "osal_utils.h"
 
 #define PIT_INST 0U
 
+/* DWT cycle counter of the cortex-m7 core, counts at the core clock */
+#define HAL_TIMER_DEMCR         (*(volatile uint32_t *)0xE000EDFCu)
+#define HAL_TIMER_DEMCR_TRCENA  (1u << 24u)
+#define HAL_TIMER_DWT_CTRL      (*(volatile uint32_t *)0xE0001000u)
+#define HAL_TIMER_DWT_CYCCNTENA (1u << 0u)
+#define HAL_TIMER_DWT_CYCCNT    (*(volatile uint32_t *)0xE0001004u)
+
+/* used until the clock driver reports the core clock */
+#define HAL_TIMER_DEFAULT_CYCLES_PER_US (120u)
+
 void PIT_0_ISR(void);
 
 void lptmr_isr(uint8_t channel)
@@ -24,6 +36,27 @@ void lptmr_isr(uint8_t channel)
  ******************************************************************************/
 static uint16_t gs_1ms_cnt = 0u;
 static uint16_t gs_100ms_cnt = 0u;
+static uint32_t gs_us_cnt = 0u;         /* free-running microseconds, see hal_timer_get_us() */
+static uint32_t gs_us_last_cyccnt = 0u; /* DWT_CYCCNT gs_us_cnt was brought up to */
+static uint32_t gs_us_rem_cycles = 0u;  /* cycles since then not making a full microsecond */
+static uint32_t gs_cycles_per_us = 0u;  /* core clock in MHz, 0 until the cycle counter runs */
+
+/* start the DWT cycle counter and take the core clock from the clock driver */
+static void hal_timer_start_cyccnt(void)
+{
+    uint32_t cycles_per_us = Clock_Ip_GetFreq(CORE_CLK) / 1000000u;
+
+    if (0u == cycles_per_us) {
+        cycles_per_us = HAL_TIMER_DEFAULT_CYCLES_PER_US;
+    }
+
+    HAL_TIMER_DEMCR |= HAL_TIMER_DEMCR_TRCENA;
+    HAL_TIMER_DWT_CYCCNT = 0u;
+    HAL_TIMER_DWT_CTRL |= HAL_TIMER_DWT_CYCCNTENA;
+    gs_us_last_cyccnt = 0u;
+    gs_us_rem_cycles = 0u;
+    gs_cycles_per_us = cycles_per_us;
+}
 
 /*function**********************************************************************
  *
@@ -34,11 +67,16 @@ static uint16_t gs_100ms_cnt = 0u;
  *end**************************************************************************/
 void hal_timer_init(void)
 {
-    Pit_Ip_Init(PIT_INST, &PIT_0_InitConfig_PB);       /* initialize the PIT0 module */
+	Pit_Ip_Init(PIT_INST, &PIT_0_InitConfig_PB);       /* initialize the PIT0 module */
 	Pit_Ip_InitChannel(PIT_INST, PIT_0_CH_0);        /* initialize PIT channel 0 */
 	IntCtrl_Ip_InstallHandler(PIT0_IRQn,PIT_0_ISR,NULL_PTR);
 	Pit_Ip_EnableChannelInterrupt(PIT_INST, 0U);     /* enable the PIT channel 0 interrupt */
 	Pit_Ip_StartChannel(PIT_INST, 0U, 40000);
+
+	/* cycle counter behind hal_timer_get_us() */
+	if (0u == gs_cycles_per_us) {
+		hal_timer_start_cyccnt();
+	}
 }
 
 void hal_timer_1ms_period(void)
@@ -54,6 +92,9 @@ void hal_timer_1ms_period(void)
     if (0u != cnt_tmp) {
         gs_100ms_cnt++;
     }
+
+    /* DWT_CYCCNT wraps after 35 s at 120 MHz, keep the microseconds up to date */
+    (void)hal_timer_get_us();
 }
 
 bool hal_timer_is_1ms_tick_timeout(void)
@@ -96,6 +137,29 @@ uint32_t hal_timer_get_timer_tick_cnt(void)
     return timer_tick_cnt;
 }
 
+uint32_t hal_timer_get_us(void)
+{
+    uint32_t primask;
+    uint32_t cyccnt;
+    uint32_t cycles;
+    uint32_t us_cnt;
+
+    primask = osal_utils_irq_save();
+    /* hal_timer_init() is optional, the first call starts the cycle counter */
+    if (0u == gs_cycles_per_us) {
+        hal_timer_start_cyccnt();
+    }
+    cyccnt = HAL_TIMER_DWT_CYCCNT;
+    cycles = (cyccnt - gs_us_last_cyccnt) + gs_us_rem_cycles;
+    gs_us_last_cyccnt = cyccnt;
+    gs_us_cnt += cycles / gs_cycles_per_us;
+    gs_us_rem_cycles = cycles % gs_cycles_per_us;
+    us_cnt = gs_us_cnt;
+    osal_utils_irq_restore(primask);
+
+    return us_cnt;
+}
+
 void hal_timer_free(void)
 {
 
@@ -6,6 +6,7 @@
 #include "Lpuart_Uart_Ip.h"
 #include "Lpuart_Uart_Ip_Irq.h"
 #include "IntCtrl_Ip.h"
+#include "osal_utils.h"
 #include <string.h>
 #include <stdint.h>
 #include <stddef.h>
@@ -27,10 +28,47 @@ static size_t rx_count = 0;
 static HAL_UART *current_huart = NULL;
 
 
+/*function**********************************************************************
+ *
+ * function name : hal_uart_tx_reap
+ * description   : retires a finished interrupt/dma transmission exactly once.
+ *                 called from the irq and from hal_uart_poll_transmit(), so the
+ *                 busy flag is claimed with interrupts masked.
+ *
+ * implements : hal_uart_tx_reap_activity
+ *end**************************************************************************/
+static int32_t hal_uart_tx_reap(void)
+{
+    uint32_t bytes_remaining;
+    uint32_t primask;
+    bool done = false;
+    Lpuart_Uart_Ip_StatusType status;
+
+    status = Lpuart_Uart_Ip_GetTransmitStatus(lpuart_instance, &bytes_remaining);
+    if (status == LPUART_UART_IP_STATUS_BUSY) {
+        return HAL_ERR_RESOURCE_BUSY;
+    }
+
+    primask = osal_utils_irq_save();
+    if (tx_busy) {
+        tx_busy = false;
+        done = true;
+    }
+    osal_utils_irq_restore(primask);
+
+    if (done) {
+        hal_uart_tx_cplt_callback(current_huart);
+    }
+
+    return (status == LPUART_UART_IP_STATUS_SUCCESS) ? HAL_ERR_SUCCESS : HAL_ERR_UART_XFER_FAILED;
+}
+
 /*function**********************************************************************
  *
  * function name : lpuart6_irq_handler
  * description   : interrupt handler for lpuart6 transmission and reception.
+ *                 runs the rtd handler first so the driver moves the data,
+ *                 then reports completed transfers to the hal callbacks.
  *
  * implements : lpuart6_irq_handler_activity
  *end**************************************************************************/
@@ -39,14 +77,11 @@ void lpuart6_irq_handler(void)
     uint32_t bytes_remaining;
     Lpuart_Uart_Ip_StatusType status;
 
+    LPUART_UART_IP_6_IRQHandler();
+
     /* check transmission status */
-    status = Lpuart_Uart_Ip_GetTransmitStatus(lpuart_instance, &bytes_remaining);
-    if (status == LPUART_UART_IP_STATUS_SUCCESS && tx_busy) {
-        tx_busy = false;
-//        if (current_huart != NULL && current_huart->send_handler != NULL) {
-//            ((void (*)(HAL_UART *))current_huart->send_handler)(current_huart);
-//        }
-        hal_uart_tx_cplt_callback(current_huart);
+    if (tx_busy) {
+        (void)hal_uart_tx_reap();
     }
 
     /* check reception status */
@@ -84,14 +119,15 @@ int32_t hal_uart_init(HAL_UART *huart)
 
     /* initialize lpuart6 */
     Lpuart_Uart_Ip_Init(huart->num, &Lpuart_Uart_Ip_xHwConfigPB_6);
-    /* configure interrupts */
-//    IntCtrl_Ip_EnableIrq(huart->irq);
-//    IntCtrl_Ip_InstallHandler(huart->irq, lpuart6_irq_handler, NULL);
 
     current_huart = huart;
     tx_busy = false;
     rx_busy = false;
 
+    /* configure interrupts: the wrapper chains to the rtd handler */
+    IntCtrl_Ip_InstallHandler(huart->irq, lpuart6_irq_handler, NULL);
+    IntCtrl_Ip_EnableIrq(huart->irq);
+
     return HAL_ERR_SUCCESS;
 }
 
@@ -145,8 +181,8 @@ int32_t hal_uart_transmit(HAL_UART *huart, uint8_t *data, size_t size, size_t ti
 
     /* start asynchronous transmission */
     status = Lpuart_Uart_Ip_SyncSend(huart->num, data, size, timeout_ms);
+    tx_busy = false;
     if (status != LPUART_UART_IP_STATUS_SUCCESS) {
-        tx_busy = false;
         return HAL_ERR_UART_XFER_FAILED;
     }
 
@@ -156,46 +192,64 @@ int32_t hal_uart_transmit(HAL_UART *huart, uint8_t *data, size_t size, size_t ti
 /*function**********************************************************************
  *
  * function name : hal_uart_transmit_it
- * description   : transmits data over uart using interrupt.
+ * description   : starts an interrupt/dma transmission and returns at once.
+ *                 the buffer must stay valid until hal_uart_tx_cplt_callback().
  *
  * implements : hal_uart_transmit_it_activity
  *end**************************************************************************/
 int32_t hal_uart_transmit_it(HAL_UART *huart, uint8_t *data, size_t size)
 {
 	Lpuart_Uart_Ip_StatusType status;
+    uint32_t primask;
 
     if (huart == NULL || data == NULL || size == 0) {
         return HAL_ERR_INVALID_PARAM;
     }
 
+    primask = osal_utils_irq_save();
     if (tx_busy) {
+        osal_utils_irq_restore(primask);
         return HAL_ERR_RESOURCE_BUSY;
     }
 
-    tx_busy = true;
     current_huart = huart;
 
-    uint32_t bytes_remaining;
-    /* start asynchronous transmission */
+    /* start asynchronous transmission, completion is reported by the irq.
+     * interrupts stay masked until the driver owns the transfer: an lpuart
+     * irq before that would read the previous transfer's status and retire
+     * this one before a byte is sent. */
     status = Lpuart_Uart_Ip_AsyncSend(huart->num, data, size);
-    if (status != LPUART_UART_IP_STATUS_SUCCESS) {
-        tx_busy = false;
-        return HAL_ERR_UART_XFER_FAILED;
+    if (status == LPUART_UART_IP_STATUS_SUCCESS) {
+        tx_busy = true;
     }
+    osal_utils_irq_restore(primask);
 
-    /* poll until transmission completes or timeout */
-    do {
-    	tx_busy = false;
-    } while ((status = Lpuart_Uart_Ip_GetTransmitStatus(huart->num, &bytes_remaining)) == LPUART_UART_IP_STATUS_BUSY);
+    return (status == LPUART_UART_IP_STATUS_SUCCESS) ? HAL_ERR_SUCCESS : HAL_ERR_UART_XFER_FAILED;
+}
 
-    if (status != LPUART_UART_IP_STATUS_SUCCESS) {
-        tx_busy = false;
-        return HAL_ERR_UART_XFER_FAILED;
+/*function**********************************************************************
+ *
+ * function name : hal_uart_poll_transmit
+ * description   : polls an interrupt/dma transmission; retires it (and runs
+ *                 the completion callback) if the irq has not done so yet.
+ *
+ * implements : hal_uart_poll_transmit_activity
+ *end**************************************************************************/
+int32_t hal_uart_poll_transmit(HAL_UART *huart)
+{
+    if (huart == NULL) {
+        return HAL_ERR_INVALID_PARAM;
     }
 
-    tx_busy = false;
+    if (current_huart == NULL) {
+        return HAL_ERR_NOT_INITIALIZED;
+    }
 
-    return HAL_ERR_SUCCESS;
+    if (!tx_busy) {
+        return HAL_ERR_SUCCESS;
+    }
+
+    return hal_uart_tx_reap();
 }
 
 
@@ -308,6 +362,7 @@ int32_t hal_uart_receive_it(HAL_UART *huart, uint8_t *data, size_t size)
 __attribute__((weak)) void hal_uart_tx_cplt_callback(HAL_UART *huart)
 {
     /* weak implementation; override in application code */
+    (void)huart;
 }
 
 /*function**********************************************************************
@@ -320,6 +375,7 @@ __attribute__((weak)) void hal_uart_tx_cplt_callback(HAL_UART *huart)
 __attribute__((weak)) void hal_uart_rx_cplt_callback(HAL_UART *huart)
 {
     /* weak implementation; override in application code */
+    (void)huart;
 }
 
 #if HAL_UNIT_TEST
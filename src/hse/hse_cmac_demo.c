@@ -8,7 +8,6 @@
 
 #include <stdint.h>
 #include <stdio.h>
-#include <stdarg.h>
 #include <string.h>
 
 #include "Hse_Ip.h"
@@ -20,7 +19,6 @@
 #define HSE_MU_INSTANCE   (0U)
 #define HSE_DCACHE_LINE   (32U)
 #define HSE_SYNC_REQ_TIMEOUT (0xFFFFFFFFUL)
-#define LOG_BUF_SIZE      (192U)
 #define SECOC_CMAC_TRUNC_BYTES (3U)
 
 /* Must match s32k312_provision CMAC_SMOKE_TEST_KEY_HANDLE (NVM CUST AES-128 g0s0). */
@@ -79,15 +77,8 @@ static void hse_dcache_invalidate(const void *addr, size_t len)
     __asm volatile ("isb 0xF" ::: "memory");
 }
 
-static void log_line(const char *fmt, ...)
-{
-    char buf[LOG_BUF_SIZE];
-    va_list ap;
-    va_start(ap, fmt);
-    vsnprintf(buf, sizeof(buf), fmt, ap);
-    va_end(ap);
-    osal_log_info(buf);
-}
+#define log_line(...)     osal_log_info(__VA_ARGS__)
+#define log_error(...)    osal_log_error(__VA_ARGS__)
 
 static const char *hse_rsp_name(hseSrvResponse_t rsp)
 {
@@ -121,7 +112,7 @@ static hseSrvResponse_t hse_send_sync(const char *step, hseSrvDescriptor_t *desc
 
     uint8_t channel = Hse_Ip_GetFreeChannel(HSE_MU_INSTANCE);
     if (HSE_IP_INVALID_MU_CHANNEL_U8 == channel) {
-        log_line("[hse_cmac] %s: no free MU channel\r\n", step);
+        log_error("[hse_cmac] %s: no free MU channel\r\n", step);
         return HSE_SRV_RSP_GENERAL_ERROR;
     }
 
@@ -223,7 +214,7 @@ void hse_cmac_demo_run(void)
              (unsigned long)keyHandle);
 
     if (HSE_IP_STATUS_SUCCESS != Hse_Ip_Init(HSE_MU_INSTANCE, &s_hse_mu_state)) {
-        osal_log_info("[hse_cmac] Hse_Ip_Init failed - aborting\r\n");
+        osal_log_error("[hse_cmac] Hse_Ip_Init failed - aborting\r\n");
         return;
     }
 
@@ -234,26 +225,26 @@ void hse_cmac_demo_run(void)
              (unsigned)((0U != (status & HSE_STATUS_INSTALL_OK)) ? 1U : 0U));
 
     if (0U == (status & HSE_STATUS_INIT_OK)) {
-        osal_log_info("[hse_cmac] HSE FW not ready (INIT_OK clear) - run s32k312_provision first\r\n");
+        osal_log_error("[hse_cmac] HSE FW not ready (INIT_OK clear) - run s32k312_provision first\r\n");
         return;
     }
     if (0U == (status & HSE_STATUS_INSTALL_OK)) {
-        osal_log_info("[hse_cmac] key catalogs not formatted (INSTALL_OK clear) - run provision\r\n");
+        osal_log_error("[hse_cmac] key catalogs not formatted (INSTALL_OK clear) - run provision\r\n");
         return;
     }
 
     hseSrvResponse_t rsp = hse_get_key_info(keyHandle);
     if (HSE_SRV_RSP_OK != rsp) {
-        log_line("[hse_cmac] NVM SecOC key missing/unusable (0x%08lX %s)\r\n",
+        log_error("[hse_cmac] NVM SecOC key missing/unusable (0x%08lX %s)\r\n",
                  (unsigned long)rsp, hse_rsp_name(rsp));
-        osal_log_info("[hse_cmac] Re-flash/run s32k312_provision so it imports SecOC key to NVM g0s0\r\n");
+        osal_log_error("[hse_cmac] Re-flash/run s32k312_provision so it imports SecOC key to NVM g0s0\r\n");
         return;
     }
 
     rsp = hse_cmac_generate(keyHandle);
     log_line("[hse_cmac] CMAC generate done, tagLen=%lu\r\n", (unsigned long)s_cmac_tag_len);
     if (HSE_SRV_RSP_OK != rsp) {
-        log_line("[hse_cmac] CMAC generate FAILED (0x%08lX %s) - key may be wrong type/flags\r\n",
+        log_error("[hse_cmac] CMAC generate FAILED (0x%08lX %s) - key may be wrong type/flags\r\n",
                  (unsigned long)rsp, hse_rsp_name(rsp));
         return;
     }
@@ -266,11 +257,11 @@ void hse_cmac_demo_run(void)
              s_cmac_tag[12], s_cmac_tag[13], s_cmac_tag[14], s_cmac_tag[15]);
 
     if (0 != memcmp(s_cmac_tag, s_secoc_expected_mac_trunc, SECOC_CMAC_TRUNC_BYTES)) {
-        log_line("[hse_cmac] trunc MAC MISMATCH got %02X %02X %02X expect %02X %02X %02X\r\n",
+        log_error("[hse_cmac] trunc MAC MISMATCH got %02X %02X %02X expect %02X %02X %02X\r\n",
                  s_cmac_tag[0], s_cmac_tag[1], s_cmac_tag[2],
                  s_secoc_expected_mac_trunc[0], s_secoc_expected_mac_trunc[1],
                  s_secoc_expected_mac_trunc[2]);
-        osal_log_info("[hse_cmac] FAIL - provisioned key material does not match SecOC test vector\r\n");
+        osal_log_error("[hse_cmac] FAIL - provisioned key material does not match SecOC test vector\r\n");
         return;
     }
     osal_log_info("[hse_cmac] trunc MAC matches mbedtls/provision reference (6A 0E 6D)\r\n");
@@ -285,7 +276,7 @@ void hse_cmac_demo_run(void)
     if (HSE_SRV_RSP_OK == rsp) {
         osal_log_info("[hse_cmac] CMAC verify PASSED - NVM key provisioning confirmed\r\n");
     } else {
-        log_line("[hse_cmac] CMAC verify FAILED (0x%08lX %s)\r\n",
+        log_error("[hse_cmac] CMAC verify FAILED (0x%08lX %s)\r\n",
                  (unsigned long)rsp, hse_rsp_name(rsp));
     }
 
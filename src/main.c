@@ -46,39 +46,131 @@
 //#include "tja1153.h"
 #include "FlexCAN_Ip.h"
 #include "hal_uart.h"
+#include "hal_flash.h"
+#include "hal_crc.h"
 #include "hse_cmac_demo.h"
+#include "user_config.h"
+#ifdef EN_CAN_TP_DRIVER
+#include "TP_cfg.h"
+#include "can_tp_cfg.h"
+#endif
 
 
 
 #define CORE1_START_ADDR (0x00500000u)
 /* User includes (#include below this line is not maintained by Processor Expert) */
 #define CAN_MSG_TYPE (CAN_MSG_ID_STD)
-#define RX_MAILBOX_ID (1u)
-#define TX_MAILBOX_ID (2u)
-Flexcan_Ip_MsgBuffType g_RXCANMsg;
-#define	RX_FUN_ID (0x7FFu)   /*can tp rx function ID*/
-#define	RX_PHY_ID (0x784u)   /*can tp rx phy ID*/
-#define	TX_ID (0x7F0u)       /*can tp tx ID*/
 
-extern void CAN0_ORED_0_31_MB_IRQHandler(void);
+/*TX: CAN_TX_MB_NUM mailboxes (CANTP_TX_PIPELINE_DEPTH), loaded in ascending order. Mailboxes with the
+same ID go out lowest number first, so they are loaded again only once all are sent: frames never
+overtake each other.*/
+#define CAN_TX_MB_FIRST (2u)
+#define CAN_TX_MB_NUM (3u)
+static volatile uint8 g_CANTxMbBusy = 0u; /*bit n: mailbox CAN_TX_MB_FIRST + n not sent yet*/
+static volatile uint8 g_CANTxMbNext = 0u; /*next mailbox to load*/
+
+/*RX: the enhanced RX FIFO takes only the diagnostic IDs and the DMA moves each frame into the
+next free ring slot, so the FIFO keeps buffering back-to-back CFs while a frame is handed to the TP*/
+#define CAN_RX_RING_LEN (2u)
+static Flexcan_Ip_MsgBuffType g_aRXCANFrameRing[CAN_RX_RING_LEN];
+static uint8 g_RXCANFrameIdx = 0u;
 
-const Flexcan_Ip_DataInfoType RXCANMsgConfig =
+/*one filter element holding both IDs, see num_enhanced_std_id_filters in Easy_Boot.mex*/
+static const Flexcan_Ip_EnhancedIdTableType RXCANFilterTable[] =
 {
-    .msg_id_type = FLEXCAN_MSG_ID_STD,
-    .data_length = 8u,
-    .is_polling = FALSE,
-    .is_remote = FALSE
+    {
+        .filterType = FLEXCAN_ENHANCED_RX_FIFO_TWO_ID_FILTER,
+        .isExtendedFrame = FALSE,
+        .rtr1 = FALSE,
+        .rtr2 = FALSE,
+        .id1 = RX_PHY_ID,
+        .id2 = RX_FUN_ID
+    }
 };
 
+/*CAN TP frames: classic CAN, or CAN FD with bit rate switch (EN_TX_CAN_FD in user_config.h)*/
+#ifdef EN_TX_CAN_FD
+#define CAN_MB_DATA_LEN (64u)
+
+/*data phase 2 Mbit/s from the 24 MHz protocol engine clock: 12 tq, sample point 83%*/
+static const Flexcan_Ip_TimeSegmentType CANFDDataBitrate =
+{
+    .propSeg = 5u,
+    .phaseSeg1 = 3u,
+    .phaseSeg2 = 1u,
+    .preDivider = 0u,
+    .rJumpwidth = 1u
+};
+#define CAN_FD_TDC_OFFSET (10u)  /*transceiver delay compensation at the data phase sample point*/
+#else
+#define CAN_MB_DATA_LEN (8u)
+#endif
+
+extern void CAN0_ORED_0_31_MB_IRQHandler(void);
+
+/*data_length is set per frame: the TP pads each frame to the smallest valid CAN FD length*/
 Flexcan_Ip_DataInfoType TXCANMsgConfig =
 {
     .msg_id_type = FLEXCAN_MSG_ID_STD,
-    .data_length = 8u,
+    .data_length = CAN_MB_DATA_LEN,
+#ifdef EN_TX_CAN_FD
+    .fd_enable = TRUE,
+    .fd_padding = 0u,
+    .enable_brs = TRUE,
+#endif
     .is_polling = FALSE,
     .is_remote = FALSE
 };
 
 HAL_UART lpuart6;
+
+#ifdef EN_CAN_TP_DRIVER
+#if (CAN_TX_MB_NUM < CANTP_TX_PIPELINE_DEPTH)
+#error "CANTP_TX_PIPELINE_DEPTH frames must fit in the TX mailboxes"
+#endif
+
+void CAN_TxFromTP(void);
+
+/*load a frame in the next TX mailbox, FALSE if all are waiting to be sent*/
+static boolean CAN_TxFrame(uint32 i_id, uint8 i_len, const uint8 *i_pData)
+{
+    boolean result = FALSE;
+
+    IntCtrl_Ip_DisableIrq(FlexCAN0_1_IRQn);
+    if(g_CANTxMbNext < CAN_TX_MB_NUM)
+    {
+        TXCANMsgConfig.data_length = i_len;
+        if(FLEXCAN_STATUS_SUCCESS == FlexCAN_Ip_Send(INST_FLEXCAN_0, (uint8)(CAN_TX_MB_FIRST + g_CANTxMbNext),
+                                                     &TXCANMsgConfig, i_id, i_pData))
+        {
+            g_CANTxMbBusy |= (uint8)(1u << g_CANTxMbNext);
+            g_CANTxMbNext++;
+            result = TRUE;
+        }
+    }
+    IntCtrl_Ip_EnableIrq(FlexCAN0_1_IRQn);
+
+    return result;
+}
+
+/*give the free TX mailboxes the frames the TP has queued. The loop running TP_MainFun() calls it after
+each pass; the TX complete interrupt calls it for the frames queued meanwhile.*/
+void CAN_TxFromTP(void)
+{
+    uint8 aData[CAN_MB_DATA_LEN];
+    uint32 id = 0u;
+    uint32 len = 0u;
+
+    while(g_CANTxMbNext < CAN_TX_MB_NUM)
+    {
+        if(TRUE != TP_DriverReadDataFromTP(sizeof(aData), aData, &id, &len))
+        {
+            break;
+        }
+        (void)CAN_TxFrame(id, (uint8)len, aData);
+    }
+}
+#endif
 /**
  * @brief
  *
@@ -91,14 +183,44 @@ void CAN_ISR_Callback(uint8 instance,Flexcan_Ip_EventType eventType,
                       uint32 buffIdx,const Flexcan_Ip_StateType * flexcanState)
 {
 
-    if(FLEXCAN_EVENT_RX_COMPLETE == eventType)
+    if((FLEXCAN_EVENT_DMA_COMPLETE == eventType) || (FLEXCAN_EVENT_ENHANCED_RXFIFO_COMPLETE == eventType))
+    {
+        const Flexcan_Ip_MsgBuffType *pstRxFrame = &g_aRXCANFrameRing[g_RXCANFrameIdx];
+
+        /*re-arm into the next slot first, the FIFO keeps buffering while the TP takes the frame*/
+        g_RXCANFrameIdx = (uint8)((g_RXCANFrameIdx + 1u) % CAN_RX_RING_LEN);
+        FlexCAN_Ip_RxFifo(INST_FLEXCAN_0, &g_aRXCANFrameRing[g_RXCANFrameIdx]);
+#ifdef EN_CAN_TP_DRIVER
+        /*a frame the TP has no room for is counted in its RX statistics*/
+        (void)TP_DriverWriteDataInTP(pstRxFrame->msgId, pstRxFrame->dataLen, pstRxFrame->data);
+#else
+        (void)pstRxFrame;
+#endif
+    }
+    else if(FLEXCAN_EVENT_ENHANCED_RXFIFO_OVERFLOW == eventType)
+    {
+#ifdef EN_CAN_TP_DRIVER
+        TP_DriverRxOverrun();
+#endif
+    }
+    else if(FLEXCAN_EVENT_DMA_ERROR == eventType)
     {
-        //TP_DriverWriteDataInTP(g_RXCANMsg.msgId, g_RXCANMsg.dataLen, g_RXCANMsg.data);
-        FlexCAN_Ip_Receive(INST_FLEXCAN_0, RX_MAILBOX_ID, &g_RXCANMsg, FALSE);
+        /*the transfer into the current slot is lost, start it again*/
+        FlexCAN_Ip_RxFifo(INST_FLEXCAN_0, &g_aRXCANFrameRing[g_RXCANFrameIdx]);
     }
     else if(FLEXCAN_EVENT_TX_COMPLETE == eventType)
     {
-        //TP_DoTxMsgSuccesfulCallback();
+        /*mailboxes finish in the order they were loaded*/
+        g_CANTxMbBusy &= (uint8)~(1u << (buffIdx - CAN_TX_MB_FIRST));
+        if(0u == g_CANTxMbBusy)
+        {
+            g_CANTxMbNext = 0u;
+        }
+#ifdef EN_CAN_TP_DRIVER
+        /*one confirmation per frame, in the order the TP handed them out*/
+        TP_DoTxMsgSuccesfulCallback();
+        CAN_TxFromTP();
+#endif
     }
     else
     {}
@@ -127,10 +249,21 @@ void board_level_init(void)
     lpuart6.irq = LPUART6_IRQn;
     hal_uart_init(&lpuart6);
 
+    // 5. Initialize flash and CRC (boot-control record lives in dflash)
+    hal_flash_init();
+    hal_crc_init();
+
+    /*after hal_crc_init(): Dma_Ip_Init() also sets up the FlexCAN0 RX FIFO channel*/
     FlexCAN_Ip_Init(INST_FLEXCAN_0, &FlexCAN_State0, &FlexCAN_Config0);
+    /*filters can only be written in freeze mode*/
+    FlexCAN_Ip_ConfigEnhancedRxFifo(INST_FLEXCAN_0, RXCANFilterTable);
+#ifdef EN_TX_CAN_FD
+    /*still in freeze mode after init: data phase bit rate for BRS frames*/
+    FlexCAN_Ip_SetBitrateCbt(INST_FLEXCAN_0, &CANFDDataBitrate, TRUE);
+    FlexCAN_Ip_SetTDCOffset(INST_FLEXCAN_0, TRUE, CAN_FD_TDC_OFFSET);
+#endif
     FlexCAN_Ip_SetStartMode(INST_FLEXCAN_0);
-    FlexCAN_Ip_ConfigRxMb(INST_FLEXCAN_0, RX_MAILBOX_ID, &RXCANMsgConfig, RX_PHY_ID);
-    FlexCAN_Ip_Receive(INST_FLEXCAN_0, RX_MAILBOX_ID, &g_RXCANMsg, FALSE);
+    FlexCAN_Ip_RxFifo(INST_FLEXCAN_0, &g_aRXCANFrameRing[g_RXCANFrameIdx]);
 
     // Tja1153_Init(0);
 }
@@ -1,12 +1,188 @@
 #include "osal_log.h"
+#include "osal_utils.h"
 #include "hal_uart.h"
+#include "hal_error.h"
+#include <stdarg.h>
+#include <stdio.h>
 #include <string.h>
 
+#if (LOG_RING_SIZE & (LOG_RING_SIZE - 1U)) != 0U
+#error "LOG_RING_SIZE must be a power of two"
+#endif
+
+#define LOG_RING_MASK (LOG_RING_SIZE - 1U)
+#define LOG_TX_CLAIMED (0xFFFFFFFFU)     /* log_tx_len while a kick inspects the ring */
+
+/*
+ * Single-producer/single-consumer ring. head is only written by the producer
+ * side (osal_log_info), tail only by the consumer side (transmit completion),
+ * both are free running and wrap through LOG_RING_MASK. Producers in thread
+ * and interrupt context are serialised by masking interrupts for the copy,
+ * which is bounded by the message length. The consumer takes no lock: whoever
+ * wins the compare-and-swap on log_tx_len (0 -> claimed) starts the next UART
+ * transfer, the transmit-complete callback advances tail and releases it.
+ */
+static uint8_t log_ring[LOG_RING_SIZE];
+static volatile uint32_t log_head;
+static volatile uint32_t log_tail;
+static volatile uint32_t log_tx_len;        /* Bytes in flight, 0 when idle */
+static volatile uint32_t log_dropped;
+
+volatile uint8_t osal_log_runtime_level = (uint8_t)OSAL_LOG_LEVEL;
+
 extern HAL_UART lpuart6;
-void osal_log_info(const char *msg)
+
+/* Hand the next contiguous span of the ring to the UART if it is idle */
+static void osal_log_kick(void)
 {
+	uint32_t idle;
+	uint32_t tail;
+	uint32_t offset;
+	uint32_t span;
+
+	do {
+		/* Claim the consumer side before looking at tail */
+		idle = 0U;
+		if (!__atomic_compare_exchange_n(&log_tx_len, &idle, LOG_TX_CLAIMED, false,
+		                                 __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+			return;
+		}
+
+		tail = log_tail;
+		offset = tail & LOG_RING_MASK;
+		span = __atomic_load_n(&log_head, __ATOMIC_ACQUIRE) - tail;
+		if (span != 0U) {
+			if (span > LOG_RING_SIZE - offset) {
+				span = LOG_RING_SIZE - offset;
+			}
+			__atomic_store_n(&log_tx_len, span, __ATOMIC_RELEASE);
+			if (hal_uart_transmit_it(&lpuart6, &log_ring[offset], span) != HAL_ERR_SUCCESS) {
+				/* UART not ready: keep the data, the next kick retries */
+				__atomic_store_n(&log_tx_len, 0U, __ATOMIC_RELEASE);
+			}
+			return;
+		}
+
+		__atomic_store_n(&log_tx_len, 0U, __ATOMIC_RELEASE);
+		/* A producer may have failed to claim while we held it empty */
+	} while (__atomic_load_n(&log_head, __ATOMIC_ACQUIRE) != log_tail);
+}
+
+/* Transmit-complete hook from hal_uart (interrupt or poll context) */
+void hal_uart_tx_cplt_callback(HAL_UART *huart)
+{
+	uint32_t sent;
+
+	if (huart != &lpuart6) {
+		return;
+	}
+
+	sent = __atomic_load_n(&log_tx_len, __ATOMIC_ACQUIRE);
+	if (sent == 0U || sent == LOG_TX_CLAIMED) {
+		/* Completion of a transfer that did not come from the ring */
+		return;
+	}
+	__atomic_store_n(&log_tail, log_tail + sent, __ATOMIC_RELEASE);
+	__atomic_store_n(&log_tx_len, 0U, __ATOMIC_RELEASE);
+	osal_log_kick();
+}
+
+void osal_log_puts(const char *msg)
+{
+	uint32_t primask;
+	uint32_t len;
+	uint32_t head;
+	uint32_t offset;
+	uint32_t first;
+
 	if (NULL == msg || msg[0] == '\0') {
 		return;
 	}
-	hal_uart_transmit_it(&lpuart6, msg, strlen(msg));
+
+	len = (uint32_t)strlen(msg);
+
+	primask = osal_utils_irq_save();
+	head = log_head;
+	if (len > LOG_RING_SIZE - (head - __atomic_load_n(&log_tail, __ATOMIC_ACQUIRE))) {
+		log_dropped++;
+		osal_utils_irq_restore(primask);
+		return;
+	}
+
+	offset = head & LOG_RING_MASK;
+	first = LOG_RING_SIZE - offset;
+	if (first > len) {
+		first = len;
+	}
+	memcpy(&log_ring[offset], msg, first);
+	memcpy(&log_ring[0], msg + first, len - first);
+	__atomic_store_n(&log_head, head + len, __ATOMIC_RELEASE);
+	osal_utils_irq_restore(primask);
+
+	osal_log_kick();
+}
+
+void osal_log_write(uint32_t level, const char *fmt, ...)
+{
+	char buf[LOG_BUFFER_SIZE];
+	va_list ap;
+
+	if (level > osal_log_runtime_level || NULL == fmt) {
+		return;
+	}
+
+	va_start(ap, fmt);
+	(void)vsnprintf(buf, sizeof(buf), fmt, ap);
+	va_end(ap);
+
+	osal_log_puts(buf);
+}
+
+void osal_log_set_level(uint32_t level)
+{
+	if (level > OSAL_LOG_LEVEL) {
+		level = OSAL_LOG_LEVEL;
+	}
+	osal_log_runtime_level = (uint8_t)level;
+}
+
+uint32_t osal_log_get_level(void)
+{
+	return osal_log_runtime_level;
+}
+
+void osal_log_process(void)
+{
+	(void)hal_uart_poll_transmit(&lpuart6);
+	osal_log_kick();
+}
+
+int32_t osal_log_flush(uint32_t timeout_ms)
+{
+	uint32_t waited_us = 0U;
+
+	while (log_head != log_tail) {
+		osal_log_process();
+		if (waited_us >= timeout_ms * 1000U) {
+			return -1;
+		}
+		osal_utils_delay_us(10U);
+		waited_us += 10U;
+	}
+
+	/* Last span handed back, wait for the shifter to finish as well */
+	while (hal_uart_poll_transmit(&lpuart6) == HAL_ERR_RESOURCE_BUSY) {
+		if (waited_us >= timeout_ms * 1000U) {
+			return -1;
+		}
+		osal_utils_delay_us(10U);
+		waited_us += 10U;
+	}
+
+	return 0;
+}
+
+uint32_t osal_log_get_dropped(void)
+{
+	return log_dropped;
 }
@@ -2,8 +2,8 @@
  * @file test_flash.c
  * @brief Test program for the HAL flash memory interface
  *
- * @version 1.0.1
- * @date 2025-06-21
+ * @version 1.0.2
+ * @date 2026-10-17
  *
  * @details
  * This test program verifies the functionality of the flash HAL interface defined
@@ -15,6 +15,7 @@
  * @history
  *  - v1.0.0, 2025-06-21, Initial test implementation
  *  - v1.0.1, 2025-06-21, Added osal_log_info for test status output
+ *  - v1.0.2, 2026-10-17, Added program-without-erase and blank check cases
  */
 
 #include "hal_flash.h"
@@ -22,7 +23,6 @@
 #include "hal_error.h"
 #include "osal_log.h"
 #include <string.h>
-#include <stdio.h>
 
 /*******************************************************************************
  * Definitions
@@ -40,7 +40,6 @@
 
 static uint8_t tx_buffer[TEST_BUFFER_SIZE]; /* Transmit buffer for write */
 static uint8_t rx_buffer[TEST_BUFFER_SIZE]; /* Receive buffer for read */
-static char log_buffer[LOG_BUFFER_SIZE];    /* Buffer for log messages */
 
 /*******************************************************************************
  * Local Functions
@@ -64,6 +63,7 @@ static const char* test_error_to_string(hal_err_t error_code)
         case HAL_ERR_FLASH_ERASE_FAILED: return "HAL_ERR_FLASH_ERASE_FAILED";
         case HAL_ERR_FLASH_INVALID_ADDR: return "HAL_ERR_FLASH_INVALID_ADDR";
         case HAL_ERR_FLASH_SECTOR_PROTECTED: return "HAL_ERR_FLASH_SECTOR_PROTECTED";
+        case HAL_ERR_FLASH_VERIFY_FAILED: return "HAL_ERR_FLASH_VERIFY_FAILED";
         default: return "UNKNOWN_ERROR";
     }
 }
@@ -107,9 +107,8 @@ static boolean test_verify_buffers(void)
 static void test_assert(boolean condition, hal_err_t error_code)
 {
     if (!condition) {
-        snprintf(log_buffer, LOG_BUFFER_SIZE, "Test failed with error: %s (0x%X)\r\n",
-                 test_error_to_string(error_code), error_code);
-        osal_log_info(log_buffer);
+        osal_log_error("Test failed with error: %s (0x%X)\r\n",
+                       test_error_to_string(error_code), error_code);
         while (TRUE) {
             /* Halt on failure */
         }
@@ -124,8 +123,7 @@ static void test_assert(boolean condition, hal_err_t error_code)
  */
 static void test_log_start(uint32_t test_number, const char *description)
 {
-    snprintf(log_buffer, LOG_BUFFER_SIZE, "Starting Test %lu: %s\r\n", test_number, description);
-    osal_log_info(log_buffer);
+    osal_log_info("Starting Test %lu: %s\r\n", test_number, description);
 }
 
 /**
@@ -135,8 +133,7 @@ static void test_log_start(uint32_t test_number, const char *description)
  */
 static void test_log_pass(uint32_t test_number)
 {
-    snprintf(log_buffer, LOG_BUFFER_SIZE, "Test %lu passed\r\n", test_number);
-    osal_log_info(log_buffer);
+    osal_log_info("Test %lu passed\r\n", test_number);
 }
 
 /*******************************************************************************
@@ -211,11 +208,27 @@ int test_flash(void)
     test_assert(status == HAL_ERR_SUCCESS, HAL_ERR_FLASH_INIT_FAILED);
     test_log_pass(10);
 
-    /* Test 11: Free resources */
-    test_log_start(11, "Free resources\r\n");
-    hal_flash_free();
+    /* Test 11: Program a second chunk into the same sector without erasing */
+    test_log_start(11, "Program second chunk without erase\r\n");
+    status = hal_flash_blank_check(FLASH_START_ADDR + TEST_BUFFER_SIZE, TEST_BUFFER_SIZE);
+    test_assert(status == HAL_ERR_SUCCESS, status);
+    status = hal_flash_program(FLASH_START_ADDR + TEST_BUFFER_SIZE, tx_buffer, TEST_BUFFER_SIZE);
+    test_assert(status == HAL_ERR_SUCCESS, HAL_ERR_FLASH_WRITE_FAILED);
+    status = hal_flash_read(FLASH_START_ADDR, rx_buffer, TEST_BUFFER_SIZE);
+    test_assert(status == HAL_ERR_SUCCESS && test_verify_buffers() == TRUE, HAL_ERR_FLASH_READ_FAILED);
     test_log_pass(11);
 
+    /* Test 12: Blank check reports programmed data */
+    test_log_start(12, "Blank check on programmed range\r\n");
+    status = hal_flash_blank_check(FLASH_START_ADDR, TEST_BUFFER_SIZE);
+    test_assert(status == HAL_ERR_FLASH_VERIFY_FAILED, status);
+    test_log_pass(12);
+
+    /* Test 13: Free resources */
+    test_log_start(13, "Free resources\r\n");
+    hal_flash_free();
+    test_log_pass(13);
+
     /* All tests passed */
     osal_log_info("All tests passed\r\n");
     return 0;
@@ -0,0 +1,88 @@
+/**
+ * @file C40_Ip.h
+ * @brief Host stand-in for the NXP RTD C40_Ip flash driver
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * Declares the subset of the C40_Ip API used by src/hal_flash.c so the flash
+ * HAL can be built and tested on the host. The implementation in c40_sim.c
+ * keeps the flash contents in RAM and models erase/program latency; see
+ * c40_sim.h for the simulator controls. Put this directory first on the
+ * include path; never build it into the target image.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial simulated backend
+ */
+
+#ifndef C40_IP_H
+#define C40_IP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint8_t boolean;
+#ifndef TRUE
+#define TRUE  ((boolean)1)
+#endif
+#ifndef FALSE
+#define FALSE ((boolean)0)
+#endif
+
+/* S32K312 flash map */
+#define C40_IP_CODE_BLOCK_0_BASE_ADDR   (0x00400000UL)
+#define C40_IP_CODE_BLOCK_0_END_ADDR    (0x004FFFFFUL)
+#define C40_IP_CODE_BLOCK_1_BASE_ADDR   (0x00500000UL)
+#define C40_IP_CODE_BLOCK_1_END_ADDR    (0x005FFFFFUL)
+#define C40_IP_DATA_BLOCK_BASE_ADDR     (0x10000000UL)
+#define C40_IP_DATA_BLOCK_END_ADDR      (0x1001FFFFUL)
+
+#define C40_DATA_ARRAY_0_BLOCK_2_S000   (256U)   /* First data flash virtual sector */
+
+typedef enum
+{
+    C40_IP_STATUS_SUCCESS = 0,
+    C40_IP_STATUS_ERROR,
+    C40_IP_STATUS_BUSY,
+    C40_IP_STATUS_ERROR_TIMEOUT,
+    C40_IP_STATUS_ERROR_INPUT_PARAM,
+    C40_IP_STATUS_ERROR_PROGRAM_VERIFY,
+    C40_IP_STATUS_SECTOR_PROTECTED,
+    C40_IP_STATUS_SECTOR_UNPROTECTED,
+} C40_Ip_StatusType;
+
+typedef uint32_t C40_Ip_VirtualSectorsType;
+
+typedef struct
+{
+    uint32_t dummy;
+} C40_Ip_ConfigType;
+
+extern const C40_Ip_ConfigType C40_Ip_InitCfg;
+
+C40_Ip_StatusType C40_Ip_Init(const C40_Ip_ConfigType *InitConfig);
+C40_Ip_VirtualSectorsType C40_Ip_GetSectorNumberFromAddress(uint32_t Address);
+C40_Ip_StatusType C40_Ip_GetLock(C40_Ip_VirtualSectorsType VirtualSector);
+C40_Ip_StatusType C40_Ip_ClearLock(C40_Ip_VirtualSectorsType VirtualSector, uint8_t DomainIdValue);
+C40_Ip_StatusType C40_Ip_MainInterfaceSectorErase(C40_Ip_VirtualSectorsType VirtualSector, uint8_t DomainIdValue);
+C40_Ip_StatusType C40_Ip_MainInterfaceSectorEraseStatus(void);
+C40_Ip_StatusType C40_Ip_MainInterfaceWrite(uint32_t LogicalAddress, uint32_t Length,
+                                            const uint8_t *SourceAddressPtr, uint8_t DomainIdValue);
+C40_Ip_StatusType C40_Ip_MainInterfaceWriteStatus(void);
+C40_Ip_StatusType C40_Ip_Read(uint32_t LogicalAddress, uint32_t Length, uint8_t *DestAddressPtr);
+C40_Ip_StatusType C40_Ip_Compare(uint32_t LogicalAddress, uint32_t Length, const uint8_t *SourceAddressPtr);
+
+/* Flash is not memory-mapped on the host: route hal_flash's direct reads into the simulated array */
+uint8_t *c40_sim_ptr(uint32_t addr);
+#define HAL_FLASH_PTR(addr) ((const uint8_t *)c40_sim_ptr(addr))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* C40_IP_H */
@@ -0,0 +1,303 @@
+/**
+ * @file c40_sim.c
+ * @brief Host-side simulated C40 flash backend
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * Flash contents live in RAM, erased to 0xFF. Erase and write complete only
+ * after the configured latency has elapsed and the matching status function
+ * has been polled, which is when the change becomes visible. Programming a
+ * byte that is not erased fails, as the ECC-protected C40 array would.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial simulated backend
+ */
+
+#include <string.h>
+#include <time.h>
+#include "C40_Ip.h"
+#include "c40_sim.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#define SIM_SECTOR_SIZE     (8192U)
+#define SIM_CODE_SIZE       (C40_IP_CODE_BLOCK_1_END_ADDR - C40_IP_CODE_BLOCK_0_BASE_ADDR + 1U)
+#define SIM_DATA_SIZE       (C40_IP_DATA_BLOCK_END_ADDR - C40_IP_DATA_BLOCK_BASE_ADDR + 1U)
+#define SIM_CODE_SECTORS    (SIM_CODE_SIZE / SIM_SECTOR_SIZE)
+#define SIM_DATA_SECTORS    (SIM_DATA_SIZE / SIM_SECTOR_SIZE)
+#define SIM_SECTORS         (SIM_CODE_SECTORS + SIM_DATA_SECTORS)
+#define SIM_WRITE_MAX       (128U)
+
+typedef enum
+{
+    SIM_OP_NONE = 0,
+    SIM_OP_ERASE,
+    SIM_OP_WRITE,
+} sim_op_t;
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+
+const C40_Ip_ConfigType C40_Ip_InitCfg = {0U};
+
+static uint8_t sim_code[SIM_CODE_SIZE];
+static uint8_t sim_data[SIM_DATA_SIZE];
+static bool sim_locked[SIM_SECTORS];
+static bool sim_powered = false;
+
+static uint32_t sim_erase_us = 0U;
+static uint32_t sim_write_us = 0U;
+
+static sim_op_t sim_op = SIM_OP_NONE;
+static uint64_t sim_op_done_at = 0U;
+static uint32_t sim_op_addr = 0U;
+static uint32_t sim_op_len = 0U;
+static uint8_t sim_op_buf[SIM_WRITE_MAX];
+static C40_Ip_StatusType sim_op_result = C40_IP_STATUS_SUCCESS;
+
+static uint32_t sim_erases = 0U;
+static uint32_t sim_writes = 0U;
+static uint32_t sim_polls = 0U;
+
+/*******************************************************************************
+ * Local Functions
+ ******************************************************************************/
+
+static uint64_t sim_now_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000U + (uint64_t)ts.tv_nsec / 1000U;
+}
+
+static uint8_t *sim_range(uint32_t addr, uint32_t len)
+{
+    if (len == 0U) {
+        return NULL;
+    }
+    if (addr >= C40_IP_CODE_BLOCK_0_BASE_ADDR && addr + len - 1U <= C40_IP_CODE_BLOCK_1_END_ADDR) {
+        return &sim_code[addr - C40_IP_CODE_BLOCK_0_BASE_ADDR];
+    }
+    if (addr >= C40_IP_DATA_BLOCK_BASE_ADDR && addr + len - 1U <= C40_IP_DATA_BLOCK_END_ADDR) {
+        return &sim_data[addr - C40_IP_DATA_BLOCK_BASE_ADDR];
+    }
+    return NULL;
+}
+
+static uint32_t sim_sector_addr(C40_Ip_VirtualSectorsType sector)
+{
+    if (sector < SIM_CODE_SECTORS) {
+        return C40_IP_CODE_BLOCK_0_BASE_ADDR + sector * SIM_SECTOR_SIZE;
+    }
+    return C40_IP_DATA_BLOCK_BASE_ADDR + (sector - C40_DATA_ARRAY_0_BLOCK_2_S000) * SIM_SECTOR_SIZE;
+}
+
+static bool sim_sector_valid(C40_Ip_VirtualSectorsType sector)
+{
+    return sector < SIM_CODE_SECTORS ||
+           (sector >= C40_DATA_ARRAY_0_BLOCK_2_S000 && sector < C40_DATA_ARRAY_0_BLOCK_2_S000 + SIM_DATA_SECTORS);
+}
+
+static uint32_t sim_lock_index(C40_Ip_VirtualSectorsType sector)
+{
+    return (sector < SIM_CODE_SECTORS) ? sector : SIM_CODE_SECTORS + (sector - C40_DATA_ARRAY_0_BLOCK_2_S000);
+}
+
+static C40_Ip_StatusType sim_status(sim_op_t op)
+{
+    uint8_t *dst;
+    uint32_t i;
+
+    if (sim_op != op) {
+        return sim_op_result;
+    }
+
+    if (sim_now_us() < sim_op_done_at) {
+        sim_polls++;
+        return C40_IP_STATUS_BUSY;
+    }
+
+    dst = sim_range(sim_op_addr, sim_op_len);
+    if (op == SIM_OP_ERASE) {
+        memset(dst, 0xFF, sim_op_len);
+        sim_op_result = C40_IP_STATUS_SUCCESS;
+    } else {
+        sim_op_result = C40_IP_STATUS_SUCCESS;
+        for (i = 0U; i < sim_op_len; i++) {
+            if (dst[i] != 0xFFU) {
+                sim_op_result = C40_IP_STATUS_ERROR_PROGRAM_VERIFY;
+            }
+            dst[i] &= sim_op_buf[i];
+        }
+    }
+
+    sim_op = SIM_OP_NONE;
+    return sim_op_result;
+}
+
+/*******************************************************************************
+ * Public Functions
+ ******************************************************************************/
+
+C40_Ip_StatusType C40_Ip_Init(const C40_Ip_ConfigType *InitConfig)
+{
+    uint32_t i;
+
+    (void)InitConfig;
+    if (!sim_powered) {
+        /* Factory state: everything erased */
+        memset(sim_code, 0xFF, sizeof(sim_code));
+        memset(sim_data, 0xFF, sizeof(sim_data));
+        sim_powered = true;
+    }
+    for (i = 0U; i < SIM_SECTORS; i++) {
+        sim_locked[i] = true;
+    }
+    sim_op = SIM_OP_NONE;
+    sim_op_result = C40_IP_STATUS_SUCCESS;
+    sim_erases = 0U;
+    sim_writes = 0U;
+    sim_polls = 0U;
+
+    return C40_IP_STATUS_SUCCESS;
+}
+
+C40_Ip_VirtualSectorsType C40_Ip_GetSectorNumberFromAddress(uint32_t Address)
+{
+    if (Address >= C40_IP_DATA_BLOCK_BASE_ADDR) {
+        return C40_DATA_ARRAY_0_BLOCK_2_S000 + (Address - C40_IP_DATA_BLOCK_BASE_ADDR) / SIM_SECTOR_SIZE;
+    }
+    return (Address - C40_IP_CODE_BLOCK_0_BASE_ADDR) / SIM_SECTOR_SIZE;
+}
+
+C40_Ip_StatusType C40_Ip_GetLock(C40_Ip_VirtualSectorsType VirtualSector)
+{
+    if (!sim_sector_valid(VirtualSector)) {
+        return C40_IP_STATUS_ERROR_INPUT_PARAM;
+    }
+    return sim_locked[sim_lock_index(VirtualSector)] ? C40_IP_STATUS_SECTOR_PROTECTED
+                                                     : C40_IP_STATUS_SECTOR_UNPROTECTED;
+}
+
+C40_Ip_StatusType C40_Ip_ClearLock(C40_Ip_VirtualSectorsType VirtualSector, uint8_t DomainIdValue)
+{
+    (void)DomainIdValue;
+    if (!sim_sector_valid(VirtualSector)) {
+        return C40_IP_STATUS_ERROR_INPUT_PARAM;
+    }
+    sim_locked[sim_lock_index(VirtualSector)] = false;
+    return C40_IP_STATUS_SUCCESS;
+}
+
+C40_Ip_StatusType C40_Ip_MainInterfaceSectorErase(C40_Ip_VirtualSectorsType VirtualSector, uint8_t DomainIdValue)
+{
+    (void)DomainIdValue;
+    if (sim_op != SIM_OP_NONE) {
+        return C40_IP_STATUS_BUSY;
+    }
+    if (!sim_sector_valid(VirtualSector)) {
+        return C40_IP_STATUS_ERROR_INPUT_PARAM;
+    }
+    if (sim_locked[sim_lock_index(VirtualSector)]) {
+        return C40_IP_STATUS_SECTOR_PROTECTED;
+    }
+
+    sim_op = SIM_OP_ERASE;
+    sim_op_addr = sim_sector_addr(VirtualSector);
+    sim_op_len = SIM_SECTOR_SIZE;
+    sim_op_done_at = sim_now_us() + sim_erase_us;
+    sim_erases++;
+
+    return C40_IP_STATUS_SUCCESS;
+}
+
+C40_Ip_StatusType C40_Ip_MainInterfaceSectorEraseStatus(void)
+{
+    return sim_status(SIM_OP_ERASE);
+}
+
+C40_Ip_StatusType C40_Ip_MainInterfaceWrite(uint32_t LogicalAddress, uint32_t Length,
+                                            const uint8_t *SourceAddressPtr, uint8_t DomainIdValue)
+{
+    (void)DomainIdValue;
+    if (sim_op != SIM_OP_NONE) {
+        return C40_IP_STATUS_BUSY;
+    }
+    /* One call programs at most one quad-page and must not cross it */
+    if (SourceAddressPtr == NULL || Length == 0U || Length > SIM_WRITE_MAX ||
+        (LogicalAddress % SIM_WRITE_MAX) + Length > SIM_WRITE_MAX ||
+        sim_range(LogicalAddress, Length) == NULL) {
+        return C40_IP_STATUS_ERROR_INPUT_PARAM;
+    }
+    if (sim_locked[sim_lock_index(C40_Ip_GetSectorNumberFromAddress(LogicalAddress))]) {
+        return C40_IP_STATUS_SECTOR_PROTECTED;
+    }
+
+    memcpy(sim_op_buf, SourceAddressPtr, Length);
+    sim_op = SIM_OP_WRITE;
+    sim_op_addr = LogicalAddress;
+    sim_op_len = Length;
+    sim_op_done_at = sim_now_us() + sim_write_us;
+    sim_writes++;
+
+    return C40_IP_STATUS_SUCCESS;
+}
+
+C40_Ip_StatusType C40_Ip_MainInterfaceWriteStatus(void)
+{
+    return sim_status(SIM_OP_WRITE);
+}
+
+C40_Ip_StatusType C40_Ip_Read(uint32_t LogicalAddress, uint32_t Length, uint8_t *DestAddressPtr)
+{
+    const uint8_t *src = sim_range(LogicalAddress, Length);
+
+    if (src == NULL || DestAddressPtr == NULL) {
+        return C40_IP_STATUS_ERROR_INPUT_PARAM;
+    }
+    memcpy(DestAddressPtr, src, Length);
+    return C40_IP_STATUS_SUCCESS;
+}
+
+C40_Ip_StatusType C40_Ip_Compare(uint32_t LogicalAddress, uint32_t Length, const uint8_t *SourceAddressPtr)
+{
+    const uint8_t *src = sim_range(LogicalAddress, Length);
+
+    if (src == NULL || SourceAddressPtr == NULL) {
+        return C40_IP_STATUS_ERROR_INPUT_PARAM;
+    }
+    return (memcmp(src, SourceAddressPtr, Length) == 0) ? C40_IP_STATUS_SUCCESS
+                                                        : C40_IP_STATUS_ERROR_PROGRAM_VERIFY;
+}
+
+void c40_sim_set_latency(uint32_t erase_us, uint32_t write_us)
+{
+    sim_erase_us = erase_us;
+    sim_write_us = write_us;
+}
+
+uint8_t *c40_sim_ptr(uint32_t addr)
+{
+    return sim_range(addr, 1U);
+}
+
+uint32_t c40_sim_erase_count(void)
+{
+    return sim_erases;
+}
+
+uint32_t c40_sim_write_count(void)
+{
+    return sim_writes;
+}
+
+uint32_t c40_sim_busy_polls(void)
+{
+    return sim_polls;
+}
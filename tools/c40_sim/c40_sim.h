@@ -0,0 +1,49 @@
+/**
+ * @file c40_sim.h
+ * @brief Controls for the host-side simulated C40 flash backend
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#ifndef C40_SIM_H
+#define C40_SIM_H
+
+#include <stdint.h>
+#include "C40_Ip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Set the simulated operation latencies
+ *
+ * @param erase_us Time one sector erase stays busy
+ * @param write_us Time one MainInterfaceWrite stays busy
+ */
+void c40_sim_set_latency(uint32_t erase_us, uint32_t write_us);
+
+/**
+ * @brief Direct pointer into the simulated array, for checks and fault injection
+ *
+ * @return Pointer to the byte at addr, NULL outside the flash map
+ */
+uint8_t *c40_sim_ptr(uint32_t addr);
+
+/**
+ * @brief Operation counters since C40_Ip_Init
+ */
+uint32_t c40_sim_erase_count(void);
+uint32_t c40_sim_write_count(void);
+
+/**
+ * @brief Number of times the engine polled a busy operation
+ */
+uint32_t c40_sim_busy_polls(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* C40_SIM_H */
@@ -0,0 +1,20 @@
+/* Host build stand-in for the RTD IntCtrl_Ip.h: the IRQs CAN TP masks around shared state, see can_tp_test.c */
+#ifndef CAN_TP_SIM_INTCTRL_IP_H
+#define CAN_TP_SIM_INTCTRL_IP_H
+
+typedef enum
+{
+    FlexCAN0_0_IRQn,
+    FlexCAN0_1_IRQn,
+    FlexCAN0_2_IRQn,
+    FlexCAN0_3_IRQn,
+    PIT0_IRQn,
+    SWT0_IRQn,
+    LPUART0_IRQn
+} IRQn_Type;
+
+/* The test runs bus and main loop in one thread */
+#define IntCtrl_Ip_DisableIrq(irq)  ((void)(irq))
+#define IntCtrl_Ip_EnableIrq(irq)   ((void)(irq))
+
+#endif
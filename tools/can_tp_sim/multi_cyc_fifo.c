@@ -0,0 +1,151 @@
+/**
+ * @file multi_cyc_fifo.c
+ * @brief Host build of the TP byte FIFOs, see multi_cyc_fifo.h
+ */
+
+#include <stddef.h>
+#include <string.h>
+#include "multi_cyc_fifo.h"
+
+#define SIM_FIFO_NUM        (4u)
+#define SIM_FIFO_MAX_LEN    (1024u)
+
+typedef struct
+{
+    uint8 id;
+    uint8 used;
+    tLen size;
+    tLen head;
+    tLen count;
+    uint8 buf[SIM_FIFO_MAX_LEN];
+} sim_fifo_t;
+
+static sim_fifo_t sim_fifo[SIM_FIFO_NUM];
+
+static sim_fifo_t *find_fifo(uint8 id)
+{
+    uint32 i;
+
+    for (i = 0U; i < SIM_FIFO_NUM; i++) {
+        if (sim_fifo[i].used != 0U && sim_fifo[i].id == id) {
+            return &sim_fifo[i];
+        }
+    }
+    return NULL;
+}
+
+void ApplyFifo(tLen i_xApplyFifoLen, uint8 i_xFifoId, tErroCode *o_peApplyStatus)
+{
+    sim_fifo_t *f = find_fifo(i_xFifoId);
+    uint32 i;
+
+    if (i_xApplyFifoLen == 0U || i_xApplyFifoLen > SIM_FIFO_MAX_LEN) {
+        *o_peApplyStatus = ERRO_OVER_MAX;
+        return;
+    }
+    for (i = 0U; f == NULL && i < SIM_FIFO_NUM; i++) {
+        if (sim_fifo[i].used == 0U) {
+            f = &sim_fifo[i];
+        }
+    }
+    if (f == NULL) {
+        *o_peApplyStatus = ERRO_REGISTERED_SECOND;
+        return;
+    }
+
+    f->id = i_xFifoId;
+    f->used = 1U;
+    f->size = i_xApplyFifoLen;
+    f->head = 0U;
+    f->count = 0U;
+    *o_peApplyStatus = ERRO_NONE;
+}
+
+void GetCanWriteLen(uint8 i_xFifoId, tLen *o_pxCanWriteLen, tErroCode *o_peGetStatus)
+{
+    const sim_fifo_t *f = find_fifo(i_xFifoId);
+
+    if (f == NULL) {
+        *o_peGetStatus = ERRO_NO_NODE;
+        return;
+    }
+    *o_pxCanWriteLen = (tLen)(f->size - f->count);
+    *o_peGetStatus = ERRO_NONE;
+}
+
+void GetCanReadLen(uint8 i_xFifoId, tLen *o_pxCanReadLen, tErroCode *o_peGetStatus)
+{
+    const sim_fifo_t *f = find_fifo(i_xFifoId);
+
+    if (f == NULL) {
+        *o_peGetStatus = ERRO_NO_NODE;
+        return;
+    }
+    *o_pxCanReadLen = f->count;
+    *o_peGetStatus = ERRO_NONE;
+}
+
+void WriteDataInFifo(uint8 i_xFifoId, uint8 *i_pWriteDataBuf, tLen i_xWriteDatalen, tErroCode *o_peWriteStatus)
+{
+    sim_fifo_t *f = find_fifo(i_xFifoId);
+    tLen i;
+
+    if (f == NULL) {
+        *o_peWriteStatus = ERRO_NO_NODE;
+        return;
+    }
+    if (i_pWriteDataBuf == NULL) {
+        *o_peWriteStatus = ERRO_POINTER_NULL;
+        return;
+    }
+    if (i_xWriteDatalen > (tLen)(f->size - f->count)) {
+        *o_peWriteStatus = ERRO_OVER_MAX;
+        return;
+    }
+
+    for (i = 0U; i < i_xWriteDatalen; i++) {
+        f->buf[(f->head + f->count) % f->size] = i_pWriteDataBuf[i];
+        f->count++;
+    }
+    *o_peWriteStatus = ERRO_NONE;
+}
+
+void ReadDataFromFifo(uint8 i_xFifoId, tLen i_xNeedReadDataLen, uint8 *o_pReadDataBuf,
+                      tLen *o_pxReadLen, tErroCode *o_peReadStatus)
+{
+    sim_fifo_t *f = find_fifo(i_xFifoId);
+    tLen n;
+    tLen i;
+
+    if (f == NULL) {
+        *o_peReadStatus = ERRO_NO_NODE;
+        return;
+    }
+    if (o_pReadDataBuf == NULL || o_pxReadLen == NULL) {
+        *o_peReadStatus = ERRO_POINTER_NULL;
+        return;
+    }
+
+    /* Hands out what is there, like the target module */
+    n = (i_xNeedReadDataLen < f->count) ? i_xNeedReadDataLen : f->count;
+    for (i = 0U; i < n; i++) {
+        o_pReadDataBuf[i] = f->buf[f->head];
+        f->head = (tLen)((f->head + 1U) % f->size);
+        f->count--;
+    }
+    *o_pxReadLen = n;
+    *o_peReadStatus = ERRO_NONE;
+}
+
+void ClearFIFO(uint8 i_xFifoId, tErroCode *o_peStatus)
+{
+    sim_fifo_t *f = find_fifo(i_xFifoId);
+
+    if (f == NULL) {
+        *o_peStatus = ERRO_NO_NODE;
+        return;
+    }
+    f->head = 0U;
+    f->count = 0U;
+    *o_peStatus = ERRO_NONE;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file multi_cyc_fifo.h
+ * @brief Host build of the byte FIFOs the TP uses between the bus driver and CAN TP
+ *
+ * @details
+ * Same interface as the RTD-side multi_cyc_fifo module: FIFOs are created
+ * by ID with ApplyFifo() and report through a tErroCode. Applying an ID
+ * again empties it, so a test can re-run TP_Init().
+ */
+
+#ifndef CAN_TP_SIM_MULTI_CYC_FIFO_H
+#define CAN_TP_SIM_MULTI_CYC_FIFO_H
+
+#include "Mcal.h"
+
+typedef uint16 tLen;
+
+typedef enum
+{
+    ERRO_NONE = 0u,         /* No error */
+    ERRO_LEES_MIN,          /* Less than asked for */
+    ERRO_OVER_MAX,          /* More than fits */
+    ERRO_NO_NODE,           /* No FIFO with this ID */
+    ERRO_REGISTERED_SECOND, /* No room for another FIFO */
+    ERRO_WRITE_ERRO,        /* Write failed */
+    ERRO_READ_ERRO,         /* Read failed */
+    ERRO_POINTER_NULL       /* NULL argument */
+} tErroCode;
+
+void ApplyFifo(tLen i_xApplyFifoLen, uint8 i_xFifoId, tErroCode *o_peApplyStatus);
+
+void GetCanWriteLen(uint8 i_xFifoId, tLen *o_pxCanWriteLen, tErroCode *o_peGetStatus);
+
+void GetCanReadLen(uint8 i_xFifoId, tLen *o_pxCanReadLen, tErroCode *o_peGetStatus);
+
+void WriteDataInFifo(uint8 i_xFifoId, uint8 *i_pWriteDataBuf, tLen i_xWriteDatalen, tErroCode *o_peWriteStatus);
+
+void ReadDataFromFifo(uint8 i_xFifoId, tLen i_xNeedReadDataLen, uint8 *o_pReadDataBuf,
+                      tLen *o_pxReadLen, tErroCode *o_peReadStatus);
+
+void ClearFIFO(uint8 i_xFifoId, tErroCode *o_peStatus);
+
+#endif /* CAN_TP_SIM_MULTI_CYC_FIFO_H */
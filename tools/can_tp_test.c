@@ -0,0 +1,690 @@
+/**
+ * @file can_tp_test.c
+ * @brief Host test of CAN TP (external/UDS_stack/TP) segmentation and reassembly
+ *
+ * @details
+ * Plays the tester on the bus side of the TP (TP_DriverWriteDataInTP /
+ * TP_DriverReadDataFromTP with an immediate TX confirmation) and UDS on the
+ * other (TP_ReadAPduFromTP / TP_WriteAPduInTP). Checks that requests up to
+ * TP_PDU_BUF_LEN are reassembled straight into a pool buffer, with the
+ * 12 bit and the escaped 32 bit FF_DL, that longer ones and a full pool are
+ * answered with an overflow flow control, and that responses are segmented
+ * out of the pool buffer and give it back. Built once for classic CAN and
+ * once with EN_TX_CAN_FD, where single frames carry up to 62 bytes,
+ * consecutive frames 63 and every frame the TP sends must use the smallest
+ * CAN FD data length that holds it. Consecutive frames must be placed in
+ * the pool buffer by TP_DriverWriteDataInTP() itself, without the RX bus
+ * FIFO or a main loop pass, also with a block size (CANTP_RX_BLOCK_SIZE).
+ * Frames that do not fit in the full RX bus FIFO must be refused and
+ * counted in the RX statistics. Without STmin the TP must keep
+ * CANTP_TX_PIPELINE_DEPTH consecutive frames with a driver that confirms
+ * them later, up to the block size the tester asked for, and one at a time
+ * STmin apart otherwise, with STmin 0xF1-0xF9 in steps of 100 us and the
+ * reserved values as 127 ms. Our flow control must carry CANTP_RX_STMIN.
+ * Time comes from a simulated microsecond counter (CANTP_GetTimeUs()).
+ * Build and run with tools/can_tp_test.sh.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "TP.h"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("  FAILED line %d: %s\n", __LINE__, #cond); \
+            fails++; \
+        } \
+    } while (0)
+
+#define PHY_ID          (RX_PHY_ID)
+#define MAX_STEPS       (20000U)
+#define MAX_FRAMES      (1024U)
+#define SF_MAX          (TX_SF_DATA_MAX_LEN)   /* 7, CAN FD 62 */
+#define CF_MAX          (DATA_LEN - 1U)        /* 7, CAN FD 63 */
+
+typedef struct
+{
+    uint32_t len;
+    uint8_t data[DATA_LEN];
+} frame_t;
+
+static int fails;
+static frame_t tx_frames[MAX_FRAMES];       /* Frames the TP sent since the last clear */
+static uint32_t tx_count;
+static uint8_t tx_status = 0xFFU;           /* Last UDS TX confirmation */
+static bool rx_escaped;                     /* Last response FF used the 32 bit FF_DL */
+static uint8_t msg[TP_PDU_BUF_LEN + 1024U];
+static uint8_t rebuilt[TP_PDU_BUF_LEN + 1024U];
+static uint32_t now_us = 0xFFF00000U;       /* Wraps during the test */
+static uint32_t pass_us = 1000U;            /* Main loop period */
+
+/*******************************************************************************
+ * Library stand-ins
+ ******************************************************************************/
+
+void *fsl_memcpy(void *pavDest2, const void *pcoavSource2, uint32_t u32Length2)
+{
+    return memcpy(pavDest2, pcoavSource2, u32Length2);
+}
+
+void *fsl_memset(void *pavDest3, uint8_t u8Fill3, uint32_t u32Length3)
+{
+    return memset(pavDest3, u8Fill3, u32Length3);
+}
+
+uint32_t hal_timer_get_us(void)
+{
+    return now_us;
+}
+
+/*******************************************************************************
+ * Bus side
+ ******************************************************************************/
+
+/* One main loop pass: tick, run the TP, confirm everything it sent */
+static void step(void)
+{
+    uint8_t buf[DATA_LEN];
+    uint32_t id;
+    uint32_t len;
+
+    now_us += pass_us;
+    TP_SystemTickCtl();
+    TP_MainFun();
+
+    while (TP_DriverReadDataFromTP(sizeof(buf), buf, &id, &len) == TRUE) {
+        if (tx_count < MAX_FRAMES && id == TX_ID) {
+            tx_frames[tx_count].len = len;
+            memcpy(tx_frames[tx_count].data, buf, len);
+            tx_count++;
+        }
+        TP_DoTxMsgSuccesfulCallback();
+    }
+}
+
+/* Smallest CAN (FD) frame holding len bytes */
+static uint32_t can_dl(uint32_t len)
+{
+    static const uint8_t dl[] = {8U, 12U, 16U, 20U, 24U, 32U, 48U, 64U};
+    uint32_t i;
+
+    for (i = 0U; i < sizeof(dl) && dl[i] < len; i++) {
+    }
+    return (i < sizeof(dl) && dl[i] <= DATA_LEN) ? dl[i] : 0U;
+}
+
+/* Tester frame, padded to the smallest CAN (FD) frame */
+static void bus_rx(const uint8_t *data, uint32_t len)
+{
+    uint8_t buf[DATA_LEN];
+
+    memset(buf, 0xCCU, sizeof(buf));
+    memcpy(buf, data, len);
+    CHECK(TP_DriverWriteDataInTP(PHY_ID, can_dl(len), buf) == TRUE);
+    step();
+}
+
+static void uds_tx_callback(uint8 i_status)
+{
+    tx_status = i_status;
+}
+
+/* Sends msg[0..len) as SF or FF + CF, following the TP's flow control; returns false on FC overflow */
+static bool send_request(uint32_t len, bool escaped)
+{
+    uint8_t f[DATA_LEN];
+    uint32_t done;
+    uint32_t pos;
+    uint8_t sn = 1U;
+
+    tx_count = 0U;
+    if (len <= 7U && !escaped) {
+        f[0] = (uint8_t)len;
+        memcpy(&f[1], msg, len);
+        bus_rx(f, len + 1U);
+        return true;
+    }
+    if (len <= SF_MAX && !escaped) {
+        /* CAN FD single frame, SF_DL in the second byte */
+        f[0] = 0x00U;
+        f[1] = (uint8_t)len;
+        memcpy(&f[2], msg, len);
+        bus_rx(f, len + 2U);
+        return true;
+    }
+
+    if (escaped) {
+        f[0] = 0x10U;
+        f[1] = 0x00U;
+        f[2] = (uint8_t)(len >> 24);
+        f[3] = (uint8_t)(len >> 16);
+        f[4] = (uint8_t)(len >> 8);
+        f[5] = (uint8_t)len;
+        memcpy(&f[6], msg, DATA_LEN - 6U);
+        done = DATA_LEN - 6U;
+    } else {
+        f[0] = (uint8_t)(0x10U | (len >> 8));
+        f[1] = (uint8_t)len;
+        memcpy(&f[2], msg, DATA_LEN - 2U);
+        done = DATA_LEN - 2U;
+    }
+    bus_rx(f, sizeof(f));
+
+    /* Flow control */
+    CHECK(tx_count != 1U || tx_frames[0].len == STANDARD_CAN_DL);
+    if (tx_count != 1U || (tx_frames[0].data[0] & 0xF0U) != 0x30U) {
+        return false;
+    }
+    if (tx_frames[0].data[0] != 0x30U) {
+        return false;
+    }
+    CHECK(tx_frames[0].data[2] == CANTP_RX_STMIN);
+    step();
+
+    for (pos = done; pos < len; pos += CF_MAX) {
+        uint32_t n = (len - pos > CF_MAX) ? CF_MAX : len - pos;
+
+        f[0] = (uint8_t)(0x20U | (sn & 0x0FU));
+        memcpy(&f[1], &msg[pos], n);
+        tx_count = 0U;
+        bus_rx(f, n + 1U);
+
+        /* End of a block: the next one needs another flow control */
+        if (CANTP_RX_BLOCK_SIZE != 0U && (sn % CANTP_RX_BLOCK_SIZE) == 0U && pos + n < len) {
+            step();
+            CHECK(tx_count == 1U && tx_frames[0].data[0] == 0x30U &&
+                  tx_frames[0].data[1] == CANTP_RX_BLOCK_SIZE);
+            step();
+        } else {
+            CHECK(tx_count == 0U);
+        }
+        sn++;
+    }
+    return true;
+}
+
+/* Takes the response the TP segmented, answers its FF with flow control; returns its length */
+static uint32_t receive_response(void)
+{
+    const uint8_t fc[3] = {0x30U, 0x00U, 0x00U};
+    uint32_t len;
+    uint32_t pos;
+    uint32_t steps = 0U;
+    uint32_t i;
+
+    tx_count = 0U;
+    rx_escaped = false;
+    while (tx_count == 0U && steps++ < MAX_STEPS) {
+        step();
+    }
+    if (tx_count == 0U) {
+        return 0U;
+    }
+
+    if ((tx_frames[0].data[0] & 0xF0U) == 0x00U) {
+        pos = 1U;
+        len = tx_frames[0].data[0];
+        if (len == 0U) {
+            /* CAN FD single frame */
+            pos = 2U;
+            len = tx_frames[0].data[1];
+            CHECK(len > 7U);
+        }
+        CHECK(tx_frames[0].len == can_dl(pos + len));
+        memcpy(rebuilt, &tx_frames[0].data[pos], len);
+        /* SF confirmed */
+        step();
+        return len;
+    }
+
+    len = ((uint32_t)(tx_frames[0].data[0] & 0x0FU) << 8) | tx_frames[0].data[1];
+    if (len == 0U) {
+        rx_escaped = true;
+        len = ((uint32_t)tx_frames[0].data[2] << 24) | ((uint32_t)tx_frames[0].data[3] << 16) |
+              ((uint32_t)tx_frames[0].data[4] << 8) | tx_frames[0].data[5];
+        memcpy(rebuilt, &tx_frames[0].data[6], DATA_LEN - 6U);
+        pos = DATA_LEN - 6U;
+    } else {
+        memcpy(rebuilt, &tx_frames[0].data[2], DATA_LEN - 2U);
+        pos = DATA_LEN - 2U;
+    }
+    CHECK(tx_frames[0].len == DATA_LEN);
+
+    /* FF confirmed, now waiting for our FC */
+    step();
+    tx_count = 0U;
+    bus_rx(fc, sizeof(fc));
+    while (tx_count < (len - pos + CF_MAX - 1U) / CF_MAX && steps++ < MAX_STEPS) {
+        step();
+    }
+    for (i = 0U; i < tx_count && pos < len; i++) {
+        uint32_t n = (len - pos > CF_MAX) ? CF_MAX : len - pos;
+
+        if (tx_frames[i].data[0] != (uint8_t)(0x20U | ((i + 1U) & 0x0FU))) {
+            return 0U;
+        }
+        /* Full frames, the last one cut to the smallest length that holds it */
+        CHECK(tx_frames[i].len == can_dl(n + 1U));
+        memcpy(&rebuilt[pos], &tx_frames[i].data[1], n);
+        pos += n;
+    }
+    /* Last CF confirmed */
+    step();
+    return (pos == len) ? len : 0U;
+}
+
+/* One main loop pass without the bus side */
+static void pass(void)
+{
+    now_us += pass_us;
+    TP_SystemTickCtl();
+    TP_MainFun();
+}
+
+/* STmin byte of a flow control in microseconds */
+static uint32_t stmin_to_us(uint8_t stmin)
+{
+    if (stmin <= 0x7FU) {
+        return stmin * 1000U;
+    }
+    if (stmin >= 0xF1U && stmin <= 0xF9U) {
+        return (stmin - 0xF0U) * 100U;
+    }
+    return 127U * 1000U;
+}
+
+/*
+ * Sends msg[0..len) as a response to a driver with CANTP_TX_PIPELINE_DEPTH
+ * TX mailboxes: each pass it takes all the TP gives and confirms it before
+ * the next pass. The tester answers with BS bs and STmin stmin (FC byte).
+ * Returns the length rebuilt, 0 on a protocol error.
+ */
+static uint32_t transmit_pipelined(uint32_t len, uint8_t bs, uint8_t stmin)
+{
+    const uint8_t fc[3] = {0x30U, bs, stmin};
+    const uint32_t stmin_us = stmin_to_us(stmin);
+    uint8_t buf[DATA_LEN];
+    uint32_t id;
+    uint32_t flen;
+    uint32_t pos = 0U;
+    uint32_t cfs = 0U;
+    uint32_t block = 0U;
+    uint32_t last_cf = 0U;
+    uint32_t max_burst = 0U;
+    uint32_t passes;
+    tTPPduHandle pdu = TP_AllocPdu();
+
+    memcpy(TP_GetPduBuf(pdu), msg, len);
+    tx_status = 0xFFU;
+    CHECK(TP_WriteAPduInTP(TX_ID, uds_tx_callback, len, pdu) == TRUE);
+    TP_ReleasePdu(pdu);
+
+    for (passes = 1U; passes < MAX_STEPS && tx_status == 0xFFU; passes++) {
+        uint32_t burst = 0U;
+
+        pass();
+        while (TP_DriverReadDataFromTP(sizeof(buf), buf, &id, &flen) == TRUE) {
+            uint32_t n;
+
+            CHECK(++burst <= CANTP_TX_PIPELINE_DEPTH);
+            if ((buf[0] & 0xF0U) == 0x10U) {
+                /* FF, 12 bit FF_DL */
+                memcpy(rebuilt, &buf[2], DATA_LEN - 2U);
+                pos = DATA_LEN - 2U;
+                CHECK(TP_DriverWriteDataInTP(PHY_ID, can_dl(sizeof(fc)), fc) == TRUE);
+                continue;
+            }
+            if (buf[0] != (uint8_t)(0x20U | (++cfs & 0x0FU))) {
+                return 0U;
+            }
+            /* STmin from the confirmation of one CF (a pass after it was sent) to the next,
+               and without a flow control in between no later than the pass it ends in */
+            CHECK(stmin_us == 0U || cfs == 1U || now_us - last_cf >= stmin_us + pass_us);
+            CHECK(stmin_us == 0U || cfs == 1U || bs != 0U || now_us - last_cf < stmin_us + 2U * pass_us);
+            last_cf = now_us;
+            n = (len - pos > CF_MAX) ? CF_MAX : len - pos;
+            memcpy(&rebuilt[pos], &buf[1], n);
+            pos += n;
+            if (bs != 0U && ++block == bs && pos < len) {
+                block = 0U;
+                CHECK(TP_DriverWriteDataInTP(PHY_ID, can_dl(sizeof(fc)), fc) == TRUE);
+            }
+        }
+        max_burst = (burst > max_burst) ? burst : max_burst;
+        while (burst-- > 0U) {
+            TP_DoTxMsgSuccesfulCallback();
+        }
+    }
+    CHECK(tx_status == TX_MSG_SUCCESSFUL);
+
+    /* Without STmin the mailboxes are kept full, up to the end of the block */
+    if (stmin_us == 0U) {
+        uint32_t expect = (bs != 0U && bs < CANTP_TX_PIPELINE_DEPTH) ? bs : CANTP_TX_PIPELINE_DEPTH;
+
+        CHECK(max_burst == expect);
+    } else {
+        CHECK(max_burst == 1U);
+    }
+    pass();
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+    return (pos == len) ? len : 0U;
+}
+
+/* Request UDS got, 0 if none */
+static uint32_t uds_read(void)
+{
+    uint32_t id = 0U;
+    uint32_t len = 0U;
+    tTPPduHandle pdu = TP_PDU_NONE;
+
+    if (TP_ReadAPduFromTP(&id, &len, &pdu) != TRUE) {
+        return 0U;
+    }
+    CHECK(id == PHY_ID);
+    memcpy(rebuilt, TP_GetPduBuf(pdu), len);
+    TP_ReleasePdu(pdu);
+    return len;
+}
+
+static void fill_msg(uint32_t len, uint8_t seed)
+{
+    uint32_t i;
+
+    for (i = 0U; i < len; i++) {
+        msg[i] = (uint8_t)(i * 7U + seed);
+    }
+}
+
+/*******************************************************************************
+ * Tests
+ ******************************************************************************/
+
+static void test_receive(void)
+{
+    static const uint32_t lens[] = {2U, 7U, 8U, 62U, 63U, 100U, 189U, FF_DL_12BIT_MAX};
+    uint32_t i;
+
+    printf("receive, %u byte frames\n", (unsigned)DATA_LEN);
+    for (i = 0U; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        fill_msg(lens[i], (uint8_t)i);
+        CHECK(send_request(lens[i], false));
+        CHECK(uds_read() == lens[i]);
+        CHECK(memcmp(rebuilt, msg, lens[i]) == 0);
+    }
+
+    /* Escaped FF_DL: the whole pool buffer */
+    fill_msg(TP_PDU_BUF_LEN, 0x5AU);
+    CHECK(send_request(TP_PDU_BUF_LEN, true));
+    CHECK(uds_read() == TP_PDU_BUF_LEN);
+    CHECK(memcmp(rebuilt, msg, TP_PDU_BUF_LEN) == 0);
+    printf("  %u byte request in one pool buffer\n", (unsigned)TP_PDU_BUF_LEN);
+
+    /* Escape used for a length that fits 12 bit: ignored */
+    {
+        const uint8_t ff[8] = {0x10U, 0x00U, 0x00U, 0x00U, 0x00U, 0x40U, 0x01U, 0x02U};
+
+        tx_count = 0U;
+        bus_rx(ff, sizeof(ff));
+        CHECK(tx_count == 0U);
+        CHECK(uds_read() == 0U);
+    }
+
+    /* CAN FD single frame whose SF_DL runs past the frame: ignored */
+    if (DATA_LEN > STANDARD_CAN_DL) {
+        uint8_t sf[12] = {0x00U, 11U};
+
+        memcpy(&sf[2], msg, 10U);
+        CHECK(TP_DriverWriteDataInTP(PHY_ID, sizeof(sf), sf) == TRUE);
+        step();
+        CHECK(uds_read() == 0U);
+        sf[1] = 10U;
+        CHECK(TP_DriverWriteDataInTP(PHY_ID, sizeof(sf), sf) == TRUE);
+        step();
+        CHECK(uds_read() == 10U && memcmp(rebuilt, msg, 10U) == 0);
+    }
+
+    /* Longer than a pool buffer: overflow flow control */
+    fill_msg(TP_PDU_BUF_LEN + 1U, 1U);
+    CHECK(!send_request(TP_PDU_BUF_LEN + 1U, true));
+    CHECK(tx_count == 1U && tx_frames[0].data[0] == 0x32U);
+    step();
+    CHECK(uds_read() == 0U);
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+}
+
+/* Consecutive frames written by the driver (RX interrupt) land in the buffer without the main loop */
+static void test_direct_cf(void)
+{
+    const uint32_t len = 1000U;
+    const uint8_t ff[2] = {(uint8_t)(0x10U | (len >> 8)), (uint8_t)len};
+    uint8_t f[DATA_LEN];
+    uint32_t pos;
+    uint32_t n;
+    uint8_t sn = 1U;
+    tLen fifo_len = 0U;
+    tErroCode status;
+
+    printf("consecutive frames from the driver\n");
+    fill_msg(len, 0x77U);
+    memset(f, 0xCCU, sizeof(f));
+    memcpy(f, ff, 2U);
+    memcpy(&f[2], msg, DATA_LEN - 2U);
+    tx_count = 0U;
+    CHECK(TP_DriverWriteDataInTP(PHY_ID, DATA_LEN, f) == TRUE);
+    step();
+    CHECK(tx_count == 1U && tx_frames[0].data[0] == 0x30U);
+
+    /* The FC is not even confirmed yet */
+    for (pos = DATA_LEN - 2U; pos < len && (CANTP_RX_BLOCK_SIZE == 0U || sn <= CANTP_RX_BLOCK_SIZE); pos += n) {
+        n = (len - pos > CF_MAX) ? CF_MAX : len - pos;
+        f[0] = (uint8_t)(0x20U | (sn & 0x0FU));
+        memcpy(&f[1], &msg[pos], n);
+        CHECK(TP_DriverWriteDataInTP(PHY_ID, can_dl(n + 1U), f) == TRUE);
+        sn++;
+    }
+    GetCanReadLen(RX_BUS_FIFO, &fifo_len, &status);
+    CHECK(status == ERRO_NONE && fifo_len == 0U);
+    if (CANTP_RX_BLOCK_SIZE == 0U) {
+        step();
+        step();
+        CHECK(uds_read() == len && memcmp(rebuilt, msg, len) == 0);
+    }
+
+    /* Wrong SN: reception aborted, the buffer given back */
+    fill_msg(len, 0x78U);
+    memcpy(f, ff, 2U);
+    memcpy(&f[2], msg, DATA_LEN - 2U);
+    /* With a block size the TP is still sending the next FC */
+    for (n = 0U; n < 5U; n++) {
+        step();
+    }
+    tx_count = 0U;
+    CHECK(TP_DriverWriteDataInTP(PHY_ID, DATA_LEN, f) == TRUE);
+    step();
+    CHECK(tx_count == 1U && tx_frames[0].data[0] == 0x30U);
+    step();
+    f[0] = 0x22U;
+    CHECK(TP_DriverWriteDataInTP(PHY_ID, DATA_LEN, f) == TRUE);
+    step();
+    step();
+    CHECK(uds_read() == 0U);
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+
+    /* A CF nobody waits for goes to the state machine, which drops it */
+    f[0] = 0x21U;
+    CHECK(TP_DriverWriteDataInTP(PHY_ID, DATA_LEN, f) == TRUE);
+    step();
+    CHECK(uds_read() == 0U);
+
+    /* Single frame in the middle of a segmented request: the request is dropped, the SF taken */
+    fill_msg(len, 0x79U);
+    memcpy(f, ff, 2U);
+    memcpy(&f[2], msg, DATA_LEN - 2U);
+    CHECK(TP_DriverWriteDataInTP(PHY_ID, DATA_LEN, f) == TRUE);
+    step();
+    step();
+    f[0] = 0x02U;
+    f[1] = 0x3EU;
+    f[2] = 0x00U;
+    bus_rx(f, 3U);
+    step();
+    CHECK(uds_read() == 2U && rebuilt[0] == 0x3EU);
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+
+    /* And the next segmented one is received again */
+    CHECK(send_request(len, false));
+    CHECK(uds_read() == len && memcmp(rebuilt, msg, len) == 0);
+}
+
+static void test_rx_overrun(void)
+{
+    const uint8_t sf[3] = {0x02U, 0x3EU, 0x00U};
+    tTPRxStatistics before;
+    tTPRxStatistics after;
+    uint32_t accepted = 0U;
+    uint32_t i;
+
+    printf("RX FIFO overrun\n");
+    TP_GetRxStatistics(&before);
+
+    /* Frames the main loop does not pick up: the TP refuses and counts them once RX_BUS_FIFO is full */
+    while (accepted < RX_BUS_FIFO_LEN && TP_DriverWriteDataInTP(PHY_ID, can_dl(3U), sf) == TRUE) {
+        accepted++;
+    }
+    CHECK(accepted > 0U && accepted < RX_BUS_FIFO_LEN);
+    TP_DriverRxOverrun();
+    TP_GetRxStatistics(&after);
+    CHECK(after.rxFrameCnt == before.rxFrameCnt + accepted + 1U);
+    CHECK(after.rxDropCnt == before.rxDropCnt + 1U);
+    CHECK(after.rxOverrunCnt == before.rxOverrunCnt + 1U);
+
+    /* The frames that made it are all delivered */
+    for (i = 0U; i < accepted; i++) {
+        step();
+        CHECK(uds_read() == 2U && rebuilt[0] == 0x3EU);
+    }
+    CHECK(uds_read() == 0U);
+
+    fill_msg(100U, 4U);
+    CHECK(send_request(100U, false));
+    CHECK(uds_read() == 100U && memcmp(rebuilt, msg, 100U) == 0);
+    TP_GetRxStatistics(&before);
+    CHECK(before.rxDropCnt == after.rxDropCnt);
+}
+
+static void test_full_pool(void)
+{
+    tTPPduHandle held[TP_PDU_BUF_NUM];
+    uint32_t i;
+
+    printf("pool exhausted\n");
+    for (i = 0U; i < TP_PDU_BUF_NUM; i++) {
+        held[i] = TP_AllocPdu();
+        CHECK(held[i] != TP_PDU_NONE);
+    }
+    CHECK(TP_AllocPdu() == TP_PDU_NONE);
+
+    /* SF dropped, FF refused with overflow */
+    fill_msg(100U, 3U);
+    CHECK(send_request(3U, false));
+    CHECK(!send_request(100U, false));
+    CHECK(tx_count == 1U && tx_frames[0].data[0] == 0x32U);
+    step();
+
+    for (i = 0U; i < TP_PDU_BUF_NUM; i++) {
+        TP_ReleasePdu(held[i]);
+    }
+    CHECK(uds_read() == 0U);
+
+    /* Works again once buffers are back */
+    CHECK(send_request(100U, false));
+    CHECK(uds_read() == 100U && memcmp(rebuilt, msg, 100U) == 0);
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+}
+
+static void test_transmit(void)
+{
+    static const uint32_t lens[] = {3U, 7U, 8U, 10U, 62U, 63U, 100U, 189U, FF_DL_12BIT_MAX, TP_PDU_BUF_LEN};
+    uint32_t i;
+
+    printf("transmit, %u byte frames\n", (unsigned)DATA_LEN);
+    for (i = 0U; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        tTPPduHandle pdu = TP_AllocPdu();
+
+        fill_msg(lens[i], (uint8_t)(0x30U + i));
+        memcpy(TP_GetPduBuf(pdu), msg, lens[i]);
+        tx_status = 0xFFU;
+        CHECK(TP_WriteAPduInTP(TX_ID, uds_tx_callback, lens[i], pdu) == TRUE);
+
+        /* UDS is done with it, the TP keeps its own reference while sending */
+        TP_ReleasePdu(pdu);
+        CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM - 1U);
+
+        CHECK(receive_response() == lens[i]);
+        CHECK(memcmp(rebuilt, msg, lens[i]) == 0);
+        CHECK(tx_status == TX_MSG_SUCCESSFUL);
+        CHECK(rx_escaped == (lens[i] > FF_DL_12BIT_MAX));
+        step();
+        CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+    }
+    printf("  %u byte response, escaped FF_DL\n", (unsigned)TP_PDU_BUF_LEN);
+
+    /* Short messages outside the pool are copied in */
+    {
+        const uint8_t rsp[2] = {0x51U, 0x01U};
+
+        CHECK(TP_WriteAFrameDataInTP(TX_ID, uds_tx_callback, sizeof(rsp), rsp) == TRUE);
+        CHECK(receive_response() == sizeof(rsp) && memcmp(rebuilt, rsp, sizeof(rsp)) == 0);
+        step();
+        CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+    }
+
+    /* Wrong ID, too long */
+    {
+        tTPPduHandle pdu = TP_AllocPdu();
+
+        CHECK(TP_WriteAPduInTP(TX_ID + 1U, uds_tx_callback, 8U, pdu) == FALSE);
+        CHECK(TP_WriteAPduInTP(TX_ID, uds_tx_callback, TP_PDU_BUF_LEN + 1U, pdu) == FALSE);
+        TP_ReleasePdu(pdu);
+        CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+    }
+}
+
+static void test_transmit_pipeline(void)
+{
+    /* BS, STmin, main loop period (us) */
+    static const uint32_t fc[][3] = {
+        {0U, 0U, 1000U}, {2U, 0U, 1000U}, {5U, 0U, 1000U}, {0U, 3U, 1000U}, {4U, 2U, 1000U},
+        {0U, 2U, 50U}, {0U, 0xF1U, 50U}, {0U, 0xF5U, 50U}, {3U, 0xF9U, 50U}, {0U, 0xF3U, 1000U},
+        {0U, 0x80U, 1000U}, {0U, 0xFAU, 1000U}
+    };
+    const uint32_t len = 40U * CF_MAX;
+    uint32_t i;
+
+    printf("transmit, %u CFs with the driver\n", (unsigned)CANTP_TX_PIPELINE_DEPTH);
+    for (i = 0U; i < sizeof(fc) / sizeof(fc[0]); i++) {
+        pass_us = fc[i][2];
+        fill_msg(len, (uint8_t)(0x50U + i));
+        CHECK(transmit_pipelined(len, (uint8_t)fc[i][0], (uint8_t)fc[i][1]) == len);
+        CHECK(memcmp(rebuilt, msg, len) == 0);
+    }
+    pass_us = 1000U;
+    printf("  STmin 100-900 us, reserved STmin as 127 ms\n");
+}
+
+int main(void)
+{
+    TP_Init();
+
+    test_receive();
+    test_direct_cf();
+    test_rx_overrun();
+    test_full_pool();
+    test_transmit();
+    test_transmit_pipeline();
+
+    printf("%s\n", fails ? "FAILED" : "all CAN TP tests passed");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,44 @@
+#!/usr/bin/env bash
+# Build and run the host test of CAN TP segmentation and reassembly
+# (external/UDS_stack/TP with the TP buffer pool, the bus FIFOs from
+# tools/can_tp_sim and the board headers from tools/uds_sim).
+#
+# Usage:
+#   bash tools/can_tp_test.sh
+#   CC=clang bash tools/can_tp_test.sh
+
+set -euo pipefail
+
+TOOLS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+EASYBOOT_ROOT="$(cd "$TOOLS_DIR/.." && pwd)"
+TP_DIR="$EASYBOOT_ROOT/external/UDS_stack/TP"
+OUT_DIR="$EASYBOOT_ROOT/build/host"
+CC="${CC:-gcc}"
+
+mkdir -p "$OUT_DIR"
+
+# Built for classic CAN, classic CAN with a block size in our flow control,
+# classic CAN sending one consecutive frame at a time, classic CAN asking
+# for 500 us STmin in our flow control and CAN FD (EN_TX_CAN_FD).
+# The simulator directories go first so their headers replace the RTD ones.
+VARIANTS=("classic:" "bs4:-DCANTP_RX_BLOCK_SIZE=4u" "depth1:-DCANTP_TX_PIPELINE_DEPTH=1u" "stmin_us:-DCANTP_RX_STMIN=0xF5u" "fd:-DEN_TX_CAN_FD")
+for VARIANT in "${VARIANTS[@]}"; do
+    NAME="${VARIANT%%:*}"
+    FLAGS="${VARIANT#*:}"
+    "$CC" -O1 -g -Wall -Wno-unused-function -Wno-unused-variable -Wno-unused-but-set-variable \
+        $FLAGS \
+        -I"$TOOLS_DIR/can_tp_sim" -I"$TOOLS_DIR/uds_sim" \
+        -I"$EASYBOOT_ROOT/include" -I"$EASYBOOT_ROOT/include/public_inc" \
+        -I"$EASYBOOT_ROOT/external/auto_lib/inc" \
+        -I"$TP_DIR/inc" -I"$TP_DIR/inc/CAN_TP" \
+        "$TOOLS_DIR/can_tp_test.c" \
+        "$TOOLS_DIR/can_tp_sim/multi_cyc_fifo.c" \
+        "$TP_DIR/src/TP.c" \
+        "$TP_DIR/src/TP_Cfg.c" \
+        "$TP_DIR/src/TP_pdu.c" \
+        "$TP_DIR/src/CAN_TP/can_tp.c" \
+        "$TP_DIR/src/CAN_TP/can_tp_cfg.c" \
+        -o "$OUT_DIR/can_tp_test_$NAME"
+
+    "$OUT_DIR/can_tp_test_$NAME"
+done
@@ -0,0 +1,136 @@
+/**
+ * @file crc_bench.c
+ * @brief Host benchmark for the software CRC paths in src/hal_crc.c
+ *
+ * @details
+ * Checks the vectors from src/test_crc_vectors.h, then times CRC32 and
+ * CRC16 over a 1 MiB buffer. The CRC32 variant is fixed at build time by
+ * HAL_CRC_SW_SLICING, so build one binary per variant (tools/crc_bench.sh
+ * does this for 1, 4 and 8):
+ *
+ *   gcc -O2 -DHAL_CRC_USE_HARDWARE=0 -DHAL_CRC_SW_SLICING=8 \
+ *       -Iinclude -Isrc tools/crc_bench.c src/hal_crc.c -o build/crc_bench_8
+ *
+ * Bytes/cycle uses the x86 TSC when available, otherwise only MB/s is shown.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <time.h>
+#include "hal_crc.h"
+#include "test_crc_vectors.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_CYCLES 1
+#define bench_cycles() __rdtsc()
+#else
+#define BENCH_HAVE_CYCLES 0
+#define bench_cycles() 0ULL
+#endif
+
+#define BENCH_BUF_SIZE  (1024U * 1024U)
+#define BENCH_ROUNDS    (64U)
+
+static int check_vectors(void)
+{
+    int fails = 0;
+
+    /*
+     * The software path takes the previous CRC as init value (0 to start), so
+     * all CRC32 vectors are checked with init 0. test_crc.c seeds vectors 2 and
+     * 3 with 0xFFFFFFFF, which is what the hardware CRC channel expects.
+     */
+    fails += hal_crc32_compute(test_data1, sizeof(test_data1), 0) != test_data1_crc32;
+    fails += hal_crc32_compute(test_data2, sizeof(test_data2), 0) != test_data2_crc32;
+    fails += hal_crc32_compute(CRC_data, CRC_DATA_SIZE, 0) != RESULT_CRC_32BIT_ETHERNET;
+    fails += hal_crc16_compute(CRC_data, CRC_DATA_SIZE, 0xFFFFU) != RESULT_CRC_16BIT_CCITT_FALSE;
+
+    /* Unaligned start, odd tail and chaining across a split point */
+    fails += hal_crc32_compute(CRC_data + 1, CRC_DATA_SIZE - 2, 0) !=
+             hal_crc32_compute(CRC_data + 102, CRC_DATA_SIZE - 103,
+                               hal_crc32_compute(CRC_data + 1, 101, 0));
+
+    /* Pieces computed on their own, combined */
+    fails += hal_crc32_combine(hal_crc32_compute(CRC_data, 101U, 0),
+                               hal_crc32_compute(CRC_data + 101U, CRC_DATA_SIZE - 101U, 0),
+                               CRC_DATA_SIZE - 101U) != RESULT_CRC_32BIT_ETHERNET;
+    fails += hal_crc32_combine(0U, RESULT_CRC_32BIT_ETHERNET, CRC_DATA_SIZE) != RESULT_CRC_32BIT_ETHERNET;
+    fails += hal_crc32_combine(RESULT_CRC_32BIT_ETHERNET, 0U, 0U) != RESULT_CRC_32BIT_ETHERNET;
+
+    /* Streaming API, same split as test_crc.c test 5 */
+    {
+        hal_crc32_ctx_t ctx;
+        uint32_t crc = 0U;
+
+        fails += hal_crc32_begin(&ctx) != 0;
+        fails += hal_crc32_update(&ctx, CRC_data, 101U) != 0;
+        fails += hal_crc32_update(&ctx, CRC_data + 101U, 3U) != 0;
+        fails += hal_crc32_update(&ctx, CRC_data + 104U, CRC_DATA_SIZE - 104U) != 0;
+        fails += hal_crc32_final(&ctx, &crc) != 0;
+        fails += crc != RESULT_CRC_32BIT_ETHERNET;
+    }
+
+    return fails;
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(void)
+{
+    uint8_t *buf = malloc(BENCH_BUF_SIZE);
+    volatile uint32_t sink = 0;
+    unsigned long long c0, c1;
+    double t0, t1;
+    double bytes = (double)BENCH_BUF_SIZE * BENCH_ROUNDS;
+    uint32_t i;
+    int fails;
+
+    if (!buf) {
+        return 1;
+    }
+
+    hal_crc_init();
+    fails = check_vectors();
+    printf("slicing-by-%d: test vectors %s\n", HAL_CRC_SW_SLICING, fails ? "FAILED" : "passed");
+
+    for (i = 0; i < BENCH_BUF_SIZE; i++) {
+        buf[i] = (uint8_t)(i * 2654435761U >> 24);
+    }
+
+    t0 = now_sec();
+    c0 = bench_cycles();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        sink ^= hal_crc32_compute(buf, BENCH_BUF_SIZE, sink);
+    }
+    c1 = bench_cycles();
+    t1 = now_sec();
+    printf("  crc32: %8.1f MB/s", bytes / (t1 - t0) / 1e6);
+    if (BENCH_HAVE_CYCLES) {
+        printf("  %.3f bytes/cycle", bytes / (double)(c1 - c0));
+    }
+    printf("\n");
+
+    t0 = now_sec();
+    c0 = bench_cycles();
+    for (i = 0; i < BENCH_ROUNDS; i++) {
+        sink ^= hal_crc16_compute(buf, BENCH_BUF_SIZE, (uint16_t)sink);
+    }
+    c1 = bench_cycles();
+    t1 = now_sec();
+    printf("  crc16: %8.1f MB/s", bytes / (t1 - t0) / 1e6);
+    if (BENCH_HAVE_CYCLES) {
+        printf("  %.3f bytes/cycle", bytes / (double)(c1 - c0));
+    }
+    printf("\n");
+
+    free(buf);
+    return fails ? 1 : 0;
+}
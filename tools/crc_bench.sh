@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+# Build and run tools/crc_bench.c once per software CRC32 variant
+# (HAL_CRC_SW_SLICING = 1, 4, 8) on the host.
+#
+# Usage:
+#   bash tools/crc_bench.sh            # uses gcc
+#   CC=clang bash tools/crc_bench.sh
+
+set -euo pipefail
+
+TOOLS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+EASYBOOT_ROOT="$(cd "$TOOLS_DIR/.." && pwd)"
+OUT_DIR="$EASYBOOT_ROOT/build/host"
+CC="${CC:-gcc}"
+
+mkdir -p "$OUT_DIR"
+
+for slicing in 1 4 8; do
+    "$CC" -O2 -Wall -DHAL_CRC_USE_HARDWARE=0 -DHAL_CRC_SW_SLICING="$slicing" \
+        -I"$EASYBOOT_ROOT/include" -I"$EASYBOOT_ROOT/src" \
+        "$TOOLS_DIR/crc_bench.c" "$EASYBOOT_ROOT/src/hal_crc.c" \
+        -o "$OUT_DIR/crc_bench_$slicing"
+    "$OUT_DIR/crc_bench_$slicing"
+done
@@ -0,0 +1,81 @@
+/**
+ * @file delta_diff.c
+ * @brief Make a delta patch between the installed and the new application image
+ *
+ * The patch is sent with dataFormatIdentifier 0x20 in RequestDownload, with
+ * memorySize set to the size of the new image; the bootloader copies from
+ * the image in the active slot while writing the inactive one.
+ *
+ * Usage: delta_diff <installed.bin> <new.bin> <patch.bin>
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "delta_encode.h"
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+    FILE *f = fopen(path, "rb");
+    uint8_t *buf;
+    long len;
+
+    if (f == NULL) {
+        perror(path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    buf = malloc((size_t)len + 8U);
+    if ((buf == NULL) || (fread(buf, 1, (size_t)len, f) != (size_t)len)) {
+        fprintf(stderr, "%s: read failed\n", path);
+        exit(1);
+    }
+    fclose(f);
+    *size = (size_t)len;
+
+    return buf;
+}
+
+int main(int argc, char **argv)
+{
+    size_t src_len;
+    size_t dst_len;
+    uint8_t *src;
+    uint8_t *dst;
+    uint8_t *patch;
+    size_t patch_len;
+    FILE *f;
+
+    if (argc != 4) {
+        fprintf(stderr, "usage: %s <installed.bin> <new.bin> <patch.bin>\n", argv[0]);
+        return 2;
+    }
+
+    src = read_file(argv[1], &src_len);
+    dst = read_file(argv[2], &dst_len);
+    patch = malloc(DELTA_ENCODE_BOUND(dst_len));
+    if (patch == NULL) {
+        return 1;
+    }
+
+    patch_len = delta_encode(src, src_len, dst, dst_len, patch);
+
+    f = fopen(argv[3], "wb");
+    if ((f == NULL) || (fwrite(patch, 1, patch_len, f) != patch_len) || (fclose(f) != 0)) {
+        perror(argv[3]);
+        return 1;
+    }
+
+    printf("%s: %zu byte patch for %zu byte image (%.1f%%)\n", argv[3], patch_len, dst_len,
+           (dst_len != 0U) ? (100.0 * (double)patch_len / (double)dst_len) : 0.0);
+
+    free(src);
+    free(dst);
+    free(patch);
+
+    return 0;
+}
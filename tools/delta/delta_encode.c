@@ -0,0 +1,170 @@
+/**
+ * @file delta_encode.c
+ * @brief Host-side diff generator for the patch format of include/boot_delta.h
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "delta_encode.h"
+#include "boot_delta.h"
+#include "hal_crc.h"
+
+#define MIN_COPY        (8U)
+#define HASH_BITS       (20U)
+#define HASH_SIZE       (1UL << HASH_BITS)
+#define MAX_CHAIN       (32U)
+#define NO_POS          ((size_t)-1)
+
+typedef struct
+{
+    uint8_t *out;
+    size_t len;
+    size_t insert_start;        /* dst offset of the pending insert run */
+    size_t insert_len;
+    size_t src_expected;        /* End of the previous copy, what distances are relative to */
+    size_t src_guess;           /* Where unchanged data would continue, steps over inserts */
+} patch_writer_t;
+
+static uint32_t hash8(const uint8_t *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return (uint32_t)((v * 0x9E3779B97F4A7C15ULL) >> (64U - HASH_BITS));
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void flush_insert(patch_writer_t *pw, const uint8_t *dst)
+{
+    while (pw->insert_len != 0U) {
+        size_t n = (pw->insert_len > BOOT_DELTA_MAX_INSERT) ? BOOT_DELTA_MAX_INSERT : pw->insert_len;
+
+        pw->out[pw->len++] = (uint8_t)(n - 1U);
+        memcpy(&pw->out[pw->len], &dst[pw->insert_start], n);
+        pw->len += n;
+        pw->insert_start += n;
+        pw->insert_len -= n;
+    }
+}
+
+static void put_copy(patch_writer_t *pw, size_t src_pos, size_t len)
+{
+    while (len != 0U) {
+        size_t n = (len > BOOT_DELTA_MAX_COPY) ? BOOT_DELTA_MAX_COPY : len;
+        int64_t distance = (int64_t)src_pos - (int64_t)pw->src_expected;
+        uint32_t zigzag = (uint32_t)((distance << 1) ^ (distance >> 63));
+
+        pw->out[pw->len++] = (uint8_t)(0x80U | ((n - 1U) >> 8));
+        pw->out[pw->len++] = (uint8_t)(n - 1U);
+        do {
+            pw->out[pw->len++] = (uint8_t)((zigzag & 0x7FU) | ((zigzag > 0x7FU) ? 0x80U : 0U));
+            zigzag >>= 7;
+        } while (zigzag != 0U);
+
+        src_pos += n;
+        len -= n;
+        pw->src_expected = src_pos;
+    }
+    pw->src_guess = src_pos;
+}
+
+static size_t match_len(const uint8_t *a, const uint8_t *b, size_t max)
+{
+    size_t n = 0U;
+
+    while ((n < max) && (a[n] == b[n])) {
+        n++;
+    }
+    return n;
+}
+
+size_t delta_encode(const uint8_t *src, size_t src_len, const uint8_t *dst, size_t dst_len, uint8_t *out)
+{
+    patch_writer_t pw = { out, BOOT_DELTA_HEADER_SIZE, 0U, 0U, 0U, 0U };
+    size_t *head = malloc(HASH_SIZE * sizeof(size_t));
+    size_t *next = malloc((src_len + 1U) * sizeof(size_t));
+    size_t i = 0U;
+
+    if ((head == NULL) || (next == NULL)) {
+        abort();
+    }
+    for (size_t h = 0U; h < HASH_SIZE; h++) {
+        head[h] = NO_POS;
+    }
+    /* Inserted back to front so chains list the lowest position first */
+    for (size_t p = src_len; p-- > 0U;) {
+        if ((p + MIN_COPY) <= src_len) {
+            uint32_t h = hash8(&src[p]);
+
+            next[p] = head[h];
+            head[h] = p;
+        }
+    }
+
+    put_u32(&out[0], BOOT_DELTA_MAGIC);
+    put_u32(&out[4], (uint32_t)src_len);
+    put_u32(&out[8], hal_crc32_compute(src, (uint32_t)src_len, 0U));
+    put_u32(&out[12], (uint32_t)dst_len);
+    put_u32(&out[16], hal_crc32_compute(dst, (uint32_t)dst_len, 0U));
+
+    while (i < dst_len) {
+        size_t best_len = 0U;
+        size_t best_pos = 0U;
+        size_t max = dst_len - i;
+
+        /* Unchanged code mostly continues where the last copy ended */
+        if (pw.src_guess < src_len) {
+            size_t lim = (max < (src_len - pw.src_guess)) ? max : (src_len - pw.src_guess);
+
+            best_len = match_len(&src[pw.src_guess], &dst[i], lim);
+            best_pos = pw.src_guess;
+        }
+
+        if ((best_len < MIN_COPY) && ((i + MIN_COPY) <= dst_len)) {
+            size_t cand = head[hash8(&dst[i])];
+            uint32_t chain = 0U;
+
+            while ((cand != NO_POS) && (chain++ < MAX_CHAIN)) {
+                size_t lim = (max < (src_len - cand)) ? max : (src_len - cand);
+                size_t n = match_len(&src[cand], &dst[i], lim);
+
+                if (n > best_len) {
+                    best_len = n;
+                    best_pos = cand;
+                }
+                cand = next[cand];
+            }
+        }
+
+        if (best_len >= MIN_COPY) {
+            flush_insert(&pw, dst);
+            put_copy(&pw, best_pos, best_len);
+            i += best_len;
+            pw.insert_start = i;
+        } else {
+            if (pw.insert_len == 0U) {
+                pw.insert_start = i;
+            }
+            pw.insert_len++;
+            i++;
+            /* Keep the continuation in step across a changed byte */
+            pw.src_guess++;
+        }
+    }
+    flush_insert(&pw, dst);
+
+    free(head);
+    free(next);
+
+    return pw.len;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file delta_encode.h
+ * @brief Host-side diff generator for the patch format of include/boot_delta.h
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#ifndef DELTA_ENCODE_H
+#define DELTA_ENCODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest patch for a dst_size image (header plus everything inserted) */
+#define DELTA_ENCODE_BOUND(n)   (20U + (n) + ((n) + 127U) / 128U)
+
+/**
+ * @brief Make a patch that turns src into dst
+ *
+ * Indexes every position of src by a hash of the 8 bytes starting there,
+ * then walks dst greedily: the continuation of the previous copy is tried
+ * first, then up to a few hash candidates; matches shorter than 8 bytes
+ * become inserts.
+ *
+ * @param src Installed image
+ * @param src_len Its size
+ * @param dst New image
+ * @param dst_len Its size
+ * @param out Patch, at least DELTA_ENCODE_BOUND(dst_len) bytes
+ * @return Patch size
+ */
+size_t delta_encode(const uint8_t *src, size_t src_len, const uint8_t *dst, size_t dst_len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DELTA_ENCODE_H */
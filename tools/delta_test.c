@@ -0,0 +1,298 @@
+/**
+ * @file delta_test.c
+ * @brief Host test of the delta patch applier in src/boot_delta.c
+ *
+ * @details
+ * Builds a synthetic "installed" image and a "new" one derived from it the
+ * way releases differ (changed constants, code inserted and removed so the
+ * rest shifts, a rewritten block, an appended section), diffs them with
+ * tools/delta, places the installed image in the simulated flash and
+ * applies the patch in random input/output piece sizes. Also checks that a
+ * patch against another image, a size mismatch, copies outside the source
+ * and trailing data are refused. Build and run with tools/delta_test.sh.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "boot_delta.h"
+#include "hal_crc.h"
+#include "hal_error.h"
+#include "hal_flash.h"
+#include "c40_sim.h"
+#include "delta_encode.h"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("  FAILED line %d: %s\n", __LINE__, #cond); \
+            fails++; \
+        } \
+    } while (0)
+
+#define SRC_ADDR        (0x00440000U)       /* Slot A */
+#define SRC_LIMIT       (0x000CA000U)
+#define IMAGE_SIZE      (700U * 1024U)
+
+static int fails;
+static boot_delta_t dt;
+static uint32_t rng = 0x2545F491U;
+static uint8_t src[IMAGE_SIZE];
+static uint8_t dst[IMAGE_SIZE + 4096U];
+static uint8_t out[IMAGE_SIZE + 4096U];
+static uint8_t patch[DELTA_ENCODE_BOUND(IMAGE_SIZE + 4096U)];
+
+static uint32_t next_rand(void)
+{
+    /* xorshift32: the low bits of an LCG repeat too soon for realistic test images */
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/* Thumb-like code: a small vocabulary of instruction words with varying register and immediate fields */
+static void make_code(uint8_t *img, size_t size)
+{
+    static const uint16_t ops[8] = {0xB580U, 0x4B03U, 0x681BU, 0xF000U, 0x2000U, 0xBD80U, 0x4770U, 0x6018U};
+
+    for (size_t i = 0U; i + 1U < size; i += 2U) {
+        uint16_t w = ops[next_rand() % 8U] ^ (uint16_t)(next_rand() & 0x0FU);
+
+        if ((next_rand() % 4U) == 0U) {
+            w ^= (uint16_t)(next_rand() & 0xFFU);
+        }
+        img[i] = (uint8_t)w;
+        img[i + 1U] = (uint8_t)(w >> 8);
+    }
+}
+
+/* The new release: returns its size */
+static size_t make_new_release(void)
+{
+    size_t d = 0U;
+    size_t s = 0U;
+
+    /* Unchanged start, with a few patched constants */
+    memcpy(&dst[d], &src[s], 100U * 1024U);
+    for (uint32_t k = 0U; k < 20U; k++) {
+        dst[d + (next_rand() % (100U * 1024U))] ^= 0x5AU;
+    }
+    d += 100U * 1024U;
+    s += 100U * 1024U;
+
+    /* 300 bytes of new code, everything behind shifts */
+    make_code(&dst[d], 300U);
+    d += 300U;
+
+    memcpy(&dst[d], &src[s], 300U * 1024U);
+    d += 300U * 1024U;
+    s += 300U * 1024U;
+
+    /* 1 KiB removed */
+    s += 1024U;
+
+    /* A rewritten 4 KiB function */
+    make_code(&dst[d], 4096U);
+    d += 4096U;
+    s += 4096U;
+
+    memcpy(&dst[d], &src[s], IMAGE_SIZE - s);
+    d += IMAGE_SIZE - s;
+
+    /* Appended section */
+    make_code(&dst[d], 2048U);
+    d += 2048U;
+
+    return d;
+}
+
+/* Copy distance as zigzag LEB128, returns its length */
+static size_t put_distance(uint8_t *p, int32_t distance)
+{
+    uint32_t v = ((uint32_t)distance << 1) ^ (uint32_t)(distance >> 31);
+    size_t n = 0U;
+
+    do {
+        p[n++] = (uint8_t)((v & 0x7FU) | ((v > 0x7FU) ? 0x80U : 0U));
+        v >>= 7;
+    } while (v != 0U);
+
+    return n;
+}
+
+/* Apply with random piece sizes, return bytes produced or -1 on error */
+static long apply_chunked(const uint8_t *p, size_t p_len, uint32_t dst_size, int32_t *err)
+{
+    const uint8_t *in = p;
+    uint32_t in_left = 0U;
+    size_t fed = 0U;
+    size_t total = 0U;
+
+    boot_delta_init(&dt, SRC_ADDR, SRC_LIMIT, dst_size);
+    *err = HAL_ERR_SUCCESS;
+
+    for (;;) {
+        uint32_t n;
+        uint32_t piece = 1U + (next_rand() % 9000U);
+
+        if (in_left == 0U) {
+            if (fed == p_len) {
+                break;
+            }
+            in_left = 1U + (next_rand() % 200U);
+            if (in_left > (p_len - fed)) {
+                in_left = (uint32_t)(p_len - fed);
+            }
+            fed += in_left;
+        }
+        if (piece > (sizeof(out) - total)) {
+            piece = (uint32_t)(sizeof(out) - total);
+        }
+        *err = boot_delta_apply(&dt, &in, &in_left, &out[total], piece, &n);
+        if (*err != HAL_ERR_SUCCESS) {
+            return -1;
+        }
+        total += n;
+    }
+
+    /* Input used up, drain a copy still in progress */
+    for (;;) {
+        uint32_t n;
+        uint32_t none = 0U;
+
+        *err = boot_delta_apply(&dt, &in, &none, &out[total], (uint32_t)(sizeof(out) - total), &n);
+        if (*err != HAL_ERR_SUCCESS) {
+            return -1;
+        }
+        if (n == 0U) {
+            break;
+        }
+        total += n;
+    }
+
+    return (long)total;
+}
+
+static void test_round_trip(void)
+{
+    size_t dst_len;
+    size_t p_len;
+    long out_len;
+    int32_t err;
+
+    printf("round trip\n");
+
+    dst_len = make_new_release();
+    p_len = delta_encode(src, IMAGE_SIZE, dst, dst_len, patch);
+    printf("  %u -> %zu byte image, %zu byte patch (%.2f%%)\n", IMAGE_SIZE, dst_len, p_len,
+           100.0 * (double)p_len / (double)dst_len);
+    CHECK(p_len < dst_len / 20U);
+
+    out_len = apply_chunked(patch, p_len, (uint32_t)dst_len, &err);
+    CHECK(err == HAL_ERR_SUCCESS);
+    CHECK(out_len == (long)dst_len);
+    CHECK((out_len == (long)dst_len) && (memcmp(out, dst, dst_len) == 0));
+    CHECK(boot_delta_is_done(&dt));
+    CHECK(dt.dst_crc == hal_crc32_compute(out, (uint32_t)dst_len, 0U));
+
+    /* Same image: a handful of copies */
+    p_len = delta_encode(src, IMAGE_SIZE, src, IMAGE_SIZE, patch);
+    printf("  unchanged image: %zu byte patch\n", p_len);
+    CHECK(p_len < 200U);
+    out_len = apply_chunked(patch, p_len, IMAGE_SIZE, &err);
+    CHECK((out_len == (long)IMAGE_SIZE) && (memcmp(out, src, IMAGE_SIZE) == 0));
+
+    /* Unrelated image: everything inserted */
+    make_code(dst, 64U * 1024U);
+    for (size_t i = 0U; i < 64U * 1024U; i++) {
+        dst[i] = (uint8_t)next_rand();
+    }
+    p_len = delta_encode(src, IMAGE_SIZE, dst, 64U * 1024U, patch);
+    CHECK(p_len <= DELTA_ENCODE_BOUND(64U * 1024U));
+    out_len = apply_chunked(patch, p_len, 64U * 1024U, &err);
+    CHECK((out_len == 64L * 1024L) && (memcmp(out, dst, 64U * 1024U) == 0));
+}
+
+static void test_rejected_patches(void)
+{
+    size_t p_len;
+    long out_len;
+    int32_t err;
+
+    printf("rejected patches\n");
+
+    memcpy(dst, src, 32U * 1024U);
+    dst[5000] ^= 1U;
+    p_len = delta_encode(src, IMAGE_SIZE, dst, 32U * 1024U, patch);
+
+    /* Installed image is not the one the patch was made for: nothing produced */
+    c40_sim_ptr(SRC_ADDR + IMAGE_SIZE - 1U)[0] ^= 0x01U;
+    out_len = apply_chunked(patch, p_len, 32U * 1024U, &err);
+    CHECK((out_len == -1) && (err == HAL_ERR_FLASH_VERIFY_FAILED) && (dt.out_total == 0U));
+    c40_sim_ptr(SRC_ADDR + IMAGE_SIZE - 1U)[0] ^= 0x01U;
+
+    /* memorySize other than the patch's dst_size */
+    out_len = apply_chunked(patch, p_len, 32U * 1024U + 1U, &err);
+    CHECK((out_len == -1) && (err == HAL_ERR_INVALID_PARAM));
+
+    /* Source bigger than the slot */
+    boot_delta_init(&dt, SRC_ADDR, 1024U, 32U * 1024U);
+    {
+        const uint8_t *in = patch;
+        uint32_t in_len = (uint32_t)p_len;
+        uint32_t n;
+
+        CHECK(boot_delta_apply(&dt, &in, &in_len, out, sizeof(out), &n) == HAL_ERR_INVALID_PARAM);
+    }
+
+    /* Trailing operation after the last byte */
+    patch[p_len] = 0x00U;
+    patch[p_len + 1U] = 0xEEU;
+    out_len = apply_chunked(patch, p_len + 2U, 32U * 1024U, &err);
+    CHECK((out_len == -1) && (err == HAL_ERR_INVALID_PARAM));
+
+    /* Copy reaching past the end of the source */
+    {
+        uint8_t bad[BOOT_DELTA_HEADER_SIZE + 8U];
+
+        memcpy(bad, patch, BOOT_DELTA_HEADER_SIZE);
+        bad[12] = 0U; bad[13] = 0U; bad[14] = 0x01U; bad[15] = 0x00U;       /* dst_size 256 */
+        bad[BOOT_DELTA_HEADER_SIZE + 0U] = 0x80U;                           /* copy 256 */
+        bad[BOOT_DELTA_HEADER_SIZE + 1U] = 0xFFU;
+        size_t n = put_distance(&bad[BOOT_DELTA_HEADER_SIZE + 2U], IMAGE_SIZE - 128);
+
+        out_len = apply_chunked(bad, BOOT_DELTA_HEADER_SIZE + 2U + n, 256U, &err);
+        CHECK((out_len == -1) && (err == HAL_ERR_INVALID_PARAM));
+
+        n = put_distance(&bad[BOOT_DELTA_HEADER_SIZE + 2U], -1);
+        out_len = apply_chunked(bad, BOOT_DELTA_HEADER_SIZE + 2U + n, 256U, &err);
+        CHECK((out_len == -1) && (err == HAL_ERR_INVALID_PARAM));
+
+        n = put_distance(&bad[BOOT_DELTA_HEADER_SIZE + 2U], IMAGE_SIZE - 256);
+        out_len = apply_chunked(bad, BOOT_DELTA_HEADER_SIZE + 2U + n, 256U, &err);
+        CHECK((out_len == 256L) && (memcmp(out, &src[IMAGE_SIZE - 256U], 256U) == 0) && boot_delta_is_done(&dt));
+    }
+}
+
+int main(void)
+{
+    if (hal_flash_init() != HAL_ERR_SUCCESS) {
+        printf("hal_flash_init failed\n");
+        return 1;
+    }
+
+    make_code(src, IMAGE_SIZE);
+    memcpy(c40_sim_ptr(SRC_ADDR), src, IMAGE_SIZE);
+
+    test_round_trip();
+    test_rejected_patches();
+
+    if (fails != 0) {
+        printf("%d check(s) failed\n", fails);
+        return 1;
+    }
+    printf("all delta tests passed\n");
+    return 0;
+}
@@ -0,0 +1,38 @@
+#!/usr/bin/env bash
+# Build and run the host test of the delta patch applier (src/boot_delta.c
+# reading the installed image from the simulated C40 backend in
+# tools/c40_sim, patches made by the diff generator in tools/delta), and
+# build the delta_diff tool next to it.
+#
+# Usage:
+#   bash tools/delta_test.sh
+#   CC=clang bash tools/delta_test.sh
+
+set -euo pipefail
+
+TOOLS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+EASYBOOT_ROOT="$(cd "$TOOLS_DIR/.." && pwd)"
+OUT_DIR="$EASYBOOT_ROOT/build/host"
+CC="${CC:-gcc}"
+
+mkdir -p "$OUT_DIR"
+
+"$CC" -O2 -g -Wall -Wextra \
+    -I"$TOOLS_DIR/delta" -I"$EASYBOOT_ROOT/include" \
+    "$TOOLS_DIR/delta/delta_diff.c" \
+    "$TOOLS_DIR/delta/delta_encode.c" \
+    "$EASYBOOT_ROOT/src/hal_crc.c" -DHAL_CRC_USE_HARDWARE=0 \
+    -o "$OUT_DIR/delta_diff"
+
+# tools/c40_sim goes first so its C40_Ip.h replaces the RTD one
+"$CC" -O2 -g -Wall -Wextra \
+    -I"$TOOLS_DIR/c40_sim" -I"$TOOLS_DIR/delta" -I"$EASYBOOT_ROOT/include" \
+    "$TOOLS_DIR/delta_test.c" \
+    "$TOOLS_DIR/delta/delta_encode.c" \
+    "$EASYBOOT_ROOT/src/boot_delta.c" \
+    "$EASYBOOT_ROOT/src/hal_flash.c" \
+    "$EASYBOOT_ROOT/src/hal_crc.c" -DHAL_CRC_USE_HARDWARE=0 \
+    "$TOOLS_DIR/c40_sim/c40_sim.c" \
+    -o "$OUT_DIR/delta_test"
+
+"$OUT_DIR/delta_test"
@@ -0,0 +1,280 @@
+/**
+ * @file flash_engine_test.c
+ * @brief Host test for the asynchronous flash job engine in src/hal_flash.c
+ *
+ * @details
+ * Runs hal_flash.c against the simulated C40 backend in tools/c40_sim with
+ * a per-sector erase latency, and checks that erase/program/verify jobs
+ * complete in order through callbacks while the "main loop" keeps running.
+ * Build and run with tools/flash_engine_test.sh.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "hal_crc.h"
+#include "hal_flash.h"
+#include "hal_error.h"
+#include "c40_sim.h"
+
+#define TEST_ADDR           (0x00440000U)
+#define TEST_SECTORS        (4U)
+#define TEST_DATA_SIZE      (3000U)     /* Not a multiple of the program chunk */
+#define TEST_ERASE_US       (2000U)
+#define TEST_WRITE_US       (20U)
+
+static uint8_t pattern[TEST_DATA_SIZE];
+static uint32_t completed[4];
+static uint32_t completed_count;
+static int fails;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("  FAILED line %d: %s\n", __LINE__, #cond); \
+            fails++; \
+        } \
+    } while (0)
+
+static void on_complete(hal_flash_job_t *job, int32_t result)
+{
+    if (completed_count < 4U) {
+        completed[completed_count++] = (uint32_t)(uintptr_t)job->user;
+    }
+    CHECK(result == HAL_ERR_SUCCESS);
+}
+
+/* Run the engine until idle, counting main loop iterations */
+static uint32_t run_until_idle(void)
+{
+    uint32_t loops = 0U;
+
+    while (!hal_flash_is_idle()) {
+        hal_flash_main_function();
+        loops++;
+    }
+    return loops;
+}
+
+static void test_queue_runs_in_order(void)
+{
+    hal_flash_job_t erase = {0};
+    hal_flash_job_t program = {0};
+    hal_flash_job_t verify = {0};
+    uint32_t loops;
+
+    printf("async erase/program/verify\n");
+
+    erase.type = HAL_FLASH_JOB_ERASE;
+    erase.addr = TEST_ADDR;
+    erase.size = TEST_SECTORS * HAL_FLASH_SECTOR_SIZE;
+    erase.complete = on_complete;
+    erase.user = (void *)1;
+
+    program.type = HAL_FLASH_JOB_PROGRAM;
+    program.addr = TEST_ADDR + 4U;      /* Unaligned to the program chunk */
+    program.size = TEST_DATA_SIZE;
+    program.data = pattern;
+    program.complete = on_complete;
+    program.user = (void *)2;
+
+    verify = program;
+    verify.type = HAL_FLASH_JOB_VERIFY;
+    verify.user = (void *)3;
+
+    CHECK(hal_flash_submit(&erase) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_submit(&program) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_submit(&verify) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_submit(&erase) == HAL_ERR_RESOURCE_BUSY);
+    CHECK(hal_flash_job_status(&erase) == HAL_ERR_RESOURCE_BUSY);
+
+    loops = run_until_idle();
+
+    CHECK(completed_count == 3U);
+    CHECK(completed[0] == 1U && completed[1] == 2U && completed[2] == 3U);
+    CHECK(hal_flash_job_status(&verify) == HAL_ERR_SUCCESS);
+    CHECK(c40_sim_erase_count() == TEST_SECTORS);
+    CHECK(memcmp(c40_sim_ptr(program.addr), pattern, TEST_DATA_SIZE) == 0);
+    CHECK(*c40_sim_ptr(TEST_ADDR) == 0xFFU);
+
+    /* The engine must have yielded while the controller was busy */
+    CHECK(c40_sim_busy_polls() > 0U);
+    printf("  %u main loop iterations, %u busy polls, %u erases, %u writes\n",
+           loops, c40_sim_busy_polls(), c40_sim_erase_count(), c40_sim_write_count());
+}
+
+static void test_verify_detects_mismatch(void)
+{
+    hal_flash_job_t verify = {0};
+
+    printf("verify mismatch\n");
+
+    *c40_sim_ptr(TEST_ADDR + 4U + 1000U) ^= 0x01U;
+
+    verify.type = HAL_FLASH_JOB_VERIFY;
+    verify.addr = TEST_ADDR + 4U;
+    verify.size = TEST_DATA_SIZE;
+    verify.data = pattern;
+
+    CHECK(hal_flash_submit(&verify) == HAL_ERR_SUCCESS);
+    run_until_idle();
+    CHECK(hal_flash_job_status(&verify) == HAL_ERR_FLASH_VERIFY_FAILED);
+}
+
+static void test_bad_parameters(void)
+{
+    hal_flash_job_t job = {0};
+
+    printf("parameter checks\n");
+
+    job.type = HAL_FLASH_JOB_ERASE;
+    job.addr = TEST_ADDR + 4U;
+    job.size = HAL_FLASH_SECTOR_SIZE;
+    CHECK(hal_flash_submit(&job) == HAL_ERR_INVALID_PARAM);
+
+    job.type = HAL_FLASH_JOB_PROGRAM;
+    job.addr = TEST_ADDR;
+    job.data = NULL;
+    CHECK(hal_flash_submit(&job) == HAL_ERR_INVALID_PARAM);
+
+    job.data = pattern;
+    job.addr = 0x0U;
+    CHECK(hal_flash_submit(&job) == HAL_ERR_INVALID_PARAM);
+}
+
+static void test_blocking_wrappers(void)
+{
+    uint8_t readback[64];
+
+    printf("blocking hal_flash_write/read\n");
+
+    CHECK(hal_flash_write(0x10004000U, pattern, sizeof(readback)) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_read(0x10004000U, readback, sizeof(readback)) == HAL_ERR_SUCCESS);
+    CHECK(memcmp(readback, pattern, sizeof(readback)) == 0);
+    CHECK(hal_flash_is_idle());
+
+    /* Any address inside the sector erases the whole sector */
+    CHECK(hal_flash_erase_sector(0x10004000U + 16U, 1U) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_blank_check(0x10004000U, HAL_FLASH_SECTOR_SIZE) == HAL_ERR_SUCCESS);
+}
+
+static void test_program_without_erase(void)
+{
+    const uint32_t base = 0x10006000U;
+    uint8_t readback[256];
+
+    printf("chunked hal_flash_program and blank check\n");
+
+    CHECK(hal_flash_erase_range(base + 100U, 8U) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_blank_check(base, HAL_FLASH_SECTOR_SIZE) == HAL_ERR_SUCCESS);
+
+    /* Two chunks into the same sector: the second must not destroy the first */
+    CHECK(hal_flash_program(base, pattern, 128U) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_program(base + 128U, pattern + 128U, 128U) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_read(base, readback, sizeof(readback)) == HAL_ERR_SUCCESS);
+    CHECK(memcmp(readback, pattern, sizeof(readback)) == 0);
+
+    CHECK(hal_flash_blank_check(base, 256U) == HAL_ERR_FLASH_VERIFY_FAILED);
+    CHECK(hal_flash_blank_check(base + 256U, HAL_FLASH_SECTOR_SIZE - 256U) == HAL_ERR_SUCCESS);
+
+    /* Programming over programmed cells is rejected */
+    CHECK(hal_flash_program(base, pattern + 1U, 128U) == HAL_ERR_FLASH_WRITE_FAILED);
+}
+
+static void test_erase_ahead(void)
+{
+    hal_flash_job_t erase = {0};
+    const uint32_t base = 0x00460000U;
+
+    printf("erase ahead\n");
+
+    /* 12 bytes straddling a sector boundary cover two sectors */
+    CHECK(hal_flash_erase_ahead(&erase, base + HAL_FLASH_SECTOR_SIZE - 4U, 12U) == HAL_ERR_SUCCESS);
+    CHECK(erase.addr == base && erase.size == 2U * HAL_FLASH_SECTOR_SIZE);
+    run_until_idle();
+    CHECK(hal_flash_job_status(&erase) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_blank_check(base, 2U * HAL_FLASH_SECTOR_SIZE) == HAL_ERR_SUCCESS);
+}
+
+static void test_write_combining(void)
+{
+    static const uint32_t pieces[] = { 5U, 13U, 100U, 1U, 256U, 300U, 77U, 3U };
+    const uint32_t base = 0x00470000U + 3U;     /* Unaligned start */
+    hal_flash_wc_t wc;
+    uint32_t writes;
+    uint32_t total = 0U;
+    uint32_t i;
+
+    printf("write combining\n");
+
+    CHECK(hal_flash_erase_range(base - 3U, HAL_FLASH_SECTOR_SIZE) == HAL_ERR_SUCCESS);
+    writes = c40_sim_write_count();
+
+    CHECK(hal_flash_wc_open(&wc, base) == HAL_ERR_SUCCESS);
+    for (i = 0U; i < sizeof(pieces) / sizeof(pieces[0]); i++) {
+        CHECK(hal_flash_wc_write(&wc, pattern + total, pieces[i]) == HAL_ERR_SUCCESS);
+        total += pieces[i];
+    }
+    CHECK(hal_flash_wc_commit(&wc) == HAL_ERR_SUCCESS);
+
+    CHECK(memcmp(c40_sim_ptr(base), pattern, total) == 0);
+    CHECK(*c40_sim_ptr(base - 1U) == 0xFFU && *c40_sim_ptr(base + total) == 0xFFU);
+
+    /* One quad-page write per touched page, no more */
+    writes = c40_sim_write_count() - writes;
+    CHECK(writes == (3U + total + HAL_FLASH_PROGRAM_CHUNK - 1U) / HAL_FLASH_PROGRAM_CHUNK);
+    printf("  %u bytes in %u pieces -> %u page writes\n", total, i, writes);
+}
+
+static void test_verify_policies(void)
+{
+    const uint32_t base = 0x00480000U;
+    const uint32_t span = 2U * HAL_FLASH_SECTOR_SIZE;
+    const uint32_t offset = HAL_FLASH_SECTOR_SIZE - 1024U;     /* Crosses a sector boundary */
+    uint32_t crc;
+
+    printf("verify policies\n");
+
+    CHECK(hal_flash_get_verify_policy() == HAL_FLASH_VERIFY_COMPARE);
+    CHECK(hal_flash_erase_range(base, span) == HAL_ERR_SUCCESS);
+
+    hal_flash_set_verify_policy(HAL_FLASH_VERIFY_SECTOR_CRC);
+    CHECK(hal_flash_program(base + offset, pattern, 2048U) == HAL_ERR_SUCCESS);
+
+    hal_flash_set_verify_policy(HAL_FLASH_VERIFY_DEFERRED);
+    CHECK(hal_flash_program(base + offset + 2048U, pattern + 2048U, 512U) == HAL_ERR_SUCCESS);
+
+    crc = hal_crc32_compute(pattern, 2560U, 0U);
+    CHECK(hal_flash_verify_crc32(base + offset, 2560U, crc) == HAL_ERR_SUCCESS);
+
+    *c40_sim_ptr(base + offset + 2100U) ^= 0x80U;
+    CHECK(hal_flash_verify_crc32(base + offset, 2560U, crc) == HAL_ERR_FLASH_VERIFY_FAILED);
+
+    hal_flash_set_verify_policy(HAL_FLASH_VERIFY_COMPARE);
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    for (i = 0U; i < TEST_DATA_SIZE; i++) {
+        pattern[i] = (uint8_t)(i * 7U + 3U);
+    }
+
+    c40_sim_set_latency(TEST_ERASE_US, TEST_WRITE_US);
+    if (hal_flash_init() != HAL_ERR_SUCCESS) {
+        printf("hal_flash_init failed\n");
+        return 1;
+    }
+
+    test_queue_runs_in_order();
+    test_verify_detects_mismatch();
+    test_bad_parameters();
+    test_blocking_wrappers();
+    test_program_without_erase();
+    test_erase_ahead();
+    test_write_combining();
+    test_verify_policies();
+
+    printf("%s\n", fails ? "Some flash engine tests failed" : "All flash engine tests passed");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+# Build and run the host test of the asynchronous flash engine
+# (src/hal_flash.c on top of the simulated C40 backend in tools/c40_sim,
+# with the software CRC path).
+#
+# Usage:
+#   bash tools/flash_engine_test.sh
+#   CC=clang bash tools/flash_engine_test.sh
+
+set -euo pipefail
+
+TOOLS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+EASYBOOT_ROOT="$(cd "$TOOLS_DIR/.." && pwd)"
+OUT_DIR="$EASYBOOT_ROOT/build/host"
+CC="${CC:-gcc}"
+
+mkdir -p "$OUT_DIR"
+
+# tools/c40_sim goes first so its C40_Ip.h replaces the RTD one
+"$CC" -O1 -g -Wall -Wextra \
+    -I"$TOOLS_DIR/c40_sim" -I"$EASYBOOT_ROOT/include" \
+    "$TOOLS_DIR/flash_engine_test.c" \
+    "$EASYBOOT_ROOT/src/hal_flash.c" \
+    "$EASYBOOT_ROOT/src/hal_crc.c" -DHAL_CRC_USE_HARDWARE=0 \
+    "$TOOLS_DIR/c40_sim/c40_sim.c" \
+    -o "$OUT_DIR/flash_engine_test"
+
+"$OUT_DIR/flash_engine_test"
@@ -0,0 +1,201 @@
+/**
+ * @file log_ring_test.c
+ * @brief Host test for the background log ring in src/osal_log.c
+ *
+ * @details
+ * Runs on src/hal_uart.c over the simulated LPUART in tools/lpuart_sim, which
+ * finishes a transfer when its status is polled, then checks that everything logged comes
+ * out in order across ring wrap-around, that messages which do not fit are
+ * dropped whole and counted, that a producer running from the completion
+ * callback ("interrupt" context) is handled, that osal_log_flush()
+ * drains the ring, that an LPUART interrupt taken while a kick starts the
+ * next transfer does not retire it early, and that the level macros filter
+ * and format. Build and run with tools/log_ring_test.sh.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "hal_uart.h"
+#include "hal_error.h"
+#include "osal_log.h"
+#include "lpuart_sim.h"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("  FAILED line %d: %s\n", __LINE__, #cond); \
+            fails++; \
+        } \
+    } while (0)
+
+HAL_UART lpuart6 = { HAL_UART_6, 0U };
+
+static int fails;
+static char wire[4 * LOG_RING_SIZE];    /* What the fake UART has sent */
+static size_t wire_len;
+static const char *isr_msg;             /* Logged from the completion callback once */
+
+/*******************************************************************************
+ * Simulated UART output / osal_utils
+ ******************************************************************************/
+
+static void wire_sink(const uint8_t *data, size_t size)
+{
+    memcpy(&wire[wire_len], data, size);
+    wire_len += size;
+
+    if (isr_msg != NULL) {
+        const char *msg = isr_msg;
+
+        isr_msg = NULL;
+        osal_log_puts(msg);
+    }
+}
+
+void osal_utils_delay_us(size_t us)
+{
+    (void)us;
+}
+
+/*******************************************************************************
+ * Tests
+ ******************************************************************************/
+
+static void drain(void)
+{
+    CHECK(osal_log_flush(10U) == 0);
+}
+
+static void test_order_and_wrap(void)
+{
+    char expect[4 * LOG_RING_SIZE];
+    char line[64];
+    size_t expect_len = 0U;
+    uint32_t i;
+
+    printf("order and wrap-around\n");
+    wire_len = 0U;
+    for (i = 0U; i < 400U; i++) {
+        int n = snprintf(line, sizeof(line), "line %u: the quick brown fox\r\n", (unsigned)i);
+
+        osal_log_puts(line);
+        memcpy(&expect[expect_len], line, (size_t)n);
+        expect_len += (size_t)n;
+        if ((i % 7U) == 0U) {
+            osal_log_process();
+            (void)hal_uart_poll_transmit(&lpuart6);
+        }
+        if (expect_len > 3U * LOG_RING_SIZE) {
+            break;
+        }
+    }
+    drain();
+    CHECK(wire_len == expect_len);
+    CHECK(memcmp(wire, expect, expect_len) == 0);
+    CHECK(osal_log_get_dropped() == 0U);
+}
+
+static void test_drop_when_full(void)
+{
+    char line[200];
+    uint32_t before = osal_log_get_dropped();
+    uint32_t logged = 0U;
+
+    printf("drop counting\n");
+    memset(line, 'x', sizeof(line) - 3U);
+    line[sizeof(line) - 3U] = '\r';
+    line[sizeof(line) - 2U] = '\n';
+    line[sizeof(line) - 1U] = '\0';
+
+    wire_len = 0U;
+    lpuart_sim_set_stalled(true);
+    while (osal_log_get_dropped() == before) {
+        osal_log_puts(line);
+        logged++;
+    }
+    /* Room for a short message is still left after the 199-byte one failed */
+    osal_log_puts("ok\r\n");
+    CHECK(osal_log_get_dropped() == before + 1U);
+    CHECK(osal_log_flush(1U) == -1);
+
+    lpuart_sim_set_stalled(false);
+    drain();
+    CHECK(wire_len == (size_t)(logged - 1U) * (sizeof(line) - 1U) + 4U);
+    CHECK(memcmp(&wire[wire_len - 4U], "ok\r\n", 4U) == 0);
+}
+
+static void test_isr_producer(void)
+{
+    printf("producer in completion context\n");
+    wire_len = 0U;
+    isr_msg = "[isr]\r\n";
+    osal_log_puts("[thread]\r\n");
+    drain();
+    CHECK(wire_len == 17U);
+    CHECK(memcmp(wire, "[thread]\r\n[isr]\r\n", 17U) == 0);
+}
+
+static void test_uart_not_ready(void)
+{
+    printf("retry after a refused transfer\n");
+    wire_len = 0U;
+    /* Someone else owns the UART */
+    CHECK(hal_uart_transmit_it(&lpuart6, (uint8_t *)"ext", 3U) == HAL_ERR_SUCCESS);
+    osal_log_puts("late\r\n");
+    drain();
+    CHECK(wire_len == 9U);
+    CHECK(memcmp(wire, "extlate\r\n", 9U) == 0);
+}
+
+static void test_irq_during_kick(void)
+{
+    printf("uart interrupt while a kick starts a transfer\n");
+    wire_len = 0U;
+    osal_log_puts("first\r\n");
+    drain();
+
+    /* The last transfer's status still reads SUCCESS when the irq comes in */
+    lpuart_sim_irq_at_next_send();
+    osal_log_puts("second\r\n");
+    osal_log_puts("third\r\n");
+    CHECK(hal_uart_poll_transmit(&lpuart6) == HAL_ERR_SUCCESS);
+    drain();
+    CHECK(wire_len == 22U);
+    CHECK(memcmp(wire, "first\r\nsecond\r\nthird\r\n", 22U) == 0);
+}
+
+static void test_levels(void)
+{
+    printf("log levels\n");
+    wire_len = 0U;
+    osal_log_set_level(OSAL_LOG_LEVEL_WARN);
+    osal_log_info("hidden %d\r\n", 1);
+    osal_log_debug("hidden %d\r\n", 2);
+    osal_log_warn("warn %d\r\n", 3);
+    osal_log_error("error %s\r\n", "four");
+    drain();
+    CHECK(wire_len == 20U);
+    CHECK(memcmp(wire, "warn 3\r\nerror four\r\n", 20U) == 0);
+
+    /* Cannot go above the compile-time threshold */
+    osal_log_set_level(OSAL_LOG_LEVEL_DEBUG);
+    CHECK(osal_log_get_level() == OSAL_LOG_LEVEL);
+    osal_log_set_level(OSAL_LOG_LEVEL_INFO);
+}
+
+int main(void)
+{
+    lpuart_sim_set_sink(wire_sink);
+    CHECK(hal_uart_init(&lpuart6) == HAL_ERR_SUCCESS);
+
+    test_order_and_wrap();
+    test_drop_when_full();
+    test_isr_producer();
+    test_uart_not_ready();
+    test_irq_during_kick();
+    test_levels();
+
+    printf("%u transfers, %s\n", (unsigned)lpuart_sim_transfers(), fails ? "FAILED" : "all log ring tests passed");
+    return fails ? 1 : 0;
+}
@@ -0,0 +1,28 @@
+#!/usr/bin/env bash
+# Build and run the host test of the background log ring
+# (src/osal_log.c and src/hal_uart.c on the simulated LPUART in tools/lpuart_sim).
+#
+# Usage:
+#   bash tools/log_ring_test.sh
+#   CC=clang bash tools/log_ring_test.sh
+
+set -euo pipefail
+
+TOOLS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+EASYBOOT_ROOT="$(cd "$TOOLS_DIR/.." && pwd)"
+OUT_DIR="$EASYBOOT_ROOT/build/host"
+CC="${CC:-gcc}"
+
+mkdir -p "$OUT_DIR"
+
+# The simulator directory goes first so its headers replace the RTD ones.
+"$CC" -O1 -g -Wall -Wextra -DOSAL_UTILS_HOST_IRQ \
+    -I"$TOOLS_DIR/lpuart_sim" \
+    -I"$EASYBOOT_ROOT/include" \
+    "$TOOLS_DIR/log_ring_test.c" \
+    "$EASYBOOT_ROOT/src/osal_log.c" \
+    "$EASYBOOT_ROOT/src/hal_uart.c" \
+    "$TOOLS_DIR/lpuart_sim/lpuart_sim.c" \
+    -o "$OUT_DIR/log_ring_test"
+
+"$OUT_DIR/log_ring_test"
@@ -0,0 +1,37 @@
+/**
+ * @file IntCtrl_Ip.h
+ * @brief Host stand-in for the NXP RTD interrupt controller driver
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * The installed handler runs when the simulator raises the LPUART interrupt
+ * and the simulated PRIMASK is clear, see lpuart_sim.h.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial simulated backend
+ */
+
+#ifndef INTCTRL_IP_H
+#define INTCTRL_IP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef int32_t IRQn_Type;
+typedef void (*IntCtrl_Ip_IrqHandlerType)(void);
+
+void IntCtrl_Ip_InstallHandler(IRQn_Type eIrqNumber, IntCtrl_Ip_IrqHandlerType pfNewHandler,
+                               IntCtrl_Ip_IrqHandlerType *pfOldHandler);
+void IntCtrl_Ip_EnableIrq(IRQn_Type eIrqNumber);
+void IntCtrl_Ip_DisableIrq(IRQn_Type eIrqNumber);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INTCTRL_IP_H */
@@ -0,0 +1,61 @@
+/**
+ * @file Lpuart_Uart_Ip.h
+ * @brief Host stand-in for the NXP RTD Lpuart_Uart_Ip driver
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * Declares the subset of the Lpuart_Uart_Ip API used by src/hal_uart.c so the
+ * UART HAL can be built and tested on the host. The implementation in
+ * lpuart_sim.c hands sent bytes to a sink and models the LPUART interrupt;
+ * see lpuart_sim.h for the simulator controls. Put this directory first on
+ * the include path; never build it into the target image.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial simulated backend
+ */
+
+#ifndef LPUART_UART_IP_H
+#define LPUART_UART_IP_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum
+{
+    LPUART_UART_IP_STATUS_SUCCESS = 0,
+    LPUART_UART_IP_STATUS_ERROR,
+    LPUART_UART_IP_STATUS_BUSY,
+    LPUART_UART_IP_STATUS_TIMEOUT,
+    LPUART_UART_IP_STATUS_TX_UNDERRUN,
+    LPUART_UART_IP_STATUS_RX_OVERRUN,
+    LPUART_UART_IP_STATUS_ABORTED,
+} Lpuart_Uart_Ip_StatusType;
+
+typedef struct
+{
+    uint32_t BaudRate;
+} Lpuart_Uart_Ip_UserConfigType;
+
+extern const Lpuart_Uart_Ip_UserConfigType Lpuart_Uart_Ip_xHwConfigPB_6;
+
+void Lpuart_Uart_Ip_Init(const uint8_t Instance, const Lpuart_Uart_Ip_UserConfigType *UserConfig);
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_Deinit(const uint8_t Instance);
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_SyncSend(const uint8_t Instance, const uint8_t *TxBuff,
+                                                  const uint32_t TxSize, const uint32_t Timeout);
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_AsyncSend(const uint8_t Instance, const uint8_t *TxBuff,
+                                                   const uint32_t TxSize);
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_GetTransmitStatus(const uint8_t Instance, uint32_t *BytesRemaining);
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_AsyncReceive(const uint8_t Instance, uint8_t *RxBuff,
+                                                      const uint32_t RxSize);
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_GetReceiveStatus(const uint8_t Instance, uint32_t *BytesRemaining);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPUART_UART_IP_H */
@@ -0,0 +1,25 @@
+/**
+ * @file Lpuart_Uart_Ip_Irq.h
+ * @brief Host stand-in for the NXP RTD LPUART interrupt handlers
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial simulated backend
+ */
+
+#ifndef LPUART_UART_IP_IRQ_H
+#define LPUART_UART_IP_IRQ_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void LPUART_UART_IP_6_IRQHandler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPUART_UART_IP_IRQ_H */
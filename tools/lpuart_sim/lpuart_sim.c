@@ -0,0 +1,211 @@
+/**
+ * @file lpuart_sim.c
+ * @brief Host-side simulated LPUART6 and PRIMASK
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * An asynchronous transfer finishes the next time its status is polled,
+ * from the interrupt handler or from thread context, unless the simulator
+ * is stalled; the bytes go to the sink at that point. The transmit status
+ * keeps the result of the last transfer until the next one is started, like
+ * the RTD driver. Reception is not simulated.
+ *
+ * @history
+ *  - v1.0.0, 2026-10-17, Initial simulated backend
+ */
+
+#include "Lpuart_Uart_Ip.h"
+#include "Lpuart_Uart_Ip_Irq.h"
+#include "IntCtrl_Ip.h"
+#include "osal_utils.h"
+#include "lpuart_sim.h"
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+
+const Lpuart_Uart_Ip_UserConfigType Lpuart_Uart_Ip_xHwConfigPB_6 = {115200U};
+
+static Lpuart_Uart_Ip_StatusType sim_tx_status = LPUART_UART_IP_STATUS_SUCCESS;
+static const uint8_t *sim_tx_data;
+static uint32_t sim_tx_size;
+static uint32_t sim_transfers;
+static bool sim_stalled;
+static bool sim_irq_at_send;
+static lpuart_sim_sink_t sim_sink;
+
+static IntCtrl_Ip_IrqHandlerType sim_handler;
+static bool sim_irq_enabled;
+static bool sim_irq_pending;
+static bool sim_in_isr;
+static uint32_t sim_primask;
+
+/*******************************************************************************
+ * Simulated interrupts
+ ******************************************************************************/
+
+static void sim_take_irq(void)
+{
+    if (!sim_irq_pending || sim_primask != 0U || sim_in_isr || !sim_irq_enabled || sim_handler == NULL) {
+        return;
+    }
+    sim_irq_pending = false;
+    sim_in_isr = true;
+    sim_handler();
+    sim_in_isr = false;
+}
+
+uint32_t osal_utils_host_irq_save(void)
+{
+    uint32_t primask = sim_primask;
+
+    sim_primask = 1U;
+    return primask;
+}
+
+void osal_utils_host_irq_restore(uint32_t primask)
+{
+    sim_primask = primask;
+    sim_take_irq();
+}
+
+void IntCtrl_Ip_InstallHandler(IRQn_Type eIrqNumber, IntCtrl_Ip_IrqHandlerType pfNewHandler,
+                               IntCtrl_Ip_IrqHandlerType *pfOldHandler)
+{
+    (void)eIrqNumber;
+    if (pfOldHandler != NULL) {
+        *pfOldHandler = sim_handler;
+    }
+    sim_handler = pfNewHandler;
+}
+
+void IntCtrl_Ip_EnableIrq(IRQn_Type eIrqNumber)
+{
+    (void)eIrqNumber;
+    sim_irq_enabled = true;
+    sim_take_irq();
+}
+
+void IntCtrl_Ip_DisableIrq(IRQn_Type eIrqNumber)
+{
+    (void)eIrqNumber;
+    sim_irq_enabled = false;
+}
+
+/*******************************************************************************
+ * Lpuart_Uart_Ip
+ ******************************************************************************/
+
+void Lpuart_Uart_Ip_Init(const uint8_t Instance, const Lpuart_Uart_Ip_UserConfigType *UserConfig)
+{
+    (void)Instance;
+    (void)UserConfig;
+    sim_tx_status = LPUART_UART_IP_STATUS_SUCCESS;
+    sim_tx_data = NULL;
+    sim_tx_size = 0U;
+    sim_transfers = 0U;
+    sim_irq_pending = false;
+}
+
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_Deinit(const uint8_t Instance)
+{
+    (void)Instance;
+    return LPUART_UART_IP_STATUS_SUCCESS;
+}
+
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_SyncSend(const uint8_t Instance, const uint8_t *TxBuff,
+                                                  const uint32_t TxSize, const uint32_t Timeout)
+{
+    (void)Instance;
+    (void)Timeout;
+    if (sim_tx_status == LPUART_UART_IP_STATUS_BUSY) {
+        return LPUART_UART_IP_STATUS_BUSY;
+    }
+    if (sim_sink != NULL) {
+        sim_sink(TxBuff, TxSize);
+    }
+    return LPUART_UART_IP_STATUS_SUCCESS;
+}
+
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_AsyncSend(const uint8_t Instance, const uint8_t *TxBuff,
+                                                   const uint32_t TxSize)
+{
+    (void)Instance;
+    if (sim_irq_at_send) {
+        sim_irq_at_send = false;
+        sim_irq_pending = true;
+        sim_take_irq();
+    }
+    if (sim_tx_status == LPUART_UART_IP_STATUS_BUSY) {
+        return LPUART_UART_IP_STATUS_BUSY;
+    }
+    sim_tx_data = TxBuff;
+    sim_tx_size = TxSize;
+    sim_tx_status = LPUART_UART_IP_STATUS_BUSY;
+    sim_transfers++;
+    return LPUART_UART_IP_STATUS_SUCCESS;
+}
+
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_GetTransmitStatus(const uint8_t Instance, uint32_t *BytesRemaining)
+{
+    (void)Instance;
+    if (sim_tx_status == LPUART_UART_IP_STATUS_BUSY && !sim_stalled) {
+        sim_tx_status = LPUART_UART_IP_STATUS_SUCCESS;
+        if (sim_sink != NULL) {
+            sim_sink(sim_tx_data, sim_tx_size);
+        }
+    }
+    if (BytesRemaining != NULL) {
+        *BytesRemaining = (sim_tx_status == LPUART_UART_IP_STATUS_BUSY) ? sim_tx_size : 0U;
+    }
+    return sim_tx_status;
+}
+
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_AsyncReceive(const uint8_t Instance, uint8_t *RxBuff,
+                                                      const uint32_t RxSize)
+{
+    (void)Instance;
+    (void)RxBuff;
+    (void)RxSize;
+    return LPUART_UART_IP_STATUS_ERROR;
+}
+
+Lpuart_Uart_Ip_StatusType Lpuart_Uart_Ip_GetReceiveStatus(const uint8_t Instance, uint32_t *BytesRemaining)
+{
+    (void)Instance;
+    if (BytesRemaining != NULL) {
+        *BytesRemaining = 0U;
+    }
+    return LPUART_UART_IP_STATUS_SUCCESS;
+}
+
+void LPUART_UART_IP_6_IRQHandler(void)
+{
+    /* The transfer state is advanced when its status is polled */
+}
+
+/*******************************************************************************
+ * Simulator controls
+ ******************************************************************************/
+
+void lpuart_sim_set_sink(lpuart_sim_sink_t sink)
+{
+    sim_sink = sink;
+}
+
+void lpuart_sim_set_stalled(bool stalled)
+{
+    sim_stalled = stalled;
+}
+
+void lpuart_sim_irq_at_next_send(void)
+{
+    sim_irq_at_send = true;
+}
+
+uint32_t lpuart_sim_transfers(void)
+{
+    return sim_transfers;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file lpuart_sim.h
+ * @brief Controls for the host-side simulated LPUART and interrupt masking
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * Build with -DOSAL_UTILS_HOST_IRQ so osal_utils_irq_save()/restore() drive
+ * the simulated PRIMASK. A raised LPUART interrupt runs the installed handler
+ * as soon as PRIMASK is clear, as the NVIC would.
+ */
+
+#ifndef LPUART_SIM_H
+#define LPUART_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "Lpuart_Uart_Ip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Receives every transfer when it finishes, in interrupt context
+ */
+typedef void (*lpuart_sim_sink_t)(const uint8_t *data, size_t size);
+
+void lpuart_sim_set_sink(lpuart_sim_sink_t sink);
+
+/**
+ * @brief While set, an asynchronous transfer never finishes
+ */
+void lpuart_sim_set_stalled(bool stalled);
+
+/**
+ * @brief Raise the LPUART interrupt when the next AsyncSend is entered
+ *
+ * @details
+ * Models an RX interrupt, or the tail of the previous transfer, arriving
+ * while the caller sets up the next transfer. It is taken at once unless
+ * PRIMASK is set.
+ */
+void lpuart_sim_irq_at_next_send(void);
+
+/**
+ * @brief Asynchronous transfers started since Lpuart_Uart_Ip_Init
+ */
+uint32_t lpuart_sim_transfers(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LPUART_SIM_H */
@@ -0,0 +1,62 @@
+/**
+ * @file lzss_compress.c
+ * @brief Compress a binary image for a compressed UDS download
+ *
+ * The output is sent with dataFormatIdentifier 0x10 in RequestDownload, with
+ * memorySize set to the size of the uncompressed image.
+ *
+ * Usage: lzss_compress <image.bin> <image.lzss>
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "lzss_encode.h"
+
+int main(int argc, char **argv)
+{
+    FILE *f;
+    long size;
+    uint8_t *in;
+    uint8_t *out;
+    size_t out_len;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <image.bin> <image.lzss>\n", argv[0]);
+        return 2;
+    }
+
+    f = fopen(argv[1], "rb");
+    if (f == NULL) {
+        perror(argv[1]);
+        return 1;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    in = malloc((size_t)size + 1U);
+    out = malloc(LZSS_ENCODE_BOUND((size_t)size) + 1U);
+    if ((in == NULL) || (out == NULL) || (fread(in, 1, (size_t)size, f) != (size_t)size)) {
+        fprintf(stderr, "%s: read failed\n", argv[1]);
+        return 1;
+    }
+    fclose(f);
+
+    out_len = lzss_encode(in, (size_t)size, out);
+
+    f = fopen(argv[2], "wb");
+    if ((f == NULL) || (fwrite(out, 1, out_len, f) != out_len) || (fclose(f) != 0)) {
+        perror(argv[2]);
+        return 1;
+    }
+
+    printf("%s: %ld -> %zu bytes (%.1f%%)\n", argv[1], size, out_len,
+           (size != 0) ? (100.0 * (double)out_len / (double)size) : 0.0);
+
+    free(in);
+    free(out);
+
+    return 0;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file lzss_encode.c
+ * @brief Host-side LZSS compressor matching src/boot_lzss.c
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "lzss_encode.h"
+#include "boot_lzss.h"
+
+/* A copy costs 1 + W + L = 16 bits, two literals 18 */
+#define MIN_MATCH       (2U)
+#define HASH_SIZE       (1UL << 16)
+#define MAX_CHAIN       (256U)
+#define NO_POS          ((size_t)-1)
+
+typedef struct
+{
+    uint8_t *out;
+    size_t len;
+    uint8_t acc;
+    uint8_t acc_bits;
+} bit_writer_t;
+
+static void put_bits(bit_writer_t *bw, uint32_t value, uint8_t n)
+{
+    while (n-- > 0U) {
+        bw->acc = (uint8_t)((bw->acc << 1) | ((value >> n) & 1U));
+        if (++bw->acc_bits == 8U) {
+            bw->out[bw->len++] = bw->acc;
+            bw->acc = 0U;
+            bw->acc_bits = 0U;
+        }
+    }
+}
+
+static uint32_t hash2(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+size_t lzss_encode(const uint8_t *in, size_t len, uint8_t *out)
+{
+    bit_writer_t bw = { out, 0U, 0U, 0U };
+    size_t *head = malloc(HASH_SIZE * sizeof(size_t));
+    size_t *prev = malloc((len + 1U) * sizeof(size_t));
+    size_t i = 0U;
+
+    if ((head == NULL) || (prev == NULL)) {
+        abort();
+    }
+    for (size_t h = 0U; h < HASH_SIZE; h++) {
+        head[h] = NO_POS;
+    }
+
+    while (i < len) {
+        size_t best_len = 0U;
+        size_t best_dist = 0U;
+
+        if ((i + MIN_MATCH) <= len) {
+            size_t max_len = len - i;
+            size_t cand = head[hash2(&in[i])];
+            uint32_t chain = 0U;
+
+            if (max_len > BOOT_LZSS_MAX_COUNT) {
+                max_len = BOOT_LZSS_MAX_COUNT;
+            }
+            while ((cand != NO_POS) && ((i - cand) <= BOOT_LZSS_WINDOW_SIZE) && (chain++ < MAX_CHAIN)) {
+                size_t n = 0U;
+
+                while ((n < max_len) && (in[cand + n] == in[i + n])) {
+                    n++;
+                }
+                if (n > best_len) {
+                    best_len = n;
+                    best_dist = i - cand;
+                    if (n == max_len) {
+                        break;
+                    }
+                }
+                cand = prev[cand];
+            }
+        }
+
+        if (best_len < MIN_MATCH) {
+            best_len = 1U;
+            put_bits(&bw, 1U, 1U);
+            put_bits(&bw, in[i], 8U);
+        } else {
+            put_bits(&bw, 0U, 1U);
+            put_bits(&bw, (uint32_t)(best_dist - 1U), BOOT_LZSS_WINDOW_BITS);
+            put_bits(&bw, (uint32_t)(best_len - 1U), BOOT_LZSS_COUNT_BITS);
+        }
+
+        for (size_t end = i + best_len; i < end; i++) {
+            if ((i + MIN_MATCH) <= len) {
+                uint32_t h = hash2(&in[i]);
+
+                prev[i] = head[h];
+                head[h] = i;
+            }
+        }
+    }
+
+    if (bw.acc_bits != 0U) {
+        put_bits(&bw, 0U, (uint8_t)(8U - bw.acc_bits));
+    }
+
+    free(head);
+    free(prev);
+
+    return bw.len;
+}
@@ -0,0 +1,39 @@
+/**
+ * @file lzss_encode.h
+ * @brief Host-side LZSS compressor matching src/boot_lzss.c
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#ifndef LZSS_ENCODE_H
+#define LZSS_ENCODE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Largest compressed size of n input bytes (all literals, 9 bits each) */
+#define LZSS_ENCODE_BOUND(n)    ((((n) * 9U) + 7U) / 8U)
+
+/**
+ * @brief Compress a whole image
+ *
+ * Greedy matching over hash chains of 2-byte prefixes, with the window and
+ * count limits of include/boot_lzss.h.
+ *
+ * @param in Image
+ * @param len Image size
+ * @param out Compressed stream, at least LZSS_ENCODE_BOUND(len) bytes
+ * @return Compressed size
+ */
+size_t lzss_encode(const uint8_t *in, size_t len, uint8_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LZSS_ENCODE_H */
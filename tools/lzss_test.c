@@ -0,0 +1,276 @@
+/**
+ * @file lzss_test.c
+ * @brief Host round-trip test of the streaming LZSS decompressor in src/boot_lzss.c
+ *
+ * @details
+ * Compresses build/Easy_Boot.elf (when present) and a synthetic image of
+ * the same order of size with tools/lzss, then decodes them feeding the
+ * input and draining the output in random piece sizes, and compares. Also
+ * checks the BOOT_LZSS_MAX_OUTPUT() bound the UDS download relies on and
+ * that a copy before the start of the stream is rejected. Build and run with
+ * tools/lzss_test.sh.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "boot_lzss.h"
+#include "hal_error.h"
+#include "lzss_encode.h"
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("  FAILED line %d: %s\n", __LINE__, #cond); \
+            fails++; \
+        } \
+    } while (0)
+
+#define SYNTH_SIZE  (1536U * 1024U)
+
+static int fails;
+static boot_lzss_t lz;
+static uint32_t rng = 1U;
+
+static uint32_t next_rand(void)
+{
+    rng = rng * 1103515245U + 12345U;
+    return (rng >> 8) & 0xFFFFFFU;
+}
+
+/* Code-like content: repeated instruction patterns, tables, literals, erased gaps */
+static void make_image(uint8_t *img, size_t size)
+{
+    size_t i = 0U;
+
+    while (i < size) {
+        size_t n = 16U + (next_rand() % 512U);
+        uint32_t kind = next_rand() % 4U;
+
+        if (n > (size - i)) {
+            n = size - i;
+        }
+        for (size_t k = 0U; k < n; k++) {
+            switch (kind) {
+            case 0U: img[i + k] = (uint8_t)next_rand(); break;
+            case 1U: img[i + k] = (i >= 1024U) ? img[i + k - 1024U + (next_rand() % 4U)] : 0x5AU; break;
+            case 2U: img[i + k] = (uint8_t)((k & 3U) == 3U ? 0x4BU : (k >> 2)); break;
+            default: img[i + k] = 0xFFU; break;
+            }
+        }
+        i += n;
+    }
+}
+
+/* Decode with random input and output piece sizes, return decoded length or -1 on error */
+static long decode_chunked(const uint8_t *comp, size_t comp_len, uint8_t *out, size_t out_size)
+{
+    const uint8_t *in = comp;
+    uint32_t in_left = 0U;
+    size_t fed = 0U;
+    size_t total = 0U;
+
+    boot_lzss_init(&lz);
+
+    for (;;) {
+        uint32_t n;
+        uint32_t piece = 1U + (next_rand() % 300U);
+        int32_t ret;
+
+        if (in_left == 0U) {
+            if (fed == comp_len) {
+                break;
+            }
+            in_left = 1U + (next_rand() % 4096U);
+            if (in_left > (comp_len - fed)) {
+                in_left = (uint32_t)(comp_len - fed);
+            }
+            fed += in_left;
+        }
+        if (piece > (out_size - total)) {
+            piece = (uint32_t)(out_size - total);
+        }
+        if (piece == 0U) {
+            return -1;
+        }
+        ret = boot_lzss_decode(&lz, &in, &in_left, &out[total], piece, &n);
+        if (ret != HAL_ERR_SUCCESS) {
+            return -1;
+        }
+        total += n;
+    }
+
+    /* Input used up, drain a copy still in progress */
+    while (!boot_lzss_is_idle(&lz)) {
+        uint32_t n;
+        uint32_t none = 0U;
+
+        if ((total == out_size) ||
+            (boot_lzss_decode(&lz, &in, &none, &out[total], (uint32_t)(out_size - total), &n) != HAL_ERR_SUCCESS)) {
+            return -1;
+        }
+        total += n;
+    }
+
+    return (long)total;
+}
+
+static void round_trip(const char *name, const uint8_t *img, size_t size)
+{
+    uint8_t *comp = malloc(LZSS_ENCODE_BOUND(size) + 1U);
+    uint8_t *out = malloc(size + 64U);
+    size_t comp_len;
+    long out_len;
+
+    comp_len = lzss_encode(img, size, comp);
+    printf("  %s: %zu -> %zu bytes (%.1f%%)\n", name, size, comp_len, 100.0 * (double)comp_len / (double)size);
+    CHECK(comp_len <= LZSS_ENCODE_BOUND(size));
+
+    out_len = decode_chunked(comp, comp_len, out, size + 64U);
+    CHECK(out_len == (long)size);
+    CHECK((out_len == (long)size) && (memcmp(out, img, size) == 0));
+    CHECK(lz.out_total == size);
+
+    free(comp);
+    free(out);
+}
+
+static void test_round_trip(void)
+{
+    uint8_t *img;
+    FILE *f;
+
+    printf("round trip\n");
+
+    img = malloc(SYNTH_SIZE);
+    make_image(img, SYNTH_SIZE);
+    round_trip("synthetic image", img, SYNTH_SIZE);
+    free(img);
+
+    f = fopen("build/Easy_Boot.elf", "rb");
+    if (f != NULL) {
+        long size;
+
+        fseek(f, 0, SEEK_END);
+        size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        img = malloc((size_t)size);
+        CHECK(fread(img, 1, (size_t)size, f) == (size_t)size);
+        fclose(f);
+        round_trip("build/Easy_Boot.elf", img, (size_t)size);
+        free(img);
+    } else {
+        printf("  build/Easy_Boot.elf not found, skipped\n");
+    }
+
+    /* Tiny inputs and long runs (overlapping copies) */
+    {
+        uint8_t small[3000];
+
+        round_trip("one byte", (const uint8_t *)"A", 1U);
+        memset(small, 0xFF, sizeof(small));
+        round_trip("0xFF run", small, sizeof(small));
+    }
+}
+
+static void test_output_bound(void)
+{
+    static uint8_t img[64U * 1024U];
+    static uint8_t comp[LZSS_ENCODE_BOUND(sizeof(img))];
+    static uint8_t out[sizeof(img)];
+    const uint8_t *in = comp;
+    size_t comp_len;
+    size_t fed = 0U;
+    size_t total = 0U;
+    uint32_t worst = 0U;
+
+    printf("output bound\n");
+
+    /* All zero compresses to back-to-back full-length copies, the worst case */
+    memset(img, 0, sizeof(img));
+    comp_len = lzss_encode(img, sizeof(img), comp);
+    boot_lzss_init(&lz);
+
+    /* Drain everything each piece of input can produce, as TransferData does */
+    while (fed < comp_len) {
+        uint32_t in_left = 1U + (next_rand() % 40U);
+        uint32_t piece = in_left;
+        uint32_t produced = 0U;
+        uint32_t n;
+
+        if (in_left > (comp_len - fed)) {
+            in_left = (uint32_t)(comp_len - fed);
+            piece = in_left;
+        }
+        fed += in_left;
+        do {
+            CHECK(boot_lzss_decode(&lz, &in, &in_left, &out[total], (uint32_t)(sizeof(out) - total), &n) == HAL_ERR_SUCCESS);
+            total += n;
+            produced += n;
+        } while ((n != 0U) && (total < sizeof(out)));
+        CHECK(produced <= BOOT_LZSS_MAX_OUTPUT(piece));
+        if (produced > worst) {
+            worst = produced;
+        }
+    }
+    CHECK(total == sizeof(img));
+    CHECK(memcmp(out, img, sizeof(img)) == 0);
+    printf("  most output per piece: %u bytes\n", (unsigned)worst);
+}
+
+static void test_corrupt_stream(void)
+{
+    /* Copy with distance 1 as the very first item */
+    static const uint8_t bad_first[] = { 0x00U, 0x00U, 0x00U };
+    /* Literal 'A', then a copy from distance 3 */
+    static const uint8_t bad_later[] = { 0xA0U, 0x80U, 0x10U, 0x00U };
+    /* Literal 'A', then copy distance 1 count 4: "AAAAA" */
+    static const uint8_t good[] = { 0xA0U, 0x80U, 0x01U, 0x80U };
+    const uint8_t *in;
+    uint32_t in_len;
+    uint8_t out[16];
+    uint32_t n;
+
+    printf("corrupt stream\n");
+
+    boot_lzss_init(&lz);
+    in = bad_first;
+    in_len = sizeof(bad_first);
+    CHECK(boot_lzss_decode(&lz, &in, &in_len, out, sizeof(out), &n) == HAL_ERR_INVALID_PARAM);
+
+    boot_lzss_init(&lz);
+    in = bad_later;
+    in_len = sizeof(bad_later);
+    CHECK(boot_lzss_decode(&lz, &in, &in_len, out, sizeof(out), &n) == HAL_ERR_INVALID_PARAM);
+
+    boot_lzss_init(&lz);
+    in = good;
+    in_len = sizeof(good);
+    CHECK(boot_lzss_decode(&lz, &in, &in_len, out, sizeof(out), &n) == HAL_ERR_SUCCESS);
+    CHECK((n == 5U) && (memcmp(out, "AAAAA", 5U) == 0));
+    CHECK(boot_lzss_is_idle(&lz));
+
+    /* Output full in the middle of the copy */
+    boot_lzss_init(&lz);
+    in = good;
+    in_len = sizeof(good);
+    CHECK(boot_lzss_decode(&lz, &in, &in_len, out, 3U, &n) == HAL_ERR_SUCCESS);
+    CHECK((n == 3U) && !boot_lzss_is_idle(&lz));
+    CHECK(boot_lzss_decode(&lz, &in, &in_len, out, sizeof(out), &n) == HAL_ERR_SUCCESS);
+    CHECK((n == 2U) && boot_lzss_is_idle(&lz));
+}
+
+int main(void)
+{
+    test_round_trip();
+    test_output_bound();
+    test_corrupt_stream();
+
+    if (fails != 0) {
+        printf("%d check(s) failed\n", fails);
+        return 1;
+    }
+    printf("all lzss tests passed\n");
+    return 0;
+}
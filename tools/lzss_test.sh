@@ -0,0 +1,34 @@
+#!/usr/bin/env bash
+# Build and run the round-trip test of the streaming LZSS decompressor
+# (src/boot_lzss.c against the host compressor in tools/lzss), and build
+# the lzss_compress tool next to it.
+#
+# Usage:
+#   bash tools/lzss_test.sh
+#   CC=clang bash tools/lzss_test.sh
+
+set -euo pipefail
+
+TOOLS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+EASYBOOT_ROOT="$(cd "$TOOLS_DIR/.." && pwd)"
+OUT_DIR="$EASYBOOT_ROOT/build/host"
+CC="${CC:-gcc}"
+
+mkdir -p "$OUT_DIR"
+
+"$CC" -O2 -g -Wall -Wextra \
+    -I"$TOOLS_DIR/lzss" -I"$EASYBOOT_ROOT/include" \
+    "$TOOLS_DIR/lzss/lzss_compress.c" \
+    "$TOOLS_DIR/lzss/lzss_encode.c" \
+    -o "$OUT_DIR/lzss_compress"
+
+"$CC" -O2 -g -Wall -Wextra \
+    -I"$TOOLS_DIR/lzss" -I"$EASYBOOT_ROOT/include" \
+    "$TOOLS_DIR/lzss_test.c" \
+    "$TOOLS_DIR/lzss/lzss_encode.c" \
+    "$EASYBOOT_ROOT/src/boot_lzss.c" \
+    -o "$OUT_DIR/lzss_test"
+
+# Run from the tree root so the test finds build/Easy_Boot.elf
+cd "$EASYBOOT_ROOT"
+"$OUT_DIR/lzss_test"
@@ -0,0 +1,1140 @@
+/**
+ * @file uds_download_test.c
+ * @brief Host test for the UDS download services in external/UDS_stack/UDS
+ *
+ * @details
+ * Runs uds_app.c/uds_app_cfg.c through the harness in tools/uds_sim on top
+ * of hal_flash.c and the simulated C40 backend, downloads an image into the
+ * inactive slot with 0x34/0x36/0x37 and compares the flash content. Also
+ * checks that TransferData is acknowledged while earlier blocks still program
+ * (0x78 only once every pipeline segment is busy), and the negative
+ * responses for out-of-range requests, wrong block sequence counters,
+ * overruns and out-of-order services. The EraseMemory routine is run in
+ * the configured mode (UDS_ERASE_AHEAD): erase-ahead must acknowledge
+ * TransferData while the range is still being erased, erase-first must
+ * answer 0x78 until the whole range is blank. CheckMemory and
+ * CheckProgrammingDependencies are checked against the CRC folded in during
+ * TransferData, a deferred-verify read-back and a corrupted slot. A
+ * compressed download (dataFormatIdentifier 0x10, tools/lzss) of the start
+ * of build/Easy_Boot.elf must land in flash decompressed, and corrupt or
+ * overlong streams must be refused. A delta download (dataFormatIdentifier
+ * 0x20, tools/delta) must rebuild the new image in the inactive slot from
+ * the one in the active slot, pausing mid-block while the flash catches
+ * up, and refuse a patch made for another installed image; cut short by a
+ * reset, it must resume (0x30) from the progress DID 0xFD20 reports. Flash read
+ * back with ReadMemoryByAddress (0x23) and RequestUpload (0x35/0x36/0x37)
+ * must match what was downloaded, at any alignment. ReadDataByIdentifier
+ * (0x22) must answer several DIDs at once from the active slot's metadata,
+ * and a fingerprint written with WriteDataByIdentifier (0x2E) must read
+ * back from data flash.
+ * Build and run with tools/uds_download_test.sh.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hal_flash.h"
+#include "hal_error.h"
+#include "c40_sim.h"
+#include "uds_sim.h"
+#include "boot_ctrl.h"
+#include "boot_version.h"
+#include "hal_crc.h"
+#include "lzss_encode.h"
+#include "delta_encode.h"
+
+#define TEST_IMAGE_SIZE     (20000U)    /* Not a multiple of the block or page size */
+#define PIPE_IMAGE_SIZE     (60000U)    /* Several times the pipeline buffers */
+#define PIPE_WRITE_US       (200U)      /* Per 128 byte page, slower than the test feeds blocks */
+#define SEGMENT_SIZE        (HAL_FLASH_SECTOR_SIZE)
+#define MAX_IDLE_CALLS      (1000000U)
+#define LZSS_IMAGE_SIZE     (512U * 1024U)
+#define DELTA_IMAGE_SIZE    (256U * 1024U)
+
+static uint8_t image[PIPE_IMAGE_SIZE];
+static int fails;
+
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("  FAILED line %d: %s\n", __LINE__, #cond); \
+            fails++; \
+        } \
+    } while (0)
+
+/*******************************************************************************
+ * Helpers
+ ******************************************************************************/
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static bool is_nrc(const uds_sim_rsp_t *rsp, uint8_t sid, uint8_t nrc)
+{
+    return rsp != NULL && rsp->len == 3U && rsp->data[0] == 0x7FU &&
+           rsp->data[1] == sid && rsp->data[2] == nrc;
+}
+
+static const uds_sim_rsp_t *request_download_format(uint8_t format, uint32_t addr, uint32_t size)
+{
+    uint8_t req[11] = {0x34U, 0x00U, 0x44U};
+
+    req[1] = format;
+    put_u32(&req[3], addr);
+    put_u32(&req[7], size);
+    return uds_sim_request(req, sizeof(req));
+}
+
+static const uds_sim_rsp_t *request_download(uint32_t addr, uint32_t size)
+{
+    return request_download_format(0x00U, addr, size);
+}
+
+static const uds_sim_rsp_t *transfer_data(uint8_t bsc, const uint8_t *data, uint32_t len)
+{
+    uint8_t req[UDS_MSG_BUF_LEN];
+
+    req[0] = 0x36U;
+    req[1] = bsc;
+    memcpy(&req[2], data, len);
+    return uds_sim_request(req, len + 2U);
+}
+
+static const uds_sim_rsp_t *transfer_exit(void)
+{
+    const uint8_t req[1] = {0x37U};
+
+    return uds_sim_request(req, sizeof(req));
+}
+
+static const uds_sim_rsp_t *read_did(const uint16_t *dids, uint32_t num)
+{
+    uint8_t req[1U + 2U * 64U] = {0x22U};
+    uint32_t i;
+
+    for (i = 0U; i < num; i++) {
+        req[1U + 2U * i] = (uint8_t)(dids[i] >> 8);
+        req[2U + 2U * i] = (uint8_t)dids[i];
+    }
+    return uds_sim_request(req, 1U + 2U * num);
+}
+
+static bool is_pending(const uds_sim_rsp_t *rsp, uint8_t sid)
+{
+    return is_nrc(rsp, sid, RCRRP);
+}
+
+static const uds_sim_rsp_t *erase_memory(uint32_t addr, uint32_t size)
+{
+    uint8_t req[13] = {0x31U, 0x01U, 0xFFU, 0x00U, 0x44U};
+
+    put_u32(&req[5], addr);
+    put_u32(&req[9], size);
+    return uds_sim_request(req, sizeof(req));
+}
+
+static bool is_routine_status(const uds_sim_rsp_t *rsp, uint8_t id_hi, uint8_t id_lo, uint8_t status)
+{
+    return rsp != NULL && rsp->len == 5U && rsp->data[0] == 0x71U && rsp->data[1] == 0x01U &&
+           rsp->data[2] == id_hi && rsp->data[3] == id_lo && rsp->data[4] == status;
+}
+
+static bool is_erase_ok(const uds_sim_rsp_t *rsp)
+{
+    return is_routine_status(rsp, 0xFFU, 0x00U, 0x00U);
+}
+
+static const uds_sim_rsp_t *check_memory(uint32_t crc)
+{
+    uint8_t req[8] = {0x31U, 0x01U, 0x02U, 0x02U};
+
+    put_u32(&req[4], crc);
+    return uds_sim_request(req, sizeof(req));
+}
+
+static const uds_sim_rsp_t *check_dependency(void)
+{
+    const uint8_t req[4] = {0x31U, 0x01U, 0xFFU, 0x01U};
+
+    return uds_sim_request(req, sizeof(req));
+}
+
+/* Runs the UDS main function until it writes a response */
+static const uds_sim_rsp_t *wait_response(void)
+{
+    const uds_sim_rsp_t *rsp = NULL;
+    uint32_t calls = 0U;
+
+    while (rsp == NULL && calls < MAX_IDLE_CALLS) {
+        rsp = uds_sim_idle();
+        calls++;
+    }
+    return rsp;
+}
+
+/* Final response of a request that may have been answered with 0x78 first */
+static const uds_sim_rsp_t *final_response(const uds_sim_rsp_t *rsp, uint8_t sid)
+{
+    while (is_pending(rsp, sid)) {
+        rsp = wait_response();
+    }
+    return rsp;
+}
+
+/* Downloads one range with 0x34/0x36/0x37, true if every response was positive */
+static bool download(uint32_t addr, const uint8_t *data, uint32_t size)
+{
+    const uds_sim_rsp_t *rsp;
+    uint32_t block_len = UDS_MAX_BLOCK_LEN - 2U;
+    uint32_t offset = 0U;
+    uint8_t bsc = 1U;
+
+    rsp = request_download(addr, size);
+    if (rsp == NULL || rsp->data[0] != 0x74U) {
+        return false;
+    }
+    while (offset < size) {
+        uint32_t n = (size - offset > block_len) ? block_len : size - offset;
+
+        rsp = final_response(transfer_data(bsc, &data[offset], n), 0x36U);
+        if (rsp == NULL || rsp->data[0] != 0x76U) {
+            return false;
+        }
+        offset += n;
+        bsc++;
+    }
+    rsp = final_response(transfer_exit(), 0x37U);
+    return rsp != NULL && rsp->data[0] == 0x77U;
+}
+
+/*******************************************************************************
+ * Tests
+ ******************************************************************************/
+
+static void test_download(void)
+{
+    const uint32_t slot = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uds_sim_rsp_t *rsp;
+    uint32_t block_len;
+    uint32_t offset = 0U;
+    uint8_t bsc = 1U;
+    uint32_t writes;
+
+    printf("download into slot B\n");
+    uds_sim_reset();
+    CHECK(hal_flash_erase_range(slot, TEST_IMAGE_SIZE) == HAL_ERR_SUCCESS);
+
+    rsp = request_download(slot, TEST_IMAGE_SIZE);
+    CHECK(rsp != NULL && rsp->len == 4U && rsp->data[0] == 0x74U && rsp->data[1] == 0x20U);
+    if (rsp == NULL || rsp->len != 4U) {
+        return;
+    }
+    block_len = ((uint32_t)rsp->data[2] << 8) | rsp->data[3];
+    CHECK(block_len == UDS_MAX_BLOCK_LEN);
+    block_len -= 2U;                    /* SID and block sequence counter */
+
+    /* A second RequestDownload while one is active is refused */
+    CHECK(is_nrc(request_download(slot, TEST_IMAGE_SIZE), 0x34U, CNC));
+
+    writes = c40_sim_write_count();
+    while (offset < TEST_IMAGE_SIZE) {
+        uint32_t n = TEST_IMAGE_SIZE - offset;
+
+        if (n > block_len) {
+            n = block_len;
+        }
+        rsp = transfer_data(bsc, &image[offset], n);
+        CHECK(rsp != NULL && rsp->len == 2U && rsp->data[0] == 0x76U && rsp->data[1] == bsc);
+
+        if (bsc == 3U) {
+            /* Tester repeats a block whose response it lost: answered, not rewritten */
+            rsp = transfer_data(bsc, &image[offset], n);
+            CHECK(rsp != NULL && rsp->len == 2U && rsp->data[0] == 0x76U && rsp->data[1] == bsc);
+            /* Skipping a counter is rejected */
+            CHECK(is_nrc(transfer_data((uint8_t)(bsc + 2U), &image[offset], n), 0x36U, WBSC));
+        }
+        offset += n;
+        bsc++;
+    }
+
+    /* Data beyond the requested size */
+    CHECK(is_nrc(transfer_data(bsc, image, 16U), 0x36U, TDS));
+
+    /* Exit waits for the segments still programming */
+    rsp = final_response(transfer_exit(), 0x37U);
+    CHECK(rsp != NULL && rsp->len == 1U && rsp->data[0] == 0x77U);
+    CHECK(hal_flash_is_idle());
+    CHECK(memcmp(c40_sim_ptr(slot), image, TEST_IMAGE_SIZE) == 0);
+    /* Streamed in whole 128 byte pages, not one write per block */
+    CHECK(c40_sim_write_count() - writes == (TEST_IMAGE_SIZE + HAL_FLASH_PROGRAM_CHUNK - 1U) / HAL_FLASH_PROGRAM_CHUNK);
+    printf("  %u bytes in %u blocks of %u, %u page writes\n", TEST_IMAGE_SIZE,
+           (unsigned)(bsc - 1U), (unsigned)block_len, (unsigned)(c40_sim_write_count() - writes));
+
+    /* Transfer is over */
+    CHECK(is_nrc(transfer_data(bsc, image, 16U), 0x36U, RSE));
+    CHECK(is_nrc(transfer_exit(), 0x37U, RSE));
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+}
+
+static void test_pipeline(void)
+{
+    const uint32_t slot = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uds_sim_rsp_t *rsp;
+    uint32_t block_len = UDS_MAX_BLOCK_LEN - 2U;
+    uint32_t offset = 0U;
+    uint32_t first_pending = 0U;
+    uint32_t pending = 0U;
+    bool overlapped = false;
+    uint8_t bsc = 1U;
+
+    printf("pipelined transfer\n");
+    uds_sim_reset();
+    CHECK(hal_flash_erase_range(slot, PIPE_IMAGE_SIZE) == HAL_ERR_SUCCESS);
+    c40_sim_set_latency(0U, PIPE_WRITE_US);
+
+    rsp = request_download(slot, PIPE_IMAGE_SIZE);
+    CHECK(rsp != NULL && rsp->data[0] == 0x74U);
+
+    while (offset < PIPE_IMAGE_SIZE) {
+        uint32_t n = PIPE_IMAGE_SIZE - offset;
+
+        if (n > block_len) {
+            n = block_len;
+        }
+        rsp = transfer_data(bsc, &image[offset], n);
+        if (is_pending(rsp, 0x36U)) {
+            if (pending == 0U) {
+                first_pending = offset;
+            }
+            pending++;
+
+            /* Another request while one is parked is refused */
+            CHECK(is_nrc(transfer_data(bsc, &image[offset], n), 0x36U, BRR));
+            rsp = wait_response();
+        } else if (offset > 0U && !hal_flash_is_idle()) {
+            /* Answered while earlier data was still being programmed */
+            overlapped = true;
+        }
+        CHECK(rsp != NULL && rsp->len == 2U && rsp->data[0] == 0x76U && rsp->data[1] == bsc);
+        offset += n;
+        bsc++;
+    }
+
+    rsp = final_response(transfer_exit(), 0x37U);
+    CHECK(rsp != NULL && rsp->len == 1U && rsp->data[0] == 0x77U);
+    CHECK(memcmp(c40_sim_ptr(slot), image, PIPE_IMAGE_SIZE) == 0);
+
+    CHECK(overlapped);
+    /* 0x78 only once the block no longer fits into the segments */
+    CHECK(pending > 0U);
+    CHECK(first_pending + block_len > UDS_DOWNLOAD_SEGMENT_NUM * SEGMENT_SIZE);
+    printf("  %u bytes, first 0x78 after %u bytes, %u blocks waited for a segment\n",
+           PIPE_IMAGE_SIZE, (unsigned)first_pending, (unsigned)pending);
+    /* Parked requests gave their TP buffer back once answered */
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+
+    c40_sim_set_latency(0U, 0U);
+}
+
+static void test_erase_memory(void)
+{
+    const uint32_t slot = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uint32_t erase_size = PIPE_IMAGE_SIZE + 2U * SEGMENT_SIZE;     /* Tail is never downloaded */
+    const uint32_t sectors = (erase_size + SEGMENT_SIZE - 1U) / SEGMENT_SIZE;
+    const uds_sim_rsp_t *rsp;
+    uint32_t block_len = UDS_MAX_BLOCK_LEN - 2U;
+    uint32_t erases;
+    uint32_t offset = 0U;
+    uint32_t i;
+    bool overlapped = false;
+    uint8_t bsc = 1U;
+
+    printf("erase memory routine (%s)\n", UDS_ERASE_AHEAD ? "erase-ahead" : "erase first");
+    uds_sim_reset();
+
+    /* Old image in the slot */
+    CHECK(hal_flash_erase_range(slot, erase_size) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_program(slot, image, PIPE_IMAGE_SIZE) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_program(slot + PIPE_IMAGE_SIZE, image, 2U * SEGMENT_SIZE) == HAL_ERR_SUCCESS);
+    for (i = 0U; i < PIPE_IMAGE_SIZE; i++) {
+        image[i] ^= 0x5AU;
+    }
+
+    c40_sim_set_latency(2000U, PIPE_WRITE_US);
+    erases = c40_sim_erase_count();
+
+    rsp = erase_memory(slot, erase_size);
+#if UDS_ERASE_AHEAD
+    /* Answered at once, the sectors erase in the background */
+    CHECK(is_erase_ok(rsp));
+    CHECK(c40_sim_erase_count() - erases < sectors);
+#else
+    /* 0x78 while erasing; nothing else may start meanwhile */
+    CHECK(is_pending(rsp, 0x31U));
+    CHECK(is_nrc(request_download(slot, PIPE_IMAGE_SIZE), 0x34U, CNC));
+    CHECK(is_nrc(erase_memory(slot, SEGMENT_SIZE), 0x31U, CNC));
+    rsp = final_response(wait_response(), 0x31U);
+    CHECK(is_erase_ok(rsp));
+    CHECK(c40_sim_erase_count() - erases == sectors);
+#endif
+
+    rsp = request_download(slot, PIPE_IMAGE_SIZE);
+    CHECK(rsp != NULL && rsp->data[0] == 0x74U);
+
+    /* The range can't change under an active download */
+    CHECK(is_nrc(erase_memory(slot, SEGMENT_SIZE), 0x31U, CNC));
+
+    while (offset < PIPE_IMAGE_SIZE) {
+        uint32_t n = PIPE_IMAGE_SIZE - offset;
+
+        if (n > block_len) {
+            n = block_len;
+        }
+        rsp = transfer_data(bsc, &image[offset], n);
+        if (!is_pending(rsp, 0x36U) && c40_sim_erase_count() - erases < sectors) {
+            /* Acknowledged while the range was still being erased */
+            overlapped = true;
+        }
+        rsp = final_response(rsp, 0x36U);
+        CHECK(rsp != NULL && rsp->len == 2U && rsp->data[0] == 0x76U && rsp->data[1] == bsc);
+        offset += n;
+        bsc++;
+    }
+
+    rsp = final_response(transfer_exit(), 0x37U);
+    CHECK(rsp != NULL && rsp->len == 1U && rsp->data[0] == 0x77U);
+    CHECK(memcmp(c40_sim_ptr(slot), image, PIPE_IMAGE_SIZE) == 0);
+    CHECK(overlapped == (UDS_ERASE_AHEAD != 0U));
+
+    /* The rest of the range is erased after the download */
+    for (i = 0U; i < MAX_IDLE_CALLS && (c40_sim_erase_count() - erases < sectors || !hal_flash_is_idle()); i++) {
+        (void)uds_sim_idle();
+    }
+    CHECK(c40_sim_erase_count() - erases == sectors);
+    for (i = PIPE_IMAGE_SIZE; i < sectors * SEGMENT_SIZE; i++) {
+        if (c40_sim_ptr(slot)[i] != 0xFFU) {
+            break;
+        }
+    }
+    CHECK(i == sectors * SEGMENT_SIZE);
+    printf("  %u sectors erased, %s\n", (unsigned)sectors,
+           overlapped ? "TransferData overlapped the erase" : "erased before RequestDownload");
+
+    /* Active slot, malformed, wrong session */
+    CHECK(is_nrc(erase_memory(boot_ctrl_slot_addr(APP_A_TYPE), SEGMENT_SIZE), 0x31U, ROOR));
+    CHECK(is_nrc(erase_memory(slot + BOOT_SLOT_SIZE - SEGMENT_SIZE, 2U * SEGMENT_SIZE), 0x31U, ROOR));
+    {
+        const uint8_t short_req[5] = {0x31U, 0x01U, 0xFFU, 0x00U, 0x44U};
+        const uint8_t session[2] = {0x10U, 0x03U};
+
+        CHECK(is_nrc(uds_sim_request(short_req, sizeof(short_req)), 0x31U, IMLOIF));
+        (void)uds_sim_request(session, sizeof(session));
+        CHECK(is_nrc(erase_memory(slot, SEGMENT_SIZE), 0x31U, ROOR));
+    }
+
+    for (i = 0U; i < PIPE_IMAGE_SIZE; i++) {
+        image[i] ^= 0x5AU;
+    }
+    c40_sim_set_latency(0U, 0U);
+}
+
+static void test_check_routines(void)
+{
+    const uint32_t slot = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uint32_t meta_addr = boot_ctrl_slot_metadata_addr(APP_B_TYPE);
+    const uint32_t image_crc = hal_crc32_compute(image, TEST_IMAGE_SIZE, 0U);
+    app_metadata_t meta;
+
+    printf("check memory / programming dependencies\n");
+    uds_sim_reset();
+
+    memset(&meta, 0, sizeof(meta));
+    meta.magic = APP_METADATA_MAGIC;
+    meta.flash_start_addr = slot;
+    meta.image_size = TEST_IMAGE_SIZE;
+    meta.crc32 = image_crc;
+
+    /* Nothing downloaded since the last EraseMemory */
+    CHECK(is_erase_ok(final_response(erase_memory(slot, TEST_IMAGE_SIZE), 0x31U)));
+    CHECK(is_erase_ok(final_response(erase_memory(meta_addr, sizeof(meta)), 0x31U)));
+    CHECK(is_nrc(check_memory(image_crc), 0x31U, RSE));
+
+    /* Image, then its metadata block; CheckMemory covers the last range */
+    CHECK(download(slot, image, TEST_IMAGE_SIZE));
+    CHECK(is_routine_status(check_memory(image_crc ^ 1U), 0x02U, 0x02U, 0x01U));
+    CHECK(is_routine_status(check_memory(image_crc), 0x02U, 0x02U, 0x00U));
+    CHECK(download(meta_addr, (const uint8_t *)&meta, sizeof(meta)));
+    CHECK(is_routine_status(check_memory(hal_crc32_compute((const uint8_t *)&meta, sizeof(meta), 0U)),
+                            0x02U, 0x02U, 0x00U));
+
+    /* Valid: the slot is marked to boot next */
+    CHECK(uds_sim_pending_slot() == APP_INVLID_TYPE);
+    CHECK(is_routine_status(check_dependency(), 0xFFU, 0x01U, 0x00U));
+    CHECK(uds_sim_pending_slot() == APP_B_TYPE);
+
+    /* The range list is gone, the image is rescanned: a flipped byte fails */
+    uds_sim_reset();
+    c40_sim_ptr(slot)[100] ^= 0x01U;
+    CHECK(is_routine_status(check_dependency(), 0xFFU, 0x01U, 0x01U));
+    CHECK(uds_sim_pending_slot() == APP_INVLID_TYPE);
+    c40_sim_ptr(slot)[100] ^= 0x01U;
+    CHECK(is_routine_status(check_dependency(), 0xFFU, 0x01U, 0x00U));
+
+    /* Deferred verify: CheckMemory reads the range back once */
+    hal_flash_set_verify_policy(HAL_FLASH_VERIFY_DEFERRED);
+    uds_sim_reset();
+    CHECK(is_erase_ok(final_response(erase_memory(slot, TEST_IMAGE_SIZE), 0x31U)));
+    CHECK(download(slot, image, TEST_IMAGE_SIZE));
+    c40_sim_ptr(slot + TEST_IMAGE_SIZE - 1U)[0] ^= 0x80U;
+    CHECK(is_routine_status(check_memory(image_crc), 0x02U, 0x02U, 0x01U));
+    c40_sim_ptr(slot + TEST_IMAGE_SIZE - 1U)[0] ^= 0x80U;
+    CHECK(is_routine_status(check_memory(image_crc), 0x02U, 0x02U, 0x00U));
+    hal_flash_set_verify_policy(HAL_FLASH_VERIFY_COMPARE);
+
+    /* Malformed, and not while a transfer is open */
+    {
+        const uint8_t short_req[5] = {0x31U, 0x01U, 0x02U, 0x02U, 0x00U};
+
+        CHECK(is_nrc(uds_sim_request(short_req, sizeof(short_req)), 0x31U, IMLOIF));
+    }
+    CHECK(request_download(slot, 0x100U)->data[0] == 0x74U);
+    CHECK(is_nrc(check_memory(image_crc), 0x31U, RSE));
+    CHECK(is_nrc(check_dependency(), 0x31U, CNC));
+    {
+        /* Leaving the program session drops the open transfer */
+        const uint8_t session[2] = {0x10U, 0x01U};
+
+        (void)uds_sim_request(session, sizeof(session));
+    }
+}
+
+static void test_compressed_download(void)
+{
+    const uint32_t slot = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uds_sim_rsp_t *rsp;
+    uint8_t *img = malloc(LZSS_IMAGE_SIZE);
+    uint8_t *comp = malloc(LZSS_ENCODE_BOUND(LZSS_IMAGE_SIZE));
+    size_t comp_len;
+    size_t offset = 0U;
+    uint32_t block_len;
+    uint32_t blocks = 0U;
+    uint8_t bsc = 1U;
+    FILE *f;
+
+    printf("compressed download\n");
+    uds_sim_reset();
+
+    /* Real firmware content when the tree has been built, the random test image otherwise */
+    memset(img, 0xFF, LZSS_IMAGE_SIZE);
+    f = fopen("build/Easy_Boot.elf", "rb");
+    if (f != NULL) {
+        CHECK(fread(img, 1, LZSS_IMAGE_SIZE, f) > 0U);
+        fclose(f);
+    } else {
+        memcpy(img, image, PIPE_IMAGE_SIZE);
+    }
+    comp_len = lzss_encode(img, LZSS_IMAGE_SIZE, comp);
+
+    CHECK(is_erase_ok(final_response(erase_memory(slot, LZSS_IMAGE_SIZE), 0x31U)));
+    rsp = request_download_format(0x10U, slot, LZSS_IMAGE_SIZE);
+    CHECK(rsp != NULL && rsp->len == 4U && rsp->data[0] == 0x74U);
+    if (rsp == NULL || rsp->len != 4U) {
+        goto out;
+    }
+    block_len = ((uint32_t)rsp->data[2] << 8) | rsp->data[3];
+    CHECK(block_len > 2U && block_len <= UDS_MAX_BLOCK_LEN);
+    block_len -= 2U;
+
+    while (offset < comp_len) {
+        uint32_t n = (comp_len - offset > block_len) ? block_len : (uint32_t)(comp_len - offset);
+
+        rsp = final_response(transfer_data(bsc, &comp[offset], n), 0x36U);
+        CHECK(rsp != NULL && rsp->len == 2U && rsp->data[0] == 0x76U && rsp->data[1] == bsc);
+        if (rsp == NULL || rsp->data[0] != 0x76U) {
+            goto out;
+        }
+        offset += n;
+        bsc++;
+        blocks++;
+    }
+    rsp = final_response(transfer_exit(), 0x37U);
+    CHECK(rsp != NULL && rsp->len == 1U && rsp->data[0] == 0x77U);
+    CHECK(memcmp(c40_sim_ptr(slot), img, LZSS_IMAGE_SIZE) == 0);
+    /* CheckMemory works on the decompressed image */
+    CHECK(is_routine_status(check_memory(hal_crc32_compute(img, LZSS_IMAGE_SIZE, 0U)), 0x02U, 0x02U, 0x00U));
+    printf("  %u bytes as %u compressed (%.1f%%) in %u blocks instead of %u\n", LZSS_IMAGE_SIZE,
+           (unsigned)comp_len, 100.0 * (double)comp_len / LZSS_IMAGE_SIZE, (unsigned)blocks,
+           (unsigned)((LZSS_IMAGE_SIZE + UDS_MAX_BLOCK_LEN - 3U) / (UDS_MAX_BLOCK_LEN - 2U)));
+
+    /* Stream longer than the announced size: suspended and dropped */
+    comp_len = lzss_encode(image, 100U, comp);
+    CHECK(request_download_format(0x10U, slot, 50U)->data[0] == 0x74U);
+    CHECK(is_nrc(final_response(transfer_data(1U, comp, (uint32_t)comp_len), 0x36U), 0x36U, TDS));
+    CHECK(is_nrc(transfer_data(2U, comp, 16U), 0x36U, RSE));
+
+    /* Copy before the start of the stream */
+    {
+        const uint8_t bad[4] = {0x00U, 0x00U, 0x00U, 0x00U};
+
+        CHECK(request_download_format(0x10U, slot, 200U)->data[0] == 0x74U);
+        CHECK(is_nrc(transfer_data(1U, bad, sizeof(bad)), 0x36U, TDS));
+        CHECK(is_nrc(transfer_exit(), 0x37U, RSE));
+    }
+
+    /* Stream shorter than the announced size: exit refused */
+    comp_len = lzss_encode(image, 60U, comp);
+    CHECK(request_download_format(0x10U, slot, 100U)->data[0] == 0x74U);
+    CHECK(final_response(transfer_data(1U, comp, (uint32_t)comp_len), 0x36U)->data[0] == 0x76U);
+    CHECK(is_nrc(transfer_exit(), 0x37U, RSE));
+    {
+        const uint8_t session[2] = {0x10U, 0x01U};
+
+        (void)uds_sim_request(session, sizeof(session));
+    }
+    while (!hal_flash_is_idle()) {
+        (void)uds_sim_idle();
+    }
+
+out:
+    free(img);
+    free(comp);
+}
+
+/* Sends a whole patch or compressed stream, false on the first negative response */
+static bool transfer_all(const uint8_t *data, size_t len, uint32_t block_len, uint32_t *pending)
+{
+    const uds_sim_rsp_t *rsp;
+    size_t offset = 0U;
+    uint8_t bsc = 1U;
+
+    while (offset < len) {
+        uint32_t n = (len - offset > block_len) ? block_len : (uint32_t)(len - offset);
+
+        rsp = transfer_data(bsc, &data[offset], n);
+        if (is_pending(rsp, 0x36U)) {
+            (*pending)++;
+            rsp = final_response(rsp, 0x36U);
+        }
+        if (rsp == NULL || rsp->len != 2U || rsp->data[0] != 0x76U || rsp->data[1] != bsc) {
+            return false;
+        }
+        offset += n;
+        bsc++;
+    }
+    return true;
+}
+
+static void test_delta_download(void)
+{
+    const uint32_t slot_a = boot_ctrl_slot_addr(APP_A_TYPE);
+    const uint32_t slot_b = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uds_sim_rsp_t *rsp;
+    uint8_t *old_img = malloc(DELTA_IMAGE_SIZE);
+    uint8_t *new_img = malloc(DELTA_IMAGE_SIZE + 1024U);
+    uint8_t *patch = malloc(DELTA_ENCODE_BOUND(DELTA_IMAGE_SIZE + 1024U));
+    const size_t new_len = DELTA_IMAGE_SIZE + 512U;
+    size_t patch_len;
+    uint32_t block_len;
+    uint32_t pending = 0U;
+    uint32_t i;
+
+    printf("delta download\n");
+    uds_sim_reset();
+
+    /* Installed image in the active slot A; the new one has a changed constant and 512 bytes of new code */
+    for (i = 0U; i < DELTA_IMAGE_SIZE; i++) {
+        old_img[i] = image[(i * 7U) % PIPE_IMAGE_SIZE] ^ (uint8_t)(i >> 12);
+    }
+    memcpy(new_img, old_img, 100000U);
+    new_img[5000] ^= 0xFFU;
+    memcpy(&new_img[100000], image, 512U);
+    memcpy(&new_img[100512], &old_img[100000], DELTA_IMAGE_SIZE - 100000U);
+    patch_len = delta_encode(old_img, DELTA_IMAGE_SIZE, new_img, new_len, patch);
+    CHECK(hal_flash_erase_range(slot_a, DELTA_IMAGE_SIZE) == HAL_ERR_SUCCESS);
+    CHECK(hal_flash_program(slot_a, old_img, DELTA_IMAGE_SIZE) == HAL_ERR_SUCCESS);
+
+    /* Copies produce far more than a block carries: slow pages make the pipeline fill mid-block */
+    c40_sim_set_latency(0U, 20U);
+    CHECK(is_erase_ok(final_response(erase_memory(slot_b, (uint32_t)new_len), 0x31U)));
+    rsp = request_download_format(0x20U, slot_b, (uint32_t)new_len);
+    CHECK(rsp != NULL && rsp->len == 4U && rsp->data[0] == 0x74U);
+    if (rsp == NULL || rsp->len != 4U) {
+        goto out;
+    }
+    block_len = (((uint32_t)rsp->data[2] << 8) | rsp->data[3]) - 2U;
+    CHECK(transfer_all(patch, patch_len, block_len, &pending));
+    CHECK(pending > 0U);
+    rsp = final_response(transfer_exit(), 0x37U);
+    CHECK(rsp != NULL && rsp->len == 1U && rsp->data[0] == 0x77U);
+    CHECK(memcmp(c40_sim_ptr(slot_b), new_img, new_len) == 0);
+    CHECK(memcmp(c40_sim_ptr(slot_a), old_img, DELTA_IMAGE_SIZE) == 0);
+    CHECK(is_routine_status(check_memory(hal_crc32_compute(new_img, (uint32_t)new_len, 0U)), 0x02U, 0x02U, 0x00U));
+    printf("  %u byte image from a %u byte patch, %u blocks waited for the flash\n",
+           (unsigned)new_len, (unsigned)patch_len, (unsigned)pending);
+    c40_sim_set_latency(0U, 0U);
+
+    /* Patch made for another installed image: refused before anything is written */
+    c40_sim_ptr(slot_a + 4U)[0] ^= 0x01U;
+    CHECK(is_erase_ok(final_response(erase_memory(slot_b, (uint32_t)new_len), 0x31U)));
+    CHECK(request_download_format(0x20U, slot_b, (uint32_t)new_len)->data[0] == 0x74U);
+    CHECK(is_nrc(final_response(transfer_data(1U, patch, block_len), 0x36U), 0x36U, CNC));
+    CHECK(is_nrc(transfer_data(2U, patch, 16U), 0x36U, RSE));
+    c40_sim_ptr(slot_a + 4U)[0] ^= 0x01U;
+
+    /* Patch cut short: exit refused */
+    CHECK(is_erase_ok(final_response(erase_memory(slot_b, (uint32_t)new_len), 0x31U)));
+    CHECK(request_download_format(0x20U, slot_b, (uint32_t)new_len)->data[0] == 0x74U);
+    CHECK(transfer_all(patch, patch_len / 2U, block_len, &pending));
+    CHECK(is_nrc(transfer_exit(), 0x37U, RSE));
+    {
+        const uint8_t session[2] = {0x10U, 0x01U};
+
+        (void)uds_sim_request(session, sizeof(session));
+    }
+    while (!hal_flash_is_idle()) {
+        (void)uds_sim_idle();
+    }
+
+    /* Reset mid-download: the progress record lets the patch go on behind the sectors already in flash */
+    uds_sim_reset();
+    {
+        const uint16_t did = 0xFD20U;
+        uint32_t out_total;
+        uint32_t in_total;
+
+        rsp = read_did(&did, 1U);
+        CHECK(rsp != NULL && rsp->len == 27U && get_u32(&rsp->data[3]) == slot_b &&
+              get_u32(&rsp->data[7]) == (uint32_t)new_len &&
+              get_u32(&rsp->data[11]) == hal_crc32_compute(old_img, DELTA_IMAGE_SIZE, 0U) &&
+              get_u32(&rsp->data[15]) == hal_crc32_compute(new_img, (uint32_t)new_len, 0U));
+        if (rsp == NULL || rsp->len != 27U) {
+            goto out;
+        }
+        out_total = get_u32(&rsp->data[19]);
+        in_total = get_u32(&rsp->data[23]);
+        CHECK(out_total != 0U && ((slot_b + out_total) % SEGMENT_SIZE) == 0U && in_total <= patch_len / 2U);
+        printf("  resumed at %u image bytes, %u patch bytes\n", (unsigned)out_total, (unsigned)in_total);
+
+        /* Only the download the record belongs to, and only over what it wrote */
+        CHECK(is_nrc(request_download_format(0x30U, slot_b, (uint32_t)new_len - 1U), 0x34U, UDNA));
+        c40_sim_ptr(slot_b + out_total - 1U)[0] ^= 0x01U;
+        CHECK(is_nrc(request_download_format(0x30U, slot_b, (uint32_t)new_len), 0x34U, UDNA));
+        c40_sim_ptr(slot_b + out_total - 1U)[0] ^= 0x01U;
+
+        CHECK(is_erase_ok(final_response(erase_memory(slot_b + out_total, (uint32_t)new_len - out_total), 0x31U)));
+        rsp = request_download_format(0x30U, slot_b, (uint32_t)new_len);
+        CHECK(rsp != NULL && rsp->len == 4U && rsp->data[0] == 0x74U);
+        CHECK(transfer_all(&patch[in_total], patch_len - in_total, block_len, &pending));
+        rsp = final_response(transfer_exit(), 0x37U);
+        CHECK(rsp != NULL && rsp->len == 1U && rsp->data[0] == 0x77U);
+        CHECK(memcmp(c40_sim_ptr(slot_b), new_img, new_len) == 0);
+        CHECK(is_routine_status(check_memory(hal_crc32_compute(new_img, (uint32_t)new_len, 0U)), 0x02U, 0x02U, 0x00U));
+
+        /* Done: nothing left to resume */
+        rsp = read_did(&did, 1U);
+        CHECK(rsp != NULL && rsp->len == 27U && get_u32(&rsp->data[3]) == 0U && get_u32(&rsp->data[19]) == 0U);
+        CHECK(is_nrc(request_download_format(0x30U, slot_b, (uint32_t)new_len), 0x34U, UDNA));
+    }
+
+out:
+    free(old_img);
+    free(new_img);
+    free(patch);
+}
+
+static const uds_sim_rsp_t *read_memory(uint32_t addr, uint32_t size)
+{
+    uint8_t req[10] = {0x23U, 0x44U};
+
+    put_u32(&req[2], addr);
+    put_u32(&req[6], size);
+    return uds_sim_request(req, sizeof(req));
+}
+
+static const uds_sim_rsp_t *request_upload(uint32_t addr, uint32_t size)
+{
+    uint8_t req[11] = {0x35U, 0x00U, 0x44U};
+
+    put_u32(&req[3], addr);
+    put_u32(&req[7], size);
+    return uds_sim_request(req, sizeof(req));
+}
+
+static const uds_sim_rsp_t *upload_block(uint8_t bsc)
+{
+    const uint8_t req[2] = {0x36U, bsc};
+
+    return uds_sim_request(req, sizeof(req));
+}
+
+static void test_upload(void)
+{
+    static uint8_t readback[TEST_IMAGE_SIZE];
+    const uint32_t slot = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uds_sim_rsp_t *rsp;
+    uint32_t block_len;
+    uint32_t offset = 0U;
+    uint8_t bsc = 1U;
+    uint32_t i;
+
+    printf("read back\n");
+    uds_sim_reset();
+    CHECK(hal_flash_erase_range(slot, TEST_IMAGE_SIZE) == HAL_ERR_SUCCESS);
+    CHECK(download(slot, image, TEST_IMAGE_SIZE));
+
+    /* Not while the ECU is locked; unlock as a SecurityAccess (0x27) would */
+    CHECK(is_nrc(read_memory(slot, 4U), 0x23U, SNS));
+    CHECK(is_nrc(request_upload(slot, 0x100U), 0x35U, SNS));
+    UDS_SetSecurityLevel(SECURITY_STATE_LEVEL_1);
+
+    /* ReadMemoryByAddress at every alignment, 1 and 4 byte memorySize */
+    for (i = 0U; i < 4U; i++) {
+        rsp = read_memory(slot + 100U + i, 33U);
+        CHECK(rsp != NULL && rsp->len == 34U && rsp->data[0] == 0x63U &&
+              memcmp(&rsp->data[1], &image[100U + i], 33U) == 0);
+    }
+    {
+        uint8_t req[7] = {0x23U, 0x14U};
+
+        put_u32(&req[2], slot + 5U);
+        req[6] = 7U;
+        rsp = uds_sim_request(req, sizeof(req));
+        CHECK(rsp != NULL && rsp->len == 8U && memcmp(&rsp->data[1], &image[5], 7U) == 0);
+    }
+    rsp = read_memory(slot + 1U, UDS_MAX_READ_MEMORY_LEN);
+    CHECK(rsp != NULL && rsp->len == UDS_MAX_READ_MEMORY_LEN + 1U &&
+          memcmp(&rsp->data[1], &image[1], UDS_MAX_READ_MEMORY_LEN) == 0);
+    rsp = read_memory(UDS_READ_DATA_FLASH_ADDR, 16U);
+    CHECK(rsp != NULL && rsp->len == 17U && memcmp(&rsp->data[1], c40_sim_ptr(UDS_READ_DATA_FLASH_ADDR), 16U) == 0);
+
+    /* Too long, outside the application slots and calibration area, boot records, malformed */
+    CHECK(is_nrc(read_memory(slot, UDS_MAX_READ_MEMORY_LEN + 1U), 0x23U, ROOR));
+    CHECK(is_nrc(read_memory(EASY_BOOT_START_ADDR, 16U), 0x23U, ROOR));
+    CHECK(is_nrc(read_memory(UDS_READ_DATA_FLASH_ADDR + UDS_READ_DATA_FLASH_SIZE - 8U, 16U), 0x23U, ROOR));
+    CHECK(is_nrc(read_memory(BOOT_CTRL_SECTOR_0_ADDR, 16U), 0x23U, ROOR));
+    CHECK(is_nrc(request_upload(BOOT_CTRL_SECTOR_1_ADDR, 0x100U), 0x35U, ROOR));
+    CHECK(is_nrc(read_memory(slot, 0U), 0x23U, ROOR));
+    {
+        const uint8_t short_req[4] = {0x23U, 0x44U, 0x00U, 0x44U};
+
+        CHECK(is_nrc(uds_sim_request(short_req, sizeof(short_req)), 0x23U, IMLOIF));
+    }
+
+    /* Upload from an odd address, one block repeated */
+    rsp = request_upload(slot + 1U, TEST_IMAGE_SIZE - 1U);
+    CHECK(rsp != NULL && rsp->len == 4U && rsp->data[0] == 0x75U && rsp->data[1] == 0x20U);
+    if (rsp == NULL || rsp->len != 4U) {
+        return;
+    }
+    block_len = ((uint32_t)rsp->data[2] << 8) | rsp->data[3];
+    CHECK(block_len == UDS_MAX_UPLOAD_BLOCK_LEN);
+    block_len -= 2U;
+
+    CHECK(is_nrc(request_download(slot, 0x100U), 0x34U, CNC));
+    CHECK(is_nrc(erase_memory(slot, 0x100U), 0x31U, CNC));
+    CHECK(is_nrc(transfer_exit(), 0x37U, RSE));
+    CHECK(is_nrc(upload_block(2U), 0x36U, WBSC));
+
+    while (offset < TEST_IMAGE_SIZE - 1U) {
+        uint32_t n = TEST_IMAGE_SIZE - 1U - offset;
+
+        if (n > block_len) {
+            n = block_len;
+        }
+        rsp = upload_block(bsc);
+        CHECK(rsp != NULL && rsp->len == n + 2U && rsp->data[0] == 0x76U && rsp->data[1] == bsc);
+        if (rsp == NULL || rsp->len != n + 2U) {
+            break;
+        }
+        memcpy(&readback[offset], &rsp->data[2], n);
+
+        if (bsc == 2U) {
+            /* Response lost, the tester asks again */
+            rsp = upload_block(bsc);
+            CHECK(rsp != NULL && rsp->len == n + 2U && memcmp(&rsp->data[2], &image[offset + 1U], n) == 0);
+        }
+        offset += n;
+        bsc++;
+    }
+    CHECK(memcmp(readback, &image[1], TEST_IMAGE_SIZE - 1U) == 0);
+    printf("  %u bytes in %u blocks of %u\n", TEST_IMAGE_SIZE - 1U, (unsigned)(bsc - 1U), (unsigned)block_len);
+
+    CHECK(is_nrc(upload_block(bsc), 0x36U, RSE));
+    rsp = transfer_exit();
+    CHECK(rsp != NULL && rsp->len == 1U && rsp->data[0] == 0x77U);
+    CHECK(is_nrc(upload_block(bsc), 0x36U, RSE));
+
+    /* Compressed upload, read past the slots, another transfer still active */
+    {
+        uint8_t req[11] = {0x35U, 0x10U, 0x44U};
+
+        put_u32(&req[3], slot);
+        put_u32(&req[7], 0x100U);
+        CHECK(is_nrc(uds_sim_request(req, sizeof(req)), 0x35U, ROOR));
+    }
+    CHECK(is_nrc(request_upload(slot + BOOT_SLOT_SIZE - 0x10U, 0x20U), 0x35U, ROOR));
+    CHECK(request_download(slot, 0x100U)->data[0] == 0x74U);
+    CHECK(is_nrc(request_upload(slot, 0x100U), 0x35U, CNC));
+
+    /* Leaving the program session drops a transfer */
+    {
+        const uint8_t session[2] = {0x10U, 0x03U};
+
+        (void)uds_sim_request(session, sizeof(session));
+        uds_sim_reset();
+        UDS_SetSecurityLevel(SECURITY_STATE_LEVEL_1);   /* The restart locks the ECU again */
+        CHECK(request_upload(slot, 0x100U)->data[0] == 0x75U);
+        (void)uds_sim_request(session, sizeof(session));
+        CHECK(read_memory(slot, 4U)->data[0] == 0x63U);
+        CHECK(is_nrc(upload_block(1U), 0x36U, SNS));
+    }
+    uds_sim_reset();
+    CHECK(is_nrc(upload_block(1U), 0x36U, RSE));
+    CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+    UDS_SetSecurityLevel(SECURITY_STATE_LOCKED);
+}
+
+static const uds_sim_rsp_t *write_did(uint16_t did, const uint8_t *data, uint32_t len)
+{
+    uint8_t req[3U + 64U] = {0x2EU, (uint8_t)(did >> 8), (uint8_t)did};
+
+    memcpy(&req[3], data, len);
+    return uds_sim_request(req, 3U + len);
+}
+
+static void test_data_identifier(void)
+{
+    const uint32_t slot_b = boot_ctrl_slot_addr(APP_B_TYPE);
+    uint8_t *meta = c40_sim_ptr(boot_ctrl_slot_metadata_addr(APP_A_TYPE));
+    const uint8_t fingerprint[9] = {0x12U, 0x34U, 0x56U, 0x78U, 0x9AU, 0xBCU, 0x26U, 0x10U, 0x17U};
+    const uint8_t session[2] = {0x10U, 0x03U};
+    const uds_sim_rsp_t *rsp;
+    uint32_t requests;
+    uint32_t downloaded;
+
+    printf("data identifiers\n");
+    uds_sim_reset();
+
+    /* app_metadata_t of the installed application in slot A, as the linker lays it out */
+    memset(meta, 0x00, 0x34U);
+    meta[0] = 0xDDU;
+    meta[1] = 0xCCU;
+    meta[2] = 0xBBU;
+    meta[3] = 0xAAU;
+    memcpy(&meta[0x04], "test_app", 8U);
+    memcpy(&meta[0x14], "v1.2.3", 6U);
+    meta[0x28] = 0x00U;
+    meta[0x29] = 0x00U;
+    meta[0x2A] = 0x50U;
+    meta[0x2B] = 0x00U;
+    meta[0x2C] = 0x20U;
+    meta[0x2D] = 0x4EU;
+    meta[0x31] = 0xEFU;
+    meta[0x32] = 0xBEU;
+    meta[0x33] = 0xADU;
+
+    /* Several DIDs in one request, in request order, unknown ones left out */
+    {
+        const uint16_t dids[5] = {0xF197U, 0x1234U, 0xF180U, 0xF186U, 0xFD00U};
+        const uint32_t ver_len = sizeof(EASY_BOOT_VERSION) - 1U;
+        const uint8_t *p;
+
+        rsp = read_did(dids, 5U);
+        CHECK(rsp != NULL && rsp->len == 1U + 18U + 2U + ver_len + 3U + 14U && rsp->data[0] == 0x62U);
+        if (rsp != NULL && rsp->len == 1U + 18U + 2U + ver_len + 3U + 14U) {
+            p = &rsp->data[1];
+            CHECK(p[0] == 0xF1U && p[1] == 0x97U && memcmp(&p[2], "test_app", 9U) == 0);
+            p += 18U;
+            CHECK(p[0] == 0xF1U && p[1] == 0x80U && memcmp(&p[2], EASY_BOOT_VERSION, ver_len) == 0);
+            p += 2U + ver_len;
+            CHECK(p[0] == 0xF1U && p[1] == 0x86U && p[2] == 0x02U);
+            p += 3U;
+            CHECK(p[0] == 0xFDU && p[1] == 0x00U && get_u32(&p[2]) == 0x00500000U &&
+                  get_u32(&p[6]) == 20000U && get_u32(&p[10]) == 0xADBEEF00U);
+        }
+    }
+
+    /* Fingerprint is erased until written, then survives a restart */
+    {
+        const uint16_t did = 0xF15AU;
+        static const uint8_t erased[9] = {0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU, 0xFFU};
+
+        rsp = read_did(&did, 1U);
+        CHECK(rsp != NULL && rsp->len == 12U && memcmp(&rsp->data[3], erased, 9U) == 0);
+        rsp = write_did(did, fingerprint, 9U);
+        CHECK(rsp != NULL && rsp->len == 3U && rsp->data[0] == 0x6EU && rsp->data[1] == 0xF1U && rsp->data[2] == 0x5AU);
+        uds_sim_reset();
+        rsp = read_did(&did, 1U);
+        CHECK(rsp != NULL && rsp->len == 12U && memcmp(&rsp->data[3], fingerprint, 9U) == 0);
+
+        /* Wrong length, read only, unknown, while a download is active */
+        CHECK(is_nrc(write_did(did, fingerprint, 8U), 0x2EU, IMLOIF));
+        CHECK(is_nrc(write_did(0xF180U, fingerprint, 8U), 0x2EU, ROOR));
+        CHECK(is_nrc(write_did(0x1234U, fingerprint, 9U), 0x2EU, ROOR));
+        CHECK(request_download(slot_b, 0x100U)->data[0] == 0x74U);
+        CHECK(is_nrc(write_did(did, fingerprint, 9U), 0x2EU, CNC));
+        uds_sim_reset();
+
+        /* Readable but not writable in the extended session */
+        (void)uds_sim_request(session, sizeof(session));
+        rsp = read_did(&did, 1U);
+        CHECK(rsp != NULL && rsp->len == 12U && memcmp(&rsp->data[3], fingerprint, 9U) == 0);
+        CHECK(is_nrc(write_did(did, fingerprint, 9U), 0x2EU, ROOR));
+        uds_sim_reset();
+    }
+
+    /* Counters: one more request (and frame) per read, downloads counted when complete */
+    {
+        const uint16_t did = 0xFD10U;
+
+        rsp = read_did(&did, 1U);
+        CHECK(rsp != NULL && rsp->len == 39U);
+        requests = (rsp != NULL) ? get_u32(&rsp->data[3]) : 0U;
+        downloaded = (rsp != NULL) ? get_u32(&rsp->data[15]) : 0U;
+        CHECK(hal_flash_erase_range(slot_b, 0x100U) == HAL_ERR_SUCCESS);
+        CHECK(download(slot_b, image, 0x100U));
+        rsp = read_did(&did, 1U);
+        CHECK(rsp != NULL && rsp->len == 39U && get_u32(&rsp->data[3]) > requests + 1U &&
+              get_u32(&rsp->data[15]) == downloaded + 0x100U && get_u32(&rsp->data[23]) == TP_PDU_BUF_NUM - 1U);
+        CHECK(rsp != NULL && get_u32(&rsp->data[27]) >= get_u32(&rsp->data[3]) &&
+              get_u32(&rsp->data[31]) == 0U && get_u32(&rsp->data[35]) == 0U);
+    }
+
+    /* Malformed, nothing supported, too many DIDs, metadata missing */
+    {
+        const uint8_t odd[4] = {0x22U, 0xF1U, 0x86U, 0xF1U};
+        const uint16_t unknown = 0x1234U;
+        const uint16_t app = 0xF189U;
+        uint16_t many[UDS_MAX_READ_DID_NUM + 1U];
+        uint32_t i;
+
+        for (i = 0U; i <= UDS_MAX_READ_DID_NUM; i++) {
+            many[i] = 0xF186U;
+        }
+        CHECK(is_nrc(uds_sim_request(odd, 1U), 0x22U, IMLOIF));
+        CHECK(is_nrc(uds_sim_request(odd, sizeof(odd)), 0x22U, IMLOIF));
+        CHECK(is_nrc(read_did(&unknown, 1U), 0x22U, ROOR));
+        CHECK(is_nrc(read_did(many, UDS_MAX_READ_DID_NUM + 1U), 0x22U, IMLOIF));
+        rsp = read_did(many, UDS_MAX_READ_DID_NUM);
+        CHECK(rsp != NULL && rsp->len == 1U + 3U * UDS_MAX_READ_DID_NUM);
+        meta[0] = 0xFFU;
+        CHECK(is_nrc(read_did(&app, 1U), 0x22U, CNC));
+    }
+    memset(meta, 0xFF, 0x34U);
+    uds_sim_reset();
+}
+
+static void test_rejected_requests(void)
+{
+    const uint32_t slot_a = boot_ctrl_slot_addr(APP_A_TYPE);
+    const uint32_t slot_b = boot_ctrl_slot_addr(APP_B_TYPE);
+    const uint8_t short_req[3] = {0x34U, 0x00U, 0x44U};
+    uint8_t req[11] = {0x34U, 0x11U, 0x44U};
+
+    printf("rejected requests\n");
+    uds_sim_reset();
+
+    /* Active slot, bootloader, past the end of the slot, empty */
+    CHECK(is_nrc(request_download(slot_a, 0x100U), 0x34U, ROOR));
+    CHECK(is_nrc(request_download(EASY_BOOT_START_ADDR, 0x100U), 0x34U, ROOR));
+    CHECK(is_nrc(request_download(slot_b + BOOT_SLOT_SIZE - 0x10U, 0x20U), 0x34U, ROOR));
+    CHECK(is_nrc(request_download(slot_b, 0U), 0x34U, ROOR));
+
+    /* Unsupported dataFormatIdentifier, malformed request */
+    put_u32(&req[3], slot_b);
+    put_u32(&req[7], 0x100U);
+    CHECK(is_nrc(uds_sim_request(req, sizeof(req)), 0x34U, ROOR));
+    CHECK(is_nrc(uds_sim_request(short_req, sizeof(short_req)), 0x34U, IMLOIF));
+
+    /* Unknown service, service not available in the default session */
+    {
+        const uint8_t unknown[2] = {0x99U, 0x00U};
+        const uint8_t session[2] = {0x10U, 0x01U};
+
+        CHECK(is_nrc(uds_sim_request(unknown, sizeof(unknown)), 0x99U, SNS));
+        (void)uds_sim_request(session, sizeof(session));
+        CHECK(is_nrc(request_download(slot_b, 0x100U), 0x34U, SNS));
+        uds_sim_reset();
+    }
+
+    /* TransferData without RequestDownload */
+    CHECK(is_nrc(transfer_data(1U, image, 16U), 0x36U, RSE));
+
+    /* Leaving the program session drops the transfer */
+    CHECK(request_download(slot_b, 0x100U)->data[0] == 0x74U);
+    {
+        const uint8_t session[2] = {0x10U, 0x03U};
+
+        (void)uds_sim_request(session, sizeof(session));
+    }
+    CHECK(is_nrc(transfer_data(1U, image, 16U), 0x36U, SNS));
+    uds_sim_reset();
+    CHECK(is_nrc(transfer_data(1U, image, 16U), 0x36U, RSE));
+
+    /* A block parked for the flash is dropped with the session, its buffer with it */
+    {
+        const uint8_t session[2] = {0x10U, 0x03U};
+        uint32_t block_len = UDS_MAX_BLOCK_LEN - 2U;
+        uint32_t offset = 0U;
+        uint8_t bsc = 1U;
+        bool parked = false;
+
+        c40_sim_set_latency(0U, PIPE_WRITE_US);
+        CHECK(hal_flash_erase_range(slot_b, PIPE_IMAGE_SIZE) == HAL_ERR_SUCCESS);
+        CHECK(request_download(slot_b, PIPE_IMAGE_SIZE)->data[0] == 0x74U);
+        while (!parked && offset + block_len <= PIPE_IMAGE_SIZE) {
+            parked = is_pending(transfer_data(bsc, &image[offset], block_len), 0x36U);
+            offset += block_len;
+            bsc++;
+        }
+        CHECK(parked);
+        CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM - 1U);
+        (void)uds_sim_request(session, sizeof(session));
+        CHECK(TP_GetFreePduNum() == TP_PDU_BUF_NUM);
+        while (!hal_flash_is_idle()) {
+            (void)uds_sim_idle();
+        }
+        c40_sim_set_latency(0U, 0U);
+        uds_sim_reset();
+    }
+}
+
+int main(void)
+{
+    uint32_t i;
+    uint32_t seed = 0x12345678U;
+
+    for (i = 0U; i < PIPE_IMAGE_SIZE; i++) {
+        seed = seed * 1103515245U + 12345U;
+        image[i] = (uint8_t)(seed >> 16);
+    }
+
+    if (hal_flash_init() != HAL_ERR_SUCCESS) {
+        printf("hal_flash_init failed\n");
+        return 1;
+    }
+
+    test_download();
+    test_pipeline();
+    test_erase_memory();
+    test_check_routines();
+    test_compressed_download();
+    test_delta_download();
+    test_upload();
+    test_data_identifier();
+    test_rejected_requests();
+
+    printf("%s\n", fails ? "FAILED" : "all UDS download tests passed");
+    return fails ? 1 : 0;
+}
+
@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+# Build and run the host test of the UDS download services
+# (external/UDS_stack/UDS and the TP buffer pool on the harness in tools/uds_sim, src/hal_flash.c on
+# the simulated C40 backend in tools/c40_sim, software CRC path, the LZSS
+# decompressor with the host compressor in tools/lzss, the delta patch
+# applier with the diff generator in tools/delta).
+#
+# Usage:
+#   bash tools/uds_download_test.sh
+#   CC=clang bash tools/uds_download_test.sh
+
+set -euo pipefail
+
+TOOLS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+EASYBOOT_ROOT="$(cd "$TOOLS_DIR/.." && pwd)"
+UDS_DIR="$EASYBOOT_ROOT/external/UDS_stack"
+OUT_DIR="$EASYBOOT_ROOT/build/host"
+CC="${CC:-gcc}"
+
+mkdir -p "$OUT_DIR"
+
+# The simulator directories go first so their headers replace the RTD ones.
+# Built with A/B slots (EN_SUPPORT_APP_B), once per EraseMemory mode (UDS_ERASE_AHEAD).
+for ERASE_AHEAD in 1 0; do
+    "$CC" -O1 -g -Wall -Wno-unused-function -Wno-unused-variable \
+        -DEN_SUPPORT_APP_B -DUDS_ERASE_AHEAD="$ERASE_AHEAD" \
+        -I"$TOOLS_DIR/c40_sim" -I"$TOOLS_DIR/uds_sim" -I"$TOOLS_DIR/lzss" -I"$TOOLS_DIR/delta" \
+        -I"$EASYBOOT_ROOT/include" -I"$EASYBOOT_ROOT/include/public_inc" \
+        -I"$EASYBOOT_ROOT/external/auto_lib/inc" \
+        -I"$UDS_DIR/TP/inc" -I"$UDS_DIR/TP/inc/CAN_TP" -I"$UDS_DIR/UDS/inc" \
+        "$TOOLS_DIR/uds_download_test.c" \
+        "$TOOLS_DIR/uds_sim/uds_sim.c" \
+        "$UDS_DIR/UDS/src/uds_app.c" \
+        "$UDS_DIR/UDS/src/uds_app_cfg.c" \
+        "$UDS_DIR/TP/src/TP_pdu.c" \
+        "$EASYBOOT_ROOT/src/hal_flash.c" \
+        "$EASYBOOT_ROOT/src/boot_lzss.c" \
+        "$TOOLS_DIR/lzss/lzss_encode.c" \
+        "$EASYBOOT_ROOT/src/boot_delta.c" \
+        "$TOOLS_DIR/delta/delta_encode.c" \
+        "$EASYBOOT_ROOT/src/hal_crc.c" -DHAL_CRC_USE_HARDWARE=0 \
+        "$TOOLS_DIR/c40_sim/c40_sim.c" \
+        -o "$OUT_DIR/uds_download_test_ea$ERASE_AHEAD"
+
+    # From the tree root, so the compressed download test finds build/Easy_Boot.elf
+    (cd "$EASYBOOT_ROOT" && "$OUT_DIR/uds_download_test_ea$ERASE_AHEAD")
+done
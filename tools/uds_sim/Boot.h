@@ -0,0 +1,7 @@
+/* Host build stand-in for the legacy bootloader Boot.h used by uds_app.c, see uds_sim.h */
+#ifndef UDS_SIM_BOOT_H
+#define UDS_SIM_BOOT_H
+
+void Boot_RequestEnterBootloader(void);
+
+#endif
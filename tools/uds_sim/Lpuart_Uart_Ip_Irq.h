@@ -0,0 +1,4 @@
+/* Host build stand-in for the RTD/board header of the same name, see uds_sim.h */
+#ifndef UDS_SIM_LPUART_UART_IP_IRQ_H
+#define UDS_SIM_LPUART_UART_IP_IRQ_H
+#endif
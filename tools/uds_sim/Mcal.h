@@ -0,0 +1,14 @@
+/* Host build stand-in for the RTD Mcal.h: AUTOSAR platform types only, see uds_sim.h */
+#ifndef UDS_SIM_MCAL_H
+#define UDS_SIM_MCAL_H
+
+#include <stdint.h>
+
+typedef uint8_t  uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef int8_t   sint8;
+typedef int16_t  sint16;
+typedef int32_t  sint32;
+
+#endif
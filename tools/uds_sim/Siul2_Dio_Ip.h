@@ -0,0 +1,4 @@
+/* Host build stand-in for the RTD/board header of the same name, see uds_sim.h */
+#ifndef UDS_SIM_SIUL2_DIO_IP_H
+#define UDS_SIM_SIUL2_DIO_IP_H
+#endif
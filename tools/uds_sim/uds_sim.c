@@ -0,0 +1,227 @@
+/**
+ * @file uds_sim.c
+ * @brief Host-side harness for the UDS application layer, see uds_sim.h
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ */
+
+#include <string.h>
+#include "uds_sim.h"
+#include "boot_ctrl.h"
+#include "boot_verify.h"
+#include "hal_error.h"
+
+/*******************************************************************************
+ * Local Variables
+ ******************************************************************************/
+
+static uint8_t sim_req[UDS_MSG_BUF_LEN];
+static uint32_t sim_req_len;
+static bool sim_req_pending;
+static uint32_t sim_rx_frame_cnt;
+static uds_sim_rsp_t sim_rsp[UDS_SIM_MAX_RSP];
+static uint32_t sim_rsp_count;
+static tpfUDSTxMsgCallBack sim_tx_callback;
+static tAPPType sim_inactive_slot = APP_B_TYPE;
+static tAPPType sim_pending_slot = APP_INVLID_TYPE;
+
+/*******************************************************************************
+ * Transport layer stand-ins
+ ******************************************************************************/
+
+/* Stands in for the CAN TP: the request arrives reassembled in a pool buffer */
+boolean TP_ReadAPduFromTP(uint32 *o_pRxMsgID, uint32 *o_pxRxDataLen, tTPPduHandle *o_pxPdu)
+{
+    tTPPduHandle pdu;
+
+    if (!sim_req_pending) {
+        return FALSE;
+    }
+
+    pdu = TP_AllocPdu();
+    if (pdu == TP_PDU_NONE) {
+        return FALSE;
+    }
+
+    sim_req_pending = false;
+    *o_pRxMsgID = UDS_SIM_PHY_ID;
+    *o_pxRxDataLen = sim_req_len;
+    *o_pxPdu = pdu;
+    memcpy(TP_GetPduBuf(pdu), sim_req, sim_req_len);
+    return TRUE;
+}
+
+boolean TP_WriteAFrameDataInTP(const uint32 i_TxMsgID, const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+                               const uint32 i_xTxDataLen, const uint8 *i_pDataBuf)
+{
+    tpfUDSTxMsgCallBack callback = i_pfUDSTxMsgCallBack;
+
+    if (i_TxMsgID != UDS_SIM_TX_ID || i_xTxDataLen == 0U || i_xTxDataLen > UDS_MSG_BUF_LEN) {
+        return FALSE;
+    }
+
+    if (sim_rsp_count < UDS_SIM_MAX_RSP) {
+        sim_rsp[sim_rsp_count].len = i_xTxDataLen;
+        memcpy(sim_rsp[sim_rsp_count].data, i_pDataBuf, i_xTxDataLen);
+        sim_rsp_count++;
+    }
+
+    /* Every frame reaches the tester; confirm it right away */
+    sim_tx_callback = callback;
+    if (callback != NULL_PTR) {
+        sim_tx_callback = NULL_PTR;
+        callback(TX_MSG_SUCCESSFUL);
+    }
+    return TRUE;
+}
+
+/* Sent at once, so the TP never needs its own reference of the buffer */
+boolean TP_WriteAPduInTP(const uint32 i_TxMsgID, const tpfUDSTxMsgCallBack i_pfUDSTxMsgCallBack,
+                         const uint32 i_xTxDataLen, const tTPPduHandle i_xPdu)
+{
+    if (TP_GetPduBuf(i_xPdu) == NULL_PTR) {
+        return FALSE;
+    }
+
+    return TP_WriteAFrameDataInTP(i_TxMsgID, i_pfUDSTxMsgCallBack, i_xTxDataLen, TP_GetPduBuf(i_xPdu));
+}
+
+uint32 TP_GetConfigTxMsgID(void)
+{
+    return UDS_SIM_TX_ID;
+}
+
+uint32 TP_GetConfigRxMsgFUNID(void)
+{
+    return UDS_SIM_FUN_ID;
+}
+
+uint32 TP_GetConfigRxMsgPHYID(void)
+{
+    return UDS_SIM_PHY_ID;
+}
+
+/* Each request counts as one frame, nothing is ever dropped */
+void TP_GetRxStatistics(tTPRxStatistics *o_pstRxStatistics)
+{
+    o_pstRxStatistics->rxFrameCnt = sim_rx_frame_cnt;
+    o_pstRxStatistics->rxDropCnt = 0U;
+    o_pstRxStatistics->rxOverrunCnt = 0U;
+}
+
+/*******************************************************************************
+ * Board and library stand-ins
+ ******************************************************************************/
+
+void WATCHDOG_HAL_SystemRest(void)
+{
+}
+
+void Boot_RequestEnterBootloader(void)
+{
+}
+
+void *fsl_memcpy(void *pavDest2, const void *pcoavSource2, uint32_t u32Length2)
+{
+    return memcpy(pavDest2, pcoavSource2, u32Length2);
+}
+
+void *fsl_memset(void *pavDest3, uint8_t u8Fill3, uint32_t u32Length3)
+{
+    return memset(pavDest3, u8Fill3, u32Length3);
+}
+
+void *fsl_memmove(void *pavDest4, const void *pcoavSource4, uint32_t u32Length4)
+{
+    return memmove(pavDest4, pcoavSource4, u32Length4);
+}
+
+/*******************************************************************************
+ * Boot-control / verify stand-ins (the real ones read flash through pointers)
+ ******************************************************************************/
+
+uint32_t boot_ctrl_slot_addr(tAPPType slot)
+{
+    if ((uint32_t)slot >= BOOT_SLOT_COUNT) {
+        return 0U;
+    }
+    return BOOT_SLOT_A_ADDR + ((uint32_t)slot * BOOT_SLOT_SIZE);
+}
+
+uint32_t boot_ctrl_slot_metadata_addr(tAPPType slot)
+{
+    uint32_t base = boot_ctrl_slot_addr(slot);
+
+    return (base == 0U) ? 0U : (base + BOOT_SLOT_METADATA_OFFSET);
+}
+
+tAPPType boot_ctrl_get_inactive_slot(void)
+{
+    return sim_inactive_slot;
+}
+
+int32_t boot_ctrl_mark_pending(tAPPType slot)
+{
+    sim_pending_slot = slot;
+    return HAL_ERR_SUCCESS;
+}
+
+int32_t boot_verify_invalidate(tAPPType slot)
+{
+    (void)slot;
+    return HAL_ERR_SUCCESS;
+}
+
+/*******************************************************************************
+ * Harness API
+ ******************************************************************************/
+
+void uds_sim_reset(void)
+{
+    sim_req_pending = false;
+    sim_rsp_count = 0U;
+    sim_pending_slot = APP_INVLID_TYPE;
+    TP_PduInit();
+    UDS_Init();
+
+    /* After 0x10 02 the bootloader restarts and announces the program session */
+    (void)UDS_TxMsgToHost();
+    sim_rsp_count = 0U;
+}
+
+const uds_sim_rsp_t *uds_sim_request(const uint8_t *req, uint32_t len)
+{
+    memcpy(sim_req, req, len);
+    sim_req_len = len;
+    sim_req_pending = true;
+    sim_rx_frame_cnt++;
+    return uds_sim_idle();
+}
+
+const uds_sim_rsp_t *uds_sim_idle(void)
+{
+    sim_rsp_count = 0U;
+    UDS_MainFun();
+    return (sim_rsp_count == 0U) ? NULL : &sim_rsp[sim_rsp_count - 1U];
+}
+
+uint32_t uds_sim_rsp_count(void)
+{
+    return sim_rsp_count;
+}
+
+const uds_sim_rsp_t *uds_sim_rsp(uint32_t n)
+{
+    return (n < sim_rsp_count) ? &sim_rsp[n] : NULL;
+}
+
+void uds_sim_set_inactive_slot(tAPPType slot)
+{
+    sim_inactive_slot = slot;
+}
+
+tAPPType uds_sim_pending_slot(void)
+{
+    return sim_pending_slot;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file uds_sim.h
+ * @brief Host-side harness for the UDS application layer in external/UDS_stack/UDS
+ *
+ * @version 1.0.0
+ * @date 2026-10-17
+ *
+ * @details
+ * Replaces the transport layer (TP_*), the boot-control/verify modules and
+ * the board headers so uds_app.c and uds_app_cfg.c can run on the host
+ * against hal_flash.c and the simulated C40 backend in tools/c40_sim. A test
+ * queues one request, runs UDS_MainFun() and inspects the response.
+ */
+
+#ifndef UDS_SIM_H
+#define UDS_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "uds_app.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define UDS_SIM_PHY_ID      (0x784u)
+#define UDS_SIM_FUN_ID      (0x7FFu)
+#define UDS_SIM_TX_ID       (0x7F0u)
+#define UDS_SIM_MAX_RSP     (8u)        /* Responses kept per request (0x78 + final) */
+
+typedef struct
+{
+    uint32_t len;
+    uint8_t  data[UDS_MSG_BUF_LEN];
+} uds_sim_rsp_t;
+
+/**
+ * @brief Reset the harness: no pending request, no responses, program session
+ *        entered the way the bootloader does after a 0x10 02 reset
+ */
+void uds_sim_reset(void);
+
+/**
+ * @brief Send one physical request and run UDS_MainFun() once
+ *
+ * @param req Request bytes, starting with the SID
+ * @param len Request length
+ * @return Last response written by the UDS layer, NULL if none
+ */
+const uds_sim_rsp_t *uds_sim_request(const uint8_t *req, uint32_t len);
+
+/**
+ * @brief Run UDS_MainFun() without a new request (background work)
+ *
+ * @return Last response written during the call, NULL if none
+ */
+const uds_sim_rsp_t *uds_sim_idle(void);
+
+/**
+ * @brief Number of responses written during the last uds_sim_request()/idle()
+ */
+uint32_t uds_sim_rsp_count(void);
+
+/**
+ * @brief Response n (0 = first) of the last uds_sim_request()/idle()
+ */
+const uds_sim_rsp_t *uds_sim_rsp(uint32_t n);
+
+/**
+ * @brief Boot-control stand-ins: download target slot and pending marker
+ */
+void uds_sim_set_inactive_slot(tAPPType slot);
+tAPPType uds_sim_pending_slot(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* UDS_SIM_H */
@@ -0,0 +1,10 @@
+/* Host build stand-in for the watchdog HAL used by the UDS stack, see uds_sim.h */
+#ifndef UDS_SIM_WATCHDOG_HAL_H
+#define UDS_SIM_WATCHDOG_HAL_H
+
+void WATCHDOG_HAL_SystemRest(void);
+
+/* Used by uds_app_cfg.c without an include of its own */
+void Boot_RequestEnterBootloader(void);
+
+#endif